@@ -107,6 +107,7 @@ MemRef::MemRef(const IRExpr::Ptr &value)
 
 bool MemRef::replaceExpr(const Object::Ptr &oldExpr, const Object::Ptr &newExpr)
 {
+    MutationLock lock(*this);
     bool success = InheritedType::replaceExpr(oldExpr, newExpr);
     if (value_ == oldExpr)
     {
@@ -351,6 +352,7 @@ DefExpr::DefExpr(const std::string &name, const Type::Ptr &type, bool hasAddress
 
 IRExpr::Ptr DefExpr::getReference()
 {
+    MutationLock lock(*this);
     if (!memRef_ && hasAddress_)
         memRef_ = new MemRef(this);
     return memRef_;
@@ -358,6 +360,7 @@ IRExpr::Ptr DefExpr::getReference()
 
 bool DefExpr::replaceExpr(const Object::Ptr &oldExpr, const Object::Ptr &newExpr)
 {
+    MutationLock lock(*this);
     bool success = InheritedType::replaceExpr(oldExpr, newExpr);
     if (memRef_ == oldExpr)
     {
@@ -448,6 +451,7 @@ IfExpr::IfExpr(const IRExpr::Ptr &cond, const IRExpr::Ptr &then, const IRExpr::P
 
 bool IfExpr::replaceExpr(const Object::Ptr &oldExpr, const Object::Ptr &newExpr)
 {
+    MutationLock lock(*this);
     bool success = InheritedType::replaceExpr(oldExpr, newExpr);
     if (cond_ == oldExpr)
     {
@@ -493,6 +497,7 @@ LoopExpr::LoopExpr(const IRExpr::Ptr &body)
 
 bool LoopExpr::replaceExpr(const Object::Ptr &oldExpr, const Object::Ptr &newExpr)
 {
+    MutationLock lock(*this);
     bool success = InheritedType::replaceExpr(oldExpr, newExpr);
     if (body_ == oldExpr)
     {
@@ -550,6 +555,7 @@ ForExpr::ForExpr(
 
 bool ForExpr::replaceExpr(const Object::Ptr &oldExpr, const Object::Ptr &newExpr)
 {
+    MutationLock lock(*this);
     bool success = InheritedType::replaceExpr(oldExpr, newExpr);
     if (var_ == oldExpr)
     {
@@ -622,6 +628,7 @@ LetExpr::LetExpr(const std::string &varName,
 
 bool LetExpr::replaceExpr(const Object::Ptr &oldExpr, const Object::Ptr &newExpr)
 {
+    MutationLock lock(*this);
     bool success = InheritedType::replaceExpr(oldExpr, newExpr);
     if (var_ == oldExpr)
     {
@@ -685,6 +692,7 @@ void BlockExpr::setName(const std::string &name)
 
 void BlockExpr::setExprList(ArrayRef<IRExpr::Ptr> exprList)
 {
+    MutationLock lock(*this);
     exprList_.clear();
     exprList_.insert(exprList_.begin(), exprList.begin(), exprList.end());
     update();
@@ -692,6 +700,7 @@ void BlockExpr::setExprList(ArrayRef<IRExpr::Ptr> exprList)
 
 void BlockExpr::addExpr(const IRExpr::Ptr &expr)
 {
+    MutationLock lock(*this);
     exprList_.push_back(expr);
     update();
 }
@@ -709,6 +718,7 @@ void BlockExpr::update()
 
 bool BlockExpr::replaceExpr(const Object::Ptr &oldExpr, const Object::Ptr &newExpr)
 {
+    MutationLock lock(*this);
     bool success = InheritedType::replaceExpr(oldExpr, newExpr);
     for (ExprList::iterator it = exprList_.begin(), end = exprList_.end(); it != end; ++it)
     {
@@ -745,6 +755,7 @@ void BlockExpr::gcApplyToChildren(const CollectorCallback &callback)
 
 void BlockExpr::addBreak(const IRExpr::Ptr &expr)
 {
+    MutationLock lock(*this);
     breakList_.push_back(expr);
     if (name_.empty())
     {
@@ -754,6 +765,7 @@ void BlockExpr::addBreak(const IRExpr::Ptr &expr)
 
 void BlockExpr::removeBreak(const IRExpr::Ptr &expr)
 {
+    MutationLock lock(*this);
     ExprList::iterator it = std::find(breakList_.begin(), breakList_.end(), expr);
     if (it != breakList_.end())
     {
@@ -798,6 +810,7 @@ BreakExpr::~BreakExpr()
 
 bool BreakExpr::replaceExpr(const Object::Ptr &oldExpr, const Object::Ptr &newExpr)
 {
+    MutationLock lock(*this);
     bool success = InheritedType::replaceExpr(oldExpr, newExpr);
     if (block_ == oldExpr)
     {
@@ -876,12 +889,14 @@ void Prototype::setReturnType(const Type::Ptr &type)
                 <<IR::IRUtils::getTypeName(returnType_)<<", cannot change to "
                 <<IR::IRUtils::getTypeName(type));
 
+    MutationLock lock(*this);
     returnType_ = type;
     computeFunctionType();
 }
 
 const FunctionType::Ptr & Prototype::computeFunctionType()
 {
+    MutationLock lock(*this);
     if (!functionType_ && returnType_)
     {
         typedef std::vector<Arg>::const_iterator Iter;
@@ -971,6 +986,7 @@ FunctionDefinition::FunctionDefinition(
 
 IRExpr::Ptr FunctionDefinition::getReference()
 {
+    MutationLock lock(*this);
     if (!memRef_)
         memRef_ = new MemRef(this);
     return memRef_;
@@ -978,6 +994,7 @@ IRExpr::Ptr FunctionDefinition::getReference()
 
 bool FunctionDefinition::replaceExpr(const Object::Ptr &oldExpr, const Object::Ptr &newExpr)
 {
+    MutationLock lock(*this);
     bool success = InheritedType::replaceExpr(oldExpr, newExpr);
     // FIXME should proto_ be replaced as well ?
     for (std::vector<DefExpr::Ptr>::iterator it = args_.begin(), end = args_.end(); it != end; ++it)
@@ -1036,6 +1053,7 @@ Function::Function(
 
 void Function::setBody(const IRExpr::Ptr &body)
 {
+    MutationLock lock(*this);
     body_ = body;
     if (body)
         getProto()->setReturnType(body_->getExprType());
@@ -1043,6 +1061,7 @@ void Function::setBody(const IRExpr::Ptr &body)
 
 bool Function::replaceExpr(const Object::Ptr &oldExpr, const Object::Ptr &newExpr)
 {
+    MutationLock lock(*this);
     bool success = InheritedType::replaceExpr(oldExpr, newExpr);
     if (body_ == oldExpr)
     {
@@ -1128,6 +1147,7 @@ CallExpr::CallExpr(const IRExpr::Ptr &callee, ArrayRef<IRExpr::Ptr> args)
 
 bool CallExpr::replaceExpr(const Object::Ptr &oldExpr, const Object::Ptr &newExpr)
 {
+    MutationLock lock(*this);
     bool success = InheritedType::replaceExpr(oldExpr, newExpr);
     for (std::vector<IRExpr::Ptr>::iterator it = args_.begin(), end = args_.end(); it != end; ++it)
     {
@@ -335,6 +335,7 @@ public:
 
     void setValue(const std::vector<IRExpr::Ptr> &value)
     {
+        MutationLock lock(*this);
         value_ = value;
     }
 
@@ -342,6 +343,7 @@ public:
 
     void setElementAt(size_t index, const IRExpr::Ptr &element)
     {
+        MutationLock lock(*this);
         value_[index] = element;
     }
 
@@ -575,12 +577,14 @@ public:
 
     void setExprListSize(size_t newSize)
     {
+        MutationLock lock(*this);
         exprList_.resize(newSize);
         update();
     }
 
     void setExprAt(size_t index, const IRExpr::Ptr &expr)
     {
+        MutationLock lock(*this);
         exprList_[index] = expr;
         // FIXME should we update ?
     }
@@ -68,6 +68,7 @@ CodeGen::CodeGen(llvm::LLVMContext &context, World &world)
     , llvmTypeMap_()
     , llvmDefs_()
     , genReference_()
+    , reuseExistingDefinitions_(false)
 {
     initLLVMDefs();
     initContext();
@@ -86,6 +87,7 @@ CodeGen::CodeGen(CompilerUnit *moduleCompilerUnit, World &world)
     , namedValues_()
     , llvmDefs_()
     , genReference_()
+    , reuseExistingDefinitions_(false)
 {
     initLLVMDefs();
     initContext();
@@ -1538,6 +1540,20 @@ llvm::Value * CodeGen::emit(IR::Prototype &proto)
     return createFunction(proto.getName(), proto);
 }
 
+llvm::Function * CodeGen::getExistingDefinition(const std::string &mangledName, const std::string &name)
+{
+    if (!reuseExistingDefinitions_ || !compilerUnit)
+        return 0;
+
+    llvm::Function *F = compilerUnit->getFunction(mangledName);
+    if (!F && !name.empty())
+        F = compilerUnit->getFunction(name);
+
+    if (F && !F->isDeclaration())
+        return F;
+    return 0;
+}
+
 llvm::Value *CodeGen::emit(IR::Function &func)
 {
     if (genReference_)
@@ -1546,6 +1562,10 @@ llvm::Value *CodeGen::emit(IR::Function &func)
             return F;
     }
 
+    // body was already compiled, e.g. loaded from the runtime cache
+    if (llvm::Function *F = getExistingDefinition(func.getMangledName()))
+        return F;
+
     namedValues_.clear();
 
     IR::Prototype::Ptr proto = func.getProto();
@@ -1664,6 +1684,9 @@ llvm::Value *CodeGen::emit(IR::Intrinsic &func)
     llvm::Type *returnType = getLLVMType(proto->getReturnType(), RETURN_TYPE);
     ppvars["rettype"] = llvmGetTypeIdentifier(returnType);
 
+    if (llvm::Function *F = getExistingDefinition(mangledFuncName, funcName))
+        return F;
+
     std::string errorMsg;
     std::string assembly = llvmDefs_ + "\n";
 //    for (LLVMTypeMap::iterator it = llvmTypeMap_.begin(), end = llvmTypeMap_.end();
@@ -238,6 +238,10 @@ public:
     // this should be used, whenever a new module is linked into the CompilerUnit
     void migrateTypes();
 
+    void setReuseExistingDefinitions(bool value) { reuseExistingDefinitions_ = value; }
+
+    bool isReuseExistingDefinitions() const { return reuseExistingDefinitions_; }
+
 private:
     typedef std::map<std::string, llvm::WeakVH> StringCacheMap;
     typedef std::map<Type::Ptr, llvm::Type*> LLVMTypeMap;
@@ -272,6 +276,9 @@ private:
     // following member influence code generation in visit methods
     // their value must be saved before modified
     bool genReference_; // visit should return reference (pointer to data) if possible
+    bool reuseExistingDefinitions_; // do not regenerate bodies of already defined functions
+
+    llvm::Function * getExistingDefinition(const std::string &mangledName, const std::string &name = "");
 
     void initLLVMDefs();
     void initContext();
@@ -114,6 +114,19 @@ namespace Compiler
 	    virtual llvm::Function * createFunction(llvm::FunctionType * type, int linkage, std::string name) = 0;
 
 	    virtual void event_activeModuleModified() { }
+
+	    // Compiled code management
+	    // Code of a function returned by acquirePointerToFunction is freed
+	    // after the last releasePointerToFunction call when nothing else uses it.
+	    // Code compiled before pinCompiledCode is kept until the unit is destroyed.
+	    virtual void* acquirePointerToFunction(llvm::Function * func) { return requestPointerToFunction(func); }
+	    virtual bool releasePointerToFunction(void * funcPtr) { return false; }
+	    virtual void pinCompiledCode() { }
+
+	    // Statistics about live compiled code
+	    virtual size_t getCodeSize() const { return 0; }
+	    virtual size_t getDataSize() const { return 0; }
+	    virtual size_t getNumStages() const { return 0; }
 	};
 }
 
@@ -74,6 +74,7 @@
 #include <KIARA/Compiler/Mangler.hpp>
 #include <KIARA/Compiler/Token.hpp>
 #include <KIARA/Compiler/Lexer.hpp>
+#include <KIARA/Utils/MemoryBuffer.hpp>
 
 
 #include <KIARA/Compiler/LLVM/MCJITCompilerUnit.hpp>
@@ -181,11 +182,11 @@ void Evaluator::init(LangParser *parser, llvm::LLVMContext *context)
 
     if (jitConfig.useLegacyJIT)
     {
-        compilerUnit = new JITCompilerUnit(module);
+        compilerUnit = new JITCompilerUnit(module, jitConfig);
     }
     else
     {
-        compilerUnit = new MCJITCompilerUnit(module);
+        compilerUnit = new MCJITCompilerUnit(module, jitConfig);
     }
     codegen_ = new CodeGen(compilerUnit, world_);
 
@@ -393,6 +394,44 @@ void * Evaluator::getPointerToFunction(const std::string &mangledName)
     return ptr;
 }
 
+void * Evaluator::acquirePointerToFunction(llvm::Value *value)
+{
+    void * ptr = 0;
+    if (llvm::Function *llvmFun = llvm::cast_or_null<llvm::Function>(value))
+    {
+        ptr = compilerUnit->acquirePointerToFunction(llvmFun);
+        codegen_->clearStringCache();
+    }
+
+    return ptr;
+}
+
+bool Evaluator::releasePointerToFunction(void *funcPtr)
+{
+    return compilerUnit->releasePointerToFunction(funcPtr);
+}
+
+void Evaluator::pinCompiledCode()
+{
+    compilerUnit->pinCompiledCode();
+    codegen_->clearStringCache();
+}
+
+size_t Evaluator::getJITCodeSize() const
+{
+    return compilerUnit->getCodeSize();
+}
+
+size_t Evaluator::getJITDataSize() const
+{
+    return compilerUnit->getDataSize();
+}
+
+size_t Evaluator::getNumJITStages() const
+{
+    return compilerUnit->getNumStages();
+}
+
 bool Evaluator::optimizeModule()
 {
     return compilerUnit->optimizeActiveModule();
@@ -417,6 +456,11 @@ void Evaluator::writeModule(const std::string &fileName)
     }
 }
 
+bool Evaluator::writeModule(const std::string &fileName, std::string &errorMsg)
+{
+    return llvmWriteModuleToFile(compilerUnit->getActiveModule(), fileName, errorMsg);
+}
+
 #define DEFAULT_LEXER_PREFIX "=<>!+-*&|/%^"
 #define DEFAULT_LEXER_SUFFIX "=<>&|"
 #define DEFAULT_LEXER_CXX_COMMENT false
@@ -459,6 +503,39 @@ bool Evaluator::loadModule(const std::string &fileName)
     return success;
 }
 
+bool Evaluator::linkPrecompiledModule(const std::string &fileName, bool replaceExisting, std::string &errorMsg)
+{
+    llvm::Module * module = llvmLoadModuleFromFile(fileName, errorMsg, &codegen_->getContext());
+    if (!module)
+        return false;
+
+    codegen_->clearStringCache();
+
+    llvm::Module *activeModule = compilerUnit->getActiveModule();
+    if (replaceExisting)
+        llvmRemoveDuplicateDefinitions(module, activeModule);
+    else
+        llvmRemoveDuplicateDefinitions(activeModule, module);
+
+    bool success = llvmLinkModules(activeModule, module, errorMsg);
+    delete module;
+    if (!success)
+        return false;
+
+    compilerUnit->event_activeModuleModified();
+    return true;
+}
+
+void Evaluator::setReuseExistingDefinitions(bool value)
+{
+    codegen_->setReuseExistingDefinitions(value);
+}
+
+bool Evaluator::isReuseExistingDefinitions() const
+{
+    return codegen_->isReuseExistingDefinitions();
+}
+
 void Evaluator::loadPlugin(const std::string &fileName)
 {
     llvmLoadPlugin(fileName);
@@ -490,8 +567,8 @@ void Evaluator::includeFile(const std::string &fileName)
         fn = DFC::FileSystem::joinPaths(
                 DFC::FileSystem::getDirname(parser_->getFileName()),
                 fileName);
-    std::ifstream in(fn.c_str());
-    if (!in)
+    MemoryBuffer buffer;
+    if (!buffer.open(fn))
     {
         std::cerr<<"Error: Could not include file "<<fileName<<std::endl;
         return;
@@ -501,7 +578,7 @@ void Evaluator::includeFile(const std::string &fileName)
     std::string suffix = parser_ ? parser_->getLexer()->getSuffix() : DEFAULT_LEXER_SUFFIX;
     bool cxxComment = parser_ ? parser_->getLexer()->getCXXComment() : DEFAULT_LEXER_CXX_COMMENT;
 
-    Lexer lexer(in, prefix, suffix);
+    Lexer lexer(buffer.begin(), buffer.end(), prefix, suffix);
     lexer.setCXXComment(cxxComment);
 
     if (parser_)
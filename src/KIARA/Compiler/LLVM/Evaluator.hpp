@@ -79,14 +79,39 @@ public:
 
     void * getPointerToFunction(const std::string &mangledName);
 
+    /// Like getPointerToFunction, but code of the function is freed
+    /// after it is released with releasePointerToFunction.
+    void * acquirePointerToFunction(llvm::Value *value);
+    bool releasePointerToFunction(void *funcPtr);
+
+    /// Keeps all code compiled so far until the evaluator is destroyed.
+    void pinCompiledCode();
+
+    size_t getJITCodeSize() const;
+    size_t getJITDataSize() const;
+    size_t getNumJITStages() const;
+
     bool optimizeModule();
     bool optimizeFunction(llvm::Value *value);
 
     void writeModule(const std::string &fileName);
+    bool writeModule(const std::string &fileName, std::string &errorMsg);
     void includeFile(const std::string &fileName);
     bool loadModule(const std::string &fileName, std::string &errorMsg);
     bool loadModule(const std::string &fileName);
 
+    /// Links precompiled bitcode module into the active module.
+    /// Definitions already present in the active module are kept, unless
+    /// replaceExisting is true, then they are replaced by the precompiled
+    /// ones (e.g. when the precompiled module was optimized).
+    bool linkPrecompiledModule(const std::string &fileName, bool replaceExisting, std::string &errorMsg);
+
+    /// When enabled, function definitions that already have a body in the
+    /// compiler unit (e.g. linked by linkPrecompiledModule) are not generated
+    /// again, only their declarations are processed.
+    void setReuseExistingDefinitions(bool value);
+    bool isReuseExistingDefinitions() const;
+
     void loadPlugin(const std::string &fileName);
 
     bool linkNativeFunc(const std::string &funcName, void * nativeFunc);
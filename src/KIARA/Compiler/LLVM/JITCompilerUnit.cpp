@@ -47,6 +47,7 @@
 #include "llvm/ExecutionEngine/JIT.h"
 #include "llvm/ExecutionEngine/MCJIT.h"
 #include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/ExecutionEngine/JITEventListener.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/Support/raw_os_ostream.h"
 #include "llvm/Support/CallSite.h"
@@ -65,15 +66,48 @@ namespace KIARA
 namespace Compiler
 {
 
+// Tracks machine code emitted by the JIT
+class JITCompilerUnit::CodeListener : public llvm::JITEventListener
+{
+public:
+    CodeListener() : codeSize_(0), codeMap_() { }
+
+    virtual void NotifyFunctionEmitted(const llvm::Function &F, void *Code, size_t Size,
+                                       const EmittedFunctionDetails &Details)
+    {
+        codeMap_[Code] = Size;
+        codeSize_ += Size;
+    }
+
+    virtual void NotifyFreeingMachineCode(void *OldPtr)
+    {
+        std::map<void *, size_t>::iterator it = codeMap_.find(OldPtr);
+        if (it != codeMap_.end())
+        {
+            codeSize_ -= it->second;
+            codeMap_.erase(it);
+        }
+    }
+
+    size_t getCodeSize() const { return codeSize_; }
+    size_t getNumFunctions() const { return codeMap_.size(); }
+
+private:
+    size_t codeSize_;
+    std::map<void *, size_t> codeMap_;
+};
+
 // CompilerUnit
 
-JITCompilerUnit::JITCompilerUnit(llvm::Module * initModule)
+JITCompilerUnit::JITCompilerUnit(llvm::Module * initModule, const JITConfiguration & config)
 	: CompilerUnit()
 	, jitModule(initModule)
 	, jitEngine(0)
-    , optimizer_()
+    , optimizer_(config)
     , trackedTypeMap_()
     , compiledFuncs_()
+    , acquiredFuncs_()
+    , codeListener_(new CodeListener)
 {
 	assert(jitModule);
 
@@ -84,7 +118,8 @@ JITCompilerUnit::JITCompilerUnit(llvm::Module * initModule)
 	std::string errorMsg;
 
 	engineBuilder.setUseMCJIT(false);
-    engineBuilder.setOptLevel(JIT_OPTIMIZATION_LEVEL);
+    engineBuilder.setOptLevel(getJITCodeGenOptLevel(config));
+    engineBuilder.setCodeModel(getJITCodeModel(config));
     engineBuilder.setErrorStr(&errorMsg);
 
 	llvm::TargetOptions Options;
@@ -101,6 +136,8 @@ JITCompilerUnit::JITCompilerUnit(llvm::Module * initModule)
 		DFC_THROW_EXCEPTION(Exception, "Could not create ExecutionEngine: "<<errorMsg);
 	}
 
+	jitEngine->RegisterJITEventListener(codeListener_);
+
 	// compile..
 	jitEngine->DisableLazyCompilation();
 
@@ -114,9 +151,11 @@ JITCompilerUnit::~JITCompilerUnit()
     {
         jitEngine->runStaticConstructorsDestructors(true);
         jitEngine->removeModule(jitModule);
+        jitEngine->UnregisterJITEventListener(codeListener_);
         delete jitEngine;
         jitEngine = 0;
     }
+    delete codeListener_;
 }
 
 llvm::LLVMContext & JITCompilerUnit::getContext()
@@ -294,6 +333,64 @@ llvm::Function * JITCompilerUnit::createFunction(llvm::FunctionType * type, int
 	return llvm::Function::Create(type, linkage, name, getActiveModule());
 }
 
+void* JITCompilerUnit::acquirePointerToFunction(llvm::Function * func)
+{
+    void *addr = requestPointerToFunction(func);
+    if (addr)
+    {
+        AcquiredFunc &acquiredFunc = acquiredFuncs_[addr];
+        acquiredFunc.func = func;
+        ++acquiredFunc.refCount;
+    }
+    return addr;
+}
+
+bool JITCompilerUnit::releasePointerToFunction(void * funcPtr)
+{
+    AcquiredFuncMap::iterator it = acquiredFuncs_.find(funcPtr);
+    if (it == acquiredFuncs_.end())
+        return false;
+
+    if (--it->second.refCount > 0)
+        return true;
+
+    llvm::Function *func = it->second.func;
+    acquiredFuncs_.erase(it);
+    compiledFuncs_.erase(funcPtr);
+
+    // Only the entry function is freed, all functions it calls
+    // are shared with other code and can be requested later by name.
+    if (!func->use_empty())
+        return true;
+    for (CompiledFuncMap::const_iterator cit = compiledFuncs_.begin(), cend = compiledFuncs_.end();
+        cit != cend; ++cit)
+    {
+        for (llvm::SmallVector<llvm::AssertingVH<llvm::Function>, 2>::const_iterator fit = cit->second.begin(),
+            fend = cit->second.end(); fit != fend; ++fit)
+        {
+            if (*fit == func)
+                return true;
+        }
+    }
+
+    DFC_DEBUG("Free machine code of function: "<<func->getName().str());
+
+    jitEngine->freeMachineCodeForFunction(func);
+    func->eraseFromParent();
+    return true;
+}
+
+size_t JITCompilerUnit::getCodeSize() const
+{
+    return codeListener_->getCodeSize();
+}
+
+size_t JITCompilerUnit::getNumStages() const
+{
+    // legacy JIT compiles every function separately
+    return codeListener_->getNumFunctions();
+}
+
 void JITCompilerUnit::findAllUsedFunctions(
     llvm::Function *func,
     std::set<llvm::Function*> &funcSet,
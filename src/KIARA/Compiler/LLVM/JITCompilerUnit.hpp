@@ -67,7 +67,7 @@ namespace Compiler
 
 		// migrates a type to the top module
 
-		JITCompilerUnit(llvm::Module * activeModule);
+		JITCompilerUnit(llvm::Module * activeModule, const JITConfiguration & config = JITConfiguration());
 
 		~JITCompilerUnit();
 
@@ -120,7 +120,14 @@ namespace Compiler
 
 	    llvm::Function * createFunction(llvm::FunctionType * type, int rawLinkage, std::string name);
 
+	    void* acquirePointerToFunction(llvm::Function * func);
+	    bool releasePointerToFunction(void * funcPtr);
+
+	    size_t getCodeSize() const;
+	    size_t getNumStages() const;
+
 	private:
+	    class CodeListener;
 
         void findAllUsedFunctions(
             llvm::Function *func,
@@ -135,6 +142,15 @@ namespace Compiler
         NamedTypeMap trackedTypeMap_;
         typedef std::map<void *, llvm::SmallVector<llvm::AssertingVH<llvm::Function>, 2> > CompiledFuncMap;
         CompiledFuncMap compiledFuncs_;
+        struct AcquiredFunc
+        {
+            llvm::Function *func;
+            unsigned refCount;
+            AcquiredFunc() : func(0), refCount(0) { }
+        };
+        typedef std::map<void *, AcquiredFunc> AcquiredFuncMap;
+        AcquiredFuncMap acquiredFuncs_;
+        CodeListener *codeListener_;
 	};
 
 } // namespace Compiler
@@ -52,6 +52,8 @@
 // #define DFC_DO_DEBUG
 #include <DFC/Utils/Debug.hpp>
 
+#include <algorithm>
+
 typedef unsigned int uint;
 
 namespace KIARA
@@ -106,10 +108,16 @@ void MCJITCompilerUnit::JitStage::updateGlobalNames()
 	//DFC_IFDEBUG( dump() );
 }
 
-MCJITCompilerUnit::JitStage::JitStage(llvm::Module * stageModule, CompilerUnit & cu)
-	: module(stageModule)
+MCJITCompilerUnit::JitStage::JitStage(llvm::Module * stageModule, unsigned stageId, CompilerUnit & cu)
+	: id(stageId)
+	, module(stageModule)
 	, engine(0)
 	, manager(new StagingMemoryManager(cu))
+	, refCount(0)
+	, numDependents(0)
+	, pinned(false)
+	, entryPoints()
+	, dependencies()
 {
 #ifdef _WIN32
     // this is required currently on Windows for MCJIT
@@ -148,6 +156,45 @@ void MCJITCompilerUnit::JitStage::dump() const
 }
 
 bool MCJITCompilerUnit::JitStage::isFinalized() const { return engine != 0; }
+
+void MCJITCompilerUnit::JitStage::addEntryPoint(const std::string & funcName)
+{
+	entryPoints.insert(funcName);
+}
+
+void MCJITCompilerUnit::JitStage::addDependency(JitStage & stage)
+{
+	if (&stage == this)
+		return;
+	if (std::find(dependencies.begin(), dependencies.end(), stage.getId()) != dependencies.end())
+		return;
+	dependencies.push_back(stage.getId());
+	++stage.numDependents;
+}
+
+bool MCJITCompilerUnit::JitStage::isUnused() const
+{
+	return !pinned && isFinalized() && !entryPoints.empty() && refCount == 0 && numDependents == 0;
+}
+
+bool MCJITCompilerUnit::JitStage::hasOnlyEntryPoints() const
+{
+	// Other functions with external linkage might be referenced
+	// by the code compiled later
+	for (llvm::Module::const_iterator itFun = module->begin(); itFun != module->end(); ++itFun)
+	{
+		if (itFun->isDeclaration() || itFun->hasLocalLinkage())
+			continue;
+		if (entryPoints.find(itFun->getName().str()) == entryPoints.end())
+			return false;
+	}
+	for (llvm::Module::const_global_iterator itGlobal = module->global_begin(); itGlobal != module->global_end(); ++itGlobal)
+	{
+		if (!itGlobal->isDeclaration() && !itGlobal->hasLocalLinkage())
+			return false;
+	}
+	return true;
+}
 llvm::Module & MCJITCompilerUnit::JitStage::getModule() const { return *module; }
 llvm::ExecutionEngine & MCJITCompilerUnit::JitStage::getEngine() const { return *engine; }
 
@@ -200,7 +247,7 @@ void MCJITCompilerUnit::registerTrackedType(const std::string & typeName, llvm::
 }
 
 // will compile the module
-void MCJITCompilerUnit::JitStage::finalize(NamedTypeMap & trackedTypes)
+void MCJITCompilerUnit::JitStage::finalize(NamedTypeMap & trackedTypes, const JITConfiguration & config)
 {
 	if (isFinalized())
 		return;
@@ -266,7 +313,8 @@ void MCJITCompilerUnit::JitStage::finalize(NamedTypeMap & trackedTypes)
 
 // set optimization options
 
-	engineBuilder.setOptLevel(JIT_OPTIMIZATION_LEVEL);
+	engineBuilder.setOptLevel(getJITCodeGenOptLevel(config));
+	engineBuilder.setCodeModel(getJITCodeModel(config));
 	engineBuilder.setErrorStr(&errorMsg);
 
 	llvm::TargetOptions Options;
@@ -305,7 +353,7 @@ MCJITCompilerUnit::JitStage & MCJITCompilerUnit::getTop() {
 	return jitStages.back();
 }
 
-llvm::JITMemoryManager * MCJITCompilerUnit::JitStage::getManager() const { return manager; }
+StagingMemoryManager * MCJITCompilerUnit::JitStage::getManager() const { return manager; }
 llvm::ExecutionEngine & MCJITCompilerUnit::getTopEngine() { return getTop().getEngine(); }
 llvm::Module & MCJITCompilerUnit::getTopModule() { return getTop().getModule(); }
 
@@ -404,10 +452,10 @@ void MCJITCompilerUnit::pushStage(llvm::Module * initModule)
     if (!jitStages.empty())
     {
         if (!getTop().isFinalized())
-            getTop().finalize(trackedTypeMap);
+            finalizeStage(getTop());
     }
 
-    jitStages.push_back(JitStage(initModule, *this));
+    jitStages.push_back(JitStage(initModule, nextStageId++, *this));
     optimizer_.setModule(initModule);
 }
 
@@ -421,20 +469,23 @@ void MCJITCompilerUnit::requestUnfinishedTop()
     }
 }
 
-MCJITCompilerUnit::MCJITCompilerUnit(llvm::Module * activeModule)
+MCJITCompilerUnit::MCJITCompilerUnit(llvm::Module * activeModule, const JITConfiguration & config)
 	: CompilerUnit()
     , trackedTypeMap()
     , topTypeMap()
     , mangler()
 	, jitStages()
 	, symbolMan(new ExternalSymbolManager())
+	, acquiredFuncs()
+	, nextStageId(0)
+	, finalizingStage(0)
 	, context(activeModule->getContext())
 	, hostTriple(activeModule->getTargetTriple())
-    , optimizer_()
+    , optimizer_(config)
 {
 	assert(activeModule);
 
-	jitStages.push_back(JitStage(activeModule, *this));
+	jitStages.push_back(JitStage(activeModule, nextStageId++, *this));
 	optimizer_.setModule(activeModule);
 
 	DFC_DEBUG( "[CU] CompilerUnit created!" );
@@ -464,7 +515,7 @@ void MCJITCompilerUnit::setModule(llvm::Module * newModule)
 
 llvm::ExecutionEngine & MCJITCompilerUnit::getActiveEngine()
 {
-	getTop().finalize(trackedTypeMap);
+	finalizeStage(getTop());
 	return getTopEngine();
 }
 #endif
@@ -507,6 +558,10 @@ void* MCJITCompilerUnit::requestPointerToFunction(const std::string & funcName)
 		return 0;
 	}
 
+	// symbol is resolved for the stage being finalized
+	if (finalizingStage)
+		finalizingStage->addDependency(*stage);
+
 	return requestPointerToFunction(stage, func);
 }
 
@@ -515,7 +570,7 @@ MCJITCompilerUnit::requestPointerToFunction(JitStage * stage, llvm::Function * f
 {
 	// compile as necessary
 	if (!stage->isFinalized())
-	    stage->finalize(trackedTypeMap);
+	    finalizeStage(*stage);
 
 	assert(&stage->getModule() == func->getParent());
 
@@ -584,13 +639,173 @@ void* MCJITCompilerUnit::requestPointerToGlobal(llvm::GlobalVariable * gv)
 	}
 
 	if (!stage->isFinalized())
-	    stage->finalize(trackedTypeMap);
+	    finalizeStage(*stage);
 
 	assert(&stage->getModule() == gv->getParent());
 
 	return stage->getPointerToGlobal(gvName);
 }
 
+MCJITCompilerUnit::JitStage * MCJITCompilerUnit::findStage(unsigned stageId)
+{
+	for (JitStageVec::iterator itStage = jitStages.begin(); itStage != jitStages.end(); ++itStage) {
+		if (itStage->getId() == stageId)
+			return &*itStage;
+	}
+	return 0;
+}
+
+void MCJITCompilerUnit::finalizeStage(JitStage & stage)
+{
+	if (stage.isFinalized())
+		return;
+
+	JitStage * prevStage = finalizingStage;
+	finalizingStage = &stage;
+	stage.finalize(trackedTypeMap, optimizer_.getConfiguration());
+	finalizingStage = prevStage;
+}
+
+void* MCJITCompilerUnit::acquirePointerToFunction(llvm::Function * func)
+{
+	void * funcPtr = requestPointerToFunction(func);
+	if (!funcPtr)
+		return 0;
+
+	std::string funcName = func->getName();
+	llvm::Function * unusedFunc = 0;
+	JitStage * stage = findStageForFunction(funcName, unusedFunc, false);
+	if (stage && !stage->isPinned()) {
+		stage->addEntryPoint(funcName);
+		stage->retain();
+		acquiredFuncs[funcPtr] = stage->getId();
+	}
+
+	return funcPtr;
+}
+
+bool MCJITCompilerUnit::releasePointerToFunction(void * funcPtr)
+{
+	AcquiredFuncMap::iterator it = acquiredFuncs.find(funcPtr);
+	if (it == acquiredFuncs.end())
+		return false;
+
+	JitStage * stage = findStage(it->second);
+	assert(stage && "acquired function without stage");
+	stage->release();
+
+	collectStages();
+	return true;
+}
+
+void MCJITCompilerUnit::pinCompiledCode()
+{
+	// compile pending definitions, so that later code is placed into separate stages
+	JitStage & top = getTop();
+	if (!top.isFinalized()) {
+		bool hasDefinitions = false;
+		for (llvm::Module::iterator itFun = top.getModule().begin(); itFun != top.getModule().end(); ++itFun) {
+			if (!itFun->isDeclaration()) {
+				hasDefinitions = true;
+				break;
+			}
+		}
+		if (hasDefinitions || !top.getModule().global_empty())
+			finalizeStage(top);
+	}
+
+	for (JitStageVec::iterator itStage = jitStages.begin(); itStage != jitStages.end(); ++itStage) {
+		if (itStage->isFinalized())
+			itStage->pin();
+	}
+}
+
+void MCJITCompilerUnit::collectStages()
+{
+	if (finalizingStage)
+		return;
+
+	bool changed = true;
+	while (changed) {
+		changed = false;
+
+		for (JitStageVec::iterator itStage = jitStages.begin(); itStage != jitStages.end(); ++itStage) {
+			JitStage & stage = *itStage;
+			// first stage contains the runtime and is never freed
+			if (itStage == jitStages.begin() || !stage.isUnused())
+				continue;
+
+			if (!stage.hasOnlyEntryPoints()) {
+				stage.pin();
+				continue;
+			}
+
+			// unfinished top module might still refer to the entry points
+			JitStage & top = getTop();
+			if (&top != &stage && !top.isFinalized()) {
+				bool referenced = false;
+				for (std::set<std::string>::const_iterator itName = stage.getEntryPoints().begin();
+						itName != stage.getEntryPoints().end(); ++itName) {
+					if (top.getModule().getFunction(*itName)) {
+						referenced = true;
+						break;
+					}
+				}
+				if (referenced)
+					continue;
+			}
+
+			DFC_DEBUG( "[CU] Freeing stage " << stage.getId() );
+
+			for (std::vector<unsigned>::const_iterator itDep = stage.getDependencies().begin();
+					itDep != stage.getDependencies().end(); ++itDep) {
+				if (JitStage * depStage = findStage(*itDep))
+					depStage->removeDependent();
+			}
+
+			for (AcquiredFuncMap::iterator itFunc = acquiredFuncs.begin(); itFunc != acquiredFuncs.end(); ) {
+				if (itFunc->second == stage.getId())
+					acquiredFuncs.erase(itFunc++);
+				else
+					++itFunc;
+			}
+
+			if (optimizer_.getModule() == &stage.getModule())
+				optimizer_.setModule(0);
+
+			stage.terminate();
+			jitStages.erase(itStage);
+			changed = true;
+			break;
+		}
+	}
+}
+
+size_t MCJITCompilerUnit::getCodeSize() const
+{
+	size_t size = 0;
+	for (JitStageVec::const_iterator itStage = jitStages.begin(); itStage != jitStages.end(); ++itStage) {
+		if (itStage->isFinalized())
+			size += itStage->getManager()->getCodeSize();
+	}
+	return size;
+}
+
+size_t MCJITCompilerUnit::getDataSize() const
+{
+	size_t size = 0;
+	for (JitStageVec::const_iterator itStage = jitStages.begin(); itStage != jitStages.end(); ++itStage) {
+		if (itStage->isFinalized())
+			size += itStage->getManager()->getDataSize();
+	}
+	return size;
+}
+
+size_t MCJITCompilerUnit::getNumStages() const
+{
+	return jitStages.size();
+}
+
 bool MCJITCompilerUnit::replaceFunction(const std::string &oldName, const std::string &newName)
 {
     DFC_DEBUG("replaceFunction: "<<oldName<<" -> "<<newName);
@@ -764,7 +979,7 @@ llvm::Function * MCJITCompilerUnit::createFunction(llvm::FunctionType * type, in
 
 void MCJITCompilerUnit::addModule(llvm::Module * module)
 {
-    getTop().finalize(trackedTypeMap); // FIXME: without this tests fail on x86 32-bit architecture
+    finalizeStage(getTop()); // FIXME: without this tests fail on x86 32-bit architecture
 
     const bool createNewStage = getTop().isFinalized();
     if (createNewStage)
@@ -34,6 +34,7 @@
 #include "Optimizer.hpp"
 
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -63,6 +64,7 @@ namespace Compiler
 {
 
 class ExternalSymbolManager;
+class StagingMemoryManager;
 
 class MCJITCompilerUnit : public CompilerUnit
 {
@@ -72,7 +74,7 @@ public:
     // migrates a type to the top module
     llvm::Type * migrateToTop(llvm::Type*);
 
-    MCJITCompilerUnit(llvm::Module * activeModule);
+    MCJITCompilerUnit(llvm::Module * activeModule, const JITConfiguration & config = JITConfiguration());
 
     ~MCJITCompilerUnit();
 
@@ -133,6 +135,14 @@ public:
 
     void event_activeModuleModified();
 
+    void* acquirePointerToFunction(llvm::Function * func);
+    bool releasePointerToFunction(void * funcPtr);
+    void pinCompiledCode();
+
+    size_t getCodeSize() const;
+    size_t getDataSize() const;
+    size_t getNumStages() const;
+
 private:
     class JitStage
     {
@@ -140,7 +150,7 @@ private:
         // mangle all global names as necessary
         void updateGlobalNames();
 
-        JitStage(llvm::Module * stageModule, CompilerUnit & cu);
+        JitStage(llvm::Module * stageModule, unsigned stageId, CompilerUnit & cu);
 
         ~JitStage();
         // the actual dtor
@@ -148,25 +158,48 @@ private:
 
         llvm::Module & getModule() const;
         llvm::ExecutionEngine & getEngine() const;
-        llvm::JITMemoryManager * getManager() const;
+        StagingMemoryManager * getManager() const;
 
         llvm::StructType * getTypeByName(const std::string & typeName) const;
 
         // will create an execution engine and compile the module
-        void finalize(NamedTypeMap & trackedTypes);
+        void finalize(NamedTypeMap & trackedTypes, const JITConfiguration & config);
         bool isFinalized() const;
 
         void * getPointerToGlobal(const std::string & globalName);
         void dump() const;
 
+        unsigned getId() const { return id; }
+
+        // Reference counting: stage is freed when all its acquired
+        // entry points are released and no other stage uses its symbols
+        void addEntryPoint(const std::string & funcName);
+        void retain() { ++refCount; }
+        void release() { if (refCount) --refCount; }
+        void addDependency(JitStage & stage);
+        const std::vector<unsigned> & getDependencies() const { return dependencies; }
+        void removeDependent() { if (numDependents) --numDependents; }
+        void pin() { pinned = true; }
+        bool isPinned() const { return pinned; }
+        bool isUnused() const;
+        bool hasOnlyEntryPoints() const;
+        const std::set<std::string> & getEntryPoints() const { return entryPoints; }
+
     private:
         typedef std::map<std::string, llvm::Function*> FunctionIndex;
 
+        unsigned id;
         llvm::Module * module;
         llvm::ExecutionEngine * engine;
-        llvm::JITMemoryManager * manager;
+        StagingMemoryManager * manager;
         FunctionIndex globalGetters;
 
+        unsigned refCount;
+        unsigned numDependents;
+        bool pinned;
+        std::set<std::string> entryPoints;
+        std::vector<unsigned> dependencies; // ids of stages whose symbols are used
+
         // Actual type name linkage (Only the top module may have a proper LLVM type name table)
         NamedTypeMap typeNames;
 
@@ -174,6 +207,12 @@ private:
     };
     typedef std::vector<JitStage> JitStageVec;
 
+    JitStage * findStage(unsigned stageId);
+    // finalizes stage and records all stages it depends on
+    void finalizeStage(JitStage & stage);
+    // frees all stages that are not used anymore
+    void collectStages();
+
     JitStage & getTop();
     llvm::ExecutionEngine & getTopEngine();
     llvm::Module & getTopModule();
@@ -209,6 +248,11 @@ private:
     JitStageVec jitStages;
     ExternalSymbolManager * symbolMan;
 
+    typedef std::map<void *, unsigned> AcquiredFuncMap;
+    AcquiredFuncMap acquiredFuncs; // entry point -> stage id
+    unsigned nextStageId;
+    JitStage * finalizingStage; // stage whose symbols are currently resolved
+
     // config
     llvm::LLVMContext & context;
     std::string hostTriple;
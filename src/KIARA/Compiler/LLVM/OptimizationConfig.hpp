@@ -26,19 +26,43 @@
 #ifndef KIARA_COMPILER_LLVM_OPTIMIZATIONCONFIG_HPP_INCLUDED
 #define KIARA_COMPILER_LLVM_OPTIMIZATIONCONFIG_HPP_INCLUDED
 
-// uncomment if no optimization should be performed
-// #define DISABLE_OPTIMIZATION
-
-#ifdef DISABLE_OPTIMIZATION
-#define JIT_OPTIMIZATION_LEVEL llvm::CodeGenOpt::Less
-#else
-//#define JIT_OPTIMIZATION_LEVEL llvm::CodeGenOpt::Default
-#define JIT_OPTIMIZATION_LEVEL llvm::CodeGenOpt::Aggressive
-// Note: llvm::CodeGenOpt::None produces segfault
-#endif
-
-// if CUSTOM_FUNCTION_OPTIMIZATION is defined, a custom sequence of the
-// optimization passes will be used for function optimization
-#define CUSTOM_FUNCTION_OPTIMIZATION
+#include <KIARA/DB/JITConfiguration.hpp>
+#include "llvm/Support/CodeGen.h"
+
+namespace KIARA
+{
+namespace Compiler
+{
+
+// Optimization settings are taken from JITConfiguration,
+// see LibraryConfiguration::getJITConfiguration
+
+inline llvm::CodeGenOpt::Level getJITCodeGenOptLevel(const JITConfiguration &config)
+{
+    switch (config.optLevel)
+    {
+        // Note: llvm::CodeGenOpt::None produces segfault
+        case 0:
+        case 1: return llvm::CodeGenOpt::Less;
+        case 2: return llvm::CodeGenOpt::Default;
+        default: return llvm::CodeGenOpt::Aggressive;
+    }
+}
+
+inline llvm::CodeModel::Model getJITCodeModel(const JITConfiguration &config)
+{
+    if (config.codeModel == "small")
+        return llvm::CodeModel::Small;
+    if (config.codeModel == "kernel")
+        return llvm::CodeModel::Kernel;
+    if (config.codeModel == "medium")
+        return llvm::CodeModel::Medium;
+    if (config.codeModel == "large")
+        return llvm::CodeModel::Large;
+    return llvm::CodeModel::JITDefault;
+}
+
+} // namespace Compiler
+} // namespace KIARA
 
 #endif /* KIARA_COMPILER_OPTIMIZATIONCONFIG_HPP_INCLUDED */
@@ -9,7 +9,6 @@
 #define _SSIZE_T_DEFINED
 
 #include "Optimizer.hpp"
-#include "OptimizationConfig.hpp"
 
 // LLVM
 #include "llvm/Config/llvm-config.h"
@@ -34,16 +33,90 @@
 
 #include <KIARA/LLVM/Inlining.hpp>
 
+#include "llvm/Support/raw_ostream.h"
+
 namespace KIARA
 {
 
 namespace Compiler
 {
 
+static llvm::Pass * createFunctionPass(const std::string &name, const JITConfiguration &config)
+{
+    if (name == "tbaa")
+        return llvm::createTypeBasedAliasAnalysisPass();
+    if (name == "basicaa")
+        return llvm::createBasicAliasAnalysisPass();
+    if (name == "instcombine")
+        return llvm::createInstructionCombiningPass();
+    if (name == "simplifycfg")
+        return llvm::createCFGSimplificationPass();
+    if (name == "sroa")
+        return llvm::createSROAPass();
+    if (name == "mem2reg")
+        return llvm::createPromoteMemoryToRegisterPass();
+    if (name == "early-cse")
+        return llvm::createEarlyCSEPass();
+    if (name == "lower-expect")
+        return llvm::createLowerExpectIntrinsicPass();
+    if (name == "simplify-libcalls")
+        return llvm::createSimplifyLibCallsPass();
+    if (name == "jump-threading")
+        return llvm::createJumpThreadingPass();
+    if (name == "correlated-propagation")
+        return llvm::createCorrelatedValuePropagationPass();
+    if (name == "tailcallelim")
+        return llvm::createTailCallEliminationPass();
+    if (name == "reassociate")
+        return llvm::createReassociatePass();
+    if (name == "loop-rotate")
+        return llvm::createLoopRotatePass();
+    if (name == "licm")
+        return llvm::createLICMPass();
+    if (name == "loop-unswitch")
+        return llvm::createLoopUnswitchPass(/* optimize for size */false);
+    if (name == "indvars")
+        return llvm::createIndVarSimplifyPass();
+    if (name == "loop-idiom")
+        return llvm::createLoopIdiomPass();
+    if (name == "loop-deletion")
+        return llvm::createLoopDeletionPass();
+    if (name == "loop-vectorize")
+        return llvm::createLoopVectorizePass();
+    if (name == "slp-vectorizer")
+        return llvm::createSLPVectorizerPass();
+    if (name == "bb-vectorize")
+        return llvm::createBBVectorizePass();
+    if (name == "loop-unroll")
+        return llvm::createLoopUnrollPass(config.unrollThreshold);
+    if (name == "gvn")
+        return llvm::createGVNPass();
+    if (name == "memcpyopt")
+        return llvm::createMemCpyOptPass();
+    if (name == "sccp")
+        return llvm::createSCCPPass();
+    if (name == "dse")
+        return llvm::createDeadStoreEliminationPass();
+    if (name == "adce")
+        return llvm::createAggressiveDCEPass();
+    return 0;
+}
+
 Optimizer::Optimizer(llvm::Module *module)
     : fpm_(0)
     , mpm_(0)
     , module_(0)
+    , config_()
+{
+    if (module)
+        setModule(module);
+}
+
+Optimizer::Optimizer(const JITConfiguration &config, llvm::Module *module)
+    : fpm_(0)
+    , mpm_(0)
+    , module_(0)
+    , config_(config)
 {
     if (module)
         setModule(module);
@@ -79,7 +152,7 @@ void Optimizer::setModule(llvm::Module *module)
     mpm_->add(new llvm::TargetData(module));
 #endif
 
-#ifndef DISABLE_OPTIMIZATION
+    if (config_.optLevel > 0)
     {
         fpm_ = new llvm::FunctionPassManager(module);
         llvm::TargetLibraryInfo *TLI = new llvm::TargetLibraryInfo(llvm::Triple(module->getTargetTriple()));
@@ -89,81 +162,98 @@ void Optimizer::setModule(llvm::Module *module)
 #else
         fpm_->add(new llvm::TargetData(module));
 #endif
+        addFunctionPasses();
     }
-#endif
 
     llvm::PassManagerBuilder builder;
-#ifdef DISABLE_OPTIMIZATION
-    builder.OptLevel = 0;
-    builder.Inliner = 0;
-#else
-    builder.OptLevel = 3;
-    builder.Inliner = llvm::createAlwaysInlinerPass();
-#endif
-    if (fpm_)
+    builder.OptLevel = config_.optLevel;
+    builder.Inliner = config_.optLevel > 0 ? llvm::createAlwaysInlinerPass() : 0;
+    builder.DisableUnrollLoops = (config_.unrollThreshold == 0);
+    builder.populateModulePassManager(*mpm_);
+}
+
+void Optimizer::addFunctionPasses()
+{
+    // explicit pipeline
+    if (!config_.passPipeline.empty())
     {
-#ifndef CUSTOM_FUNCTION_OPTIMIZATION
-        builder.populateFunctionPassManager(*fpm_);
-#else
-        fpm_->add(llvm::createTypeBasedAliasAnalysisPass());
-        fpm_->add(llvm::createBasicAliasAnalysisPass());
+        if (config_.passPipeline.size() == 1 && config_.passPipeline[0] == "standard")
+        {
+            llvm::PassManagerBuilder builder;
+            builder.OptLevel = config_.optLevel;
+            builder.DisableUnrollLoops = (config_.unrollThreshold == 0);
+            builder.populateFunctionPassManager(*fpm_);
+            return;
+        }
 
-        fpm_->add(llvm::createInstructionCombiningPass());
-        fpm_->add(llvm::createCFGSimplificationPass());
-        fpm_->add(llvm::createSROAPass());
+        for (std::vector<std::string>::const_iterator it = config_.passPipeline.begin(),
+            end = config_.passPipeline.end(); it != end; ++it)
+        {
+            if (llvm::Pass *pass = createFunctionPass(*it, config_))
+                fpm_->add(pass);
+            else
+                llvm::errs() << "[Optimizer] unknown pass '" << *it << "' ignored\n";
+        }
+        return;
+    }
 
-        fpm_->add(llvm::createEarlyCSEPass());
-        fpm_->add(llvm::createLowerExpectIntrinsicPass());
+    fpm_->add(llvm::createTypeBasedAliasAnalysisPass());
+    fpm_->add(llvm::createBasicAliasAnalysisPass());
 
-        fpm_->add(llvm::createSimplifyLibCallsPass());
-        fpm_->add(llvm::createJumpThreadingPass());         // Thread jumps.
-        fpm_->add(llvm::createCorrelatedValuePropagationPass()); // Propagate conditionals
-        fpm_->add(llvm::createCFGSimplificationPass());     // Merge & remove BBs
-        fpm_->add(llvm::createInstructionCombiningPass());  // Combine silly seq's
+    fpm_->add(llvm::createInstructionCombiningPass());
+    fpm_->add(llvm::createCFGSimplificationPass());
+    fpm_->add(llvm::createSROAPass());
 
-        fpm_->add(llvm::createTailCallEliminationPass());   // Eliminate tail calls
-        fpm_->add(llvm::createCFGSimplificationPass());     // Merge & remove BBs
-        fpm_->add(llvm::createReassociatePass());           // Reassociate expressions
-        fpm_->add(llvm::createLoopRotatePass());            // Rotate Loop
-        fpm_->add(llvm::createLICMPass());                  // Hoist loop invariants
-        fpm_->add(llvm::createLoopUnswitchPass(/* optimize for size */false));
-        fpm_->add(llvm::createInstructionCombiningPass());
-        fpm_->add(llvm::createIndVarSimplifyPass());        // Canonicalize indvars
-        fpm_->add(llvm::createLoopIdiomPass());             // Recognize idioms like memset.
-        fpm_->add(llvm::createLoopDeletionPass());          // Delete dead loops
+    fpm_->add(llvm::createEarlyCSEPass());
+    fpm_->add(llvm::createLowerExpectIntrinsicPass());
+
+    // level 1 only performs cleanup of the generated code
+    if (config_.optLevel < 2)
+        return;
 
+    fpm_->add(llvm::createSimplifyLibCallsPass());
+    fpm_->add(llvm::createJumpThreadingPass());         // Thread jumps.
+    fpm_->add(llvm::createCorrelatedValuePropagationPass()); // Propagate conditionals
+    fpm_->add(llvm::createCFGSimplificationPass());     // Merge & remove BBs
+    fpm_->add(llvm::createInstructionCombiningPass());  // Combine silly seq's
+
+    fpm_->add(llvm::createTailCallEliminationPass());   // Eliminate tail calls
+    fpm_->add(llvm::createCFGSimplificationPass());     // Merge & remove BBs
+    fpm_->add(llvm::createReassociatePass());           // Reassociate expressions
+    fpm_->add(llvm::createLoopRotatePass());            // Rotate Loop
+    fpm_->add(llvm::createLICMPass());                  // Hoist loop invariants
+    fpm_->add(llvm::createLoopUnswitchPass(/* optimize for size */false));
+    fpm_->add(llvm::createInstructionCombiningPass());
+    fpm_->add(llvm::createIndVarSimplifyPass());        // Canonicalize indvars
+    fpm_->add(llvm::createLoopIdiomPass());             // Recognize idioms like memset.
+    fpm_->add(llvm::createLoopDeletionPass());          // Delete dead loops
+
+    if (config_.loopVectorize)
         fpm_->add(llvm::createLoopVectorizePass());
 
-        fpm_->add(llvm::createLoopUnrollPass());          // Unroll small loops
-        fpm_->add(llvm::createGVNPass());                 // Remove redundancies
-        fpm_->add(llvm::createMemCpyOptPass());             // Remove memcpy / form memset
-        fpm_->add(llvm::createSCCPPass());                  // Constant prop with SCCP
+    if (config_.unrollThreshold != 0)
+        fpm_->add(llvm::createLoopUnrollPass(config_.unrollThreshold)); // Unroll small loops
+    fpm_->add(llvm::createGVNPass());                 // Remove redundancies
+    fpm_->add(llvm::createMemCpyOptPass());             // Remove memcpy / form memset
+    fpm_->add(llvm::createSCCPPass());                  // Constant prop with SCCP
 
-        // Run instcombine after redundancy elimination to exploit opportunities
-        // opened up by them.
-        fpm_->add(llvm::createInstructionCombiningPass());
-        fpm_->add(llvm::createJumpThreadingPass());         // Thread jumps
-        fpm_->add(llvm::createCorrelatedValuePropagationPass());
-        fpm_->add(llvm::createDeadStoreEliminationPass());  // Delete dead stores
+    // Run instcombine after redundancy elimination to exploit opportunities
+    // opened up by them.
+    fpm_->add(llvm::createInstructionCombiningPass());
+    fpm_->add(llvm::createJumpThreadingPass());         // Thread jumps
+    fpm_->add(llvm::createCorrelatedValuePropagationPass());
+    fpm_->add(llvm::createDeadStoreEliminationPass());  // Delete dead stores
 
-        // following passes seems to not optimize much
-#if 0
+    // SLP vectorizer seems to not optimize much for the generated code,
+    // it is disabled by default
+    if (config_.slpVectorize)
+    {
         fpm_->add(llvm::createSLPVectorizerPass());     // Vectorize parallel scalar chains.
-
-        fpm_->add(llvm::createBBVectorizePass());
         fpm_->add(llvm::createInstructionCombiningPass());
         fpm_->add(llvm::createGVNPass());                   // Remove redundancies
-
-        // BBVectorize may have significantly shortened a loop body; unroll again.
-        fpm_->add(llvm::createLoopUnrollPass());
-
         fpm_->add(llvm::createAggressiveDCEPass());         // Delete dead instructions
         fpm_->add(llvm::createCFGSimplificationPass());     // Merge & remove BBs
-        fpm_->add(llvm::createInstructionCombiningPass());  // Clean up after everything.
-#endif
-#endif
     }
-    builder.populateModulePassManager(*mpm_);
 }
 
 bool Optimizer::optimizeModule()
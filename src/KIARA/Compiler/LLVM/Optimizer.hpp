@@ -8,6 +8,7 @@
 #ifndef KIARA_COMPILER_LLVM_OPTIMIZER_HPP_INCLUDED
 #define KIARA_COMPILER_LLVM_OPTIMIZER_HPP_INCLUDED
 
+#include <KIARA/DB/JITConfiguration.hpp>
 
 namespace llvm
 {
@@ -28,8 +29,11 @@ class Optimizer
 public:
 
     Optimizer(llvm::Module *module = 0);
+    Optimizer(const JITConfiguration &config, llvm::Module *module = 0);
     ~Optimizer();
 
+    const JITConfiguration & getConfiguration() const { return config_; }
+
     void reset();
 
     llvm::Module * getModule() const { return module_; }
@@ -45,6 +49,9 @@ private:
     llvm::FunctionPassManager *fpm_;
     llvm::PassManager *mpm_;
     llvm::Module *module_;
+    JITConfiguration config_;
+
+    void addFunctionPasses();
 };
 
 } // namespace Compiler
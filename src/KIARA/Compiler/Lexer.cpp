@@ -27,6 +27,7 @@
 #include <boost/lexical_cast.hpp>
 #include <cerrno>
 #include <cstdlib>
+#include <cstdio>
 
 #if defined(_MSC_VER)
 #define strtoll(nptr,  endptr, base) _strtoi64(nptr, endptr, base)
@@ -38,6 +39,10 @@ namespace Compiler {
 
 Lexer::Lexer(const std::string &prefix, const std::string &suffix)
     : in_(&std::cin)
+    , line_()
+    , cur_(0)
+    , end_(0)
+    , ioError_(false)
     , prefix_(prefix)
     , suffix_(suffix)
     , cxxComment_(true)
@@ -47,6 +52,23 @@ Lexer::Lexer(const std::string &prefix, const std::string &suffix)
 
 Lexer::Lexer(std::istream &in, const std::string &prefix, const std::string &suffix)
     : in_(&in)
+    , line_()
+    , cur_(0)
+    , end_(0)
+    , ioError_(false)
+    , prefix_(prefix)
+    , suffix_(suffix)
+    , cxxComment_(true)
+    , loc_(1, 1)
+{
+}
+
+Lexer::Lexer(const char *begin, const char *end, const std::string &prefix, const std::string &suffix)
+    : in_(0)
+    , line_()
+    , cur_(begin)
+    , end_(end)
+    , ioError_(false)
     , prefix_(prefix)
     , suffix_(suffix)
     , cxxComment_(true)
@@ -66,10 +88,55 @@ void Lexer::reset()
 void Lexer::reset(std::istream &in)
 {
     in_ = &in;
+    line_.clear();
+    cur_ = end_ = 0;
+    ioError_ = false;
+    loc_.line = 1;
+    loc_.col = 1;
+}
+
+void Lexer::reset(const char *begin, const char *end)
+{
+    in_ = 0;
+    line_.clear();
+    cur_ = begin;
+    end_ = end;
+    ioError_ = false;
     loc_.line = 1;
     loc_.col = 1;
 }
 
+bool Lexer::fill()
+{
+    if (!in_ || !in_->good())
+        return false;
+    std::getline(*in_, line_);
+    if (in_->bad())
+    {
+        ioError_ = true;
+        return false;
+    }
+    if (!in_->eof())
+        line_ += '\n';
+    else if (line_.empty())
+        return false;
+    // characters of the previous line are never ungot, so line_ can be reused
+    cur_ = line_.data();
+    end_ = cur_ + line_.size();
+    return true;
+}
+
+namespace
+{
+
+inline bool isNameChar(int c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+        (c >= '0' && c <= '9') || c == '_';
+}
+
+} // unnamed namespace
+
 // Based on JavaScript code by Douglas Crockford
 // http://javascript.crockford.com/tdop/tokens.js
 
@@ -77,20 +144,19 @@ void Lexer::reset(std::istream &in)
 TokenType Lexer::next(Token &token)
 {
     std::string str; // The string value.
-
-    // Begin tokenization. If the source string is empty, return nothing.
-    if (!in_ || !*in_)
-    {
-        token.set(TOK_EOF, loc_);
-        return token.type;
-    }
-
-#define IO_GETCHAR() (in_->get())
-#define IO_EOF() (in_->eof())
-#define IO_ERROR() (!in_->good())
-    // IO_UNGETCHAR does not work with newlines
+    bool eof = false;
+
+    // Input is scanned from the [cur_, end_) range, fill() buffers the next
+    // line of the stream. No token spans over a line end, so ungetting
+    // a character never crosses the range start.
+#define IO_GETCHAR()                                            \
+        ((cur_ != end_ || fill()) ?                             \
+            (eof = false, static_cast<unsigned char>(*cur_++)) : \
+            (eof = true, EOF))
+#define IO_EOF() (eof)
+#define IO_ERROR() (ioError_)
 #define IO_UNGETCHAR()                      \
-        { in_->clear(); in_->unget(); }
+        { if (!eof) --cur_; }
 
 #define RETURN_EOF()                        \
         {                                   \
@@ -136,28 +202,12 @@ TokenType Lexer::next(Token &token)
         if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_')
         {
             startLoc = loc_;
-            ++loc_.col;
-            str.assign(1, c);
-            for (;;)
-            {
-                c = IO_GETCHAR();
-                if (IO_EOF())
-                    break;
-                if (IO_ERROR())
-                    RETURN_ERROR("Could not read name");
-
-                if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
-                        (c >= '0' && c <= '9') || c == '_')
-                {
-                    str += c;
-                    ++loc_.col;
-                }
-                else
-                {
-                    IO_UNGETCHAR();
-                    break;
-                }
-            }
+            // names never span over the end of the buffered range
+            const char *start = cur_ - 1;
+            while (cur_ != end_ && isNameChar(static_cast<unsigned char>(*cur_)))
+                ++cur_;
+            loc_.col += static_cast<int>(cur_ - start);
+            str.assign(start, cur_);
             token.set(TOK_NAME, str, startLoc);
             return token.type;
         }
@@ -41,10 +41,14 @@ public:
 
     Lexer(const std::string &prefix = "<>+-&", const std::string &suffix = "=>&:");
     Lexer(std::istream &in, const std::string &prefix = "<>+-&", const std::string &suffix = "=>&:");
+    /// Scans the memory range [begin, end) which must stay valid while in use
+    Lexer(const char *begin, const char *end, const std::string &prefix = "<>+-&", const std::string &suffix = "=>&:");
     ~Lexer();
 
     void reset();
+    /// Stream input is buffered line by line, so interactive input works
     void reset(std::istream &in);
+    void reset(const char *begin, const char *end);
 
     // returns type of the next parsed token
     TokenType next(Token &token);
@@ -63,11 +67,18 @@ public:
     }
 
 private:
-    std::istream *in_;
+    std::istream *in_;  // 0 when scanning memory range
+    std::string line_;  // current line of in_
+    const char *cur_;
+    const char *end_;
+    bool ioError_;
     std::string prefix_;
     std::string suffix_;
     bool cxxComment_;
     SourceLocation loc_;
+
+    /// Reads next line from in_, returns false on end of file or error
+    bool fill();
 };
 
 } // namespace Compiler
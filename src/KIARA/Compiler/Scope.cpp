@@ -77,11 +77,13 @@ void OverloadedObjectMap::addObject(const std::string &name, const Object::Ptr &
     if (objectMap_.find(name) != objectMap_.end())
         DFC_THROW_EXCEPTION(Exception, "Object '"<<name<<"' already defined.");
 
+    MutationLock lock(*this);
     objectMap_[name] = object;
 }
 
 bool OverloadedObjectMap::removeObject(const std::string &name)
 {
+    MutationLock lock(*this);
     ObjectMap::iterator it = objectMap_.find(name);
     if (it != objectMap_.end())
     {
@@ -173,6 +175,7 @@ Scope::Scope(World& world, const std::string &name)
     , parent_()
     , objectMap_()
     , subscopes_()
+    , symbolIndex_()
 {
 }
 
@@ -182,6 +185,7 @@ Scope::Scope(World& world, const std::string &name, const Scope::Ptr &parent)
     , parent_(parent)
     , objectMap_()
     , subscopes_()
+    , symbolIndex_()
 {
 }
 
@@ -208,6 +212,7 @@ std::string Scope::getFullName() const
 
 void Scope::setParent(const Scope::Ptr &parent)
 {
+    MutationLock lock(*this);
     parent_ = parent;
 }
 
@@ -226,92 +231,118 @@ void Scope::addObject(const std::string &name, const Object::Ptr &object)
     BOOST_ASSERT(object != 0);
     BOOST_ASSERT(&object->getWorld() == &getWorld());
 
-    if (objectMap_.find(name) != objectMap_.end())
+    const Symbol symbol = internSymbol(name);
+
+    // the collector must not trace objectMap_ while it is modified
+    MutationLock lock(*this);
+
+    if (symbolIndex_.contains(symbol))
         DFC_THROW_EXCEPTION(Exception, "Object '"<<name<<"' already defined.");
 
-    objectMap_[name] = object;
+    objectMap_.insert(std::make_pair(name, object));
+    symbolIndex_.insert(symbol, object);
 }
 
 void Scope::removeObject(const std::string &name)
 {
-    ObjectMap::iterator it = objectMap_.find(name);
-    if (it != objectMap_.end())
-        objectMap_.erase(it);
+    const Symbol symbol = findSymbol(name);
+    if (!symbol)
+        return;
+
+    MutationLock lock(*this);
+    if (symbolIndex_.erase(symbol))
+        objectMap_.erase(name);
+}
+
+Object::Ptr Scope::findLocalObject(Symbol symbol) const
+{
+    return symbolIndex_.find(symbol);
 }
 
 const Object::Ptr Scope::lookupObject(const std::string &name, bool recursive) const
 {
-    if (recursive)
-    {
-        OverloadedObjectMap::Ptr ovm(new OverloadedObjectMap(getWorld(), name));
-        lookupOverloadedObjects(name, ovm->objectMap_);
-        if (!ovm->empty())
-        {
-            return ovm;
-        }
-    }
+    // names that were never interned are not bound in any scope
+    const Symbol symbol = findSymbol(name);
+    return symbol ? lookupObject(symbol, recursive) : Object::Ptr();
+}
 
-    ObjectMap::const_iterator it = objectMap_.find(name);
+const Object::Ptr Scope::lookupObject(Symbol symbol, bool recursive) const
+{
+    if (!recursive)
+        return findLocalObject(symbol);
 
-    if (it != objectMap_.end())
-        return it->second;
-    else
-        return (recursive && parent_) ? parent_->lookupObject(name, recursive) : Object::Ptr();
+    ObjectMap overloadedObjects;
+    lookupOverloadedObjects(symbol, overloadedObjects);
+    if (!overloadedObjects.empty())
+        return new OverloadedObjectMap(getWorld(), *symbol, overloadedObjects);
+
+    for (const Scope *scope = this; scope != 0; scope = scope->parent_.get())
+    {
+        if (Object::Ptr object = scope->findLocalObject(symbol))
+            return object;
+    }
+    return Object::Ptr();
 }
 
 void Scope::lookupObjectsRecursive(const std::string &name, ObjectList &objects) const
+{
+    if (const Symbol symbol = findSymbol(name))
+        lookupObjectsRecursive(symbol, objects);
+}
+
+void Scope::lookupObjectsRecursive(Symbol symbol, ObjectList &objects) const
 {
     if (parent_)
-        parent_->lookupObjectsRecursive(name, objects);
+        parent_->lookupObjectsRecursive(symbol, objects);
 
-    ObjectMap::const_iterator it = objectMap_.find(name);
-    if (it != objectMap_.end())
+    if (OverloadedObjectMap::Ptr overloadedObjects = dyn_cast<OverloadedObjectMap>(findLocalObject(symbol)))
     {
-        if (OverloadedObjectMap::Ptr overloadedObjects = dyn_cast<OverloadedObjectMap>(it->second))
-        {
-            for (OverloadedObjectMap::const_iterator j = overloadedObjects->begin(), end = overloadedObjects->end();
-                j != end; ++j)
-                objects.push_back(j->second);
-        }
+        for (OverloadedObjectMap::const_iterator j = overloadedObjects->begin(), end = overloadedObjects->end();
+            j != end; ++j)
+            objects.push_back(j->second);
     }
 }
 
-void Scope::lookupOverloadedObjects(const std::string &name, ObjectMap &objects) const
+void Scope::lookupOverloadedObjects(Symbol symbol, ObjectMap &objects) const
 {
     if (parent_)
-        parent_->lookupOverloadedObjects(name, objects);
+        parent_->lookupOverloadedObjects(symbol, objects);
 
-    ObjectMap::const_iterator it = objectMap_.find(name);
-    if (it != objectMap_.end())
+    if (OverloadedObjectMap::Ptr overloadedObjects = dyn_cast<OverloadedObjectMap>(findLocalObject(symbol)))
     {
-        if (OverloadedObjectMap::Ptr overloadedObjects = dyn_cast<OverloadedObjectMap>(it->second))
-        {
-            for (OverloadedObjectMap::const_iterator it = overloadedObjects->begin(), end = overloadedObjects->end();
-                it != end; ++it)
-                objects[it->first] = it->second;
-        }
+        for (OverloadedObjectMap::const_iterator it = overloadedObjects->begin(), end = overloadedObjects->end();
+            it != end; ++it)
+            objects[it->first] = it->second;
     }
 }
 
 std::pair<Object::Ptr, const Scope *> Scope::lookupObjectAndScope(const std::string &name) const
 {
-    ObjectMap::const_iterator it = objectMap_.find(name);
+    if (const Symbol symbol = findSymbol(name))
+        return lookupObjectAndScope(symbol);
+    return std::make_pair(Object::Ptr(), static_cast<const Scope *>(0));
+}
 
-    if (it != objectMap_.end())
-        return std::make_pair(it->second, this);
-    else if (parent_)
-        return parent_->lookupObjectAndScope(name);
-    else
-        return std::make_pair(Object::Ptr(), static_cast<const Scope *>(0));
+std::pair<Object::Ptr, const Scope *> Scope::lookupObjectAndScope(Symbol symbol) const
+{
+    for (const Scope *scope = this; scope != 0; scope = scope->parent_.get())
+    {
+        if (Object::Ptr object = scope->findLocalObject(symbol))
+            return std::make_pair(object, scope);
+    }
+    return std::make_pair(Object::Ptr(), static_cast<const Scope *>(0));
 }
 
 const std::string Scope::getObjectName(const Object::Ptr &object, bool recursive) const
 {
-    for (ObjectMap::const_iterator it = objectMap_.begin(), end = objectMap_.end();
-            it != end; ++it)
     {
-        if (it->second == object)
-            return it->first;
+        MutationLock lock(*this);
+        for (ObjectMap::const_iterator it = objectMap_.begin(), end = objectMap_.end();
+                it != end; ++it)
+        {
+            if (it->second == object)
+                return it->first;
+        }
     }
     if (recursive && parent_)
         return parent_->getObjectName(object, recursive);
@@ -369,6 +400,7 @@ void Scope::gcUnlinkRefs()
     gcUnlinkChild(parent_);
     gcUnlinkChildren(GCObject::map_values_tag(), objectMap_.begin(), objectMap_.end());
     gcUnlinkChildren(subscopes_.begin(), subscopes_.end());
+    symbolIndex_.clear();
 }
 
 void Scope::gcApplyToChildren(const CollectorCallback &callback)
@@ -377,6 +409,10 @@ void Scope::gcApplyToChildren(const CollectorCallback &callback)
     gcApply(parent_, callback);
     gcApply(GCObject::map_values_tag(), objectMap_.begin(), objectMap_.end(), callback);
     gcApply(subscopes_.begin(), subscopes_.end(), callback);
+    // index holds its own references
+    for (PublishedMap<Symbol, Object::Ptr, SymbolHash>::const_iterator it = symbolIndex_.begin(),
+            end = symbolIndex_.end(); it != end; ++it)
+        gcApply(it->value, callback);
 }
 
 DFC_STATIC_INIT_FUNC {
@@ -27,8 +27,10 @@
 #define KIARA_COMPILER_SCOPE_HPP_INCLUDED
 
 #include "Config.hpp"
+#include "Symbol.hpp"
 #include <KIARA/Common/Config.hpp>
 #include <KIARA/DB/Object.hpp>
+#include <KIARA/Utils/PublishedMap.hpp>
 #include <map>
 #include <string>
 
@@ -112,13 +114,20 @@ public:
 
     Ptr getTopScope() const;
 
+    // Objects can be added and looked up concurrently from multiple threads,
+    // lookups do not lock. Iteration is not synchronized with addObject/removeObject.
+    // Removed objects are released by removeObject.
+
     void addObject(const std::string &name, const Object::Ptr &object);
     void removeObject(const std::string &name);
     const Object::Ptr lookupObject(const std::string &name, bool recursive = true) const;
+    const Object::Ptr lookupObject(Symbol symbol, bool recursive = true) const;
 
     void lookupObjectsRecursive(const std::string &name, ObjectList &objects) const;
+    void lookupObjectsRecursive(Symbol symbol, ObjectList &objects) const;
 
     std::pair<Object::Ptr, const Scope *> lookupObjectAndScope(const std::string &name) const;
+    std::pair<Object::Ptr, const Scope *> lookupObjectAndScope(Symbol symbol) const;
 
     const std::string getObjectName(const Object::Ptr &object, bool recursive = true) const;
 
@@ -143,8 +152,10 @@ private:
     Scope::Ptr parent_;
     ObjectMap objectMap_;
     std::vector<Scope::Ptr> subscopes_;
+    PublishedMap<Symbol, Object::Ptr, SymbolHash> symbolIndex_; // lock-free index of objectMap_
 
-    void lookupOverloadedObjects(const std::string &name, ObjectMap &objects) const;
+    Object::Ptr findLocalObject(Symbol symbol) const;
+    void lookupOverloadedObjects(Symbol symbol, ObjectMap &objects) const;
 };
 
 } // namespace Compiler
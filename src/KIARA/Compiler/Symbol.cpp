@@ -0,0 +1,86 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * Symbol.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#define KIARA_COMPILER_LIB
+#include "Symbol.hpp"
+#include <DFC/Base/Utils/StaticInit.hpp>
+#include <boost/unordered_set.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/locks.hpp>
+
+namespace KIARA
+{
+
+namespace Compiler
+{
+
+namespace
+{
+
+struct SymbolPool
+{
+    // elements of node based containers don't move on rehashing
+    boost::unordered_set<std::string> names;
+    boost::shared_mutex mutex;
+};
+
+SymbolPool & getSymbolPool()
+{
+    static SymbolPool pool;
+    return pool;
+}
+
+} // unnamed namespace
+
+Symbol internSymbol(const std::string &name)
+{
+    SymbolPool &pool = getSymbolPool();
+    {
+        boost::shared_lock<boost::shared_mutex> lock(pool.mutex);
+        boost::unordered_set<std::string>::const_iterator it = pool.names.find(name);
+        if (it != pool.names.end())
+            return &(*it);
+    }
+    boost::unique_lock<boost::shared_mutex> lock(pool.mutex);
+    return &(*pool.names.insert(name).first);
+}
+
+Symbol findSymbol(const std::string &name)
+{
+    SymbolPool &pool = getSymbolPool();
+    boost::shared_lock<boost::shared_mutex> lock(pool.mutex);
+    boost::unordered_set<std::string>::const_iterator it = pool.names.find(name);
+    return it != pool.names.end() ? &(*it) : 0;
+}
+
+// construct the pool before any threads are started
+DFC_STATIC_INIT_FUNC
+{
+    getSymbolPool();
+}
+
+} // namespace Compiler
+
+} // namespace KIARA
@@ -0,0 +1,67 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * Symbol.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef KIARA_COMPILER_SYMBOL_HPP_INCLUDED
+#define KIARA_COMPILER_SYMBOL_HPP_INCLUDED
+
+#include "Config.hpp"
+#include <KIARA/Common/Config.hpp>
+#include <string>
+
+namespace KIARA
+{
+
+namespace Compiler
+{
+
+/// Interned name, equal names are represented by the same pointer.
+/// Symbols are never freed.
+typedef const std::string * Symbol;
+
+/// Returns the unique symbol of the name, interns the name when necessary
+KIARA_COMPILER_API Symbol internSymbol(const std::string &name);
+
+/// Returns the unique symbol of the name or 0 when the name was never interned
+KIARA_COMPILER_API Symbol findSymbol(const std::string &name);
+
+/// Hash of symbols, they are compared by pointer
+struct SymbolHash
+{
+    size_t operator()(Symbol symbol) const
+    {
+        // symbols are heap allocated, low bits are mostly zero
+        size_t h = reinterpret_cast<size_t>(symbol) >> 3;
+        h ^= h >> 16;
+        h *= 0x45d9f3bU;
+        h ^= h >> 16;
+        return h;
+    }
+};
+
+} // namespace Compiler
+
+} // namespace KIARA
+
+#endif /* KIARA_COMPILER_SYMBOL_HPP_INCLUDED */
@@ -382,7 +382,7 @@ KIARA_Result sendMessageSync(KIARA_Connection *conn, KIARA_Message *outMsg, KIAR
 
 	//free(msgData);
 
-	if (result == KIARA_SUCCESS)
+	if (result == KIARA_SUCCESS && inMsg)
 	{
 		kr_dbuffer_make_cstr(&buf);
 		result = initMessageFromString(inMsg, buf.data, buf.size);
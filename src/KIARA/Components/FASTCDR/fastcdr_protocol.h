@@ -44,7 +44,8 @@ void setGenericErrorMessage(KIARA_Message *message, int errorCode, const char *e
 void freeMessage(KIARA_Message *msg) KIARA_ALWAYS_INLINE;
 
 /* Perform synchronous call with outMsg and store response to inMsg
- * inMsg and outMsg can be equal
+ * inMsg and outMsg can be equal.
+ * When inMsg is NULL the message is one-way and the response is ignored.
  */
 KIARA_Result sendMessageSync(KIARA_Connection *conn, KIARA_Message *outMsg, KIARA_Message *inMsg) KIARA_ALWAYS_INLINE;
 
@@ -0,0 +1,16 @@
+/*
+ * native_api.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ *
+ *  Functions required by protocol components compiled to native
+ *  shared libraries. Bitcode components get them linked in by the JIT.
+ */
+#include <KIARA/Components/api.h>
+#include <KIARA/Impl/API.h>
+
+int sendData(KIARA_Connection *conn, const void *data, size_t dataSize, kr_dbuffer_t * destBuf)
+{
+    return kiaraSendConnectionData(conn, data, dataSize, destBuf);
+}
@@ -338,23 +338,6 @@ KIARA_Message * createResponseMessage(KIARA_Connection * KIARA_UNUSED conn, KIAR
     return msg;
 }
 
-KIARA_Message * createResponseMessageZmq(KIARA_Message * KIARA_UNUSED requestMsg)
-{
-    KIARA_PING();
-
-    KIARA_Message *msg = createNewMessage(ORTECDR_RESPONSE);
-
-    CDR_buffer_ensure_capacity_nocopy(&msg->codec, 1024);
-
-    writeMessageHeader(msg);
-
-    KIARA_IFDEBUG(dumpMessage(msg));
-
-    KIARA_DEBUGF("LEAVE createResponseMessage\n");
-
-    return msg;
-}
-
 void setGenericErrorMessage(KIARA_Message *msg, int errorCode, const char *errorMessage)
 {
     KIARA_PINGF("msg = %p, errorCode = %i, errorMessage = %s\n", msg, errorCode, errorMessage);
@@ -387,7 +370,7 @@ KIARA_Result sendMessageSync(KIARA_Connection *conn, KIARA_Message *outMsg, KIAR
 
     result = sendData(conn, CDR_buffer_data(&outMsg->codec), CDR_buffer_size(&outMsg->codec), &buf);
 
-    if (result == KIARA_SUCCESS)
+    if (result == KIARA_SUCCESS && inMsg)
         result = initMessageFromBuffer(inMsg, &buf);
 
     kr_dbuffer_destroy(&buf);
@@ -729,7 +729,7 @@ KIARA_Result sendMessageSync(KIARA_Connection *conn, KIARA_Message *outMsg, KIAR
 
     result = sendData(conn, kr_dbuffer_data(&outMsg->buf), kr_dbuffer_size(&outMsg->buf), &buf);
 
-    if (result == KIARA_SUCCESS)
+    if (result == KIARA_SUCCESS && inMsg)
         result = initMessageFromBuffer(inMsg, &buf);
 
     kr_dbuffer_destroy(&buf);
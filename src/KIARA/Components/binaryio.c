@@ -509,89 +509,42 @@ KIARA_Result readTypeAsBinary_user_string(KIARA_BinaryStream *in, KIARA_UserType
     return result;
 }
 
+/* Returns the per-thread cached key of the connection, NULL on failure */
+static const KIARA_SymmetricKey * getStreamKey(KIARA_Connection *conn, const char *keyName)
+{
+    const char *keyText = kiaraGetSecretKeyText(conn, keyName);
+    const char *cipherName = kiaraGetSecretKeyCipherName(conn, keyName);
+    const KIARA_Cipher *cipher;
+
+    if (!keyText)
+        return NULL; /* Could not get key text */
+
+    cipher = kiaraGetCipher(cipherName && *cipherName ? cipherName : KIARA_DEFAULT_AEAD_CIPHER);
+    if (!kiaraIsAEADCipher(cipher))
+        return NULL; /* Unknown cipher or no AEAD cipher */
+
+    return kiaraGetThreadSymmetricKey(cipher, keyText);
+}
+
+/* Stream contents are encrypted in place, nonce and tag are appended */
 KIARA_Result encryptStream(KIARA_Connection *conn, KIARA_BinaryStream *stream, const char *keyName)
 {
-    KIARA_Result result = KIARA_SUCCESS;
-    KIARA_SymmetricKey *key = kiaraNewSymmetricKey(kiaraGetCipher(NULL));
-    if (key)
-    {
-        const char *keyText = kiaraGetSecretKeyText(conn, keyName);
-        if (keyText)
-        {
-            result = kiaraInitSymmetricKeyFromText(key, keyText);
-            if (result == KIARA_SUCCESS)
-            {
-                KIARA_CipherContext *ec = kiaraNewCipherContext();
-                if (ec)
-                {
-                    result = kiaraInitEncryption(ec, key);
-                    if (result == KIARA_SUCCESS)
-                    {
-                        kr_dbuffer_t tmp;
-                        kr_dbuffer_init(&tmp);
-
-                        result = kiaraEncrypt(ec, &tmp, getStreamBuffer(stream));
-                        if (result == KIARA_SUCCESS)
-                            setStreamBuffer(stream, &tmp);
-
-                        kr_dbuffer_destroy(&tmp);
-                    }
-
-                    kiaraFreeCipherContext(ec);
-                }
-                else
-                    result = KIARA_FAILURE; /* Could not create cipher context */
-            }
-        }
-        else
-            result = KIARA_FAILURE; /* Could not get key text */
-        kiaraFreeSymmetricKey(key);
-    }
-    else
-        result = KIARA_FAILURE; /* Could not create key */
-    return result;
+    const KIARA_SymmetricKey *key = getStreamKey(conn, keyName);
+    if (!key)
+        return KIARA_FAILURE;
+    stream->offset = 0;
+    return kiaraSealInPlace(key, getStreamBuffer(stream));
 }
 
 KIARA_Result decryptStream(KIARA_Connection *conn, KIARA_BinaryStream *stream, const char *keyName)
 {
-    KIARA_Result result = KIARA_SUCCESS;
-    KIARA_SymmetricKey *key = kiaraNewSymmetricKey(kiaraGetCipher(NULL));
+    KIARA_Result result = KIARA_FAILURE;
+    const KIARA_SymmetricKey *key = getStreamKey(conn, keyName);
     if (key)
     {
-        const char *keyText = kiaraGetSecretKeyText(conn, keyName);
-        if (keyText)
-        {
-            result = kiaraInitSymmetricKeyFromText(key, keyText);
-            if (result == KIARA_SUCCESS)
-            {
-                KIARA_CipherContext *dc = kiaraNewCipherContext();
-                if (dc)
-                {
-                    result = kiaraInitDecryption(dc, key);
-                    if (result == KIARA_SUCCESS)
-                    {
-                        kr_dbuffer_t tmp;
-                        kr_dbuffer_init(&tmp);
-
-                        result = kiaraDecrypt(dc, &tmp, getStreamBuffer(stream));
-                        if (result == KIARA_SUCCESS)
-                            setStreamBuffer(stream, &tmp);
-
-                        kr_dbuffer_destroy(&tmp);
-                    }
-
-                    kiaraFreeCipherContext(dc);
-                }
-                else
-                    result = KIARA_FAILURE; /* Could not create cipher context */
-            }
-        }
-        else
-            result = KIARA_FAILURE; /* Could not get key text */
-        kiaraFreeSymmetricKey(key);
+        result = kiaraOpenInPlace(key, getStreamBuffer(stream));
+        stream->offset = 0;
     }
-    else
-        result = KIARA_FAILURE; /* Could not create key */
 
     KIARA_DEBUGF("LEAVE decryptStream -> %i\n", (int)result);
 
@@ -260,7 +260,8 @@ KIARA_Result sendMessageSync(KIARA_Connection *conn, KIARA_Message *outMsg, KIAR
 
     result = sendData(conn, outBuf, DUMMY_MESSAGE_SIZE, &buf);
 
-    inMsg->methodName = NULL;
+    if (inMsg)
+        inMsg->methodName = NULL;
 
 #if 0
     if (result == KIARA_SUCCESS)
@@ -27,6 +27,7 @@
 #include <KIARA/Core/CycleCollector.hpp>
 #include <KIARA/Core/Exception.hpp>
 #include <KIARA/Utils/VarGuard.hpp>
+#include <KIARA/Utils/Timer.hpp>
 #include <algorithm>
 #include <iostream>
 
@@ -38,9 +39,19 @@
 namespace KIARA
 {
 
+const size_t CycleCollector::npos;
+
 CycleCollector::CycleCollector(size_t maxNumPossibleCycleRoots)
-    : numPossibleCycleRoots_(0)
+    : mutex_()
+    , objectsMutex_()
+    , objects_()
+    , newRoots_(0)
+    , numPossibleCycleRoots_(0)
     , maxNumPossibleCycleRoots_(maxNumPossibleCycleRoots)
+    , roots_()
+    , deferredRoots_()
+    , numCollectedObjects_(0)
+    , timeBudget_(0.0)
     , collecting_(false)
 {
 }
@@ -49,6 +60,9 @@ CycleCollector::~CycleCollector()
 {
     //dumpMemGraph(); //???DEBUG
 
+    // no collections while everything is unlinked
+    collecting_ = true;
+
     // unlink and free garbage
     GCObject::Ptr ref;
     for (GCList::iterator it = objects_.begin();
@@ -59,6 +73,18 @@ CycleCollector::~CycleCollector()
     }
     ref.reset();
 
+    // drop references of the root buffer, freeing of buffered objects
+    // can buffer further roots
+    takeNewRoots();
+    while (!roots_.empty())
+    {
+        RootBuffer slice;
+        slice.swap(roots_);
+        for (RootBuffer::iterator it = slice.begin(), end = slice.end(); it != end; ++it)
+            releaseRoot(*it);
+        takeNewRoots();
+    }
+
     // check memory leaks
     if (!objects_.empty())
     {
@@ -81,23 +107,12 @@ CycleCollector::~CycleCollector()
 namespace
 {
 
-struct GCInfo
-{
-    unsigned long inEdges;
-    bool reachable;
-
-    GCInfo(unsigned long inEdges = 0)
-        : inEdges(inEdges)
-        , reachable(false)
-    { }
-};
-typedef std::map<GCObject::RawPtr, GCInfo> GCMap;
+// Number of roots collected at once by the incremental collection
+const size_t ROOT_SLICE_SIZE = 64;
 
 struct GCData
 {
-    GCMap gcMap;
-    bool externalRef;
-    unsigned long numReachables;
+    std::vector<GCObject::RawPtr> garbage;
 #if defined(KIARA_GC_DUMP_CYCLEGRAPH)
     std::set<GCObject::RawPtr> dumpedObjects;
 #endif
@@ -109,9 +124,15 @@ class CycleCollector::PrivateImpl
 {
 public:
 
-    static void gcFindRoots(GCObject::RawPtr obj, void *data);
+    static void gcMarkGray(GCObject::RawPtr obj, void *data);
+
+    static void gcMarkGrayChild(GCObject::RawPtr obj, void *data);
+
+    static void gcScan(GCObject::RawPtr obj, void *data);
+
+    static void gcScanBlack(GCObject::RawPtr obj, void *data);
 
-    static void gcFindReachables(GCObject::RawPtr obj, void *data);
+    static void gcCollectWhite(GCObject::RawPtr obj, void *data);
 
     static void memGraphScanChild(GCObject::RawPtr obj, void *data);
 
@@ -143,21 +164,14 @@ void CycleCollector::PrivateImpl::gcDumpChild(GCObject::RawPtr obj, void *rawDat
         return;
     data->dumpedObjects.insert(obj);
 
-    GCMap::iterator it = data->gcMap.find(obj);
+    static const char * const colorNames[] = {"black", "gray", "white"};
 
     std::ostream &out = std::cerr;
 
     out<<" obj_"<<(void*)obj<<" [shape=box, label=\"";
     obj->getCollector().dumpAsDotLabel(out, obj);
-    if (it != data->gcMap.end())
-    {
-        out<<"\\ninEdges = "<<it->second.inEdges;
-        out<<"\\nreachable = "<<(it->second.reachable ? "true" : "false");
-    }
-    else
-    {
-        out<<"\\nNOT IN GCMAP : reachable";
-    }
+    out<<"\\ncount = "<<obj->gcCount_;
+    out<<"\\ncolor = "<<colorNames[obj->gcColor_];
     out<<"\"];\n";
     out<<" obj_"<<(void*)obj<<" -> { ";
     obj->gcApplyToChildren(CollectorCallback(gcDumpChildName, data));
@@ -168,106 +182,214 @@ void CycleCollector::PrivateImpl::gcDumpChild(GCObject::RawPtr obj, void *rawDat
 
 void CycleCollector::collectCycles()
 {
-    if (collecting_ || numPossibleCycleRoots_ == 0)
+    Lock lock(mutex_);
+    // objects modified by the calling thread can be inconsistent
+    if (collecting_ || mutex_.getLockDepth() > 1)
         return;
     VarGuard<bool> g(collecting_, true);
 
-    GCData data;
-    data.numReachables = 0;
+    takeNewRoots();
+    RootBuffer slice;
+    slice.swap(roots_);
+    collectRoots(slice);
+}
 
+bool CycleCollector::collectCyclesIncremental(double timeBudget)
+{
+    Lock lock(mutex_);
+    if (collecting_ || mutex_.getLockDepth() > 1)
+        return roots_.empty();
+    VarGuard<bool> g(collecting_, true);
 
-    // detect roots (objects not reachable from other objects, but for example from stack)
-    for (GCList::iterator it = objects_.begin(),
-            end = objects_.end(); it != end; ++it)
+    takeNewRoots();
+    Timer timer;
+    RootBuffer slice;
+    slice.reserve(ROOT_SLICE_SIZE);
+    while (!roots_.empty())
     {
-        GCObject::RawPtr obj = &(*it);
-        if (obj->possibleCycleRoot_)
-        {
-            data.externalRef = true;
-            PrivateImpl::gcFindRoots(obj, &data);
-        }
+        const size_t n = std::min(ROOT_SLICE_SIZE, roots_.size());
+        slice.assign(roots_.end() - n, roots_.end());
+        roots_.resize(roots_.size() - n);
+        collectRoots(slice);
+        slice.clear();
+        if (timer.elapsed() >= timeBudget)
+            break;
     }
+    return roots_.empty();
+}
+
+void CycleCollector::takeNewRoots()
+{
+    // roots deferred by the previous collection are collected again
+    roots_.insert(roots_.end(), deferredRoots_.begin(), deferredRoots_.end());
+    deferredRoots_.clear();
+
+    GCObject::RawPtr obj = newRoots_.exchange(0, boost::memory_order_acquire);
+    for (; obj != 0; obj = obj->gcNextRoot_)
+        roots_.push_back(obj);
+}
+
+void CycleCollector::collectRoots(RootBuffer &slice)
+{
+    // mark subgraphs reachable from roots gray and
+    // subtract internal references from their counts
+    for (RootBuffer::iterator it = slice.begin(), end = slice.end(); it != end; ++it)
+        PrivateImpl::gcMarkGray(*it, 0);
 
-    // find all from roots reachable objects
-    // roots have externalRefs counter greater than zero
-    for (GCMap::iterator it = data.gcMap.begin(), end = data.gcMap.end(); it != end; ++it)
+    // reference of the root buffer is internal too
+    for (RootBuffer::iterator it = slice.begin(), end = slice.end(); it != end; ++it)
+        --(*it)->gcCount_;
+
+    // objects with external references and everything reachable
+    // from them are alive, remaining gray objects are garbage
+    for (RootBuffer::iterator it = slice.begin(), end = slice.end(); it != end; ++it)
+        PrivateImpl::gcScan(*it, 0);
+
+    std::vector<bool> garbageRoots(slice.size());
+    for (size_t i = 0; i < slice.size(); ++i)
+        garbageRoots[i] = slice[i]->gcColor_ == GCObject::GC_WHITE;
+
+    GCData data;
+    for (RootBuffer::iterator it = slice.begin(), end = slice.end(); it != end; ++it)
+        PrivateImpl::gcCollectWhite(*it, &data);
+
+    // Child references did not change, but other threads could obtain
+    // references to garbage objects while they were traced, e.g. copy a
+    // child of an object they reference and release the object. In this
+    // case the subgraph is kept and its roots are collected again.
+    bool unchanged = true;
+    for (std::vector<GCObject::RawPtr>::iterator it = data.garbage.begin(), end = data.garbage.end(); it != end; ++it)
     {
-        // note special case: when reference count is 0 object is not yet assigned to smart ptr
-        if (!it->second.reachable &&
-                ((it->first->getNumRefs() > it->second.inEdges) || it->first->getNumRefs() == 0))
+        if ((*it)->getNumRefs() != (*it)->gcNumRefsAtMark_)
         {
-            PrivateImpl::gcFindReachables(it->first, &data);
+            unchanged = false;
+            break;
         }
     }
 
-    size_t numGCObjects = data.gcMap.size() - data.numReachables;
-    if (numGCObjects == 0)
-        return;
+    if (unchanged && !data.garbage.empty())
+    {
+        // garbage objects are alive until all of them are unlinked
+        std::vector<GCObject::Ptr> garbage(data.garbage.begin(), data.garbage.end());
+        numCollectedObjects_ += garbage.size();
 
 #if defined(KIARA_GC_DUMP_CYCLEGRAPH)
-    // dump collected information
-    std::cerr<<"digraph {\n concentrate=true;\n";
-    for (GCList::iterator it = objects_.begin(),
-            end = objects_.end(); it != end; ++it)
-    {
-        GCObject::RawPtr obj = &(*it);
-        PrivateImpl::gcDumpChild(obj, &data);
-    }
-    std::cerr<<"}\n";
+        // dump collected information
+        std::cerr<<"digraph {\n concentrate=true;\n";
+        for (std::vector<GCObject::RawPtr>::iterator it = data.garbage.begin(), end = data.garbage.end(); it != end; ++it)
+            PrivateImpl::gcDumpChild(*it, &data);
+        std::cerr<<"}\n";
 #endif
 
-    std::vector<GCObject::Ptr> garbage;
-    garbage.reserve(numGCObjects);
+        // unlink & remove garbage, references released by unlinking
+        // must not buffer garbage objects
+        for (std::vector<GCObject::Ptr>::iterator it = garbage.begin(), end = garbage.end(); it != end; ++it)
+            (*it)->gcBufferState_.store(GCObject::GC_GARBAGE, boost::memory_order_relaxed);
+        for (std::vector<GCObject::Ptr>::iterator it = garbage.begin(), end = garbage.end(); it != end; ++it)
+        {
+            (*it)->gcUnlinkRefs();
+        }
+        garbage.clear();
+    }
 
-    for (GCMap::iterator it = data.gcMap.begin(), end = data.gcMap.end(); it != end; ++it)
+    for (size_t i = 0; i < slice.size(); ++i)
     {
-        if (!it->second.reachable)
-            garbage.push_back(it->first);
+        if (garbageRoots[i] && unchanged)
+            releaseRoot(slice[i]);
+        else if (garbageRoots[i] || !releaseLiveRoot(slice[i]))
+            deferredRoots_.push_back(slice[i]);
     }
+}
 
-    data.gcMap.clear();
+void CycleCollector::releaseRoot(GCObject::RawPtr object)
+{
+    // object is garbage, nobody else can buffer it
+    object->gcBufferState_.store(GCObject::GC_UNBUFFERED, boost::memory_order_release);
+    dropRootReference(object);
+}
 
-    // unlink & remove garbage
-    for (std::vector<GCObject::Ptr>::iterator it = garbage.begin(), end = garbage.end(); it != end; ++it)
+bool CycleCollector::releaseLiveRoot(GCObject::RawPtr object)
+{
+    unsigned char state = GCObject::GC_BUFFERED;
+    if (!object->gcBufferState_.compare_exchange_strong(state, GCObject::GC_UNBUFFERED,
+                                                        boost::memory_order_acq_rel))
     {
-        (*it)->gcUnlinkRefs();
+        // released while it was collected, only the collector leaves this state
+        object->gcBufferState_.store(GCObject::GC_BUFFERED, boost::memory_order_release);
+        return false;
     }
-    garbage.clear();
+    // object is buffered again when it is released by someone else
+    dropRootReference(object);
+    return true;
 }
 
-void CycleCollector::PrivateImpl::gcFindRoots(GCObject::RawPtr obj, void *rawData)
+void CycleCollector::dropRootReference(GCObject::RawPtr object)
 {
-    BOOST_ASSERT(rawData != 0 && obj != 0);
-    GCData *data = static_cast<GCData*>(rawData);
+    numPossibleCycleRoots_.fetch_sub(1, boost::memory_order_relaxed);
+    if (object->gcNumRefs_.fetch_sub(1, boost::memory_order_acq_rel) == 1)
+        object->destroy();
+}
 
-    GCMap::iterator it = data->gcMap.find(obj);
-    if (it != data->gcMap.end())
-    {
-       // if origin of the edge is not root
-       // update count of incoming edges
-        if (!data->externalRef)
-            ++it->second.inEdges;
+void CycleCollector::PrivateImpl::gcMarkGray(GCObject::RawPtr obj, void *rawData)
+{
+    BOOST_ASSERT(obj != 0);
+
+    if (obj->gcColor_ == GCObject::GC_GRAY)
+        return;
+    obj->gcColor_ = GCObject::GC_GRAY;
+    obj->gcNumRefsAtMark_ = obj->getNumRefs();
+    obj->gcCount_ = static_cast<long>(obj->gcNumRefsAtMark_);
+    obj->gcApplyToChildren(CollectorCallback(gcMarkGrayChild, rawData));
+}
+
+void CycleCollector::PrivateImpl::gcMarkGrayChild(GCObject::RawPtr obj, void *rawData)
+{
+    BOOST_ASSERT(obj != 0);
+
+    gcMarkGray(obj, rawData);
+    // reference from a gray object is internal
+    --obj->gcCount_;
+}
+
+void CycleCollector::PrivateImpl::gcScan(GCObject::RawPtr obj, void *rawData)
+{
+    BOOST_ASSERT(obj != 0);
+
+    if (obj->gcColor_ != GCObject::GC_GRAY)
         return;
+
+    // note special case: when reference count is 0 object is not yet assigned to smart ptr
+    if (obj->gcCount_ > 0 || obj->getNumRefs() == 0)
+    {
+        gcScanBlack(obj, rawData);
     }
-    it = data->gcMap.insert(std::make_pair(obj, GCInfo(data->externalRef ? 0 : 1))).first;
+    else
+    {
+        obj->gcColor_ = GCObject::GC_WHITE;
+        obj->gcApplyToChildren(CollectorCallback(gcScan, rawData));
+    }
+}
+
+void CycleCollector::PrivateImpl::gcScanBlack(GCObject::RawPtr obj, void *rawData)
+{
+    BOOST_ASSERT(obj != 0);
 
-    data->externalRef = false;
-    obj->gcApplyToChildren(CollectorCallback(gcFindRoots, data));
+    if (obj->gcColor_ == GCObject::GC_BLACK)
+        return;
+    obj->gcColor_ = GCObject::GC_BLACK;
+    obj->gcApplyToChildren(CollectorCallback(gcScanBlack, rawData));
 }
 
-void CycleCollector::PrivateImpl::gcFindReachables(GCObject::RawPtr obj, void *rawData)
+void CycleCollector::PrivateImpl::gcCollectWhite(GCObject::RawPtr obj, void *rawData)
 {
     BOOST_ASSERT(rawData != 0 && obj != 0);
     GCData *data = static_cast<GCData*>(rawData);
 
-    GCMap::iterator it = data->gcMap.find(obj);
-    BOOST_ASSERT(it != data->gcMap.end());
-
-    if (it->second.reachable)
+    if (obj->gcColor_ != GCObject::GC_WHITE)
         return;
-    it->second.reachable = true;
-    ++data->numReachables;
-    obj->gcApplyToChildren(CollectorCallback(gcFindReachables, data));
+    obj->gcColor_ = GCObject::GC_BLACK;
+    data->garbage.push_back(obj);
+    obj->gcApplyToChildren(CollectorCallback(gcCollectWhite, data));
 }
 
 void CycleCollector::dump()
@@ -304,26 +426,66 @@ void CycleCollector::dumpAsDotLabel(std::ostream &out, GCObject::RawPtr obj)
 void CycleCollector::onNewObject(GCObject::RawPtr object)
 {
     BOOST_ASSERT(object != 0);
+    boost::mutex::scoped_lock lock(objectsMutex_);
     objects_.push_back(*object);
 }
 
 void CycleCollector::onDestroyObject(GCObject::RawPtr object)
 {
     BOOST_ASSERT(object != 0);
+    // buffered objects are referenced by the buffer and never destroyed
+    BOOST_ASSERT(object->gcBufferState_.load(boost::memory_order_relaxed) == GCObject::GC_UNBUFFERED ||
+                 object->gcBufferState_.load(boost::memory_order_relaxed) == GCObject::GC_GARBAGE);
+    boost::mutex::scoped_lock lock(objectsMutex_);
     objects_.erase(objects_.iterator_to(*object));
 }
 
-void CycleCollector::onObjectAddRef(size_t numRefs)
+bool CycleCollector::onPossibleCycleRoot(GCObject::RawPtr object)
 {
-    if (numPossibleCycleRoots_ > 0)
-        --numPossibleCycleRoots_;
+    BOOST_ASSERT(object != 0);
+    unsigned char state = object->gcBufferState_.load(boost::memory_order_acquire);
+    for (;;)
+    {
+        // A buffered object can be collected right now, the collection must
+        // not drop it when it was released again meanwhile.
+        if (state == GCObject::GC_BUFFERED_RELEASED || state == GCObject::GC_GARBAGE)
+            return false;
+        if (object->gcBufferState_.compare_exchange_weak(
+                state, state == GCObject::GC_UNBUFFERED ? GCObject::GC_BUFFERED : GCObject::GC_BUFFERED_RELEASED,
+                boost::memory_order_acq_rel))
+            break;
+    }
+    if (state != GCObject::GC_UNBUFFERED)
+        return false;
+
+    // The buffer takes over the released reference, so that no collection
+    // can see the object alive only because of the reference being released.
+    GCObject::RawPtr head = newRoots_.load(boost::memory_order_relaxed);
+    do
+    {
+        object->gcNextRoot_ = head;
+    } while (!newRoots_.compare_exchange_weak(head, object,
+                                              boost::memory_order_release,
+                                              boost::memory_order_relaxed));
+
+    const size_t numRoots = numPossibleCycleRoots_.fetch_add(1, boost::memory_order_relaxed) + 1;
+    if (maxNumPossibleCycleRoots_ != npos && numRoots > maxNumPossibleCycleRoots_)
+        collectAutomatically();
+    return true;
 }
 
-void CycleCollector::onObjectRelease(size_t numRefs)
+void CycleCollector::collectAutomatically()
 {
-    if (numRefs != 0)
-        ++numPossibleCycleRoots_;
-    if (maxNumPossibleCycleRoots_ != size_t(-1) && numPossibleCycleRoots_ > maxNumPossibleCycleRoots_)
+    // Never wait for a collection in another thread, the releasing
+    // thread can hold locks that the collection needs. A thread releasing
+    // while it modifies objects leaves the roots to the next collection.
+    Lock lock(mutex_, boost::try_to_lock);
+    if (!lock.owns_lock() || mutex_.getLockDepth() > 1)
+        return;
+
+    if (timeBudget_ > 0.0)
+        collectCyclesIncremental(timeBudget_);
+    else
         collectCycles();
 }
 
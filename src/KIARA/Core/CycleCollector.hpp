@@ -30,24 +30,95 @@
 #include <KIARA/Core/GCObject.hpp>
 #include <boost/assert.hpp>
 #include <boost/scoped_array.hpp>
+#include <boost/atomic.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/recursive_mutex.hpp>
+#include <boost/thread/locks.hpp>
 #include <vector>
 #include <iostream>
 
-// This is not MT-safe
-
 namespace KIARA
 {
 
+/** Synchronous cycle collector (Bacon, Rajan: Concurrent Cycle Collection
+ *  in Reference Counted Systems). Objects whose reference count is decremented
+ *  to a non-zero value are buffered as possible cycle roots, collection traces
+ *  only subgraphs reachable from buffered roots.
+ *
+ *  Objects can be shared between threads: reference counts are atomic and
+ *  possible roots are pushed to a lock-free buffer, which takes over the
+ *  released reference, so garbage is freed by the next collection only.
+ *
+ *  Collections hold the collector mutex, which is also taken by every
+ *  modification of child references (see GCObject::MutationLock), so the
+ *  object graph does not change while it is traced. Only references held
+ *  outside of collected objects change concurrently. A subgraph whose
+ *  reference counts changed while it was traced is not collected, its roots
+ *  are kept for the next collection.
+ */
 class KIARA_API CycleCollector
 {
     friend class GCObject;
 public:
 
+    static const size_t npos = static_cast<size_t>(-1);
+
+    /// Recursive mutex which knows how often its owner locked it
+    class Mutex
+    {
+    public:
+        Mutex() : mutex_(), depth_(0) { }
+
+        void lock() { mutex_.lock(); ++depth_; }
+
+        bool try_lock()
+        {
+            if (!mutex_.try_lock())
+                return false;
+            ++depth_;
+            return true;
+        }
+
+        void unlock() { --depth_; mutex_.unlock(); }
+
+        /// Only valid in the thread owning the mutex
+        unsigned int getLockDepth() const { return depth_; }
+
+    private:
+        boost::recursive_mutex mutex_;
+        unsigned int depth_;
+    };
+
+    typedef boost::unique_lock<Mutex> Lock;
+
+    /// Mutex held by collections and modifications of child references
+    Mutex & getMutex() const { return mutex_; }
+
     CycleCollector(size_t maxNumPossibleCycleRoots = 10000);
     ~CycleCollector();
 
+    /// Collects garbage cycles reachable from all buffered roots
     void collectCycles();
 
+    /** Processes buffered roots in small slices until timeBudget seconds elapsed.
+     *  Each slice is collected completely, so the collection can be interrupted
+     *  between slices and resumed by the next call.
+     *  Returns true when no buffered roots are left.
+     */
+    bool collectCyclesIncremental(double timeBudget);
+
+    /** Time budget in seconds of automatic collections started when number
+     *  of possible cycle roots exceeds the maximum, 0 (default) performs full collection.
+     */
+    void setTimeBudget(double timeBudget) { timeBudget_ = timeBudget; }
+
+    double getTimeBudget() const { return timeBudget_; }
+
+    size_t getNumPossibleCycleRoots() const { return numPossibleCycleRoots_.load(boost::memory_order_relaxed); }
+
+    /// Total number of objects collected as members of garbage cycles
+    size_t getNumCollectedObjects() const { return numCollectedObjects_; }
+
     void dump();
 
     void dump(GCObject::RawPtr obj);
@@ -64,16 +135,46 @@ protected:
     void onNewObject(GCObject::RawPtr object);
     void onDestroyObject(GCObject::RawPtr object);
 private:
+    typedef std::vector<GCObject::RawPtr> RootBuffer;
+
+    mutable Mutex mutex_;           // serializes collections and modifications
+    boost::mutex objectsMutex_;     // guards objects_
     GCList objects_;
-    size_t numPossibleCycleRoots_;
+    boost::atomic<GCObject::RawPtr> newRoots_;     // lock-free stack linked by GCObject::gcNextRoot_
+    boost::atomic<size_t> numPossibleCycleRoots_;  // buffered roots not collected yet
     size_t maxNumPossibleCycleRoots_;
+
+    // following members are guarded by mutex_
+    RootBuffer roots_;              // roots taken from newRoots_
+    RootBuffer deferredRoots_;      // roots of subgraphs changed during collection
+    size_t numCollectedObjects_;
+    double timeBudget_;
     bool collecting_;
 
     class PrivateImpl;
     friend class PrivateImpl;
 
-    void onObjectAddRef(size_t numRefs);
-    void onObjectRelease(size_t numRefs);
+    /// Buffers the object released by the caller, returns true when
+    /// the buffer took over the released reference
+    bool onPossibleCycleRoot(GCObject::RawPtr object);
+
+    /// Starts a collection unless another thread is collecting or
+    /// the releasing thread modifies objects
+    void collectAutomatically();
+
+    /// Moves all buffered roots to roots_
+    void takeNewRoots();
+
+    void collectRoots(RootBuffer &slice);
+
+    /// Drops reference of the root buffer to the collected object
+    void releaseRoot(GCObject::RawPtr object);
+
+    /// Drops reference of the root buffer to the live object unless it
+    /// was released again while it was collected, returns false then
+    bool releaseLiveRoot(GCObject::RawPtr object);
+
+    void dropRootReference(GCObject::RawPtr object);
 };
 
 } // namespace KIARA
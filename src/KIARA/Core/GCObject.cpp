@@ -37,7 +37,12 @@ DFC_DEFINE_ABSTRACT_TYPE(KIARA::GCObject)
 
 GCObject::GCObject(CycleCollector &collector)
     : collector_(collector)
-    , possibleCycleRoot_(false)
+    , gcNumRefs_(0)
+    , gcBufferState_(GC_UNBUFFERED)
+    , gcNextRoot_(0)
+    , gcColor_(GC_BLACK)
+    , gcCount_(0)
+    , gcNumRefsAtMark_(0)
 {
     collector_.onNewObject(this);
 }
@@ -46,6 +51,17 @@ GCObject::~GCObject()
 {
 }
 
+GCObject::MutationLock::MutationLock(const GCObject &object)
+    : collector_(object.getCollector())
+{
+    collector_.getMutex().lock();
+}
+
+GCObject::MutationLock::~MutationLock()
+{
+    collector_.getMutex().unlock();
+}
+
 void GCObject::destroy()
 {
     collector_.onDestroyObject(this);
@@ -54,19 +70,20 @@ void GCObject::destroy()
 
 size_t GCObject::addRef()
 {
-    possibleCycleRoot_ = false;
-    size_t result = InheritedType::addRef();
-    collector_.onObjectAddRef(result);
-    return result;
+    return gcNumRefs_.fetch_add(1, boost::memory_order_relaxed) + 1;
 }
 
 size_t GCObject::release()
 {
-    possibleCycleRoot_ = true;
-    CycleCollector &collector = collector_;
-    size_t result = InheritedType::release();
-    collector.onObjectRelease(result);
-    return result;
+    // Object that survives the release is a possible root of a garbage cycle,
+    // when it is buffered the buffer owns the released reference.
+    const size_t refs = gcNumRefs_.load(boost::memory_order_relaxed);
+    if (refs > 1 && collector_.onPossibleCycleRoot(this))
+        return refs - 1;
+    const size_t numRefs = gcNumRefs_.fetch_sub(1, boost::memory_order_acq_rel) - 1;
+    if (numRefs == 0)
+        destroy();
+    return numRefs;
 }
 
 } // namespace KIARA
@@ -29,6 +29,7 @@
 #include <KIARA/Common/Config.hpp>
 #include <DFC/Base/Core/Object.hpp>
 #include <KIARA/Utils/IntrusiveList.hpp>
+#include <boost/atomic.hpp>
 #include <algorithm>
 
 namespace KIARA
@@ -73,12 +74,33 @@ public:
 
     CycleCollector & getCollector() const { return collector_; }
 
+    /// Reference counting is lock-free, objects can be shared between threads
     virtual size_t addRef();
 
     virtual size_t release();
 
+    size_t getNumRefs() const { return gcNumRefs_.load(boost::memory_order_acquire); }
+
+    size_t getRefCount() const { return getNumRefs(); }
+
 protected:
 
+    /** Locks the collector while child references of an object are modified.
+     *  Collections hold the same lock, so they never trace an object whose
+     *  children change. The lock is recursive.
+     */
+    class KIARA_API MutationLock
+    {
+    public:
+        explicit MutationLock(const GCObject &object);
+        ~MutationLock();
+    private:
+        CycleCollector &collector_;
+
+        MutationLock(const MutationLock &);
+        MutationLock & operator=(const MutationLock &);
+    };
+
     virtual void destroy();
 
     /** Unlink all children references in this object.
@@ -151,8 +173,31 @@ protected:
     }
 
 private:
+    // Colors used by the synchronous cycle collection algorithm of Bacon and Rajan
+    enum GCColor
+    {
+        GC_BLACK,   // in use or free
+        GC_GRAY,    // possible member of cycle
+        GC_WHITE    // member of garbage cycle
+    };
+
+    enum GCBufferState
+    {
+        GC_UNBUFFERED,
+        GC_BUFFERED,        // in the root buffer, which holds a reference
+        GC_BUFFERED_RELEASED, // released again while buffered
+        GC_GARBAGE          // unlinked by the collector, never buffered
+    };
+
     CycleCollector &collector_;
-    bool possibleCycleRoot_;
+    boost::atomic<size_t> gcNumRefs_;
+    boost::atomic<unsigned char> gcBufferState_;
+    GCObject *gcNextRoot_;           // next object in the root buffer
+
+    // following members are used by the collection only
+    unsigned char gcColor_;
+    long gcCount_;          // reference count minus internal references, valid while gray
+    size_t gcNumRefsAtMark_; // reference count when marked gray
 };
 
 
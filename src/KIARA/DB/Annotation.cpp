@@ -50,6 +50,7 @@ Annotation::Annotation(const Annotation &other)
 
 void Annotation::setAnnotationType(const StructType::Ptr & annotationType)
 {
+    MutationLock lock(*this);
     annotationType_ = annotationType;
 }
 
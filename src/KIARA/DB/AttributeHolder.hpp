@@ -89,6 +89,14 @@ public:
         return attributeDict_[key];
     }
 
+    /// Returns Tag::getAttrName() as a string, constructed only once per tag
+    template <typename Tag>
+    static const std::string & getAttrKey()
+    {
+        static const std::string key(Tag::getAttrName());
+        return key;
+    }
+
     template <typename Tag>
     bool hasAttributeValue(const std::string &name) const
     {
@@ -101,7 +109,7 @@ public:
     template <typename Tag>
     bool hasAttributeValue() const
     {
-        return hasAttributeValue<Tag>(Tag::getAttrName());
+        return hasAttributeValue<Tag>(getAttrKey<Tag>());
     }
 
     template <typename Tag>
@@ -121,7 +129,7 @@ public:
     template <typename Tag>
     typename Tag::type getAttributeValue() const
     {
-        return getAttributeValue<Tag>(Tag::getAttrName());
+        return getAttributeValue<Tag>(getAttrKey<Tag>());
     }
 
     template <typename Tag>
@@ -157,19 +165,19 @@ public:
     template <typename Tag>
     typename Tag::type * getAttributeValuePtr()
     {
-        return getAttributeValuePtr<Tag>(Tag::getAttrName());
+        return getAttributeValuePtr<Tag>(getAttrKey<Tag>());
     }
 
     template <typename Tag>
     typename Tag::type & getOrCreateAttributeValueRef()
     {
-        return getOrCreateAttributeValueRef<Tag>(Tag::getAttrName());
+        return getOrCreateAttributeValueRef<Tag>(getAttrKey<Tag>());
     }
 
     template <typename Tag>
     const typename Tag::type * getAttributeValuePtr() const
     {
-        return getAttributeValuePtr<Tag>(Tag::getAttrName());
+        return getAttributeValuePtr<Tag>(getAttrKey<Tag>());
     }
 
     template <typename Tag>
@@ -181,7 +189,7 @@ public:
     template <typename Tag>
     void setAttributeValue(typename Tag::arg_type value)
     {
-        setAttributeValue<Tag>(Tag::getAttrName(), value);
+        setAttributeValue<Tag>(getAttrKey<Tag>(), value);
     }
 
     std::string getAttributeAsString(const std::string &key) const
@@ -0,0 +1,46 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * ConnectionPoolConfiguration.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#define KIARA_LIB
+#include "ConnectionPoolConfiguration.hpp"
+
+namespace KIARA
+{
+
+ConnectionPoolConfiguration::ConnectionPoolConfiguration()
+{
+    clear();
+}
+
+void ConnectionPoolConfiguration::clear()
+{
+    enabled = true;
+    maxConnections = 64;
+    maxConnectionsPerPeer = 2;
+    idleTimeout = 30000;
+    callTimeout = 60000;
+}
+
+} // namespace KIARA
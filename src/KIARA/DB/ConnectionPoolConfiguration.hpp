@@ -0,0 +1,62 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * ConnectionPoolConfiguration.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef KIARA_DB_CONNECTIONPOOLCONFIGURATION_HPP_INCLUDED
+#define KIARA_DB_CONNECTIONPOOLCONFIGURATION_HPP_INCLUDED
+
+#include <KIARA/Common/Config.hpp>
+
+namespace KIARA
+{
+
+class KIARA_API ConnectionPoolConfiguration
+{
+public:
+    ConnectionPoolConfiguration();
+
+    /// When true, client connections of a context to the same peer
+    /// share pooled transport connections.
+    bool enabled;
+
+    /// Maximal number of open transport connections of a context.
+    unsigned int maxConnections;
+
+    /// Maximal number of open transport connections to a single peer.
+    unsigned int maxConnectionsPerPeer;
+
+    /// Time in milliseconds after which an unused transport connection is closed,
+    /// 0 keeps connections open until the pool is destroyed.
+    unsigned int idleTimeout;
+
+    /// Time in milliseconds after which a call without reply fails, 0 waits forever.
+    unsigned int callTimeout;
+
+    void clear();
+
+};
+
+} // namespace KIARA
+
+#endif /* KIARA_DB_CONNECTIONPOOLCONFIGURATION_HPP_INCLUDED */
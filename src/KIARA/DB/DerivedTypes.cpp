@@ -378,10 +378,12 @@ EnumType::EnumType(World &world, const std::string &name)
 void EnumType::addConstant(const std::string &name, const Expr::Ptr &expr)
 {
     // FIXME: add check that name is not already used
+    MutationLock lock(*this);
     size_t index = getNumElements();
     resizeElements(index+1);
     elements_[index] = expr;
-    nameToIndexBimap_.insert(NameToIndexBimap::value_type(name, index));
+    constantNames_.push_back(name);
+    nameIndex_.insert(name, index);
 }
 
 EnumType::Ptr EnumType::create(World &world, const std::string &name)
@@ -467,12 +469,23 @@ void CompositeType::resizeElements(size_t newSize)
     if (!isUnique())
         DFC_THROW_EXCEPTION(Exception, "Structure is not unique");
     Type::resizeElements(newSize);
+    const bool shrink = newSize < elementDataList_.size();
     elementDataList_.resize(newSize);
+    if (shrink)
+        rebuildNameIndex();
+}
+
+void CompositeType::rebuildNameIndex()
+{
+    nameIndex_.clear();
+    for (size_t i = 0; i < elementDataList_.size(); ++i)
+        nameIndex_.insert(elementDataList_[i].getName(), i);
 }
 
 void CompositeType::setElements(ArrayRef<Type::Ptr> elems)
 {
     BOOST_ASSERT(elems.size() == getNumElements());
+    MutationLock lock(*this);
     std::copy(elems.begin(), elems.end(), elements_.begin());
 }
 
@@ -481,6 +494,7 @@ void CompositeType::setElementAt(size_t index, const Type::Ptr &element)
     BOOST_ASSERT(index < getNumElements());
     if (!isUnique())
         DFC_THROW_EXCEPTION(Exception, "Structure is not unique");
+    MutationLock lock(*this);
     elements_[index] = element;
 }
 
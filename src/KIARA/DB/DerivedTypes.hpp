@@ -30,7 +30,7 @@
 #include <KIARA/kiara.h>
 #include <KIARA/DB/Type.hpp>
 #include <KIARA/DB/Expr.hpp>
-#include <boost/bimap.hpp>
+#include <KIARA/DB/NameIndex.hpp>
 
 namespace KIARA
 {
@@ -252,24 +252,29 @@ public:
 
     const std::string & getConstantNameAt(size_t index) const
     {
-        return nameToIndexBimap_.right.find(index)->second;
+        BOOST_ASSERT(index < constantNames_.size());
+        return constantNames_[index];
     }
 
     size_t getConstantIndexByName(const std::string &name) const
     {
-        NameToIndexBimap::left_const_iterator it = nameToIndexBimap_.left.find(name);
-        if (it != nameToIndexBimap_.left.end())
-            return it->second;
-        else
-            return npos;
+        return nameIndex_.find(name, ConstantNameAt(constantNames_));
     }
 
     virtual size_t hash() const;
     virtual void print(std::ostream &out, std::set<const Type*> &visited) const;
 
 private:
-    typedef boost::bimap<std::string, unsigned int> NameToIndexBimap;
-    NameToIndexBimap nameToIndexBimap_;
+
+    struct ConstantNameAt
+    {
+        const std::vector<std::string> &names;
+        ConstantNameAt(const std::vector<std::string> &names) : names(names) { }
+        const std::string & operator()(size_t index) const { return names[index]; }
+    };
+
+    std::vector<std::string> constantNames_;
+    NameIndex nameIndex_;
 
     EnumType(World &world, const std::string &name);
 };
@@ -296,9 +301,13 @@ public:
     { }
 
     const std::string & getName() const { return name_; }
-    void setName(const std::string &name) { name_ = name; }
 
 private:
+    friend class CompositeType;
+
+    // Names are changed only by CompositeType, which keeps its name index in sync
+    void setName(const std::string &name) { name_ = name; }
+
     std::string name_;
 };
 
@@ -330,12 +339,16 @@ public:
     /// returns npos if no element with specified name found.
     size_t getElementIndexByName(const std::string &name) const
     {
-        for (size_t i = 0; i < getNumElements(); ++i)
+        if (name.empty())
         {
-            if (getElementNameAt(i) == name)
-                return i;
+            for (size_t i = 0; i < elementDataList_.size(); ++i)
+            {
+                if (elementDataList_[i].getName().empty())
+                    return i;
+            }
+            return npos;
         }
-        return npos;
+        return nameIndex_.find(name, ElementNameAt(elementDataList_));
     }
 
     const Type::Ptr getElementAt(size_t index) const
@@ -367,6 +380,7 @@ public:
         {
             elementDataList_[i].setName(names[i]);
         }
+        rebuildNameIndex();
     }
 
     void setElementNames(const std::vector<std::string> &names)
@@ -378,6 +392,7 @@ public:
         {
             elementDataList_[i].setName(names[i]);
         }
+        rebuildNameIndex();
     }
 
     const std::vector<std::string> getElementNames() const
@@ -395,7 +410,10 @@ public:
 
     void setElementNameAt(size_t index, const std::string &name)
     {
-        elementDataList_[index].setName(name);
+        ElementData &data = elementDataList_[index];
+        nameIndex_.remove(data.getName(), index);
+        data.setName(name);
+        nameIndex_.insert(name, index);
     }
 
     virtual void print(std::ostream &out, std::set<const Type*> &visited) const;
@@ -432,6 +450,7 @@ protected:
     void setElementAtUnsafe(size_t index, const Type::Ptr &element)
     {
         BOOST_ASSERT(index < getNumElements());
+        MutationLock lock(*this);
         elements_[index] = element;
     }
 
@@ -439,8 +458,18 @@ protected:
 
 private:
 
+    struct ElementNameAt
+    {
+        const ElementDataList &elementDataList;
+        ElementNameAt(const ElementDataList &elementDataList) : elementDataList(elementDataList) { }
+        const std::string & operator()(size_t index) const { return elementDataList[index].getName(); }
+    };
+
+    void rebuildNameIndex();
+
     bool unique_;
     std::vector<ElementData> elementDataList_;
+    NameIndex nameIndex_;   // element names to indices, updated on each name change
 };
 
 // StructType
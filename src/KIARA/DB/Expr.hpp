@@ -54,6 +54,7 @@ protected:
 
     void setExprType(const Type::Ptr & type)
     {
+        MutationLock lock(*this);
         exprType_ = type;
     }
 
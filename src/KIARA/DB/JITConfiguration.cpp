@@ -37,6 +37,16 @@ JITConfiguration::JITConfiguration()
 void JITConfiguration::clear()
 {
     useLegacyJIT = true;
+    useInterpreter = false;
+    useRuntimeCache = true;
+    runtimeCacheDir.clear();
+    optLevel = 3;
+    passPipeline.clear();
+    loopVectorize = true;
+    slpVectorize = false;
+    unrollThreshold = -1;
+    codeModel = "default";
+    maxCompileRecords = 1000;
 }
 
 } // namespace KIARA
@@ -28,6 +28,7 @@
 
 #include <KIARA/Common/Config.hpp>
 #include <string>
+#include <vector>
 
 namespace KIARA
 {
@@ -39,6 +40,39 @@ public:
 
 	bool useLegacyJIT;
 
+    /// When true, connections use the table-driven serialization
+    /// interpreter instead of JIT-compiled stubs.
+    bool useInterpreter;
+
+    /// When true, compiled KL runtime files (stdlib.kl, api.kl) are cached
+    /// as bitcode in runtimeCacheDir and reused by later processes.
+    bool useRuntimeCache;
+
+    std::string runtimeCacheDir;
+
+    /// Optimization level 0-3 of IR passes and machine code generation.
+    int optLevel;
+
+    /// Names of function passes run on each compiled function,
+    /// e.g. "instcombine", "gvn". When empty the built-in pipeline for
+    /// optLevel is used, "standard" selects LLVM's standard function passes.
+    std::vector<std::string> passPipeline;
+
+    bool loopVectorize;
+    bool slpVectorize;
+
+    /// Loop unroll threshold, negative value uses the LLVM default
+    /// and 0 disables unrolling.
+    int unrollThreshold;
+
+    /// One of "default", "small", "kernel", "medium", "large".
+    std::string codeModel;
+
+    /// Maximal number of compile records kept by each runtime environment,
+    /// records of the oldest compiled functions are dropped first.
+    /// 0 disables compile records.
+    size_t maxCompileRecords;
+
     void clear();
 
 };
@@ -77,6 +77,8 @@ SecurityConfiguration LibraryConfiguration::getSecurityConfiguration() const
     // security.certFile
     // security.keyFile
     // security.caCertFile
+    // security.encryptionPassword
+    // security.encryptionCipher
     SecurityConfiguration sc;
 
     if (config.isDict())
@@ -116,6 +118,12 @@ SecurityConfiguration LibraryConfiguration::getSecurityConfiguration() const
                 {
                     sc.encryptionPassword = "password";
                 }
+
+                it = securityDict.find("encryptionCipher");
+                if (it != securityDict.end() && it->second.isString())
+                {
+                    sc.encryptionCipher = it->second.getString();
+                }
             }
         }
     }
@@ -123,12 +131,69 @@ SecurityConfiguration LibraryConfiguration::getSecurityConfiguration() const
     return sc;
 }
 
+// pass pipeline is either an array of names or a comma separated string
+static void parsePassPipeline(const std::string &text, std::vector<std::string> &passes)
+{
+    passes.clear();
+    std::vector<std::string> names;
+    boost::algorithm::split(names, text, boost::algorithm::is_any_of(","));
+    for (std::vector<std::string>::iterator it = names.begin(), end = names.end(); it != end; ++it)
+    {
+        boost::algorithm::trim(*it);
+        if (!it->empty())
+            passes.push_back(*it);
+    }
+}
+
+static void parsePassPipeline(const Value &value, std::vector<std::string> &passes)
+{
+    if (value.isString())
+    {
+        parsePassPipeline(value.getString(), passes);
+    }
+    else if (value.isArray())
+    {
+        passes.clear();
+        const ArrayValue &names = value.getArray();
+        for (ArrayValue::const_iterator it = names.begin(), end = names.end(); it != end; ++it)
+        {
+            if (it->isString() && !it->getString().empty())
+                passes.push_back(it->getString());
+        }
+    }
+}
+
+static bool parseBoolEnv(const char *text, bool defaultValue)
+{
+    if (!text)
+        return defaultValue;
+    if (boost::algorithm::iequals(text, "1") ||
+        boost::algorithm::iequals(text, "true") ||
+        boost::algorithm::iequals(text, "yes") ||
+        boost::algorithm::iequals(text, "on"))
+        return true;
+    if (boost::algorithm::iequals(text, "0") ||
+        boost::algorithm::iequals(text, "false") ||
+        boost::algorithm::iequals(text, "no") ||
+        boost::algorithm::iequals(text, "off"))
+        return false;
+    return defaultValue;
+}
+
 JITConfiguration LibraryConfiguration::getJITConfiguration() const
 {
     // read following entries
-    // security.certFile
-    // security.keyFile
-    // security.caCertFile
+    // jit.useLegacyJIT
+    // jit.useInterpreter
+    // jit.useRuntimeCache
+    // jit.runtimeCacheDir
+    // jit.optLevel
+    // jit.passPipeline
+    // jit.loopVectorize
+    // jit.slpVectorize
+    // jit.unrollThreshold
+    // jit.codeModel
+    // jit.maxCompileRecords
     JITConfiguration jc;
 
     if (config.isDict())
@@ -147,6 +212,66 @@ JITConfiguration LibraryConfiguration::getJITConfiguration() const
                 {
                     jc.useLegacyJIT = it->second.getBool();
                 }
+
+                it = jitDict.find("useInterpreter");
+                if (it != jitDict.end() && it->second.isBool())
+                {
+                    jc.useInterpreter = it->second.getBool();
+                }
+
+                it = jitDict.find("useRuntimeCache");
+                if (it != jitDict.end() && it->second.isBool())
+                {
+                    jc.useRuntimeCache = it->second.getBool();
+                }
+
+                it = jitDict.find("runtimeCacheDir");
+                if (it != jitDict.end() && it->second.isString())
+                {
+                    jc.runtimeCacheDir = makeNativePath(it->second.getString());
+                }
+
+                it = jitDict.find("optLevel");
+                if (it != jitDict.end() && it->second.isNumber())
+                {
+                    jc.optLevel = static_cast<int>(it->second.getNumber().toInt());
+                }
+
+                it = jitDict.find("passPipeline");
+                if (it != jitDict.end())
+                {
+                    parsePassPipeline(it->second, jc.passPipeline);
+                }
+
+                it = jitDict.find("loopVectorize");
+                if (it != jitDict.end() && it->second.isBool())
+                {
+                    jc.loopVectorize = it->second.getBool();
+                }
+
+                it = jitDict.find("slpVectorize");
+                if (it != jitDict.end() && it->second.isBool())
+                {
+                    jc.slpVectorize = it->second.getBool();
+                }
+
+                it = jitDict.find("unrollThreshold");
+                if (it != jitDict.end() && it->second.isNumber())
+                {
+                    jc.unrollThreshold = static_cast<int>(it->second.getNumber().toInt());
+                }
+
+                it = jitDict.find("codeModel");
+                if (it != jitDict.end() && it->second.isString())
+                {
+                    jc.codeModel = it->second.getString();
+                }
+
+                it = jitDict.find("maxCompileRecords");
+                if (it != jitDict.end() && it->second.isNumber())
+                {
+                    jc.maxCompileRecords = static_cast<size_t>(it->second.getNumber().toUInt());
+                }
             }
         }
     }
@@ -156,14 +281,365 @@ JITConfiguration LibraryConfiguration::getJITConfiguration() const
     if (jitEngine)
     {
         if (boost::algorithm::iequals(jitEngine, "JIT"))
+        {
             jc.useLegacyJIT = true;
+            jc.useInterpreter = false;
+        }
         else if (boost::algorithm::iequals(jitEngine, "MCJIT"))
+        {
             jc.useLegacyJIT = false;
+            jc.useInterpreter = false;
+        }
+        else if (boost::algorithm::iequals(jitEngine, "Interpreter"))
+            jc.useInterpreter = true;
     }
 
+    char *runtimeCacheDir = ::getenv("KIARA_RUNTIME_CACHE_DIR");
+    if (runtimeCacheDir)
+    {
+        // empty value disables the cache
+        if (runtimeCacheDir[0] == '\0')
+            jc.useRuntimeCache = false;
+        else
+            jc.runtimeCacheDir = makeNativePath(runtimeCacheDir);
+    }
+
+    if (jc.runtimeCacheDir.empty())
+        jc.runtimeCacheDir = makeNativePath("~/.kiara/cache");
+
+    if (char *optLevel = ::getenv("KIARA_JIT_OPT_LEVEL"))
+        jc.optLevel = atoi(optLevel);
+    if (jc.optLevel < 0)
+        jc.optLevel = 0;
+    if (jc.optLevel > 3)
+        jc.optLevel = 3;
+
+    if (char *passes = ::getenv("KIARA_JIT_PASSES"))
+        parsePassPipeline(passes, jc.passPipeline);
+
+    jc.loopVectorize = parseBoolEnv(::getenv("KIARA_JIT_LOOP_VECTORIZE"), jc.loopVectorize);
+    jc.slpVectorize = parseBoolEnv(::getenv("KIARA_JIT_SLP_VECTORIZE"), jc.slpVectorize);
+
+    if (char *unrollThreshold = ::getenv("KIARA_JIT_UNROLL_THRESHOLD"))
+        jc.unrollThreshold = atoi(unrollThreshold);
+
+    if (char *codeModel = ::getenv("KIARA_JIT_CODE_MODEL"))
+        jc.codeModel = codeModel;
+
+    if (char *maxCompileRecords = ::getenv("KIARA_JIT_MAX_COMPILE_RECORDS"))
+        jc.maxCompileRecords = static_cast<size_t>(strtoul(maxCompileRecords, 0, 10));
+
     return jc;
 }
 
+ConnectionPoolConfiguration LibraryConfiguration::getConnectionPoolConfiguration() const
+{
+    // read following entries
+    // connectionPool.enabled
+    // connectionPool.maxConnections
+    // connectionPool.maxConnectionsPerPeer
+    // connectionPool.idleTimeout
+    // connectionPool.callTimeout
+    ConnectionPoolConfiguration pc;
+
+    if (config.isDict())
+    {
+        const DictValue &dict = config.getDict();
+        DictValue::const_iterator it = dict.find("connectionPool");
+        if (it != dict.end())
+        {
+            const Value &pool = it->second;
+            if (pool.isDict())
+            {
+                const DictValue &poolDict = pool.getDict();
+
+                it = poolDict.find("enabled");
+                if (it != poolDict.end() && it->second.isBool())
+                {
+                    pc.enabled = it->second.getBool();
+                }
+
+                it = poolDict.find("maxConnections");
+                if (it != poolDict.end() && it->second.isNumber())
+                {
+                    pc.maxConnections = static_cast<unsigned int>(it->second.getNumber().toUInt());
+                }
+
+                it = poolDict.find("maxConnectionsPerPeer");
+                if (it != poolDict.end() && it->second.isNumber())
+                {
+                    pc.maxConnectionsPerPeer = static_cast<unsigned int>(it->second.getNumber().toUInt());
+                }
+
+                it = poolDict.find("idleTimeout");
+                if (it != poolDict.end() && it->second.isNumber())
+                {
+                    pc.idleTimeout = static_cast<unsigned int>(it->second.getNumber().toUInt());
+                }
+
+                it = poolDict.find("callTimeout");
+                if (it != poolDict.end() && it->second.isNumber())
+                {
+                    pc.callTimeout = static_cast<unsigned int>(it->second.getNumber().toUInt());
+                }
+            }
+        }
+    }
+
+    // Environment has precedence over configuration files
+    pc.enabled = parseBoolEnv(::getenv("KIARA_CONNECTION_POOL"), pc.enabled);
+
+    if (char *maxConnections = ::getenv("KIARA_CONNECTION_POOL_SIZE"))
+        pc.maxConnections = static_cast<unsigned int>(atoi(maxConnections));
+
+    if (char *maxConnectionsPerPeer = ::getenv("KIARA_CONNECTION_POOL_PER_PEER"))
+        pc.maxConnectionsPerPeer = static_cast<unsigned int>(atoi(maxConnectionsPerPeer));
+
+    if (char *idleTimeout = ::getenv("KIARA_CONNECTION_POOL_IDLE_TIMEOUT"))
+        pc.idleTimeout = static_cast<unsigned int>(atoi(idleTimeout));
+
+    if (char *callTimeout = ::getenv("KIARA_CONNECTION_POOL_CALL_TIMEOUT"))
+        pc.callTimeout = static_cast<unsigned int>(atoi(callTimeout));
+
+    if (pc.maxConnections == 0)
+        pc.maxConnections = 1;
+    if (pc.maxConnectionsPerPeer == 0)
+        pc.maxConnectionsPerPeer = 1;
+    if (pc.maxConnectionsPerPeer > pc.maxConnections)
+        pc.maxConnectionsPerPeer = pc.maxConnections;
+
+    return pc;
+}
+
+WorkerPoolConfiguration LibraryConfiguration::getWorkerPoolConfiguration() const
+{
+    // read following entries
+    // workerPool.numWorkers
+    // workerPool.cpuAffinity
+    WorkerPoolConfiguration wc;
+
+    if (config.isDict())
+    {
+        const DictValue &dict = config.getDict();
+        DictValue::const_iterator it = dict.find("workerPool");
+        if (it != dict.end())
+        {
+            const Value &pool = it->second;
+            if (pool.isDict())
+            {
+                const DictValue &poolDict = pool.getDict();
+
+                it = poolDict.find("numWorkers");
+                if (it != poolDict.end() && it->second.isNumber())
+                {
+                    wc.numWorkers = static_cast<unsigned int>(it->second.getNumber().toUInt());
+                }
+
+                it = poolDict.find("cpuAffinity");
+                if (it != poolDict.end() && it->second.isBool())
+                {
+                    wc.cpuAffinity = it->second.getBool();
+                }
+            }
+        }
+    }
+
+    // Environment has precedence over configuration files
+    if (char *numWorkers = ::getenv("KIARA_SERVER_WORKERS"))
+        wc.numWorkers = static_cast<unsigned int>(atoi(numWorkers));
+
+    wc.cpuAffinity = parseBoolEnv(::getenv("KIARA_SERVER_CPU_AFFINITY"), wc.cpuAffinity);
+
+    return wc;
+}
+
+PubSubConfiguration LibraryConfiguration::getPubSubConfiguration() const
+{
+    // read following entries
+    // pubSub.sendHighWaterMark
+    // pubSub.receiveHighWaterMark
+    // pubSub.conflate
+    PubSubConfiguration psc;
+
+    if (config.isDict())
+    {
+        const DictValue &dict = config.getDict();
+        DictValue::const_iterator it = dict.find("pubSub");
+        if (it != dict.end())
+        {
+            const Value &pubSub = it->second;
+            if (pubSub.isDict())
+            {
+                const DictValue &pubSubDict = pubSub.getDict();
+
+                it = pubSubDict.find("sendHighWaterMark");
+                if (it != pubSubDict.end() && it->second.isNumber())
+                {
+                    psc.sendHighWaterMark = static_cast<unsigned int>(it->second.getNumber().toUInt());
+                }
+
+                it = pubSubDict.find("receiveHighWaterMark");
+                if (it != pubSubDict.end() && it->second.isNumber())
+                {
+                    psc.receiveHighWaterMark = static_cast<unsigned int>(it->second.getNumber().toUInt());
+                }
+
+                it = pubSubDict.find("conflate");
+                if (it != pubSubDict.end() && it->second.isBool())
+                {
+                    psc.conflate = it->second.getBool();
+                }
+            }
+        }
+    }
+
+    // Environment has precedence over configuration files
+    if (char *sendHighWaterMark = ::getenv("KIARA_PUBSUB_SNDHWM"))
+        psc.sendHighWaterMark = static_cast<unsigned int>(atoi(sendHighWaterMark));
+
+    if (char *receiveHighWaterMark = ::getenv("KIARA_PUBSUB_RCVHWM"))
+        psc.receiveHighWaterMark = static_cast<unsigned int>(atoi(receiveHighWaterMark));
+
+    psc.conflate = parseBoolEnv(::getenv("KIARA_PUBSUB_CONFLATE"), psc.conflate);
+
+    return psc;
+}
+
+SharedMemoryConfiguration LibraryConfiguration::getSharedMemoryConfiguration() const
+{
+    // read following entries
+    // sharedMemory.enabled
+    // sharedMemory.ringSize
+    // sharedMemory.spinCount
+    // sharedMemory.socketDirectory
+    // sharedMemory.maxMessageSize
+    // sharedMemory.maxConnections
+    SharedMemoryConfiguration smc;
+
+    if (config.isDict())
+    {
+        const DictValue &dict = config.getDict();
+        DictValue::const_iterator it = dict.find("sharedMemory");
+        if (it != dict.end())
+        {
+            const Value &sharedMemory = it->second;
+            if (sharedMemory.isDict())
+            {
+                const DictValue &sharedMemoryDict = sharedMemory.getDict();
+
+                it = sharedMemoryDict.find("enabled");
+                if (it != sharedMemoryDict.end() && it->second.isBool())
+                {
+                    smc.enabled = it->second.getBool();
+                }
+
+                it = sharedMemoryDict.find("ringSize");
+                if (it != sharedMemoryDict.end() && it->second.isNumber())
+                {
+                    smc.ringSize = static_cast<unsigned int>(it->second.getNumber().toUInt());
+                }
+
+                it = sharedMemoryDict.find("spinCount");
+                if (it != sharedMemoryDict.end() && it->second.isNumber())
+                {
+                    smc.spinCount = static_cast<unsigned int>(it->second.getNumber().toUInt());
+                }
+
+                it = sharedMemoryDict.find("socketDirectory");
+                if (it != sharedMemoryDict.end() && it->second.isString())
+                {
+                    smc.socketDirectory = makeNativePath(it->second.getString());
+                }
+
+                it = sharedMemoryDict.find("maxMessageSize");
+                if (it != sharedMemoryDict.end() && it->second.isNumber())
+                {
+                    smc.maxMessageSize = static_cast<unsigned int>(it->second.getNumber().toUInt());
+                }
+
+                it = sharedMemoryDict.find("maxConnections");
+                if (it != sharedMemoryDict.end() && it->second.isNumber())
+                {
+                    smc.maxConnections = static_cast<unsigned int>(it->second.getNumber().toUInt());
+                }
+            }
+        }
+    }
+
+    // Environment has precedence over configuration files
+    smc.enabled = parseBoolEnv(::getenv("KIARA_SHARED_MEMORY"), smc.enabled);
+
+    if (char *ringSize = ::getenv("KIARA_SHARED_MEMORY_RING_SIZE"))
+        smc.ringSize = static_cast<unsigned int>(atoi(ringSize));
+
+    if (char *socketDirectory = ::getenv("KIARA_SHARED_MEMORY_DIR"))
+        smc.socketDirectory = makeNativePath(socketDirectory);
+
+    if (char *maxMessageSize = ::getenv("KIARA_SHARED_MEMORY_MAX_MESSAGE_SIZE"))
+        smc.maxMessageSize = static_cast<unsigned int>(atoi(maxMessageSize));
+
+    if (char *maxConnections = ::getenv("KIARA_SHARED_MEMORY_MAX_CONNECTIONS"))
+        smc.maxConnections = static_cast<unsigned int>(atoi(maxConnections));
+
+    // at least one page, at most 1 GiB per ring
+    if (smc.ringSize < 4096)
+        smc.ringSize = 4096;
+    if (smc.ringSize > (1u << 30))
+        smc.ringSize = 1u << 30;
+
+    return smc;
+}
+
+LocalTransportConfiguration LibraryConfiguration::getLocalTransportConfiguration() const
+{
+    // read following entries
+    // localTransport.inproc
+    // localTransport.ipc
+    // localTransport.ipcDirectory
+    LocalTransportConfiguration ltc;
+
+    if (config.isDict())
+    {
+        const DictValue &dict = config.getDict();
+        DictValue::const_iterator it = dict.find("localTransport");
+        if (it != dict.end())
+        {
+            const Value &localTransport = it->second;
+            if (localTransport.isDict())
+            {
+                const DictValue &localTransportDict = localTransport.getDict();
+
+                it = localTransportDict.find("inproc");
+                if (it != localTransportDict.end() && it->second.isBool())
+                {
+                    ltc.inproc = it->second.getBool();
+                }
+
+                it = localTransportDict.find("ipc");
+                if (it != localTransportDict.end() && it->second.isBool())
+                {
+                    ltc.ipc = it->second.getBool();
+                }
+
+                it = localTransportDict.find("ipcDirectory");
+                if (it != localTransportDict.end() && it->second.isString())
+                {
+                    ltc.ipcDirectory = makeNativePath(it->second.getString());
+                }
+            }
+        }
+    }
+
+    // Environment has precedence over configuration files
+    ltc.inproc = parseBoolEnv(::getenv("KIARA_INPROC"), ltc.inproc);
+    ltc.ipc = parseBoolEnv(::getenv("KIARA_IPC"), ltc.ipc);
+
+    if (char *ipcDirectory = ::getenv("KIARA_IPC_DIR"))
+        ltc.ipcDirectory = makeNativePath(ipcDirectory);
+
+    return ltc;
+}
+
 #undef CLERROR
 #undef ARG
 #undef ARG_STARTS_WITH
@@ -30,6 +30,11 @@
 #include <KIARA/DB/Value.hpp>
 #include "SecurityConfiguration.hpp"
 #include "JITConfiguration.hpp"
+#include "ConnectionPoolConfiguration.hpp"
+#include "WorkerPoolConfiguration.hpp"
+#include "PubSubConfiguration.hpp"
+#include "SharedMemoryConfiguration.hpp"
+#include "LocalTransportConfiguration.hpp"
 #include <string>
 #include <vector>
 #include <ostream>
@@ -53,6 +58,16 @@ public:
 
     JITConfiguration getJITConfiguration() const;
 
+    ConnectionPoolConfiguration getConnectionPoolConfiguration() const;
+
+    WorkerPoolConfiguration getWorkerPoolConfiguration() const;
+
+    PubSubConfiguration getPubSubConfiguration() const;
+
+    SharedMemoryConfiguration getSharedMemoryConfiguration() const;
+
+    LocalTransportConfiguration getLocalTransportConfiguration() const;
+
     void parseCommandLine(int *argc, char **argv);
 
     void printSupportedArguments(std::ostream &out);
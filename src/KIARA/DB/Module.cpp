@@ -73,6 +73,7 @@ const std::string Module::getTypeName(const Type::Ptr &type) const
 
 void Module::addTypeDeclaration(TypeDeclarationKind kind, const Type::Ptr &type)
 {
+    MutationLock lock(*this);
     typeDeclarations_.push_back(std::make_pair(kind, type));
 }
 
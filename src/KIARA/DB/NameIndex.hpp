@@ -0,0 +1,175 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * NameIndex.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef KIARA_DB_NAMEINDEX_HPP_INCLUDED
+#define KIARA_DB_NAMEINDEX_HPP_INCLUDED
+
+#include <KIARA/Common/Config.hpp>
+#include <boost/cstdint.hpp>
+#include <string>
+#include <vector>
+
+namespace KIARA
+{
+
+/// Maps names to element indices.
+///
+/// Names are owned by the caller, the index keeps only a hash and the element
+/// index of each name in a flat open addressing table (linear probing), so a
+/// lookup touches a few contiguous slots and compares strings only when the
+/// hashes match. Several elements may have the same name, find returns the
+/// smallest index. Empty names are not indexed.
+class NameIndex
+{
+public:
+    static const size_t npos = -1;
+
+    NameIndex() : slots_(), size_(0) { }
+
+    size_t size() const { return size_; }
+
+    void clear()
+    {
+        slots_.clear();
+        size_ = 0;
+    }
+
+    static boost::uint32_t hashName(const std::string &name)
+    {
+        // FNV-1a
+        boost::uint32_t h = 2166136261u;
+        for (std::string::const_iterator it = name.begin(), end = name.end(); it != end; ++it)
+        {
+            h ^= static_cast<unsigned char>(*it);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    void insert(const std::string &name, size_t index)
+    {
+        if (name.empty())
+            return;
+        if ((size_ + 1) * 2 > slots_.size())
+            grow();
+        insertSlot(Slot(hashName(name), static_cast<boost::uint32_t>(index)));
+        ++size_;
+    }
+
+    /// Removes entry added by insert(name, index)
+    void remove(const std::string &name, size_t index)
+    {
+        if (name.empty() || size_ == 0)
+            return;
+        const size_t mask = slots_.size() - 1;
+        const boost::uint32_t h = hashName(name);
+        for (size_t i = h & mask; !slots_[i].isEmpty(); i = (i + 1) & mask)
+        {
+            if (slots_[i].index == index && slots_[i].hash == h)
+            {
+                eraseSlot(i);
+                --size_;
+                return;
+            }
+        }
+    }
+
+    /// Returns npos if name is not found. nameAt(i) must return the name of the i-th element.
+    template <class NameAt>
+    size_t find(const std::string &name, const NameAt &nameAt) const
+    {
+        if (size_ == 0 || name.empty())
+            return npos;
+        const size_t mask = slots_.size() - 1;
+        const boost::uint32_t h = hashName(name);
+        size_t result = npos;
+        for (size_t i = h & mask; !slots_[i].isEmpty(); i = (i + 1) & mask)
+        {
+            const Slot &slot = slots_[i];
+            if (slot.hash == h && slot.index < result && nameAt(slot.index) == name)
+                result = slot.index;
+        }
+        return result;
+    }
+
+private:
+
+    struct Slot
+    {
+        static const boost::uint32_t EMPTY = 0xFFFFFFFFu;
+
+        boost::uint32_t hash;
+        boost::uint32_t index;
+
+        Slot() : hash(0), index(EMPTY) { }
+        Slot(boost::uint32_t hash, boost::uint32_t index) : hash(hash), index(index) { }
+
+        bool isEmpty() const { return index == EMPTY; }
+    };
+
+    void insertSlot(const Slot &slot)
+    {
+        const size_t mask = slots_.size() - 1;
+        size_t i = slot.hash & mask;
+        while (!slots_[i].isEmpty())
+            i = (i + 1) & mask;
+        slots_[i] = slot;
+    }
+
+    /// Backward shift deletion, keeps probe sequences free of holes
+    void eraseSlot(size_t hole)
+    {
+        const size_t mask = slots_.size() - 1;
+        for (size_t j = (hole + 1) & mask; !slots_[j].isEmpty(); j = (j + 1) & mask)
+        {
+            const size_t home = slots_[j].hash & mask;
+            const bool canMove = (hole <= j) ? (home <= hole || home > j) : (home <= hole && home > j);
+            if (canMove)
+            {
+                slots_[hole] = slots_[j];
+                hole = j;
+            }
+        }
+        slots_[hole] = Slot();
+    }
+
+    void grow()
+    {
+        std::vector<Slot> oldSlots(slots_.empty() ? 8 : slots_.size() * 2);
+        oldSlots.swap(slots_);
+        for (std::vector<Slot>::const_iterator it = oldSlots.begin(), end = oldSlots.end(); it != end; ++it)
+        {
+            if (!it->isEmpty())
+                insertSlot(*it);
+        }
+    }
+
+    std::vector<Slot> slots_;
+    size_t size_;
+};
+
+} // namespace KIARA
+
+#endif /* KIARA_DB_NAMEINDEX_HPP_INCLUDED */
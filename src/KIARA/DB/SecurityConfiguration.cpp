@@ -34,6 +34,7 @@ void SecurityConfiguration::clear()
     keyFile.clear();
     caCertFile.clear();
     encryptionPassword.clear();
+    encryptionCipher.clear();
 }
 
 } // namespace KIARA
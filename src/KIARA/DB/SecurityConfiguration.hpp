@@ -40,6 +40,7 @@ public:
     std::string keyFile;
     std::string caCertFile;
     std::string encryptionPassword;
+    std::string encryptionCipher; // AEAD cipher used for encrypted types
 
     void clear();
 
@@ -0,0 +1,49 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * SharedMemoryConfiguration.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#define KIARA_LIB
+#include "SharedMemoryConfiguration.hpp"
+#include <cstdlib>
+
+namespace KIARA
+{
+
+SharedMemoryConfiguration::SharedMemoryConfiguration()
+{
+    clear();
+}
+
+void SharedMemoryConfiguration::clear()
+{
+    enabled = true;
+    ringSize = 1024 * 1024;
+    spinCount = 2000;
+    const char *runtimeDir = ::getenv("XDG_RUNTIME_DIR");
+    socketDirectory = runtimeDir && *runtimeDir ? runtimeDir : "/tmp";
+    maxMessageSize = 64 * 1024 * 1024;
+    maxConnections = 256;
+}
+
+} // namespace KIARA
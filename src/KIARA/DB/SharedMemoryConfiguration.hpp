@@ -0,0 +1,70 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * SharedMemoryConfiguration.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef KIARA_DB_SHAREDMEMORYCONFIGURATION_HPP_INCLUDED
+#define KIARA_DB_SHAREDMEMORYCONFIGURATION_HPP_INCLUDED
+
+#include <KIARA/Common/Config.hpp>
+#include <string>
+
+namespace KIARA
+{
+
+class KIARA_API SharedMemoryConfiguration
+{
+public:
+    SharedMemoryConfiguration();
+
+    /// When true, servers accept TCP services also over shared memory
+    /// and advertise it to clients on the same host.
+    bool enabled;
+
+    /// Size in bytes of each of the two ring buffers of a connection,
+    /// rounded up to a power of two.
+    unsigned int ringSize;
+
+    /// Number of polls of a ring buffer before a waiting thread sleeps.
+    unsigned int spinCount;
+
+    /// Directory of the sockets used to set up connections, $XDG_RUNTIME_DIR
+    /// or /tmp by default. Sockets are created in its subdirectory
+    /// kiara-<uid> that must be owned by the user and have mode 0700.
+    std::string socketDirectory;
+
+    /// Largest message in bytes that is accepted from a peer, the connection
+    /// is closed when a larger one is received.
+    unsigned int maxMessageSize;
+
+    /// Largest number of connections a server serves at once, each of them
+    /// has its own thread. Further connections are closed when accepted.
+    unsigned int maxConnections;
+
+    void clear();
+
+};
+
+} // namespace KIARA
+
+#endif /* KIARA_DB_SHAREDMEMORYCONFIGURATION_HPP_INCLUDED */
@@ -42,6 +42,7 @@ Namespace::Namespace(World& world, const std::string &name)
     , parent_()
     , typeMap_()
     , subnamespaces_()
+    , typeIndex_()
 {
 }
 
@@ -73,6 +74,7 @@ std::string Namespace::getFullName() const
 
 void Namespace::setParent(const Namespace::Ptr &parent)
 {
+    MutationLock lock(*this);
     parent_ = parent;
 }
 
@@ -81,10 +83,14 @@ void Namespace::bindType(const std::string &name, const Type::Ptr &type, bool ta
     BOOST_ASSERT(type != 0);
     BOOST_ASSERT(&type->getWorld() == &getWorld());
 
+    // the collector must not trace typeMap_ while it is modified
+    MutationLock lock(*this);
+
     if (typeMap_.find(name) != typeMap_.end())
         DFC_THROW_EXCEPTION(Exception, "Type '"<<name<<"' already defined.");
 
     typeMap_[name] = type;
+    typeIndex_.insert(name, type);
     if (takeOwnership)
     {
         type->setNamespace(this);
@@ -93,12 +99,12 @@ void Namespace::bindType(const std::string &name, const Type::Ptr &type, bool ta
 
 const Type::Ptr Namespace::lookupType(const std::string &name) const
 {
-    TypeMap::const_iterator it = typeMap_.find(name);
-    return it != typeMap_.end() ? it->second : Type::Ptr();
+    return typeIndex_.find(name);
 }
 
 const std::string Namespace::getTypeName(const Type::Ptr &type) const
 {
+    MutationLock lock(*this);
     for (TypeMap::const_iterator it = typeMap_.begin(), end = typeMap_.end();
             it != end; ++it)
     {
@@ -119,6 +125,7 @@ void Namespace::gcUnlinkRefs()
     gcUnlinkChild(parent_);
     gcUnlinkChildren(GCObject::map_values_tag(), typeMap_.begin(), typeMap_.end());
     gcUnlinkChildren(subnamespaces_.begin(), subnamespaces_.end());
+    typeIndex_.clear();
 }
 
 void Namespace::gcApplyToChildren(const CollectorCallback &callback)
@@ -127,6 +134,10 @@ void Namespace::gcApplyToChildren(const CollectorCallback &callback)
     gcApply(parent_, callback);
     gcApply(GCObject::map_values_tag(), typeMap_.begin(), typeMap_.end(), callback);
     gcApply(subnamespaces_.begin(), subnamespaces_.end(), callback);
+    // index holds its own references
+    for (PublishedMap<std::string, TypePtr>::const_iterator it = typeIndex_.begin(),
+            end = typeIndex_.end(); it != end; ++it)
+        gcApply(it->value, callback);
 }
 
 /// Type
@@ -155,6 +166,7 @@ Type::Type(World& world, const std::string &name, int kind, ArrayRef<Object::Ptr
 
 void Type::setNamespace(const Namespace::Ptr &newNamespace)
 {
+    MutationLock lock(*this);
     namespace_ = newNamespace;
 }
 
@@ -210,11 +222,13 @@ void Type::print(std::ostream & p, std::set<const Type*> &visited) const
 
 void Type::resizeElements(size_t newSize)
 {
+    MutationLock lock(*this);
     elements_.resize(newSize);
 }
 
 void Type::setCanonicalTypeUnsafe(const Type::Ptr &type)
 {
+    MutationLock lock(*this);
     canonicalType_ = type;
 }
 
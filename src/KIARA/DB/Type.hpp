@@ -34,6 +34,7 @@
 #include <KIARA/DB/AttributeHolder.hpp>
 #include <KIARA/Utils/ArrayRef.hpp>
 #include <KIARA/Utils/TypedBox.hpp>
+#include <KIARA/Utils/PublishedMap.hpp>
 #include <KIARA/Common/stdint.h>
 #include "Enums.hpp"
 #include <map>
@@ -67,12 +68,15 @@ public:
     const Ptr & getParent() const { return parent_; }
     void setParent(const Namespace::Ptr &parent);
 
+    /// Binding and lookup can be performed concurrently from multiple threads,
+    /// lookupType does not lock.
     void bindType(const std::string &name, const TypePtr &type, bool takeOwnership = true);
     const TypePtr lookupType(const std::string &name) const;
     const std::string getTypeName(const TypePtr &type) const;
 
     virtual void print(std::ostream &out) const;
 
+    // iteration is not synchronized with bindType
     typemap_iterator typemap_begin() { return typeMap_.begin(); }
     typemap_iterator typemap_end() { return typeMap_.end(); }
 
@@ -93,6 +97,7 @@ private:
     Namespace::Ptr parent_;
     TypeMap typeMap_;
     std::vector<TypePtr> subnamespaces_;
+    PublishedMap<std::string, TypePtr> typeIndex_; // lock-free index of typeMap_
 };
 
 class KIARA_API Type : public Object, public AttributeHolder
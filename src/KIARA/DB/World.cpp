@@ -35,9 +35,13 @@ namespace KIARA
 
 World::World()
     : CycleCollector()
+    , uniqueStructTypes_()
     , objects_()
     , namespace_()
 {
+    // automatic collections are incremental in order to bound pauses during compilation
+    setTimeBudget(0.001);
+
     namespace_ = Namespace::create(*this, "kiara");
 
     type_ = getOrCreate<TypeType>(new TypeType(*this));
@@ -129,6 +133,8 @@ const Namespace::Ptr & World::getWorldNamespace()
 
 Object::Ptr World::findObject(const Object::Ptr &val)
 {
+    // concurrently created equal objects are unified
+    Lock lock(getMutex());
     ObjectSet::iterator i = objects_.find(val);
     if (i != objects_.end())
         return *i;
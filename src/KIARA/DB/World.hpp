@@ -44,6 +44,9 @@ public:
     World();
     virtual ~World();
 
+    // getMutex() returns the collector mutex, which serializes interning
+    // and other modifications of the world with collections.
+
     const Namespace::Ptr & getWorldNamespace();
 
     // Abstract built-in types
@@ -27,6 +27,8 @@ IDLParserContext::IDLParserContext(const Module::Ptr &module, const std::string
     : scanner(0)
     , parser(0)
     , is(&std::cin)
+    , inputPos(0)
+    , inputEnd(0)
     , fileName(fileName)
     , lineNum(0)
     , token()
@@ -47,6 +49,8 @@ IDLParserContext::IDLParserContext(const Module::Ptr &module,
     : scanner(0)
     , parser(0)
     , is(&is)
+    , inputPos(0)
+    , inputEnd(0)
     , fileName(fileName)
     , lineNum(0)
     , token()
@@ -61,6 +65,30 @@ IDLParserContext::IDLParserContext(const Module::Ptr &module,
     initParser();
 }
 
+IDLParserContext::IDLParserContext(const Module::Ptr &module,
+                                   const char *begin,
+                                   const char *end,
+                                   const std::string &fileName)
+    : scanner(0)
+    , parser(0)
+    , is(0)
+    , inputPos(begin)
+    , inputEnd(end)
+    , fileName(fileName)
+    , lineNum(0)
+    , token()
+    , scannerError()
+    , parsingFailed(false)
+    , parserErrors()
+    , module_(module)
+{
+    BOOST_ASSERT(module.get() != 0);
+    BOOST_ASSERT(begin != 0 && begin <= end);
+
+    initScanner();
+    initParser();
+}
+
 IDLParserContext::~IDLParserContext()
 {
     destroyScanner();
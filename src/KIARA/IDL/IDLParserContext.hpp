@@ -33,7 +33,9 @@ public:
     void *scanner;
     void *parser;
 
-    std::istream *is; // input stream
+    std::istream *is; // input stream, 0 when memory range is scanned
+    const char *inputPos; // memory range input
+    const char *inputEnd;
     std::string fileName; // file name used
     int lineNum;
     IDLToken token;
@@ -44,6 +46,11 @@ public:
 
     IDLParserContext(const Module::Ptr &module, std::istream &is, const std::string &fileName);
 
+    /** Parses memory range [begin, end) which must stay valid while
+     *  the context is in use.
+     */
+    IDLParserContext(const Module::Ptr &module, const char *begin, const char *end, const std::string &fileName);
+
     ~IDLParserContext();
 
     std::string getText();
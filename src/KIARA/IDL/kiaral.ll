@@ -41,6 +41,7 @@
 #include <string>
 #include <cerrno>
 #include <cstdlib>
+#include <cstring>
 #include <cassert>
 #include <sstream>
 
@@ -127,7 +128,18 @@ do {                                                           \
 
 #define YY_USER_ACTION yyextra->lineNum = yylineno;
 
+// Memory input is copied in blocks, stream input line by line
 #define YY_INPUT(buf,result,max_size)                     \
+if (!yyextra->is)                                         \
+{                                                         \
+    size_t n = yyextra->inputEnd - yyextra->inputPos;     \
+    if (n > (size_t)max_size)                             \
+        n = max_size;                                     \
+    memcpy(buf, yyextra->inputPos, n);                    \
+    yyextra->inputPos += n;                               \
+    result = n;                                           \
+}                                                         \
+else                                                      \
 {                                                         \
     char c = '*';                                         \
     size_t n;                                             \
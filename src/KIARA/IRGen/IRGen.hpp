@@ -31,6 +31,7 @@
 #include "KIARA/Compiler/Mangler.hpp"
 #include "KIARA/DB/MemberSemantics.hpp"
 #include "KIARA/DB/Attributes.hpp"
+#include "KIARA/Utils/Timer.hpp"
 #include <boost/noncopyable.hpp>
 
 namespace KIARA
@@ -66,12 +67,14 @@ struct IRGenContext
     KIARA::Compiler::IRBuilder builder;
     std::vector<KIARA::IR::IRExpr::Ptr> expressions;
     FunctionLinkMap functionLinkMap;
+    double startTime; // used for JIT telemetry
 
     IRGenContext(KIARA::Impl::Base *baseCtx, const KIARA::Compiler::Scope::Ptr &topScope)
         : baseCtx(baseCtx)
         , topScope(topScope)
         , builder(topScope)
         , functionLinkMap()
+        , startTime(KIARA::Timer::now())
     { }
 
     KIARA::IR::ExternFunction::Ptr addExternFunction(const KIARA::IR::Prototype::Ptr &proto, const FunctionLinkInfo &funcInfo)
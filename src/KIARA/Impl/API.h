@@ -17,7 +17,6 @@ typedef int (*KIARA_InitNetworkFunc)(KIARA_Connection *);
 typedef int (*KIARA_FinalizeNetworkFunc)(KIARA_Connection *);
 typedef KIARA_Message * (*KIARA_CreateRequestMessageFromData)(const void *data, size_t dataSize);
 typedef KIARA_Message * (*KIARA_CreateResponseMessage)(KIARA_Connection *conn, KIARA_Message *requestMsg);
-typedef KIARA_Message * (*KIARA_CreateResponseMessageZmq)(KIARA_Message *requestMsg);
 typedef const char * (*KIARA_GetMessageMethodName)(KIARA_Message *msg);
 typedef void (*KIARA_FreeMessage)(KIARA_Message *msg);
 typedef KIARA_Result (*KIARA_GetMessageData)(KIARA_Message *msg, kr_dbuffer_t *dest);
@@ -28,6 +27,9 @@ typedef KIARA_Connection * (*KIARA_GetConnection)(KIARA_FuncObj *funcObj);
 typedef KIARA_Connection * (*KIARA_GetServiceConnection)(KIARA_ServiceFuncObj *funcObj);
 typedef KIARA_Result (*KIARA_SendData)(KIARA_Connection *conn, const void *data, size_t dataSize, kr_dbuffer_t *destBuf);
 
+/* Sends data via transport of the connection, used by natively compiled protocol components. */
+KIARA_API KIARA_Result kiaraSendConnectionData(KIARA_Connection *conn, const void *data, size_t dataSize, kr_dbuffer_t *destBuf);
+
 KIARA_END_EXTERN_C
 
 #endif /* KIARA_IMPL_API_H_INCLUDED */
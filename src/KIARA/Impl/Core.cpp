@@ -29,6 +29,7 @@
 
 #include <KIARA/Impl/Core.hpp>
 #include <KIARA/Impl/Network.hpp>
+#include <KIARA/Impl/PubSub.hpp>
 #include <KIARA/kiara_security.h>
 #include <KIARA/DB/Attributes.hpp>
 #include <KIARA/Core/Exception.hpp>
@@ -36,16 +37,24 @@
 #include <KIARA/DB/TypeUtils.hpp>
 #include <KIARA/IDL/IDLParserContext.hpp>
 #include <KIARA/Utils/URLLoader.hpp>
+#include <KIARA/Utils/MemoryBuffer.hpp>
+#include <KIARA/Utils/Hash.hpp>
+#include <KIARA/Utils/Timer.hpp>
 #include <KIARA/Utils/ServerConfiguration.hpp>
 #include <DFC/Utils/StrUtils.hpp>
 #include <boost/assert.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/classification.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/atomic.hpp>
+#include <boost/filesystem.hpp>
 #include <cstdio>
 #include <cstring>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <cstdarg>
 #include <memory>
 #include <openssl/aes.h>
@@ -69,12 +78,124 @@ namespace KIARA
 namespace Impl
 {
 
+namespace
+{
+
+// C++ declaration getters initialize static function variables
+boost::mutex declTypeGetterMutex;
+
+// Errors of a single thread keyed by ThreadError id, only used by the thread itself
+struct ThreadErrors
+{
+    std::map<uint64_t, Error> errors;
+    unsigned int numDestroyed;  // ThreadErrorRegistry::numDestroyed when errors were pruned
+
+    ThreadErrors() : errors(), numDestroyed(0) { }
+};
+
+struct ThreadErrorRegistry
+{
+    boost::mutex mutex;                     // guards liveIds and nextId
+    std::set<uint64_t> liveIds;             // ids of existing ThreadError objects
+    uint64_t nextId;
+    boost::atomic<unsigned int> numDestroyed; // changes when a ThreadError is destroyed
+
+    ThreadErrorRegistry() : mutex(), liveIds(), nextId(0), numDestroyed(0) { }
+};
+
+ThreadErrorRegistry & getThreadErrorRegistry()
+{
+    // Never destroyed, threads may exit after static destructors were run
+    static ThreadErrorRegistry *registry = new ThreadErrorRegistry;
+    return *registry;
+}
+
+boost::thread_specific_ptr<ThreadErrors> threadErrors;
+
+// Checks that fileName is a single path component named like files
+// written by the runtime cache: <stem>-<16 hex digits>.bc
+bool isRuntimeCacheFileName(const std::string &fileName)
+{
+    static const std::string suffix = ".bc";
+    static const size_t hashLength = 16;
+    const size_t minLength = 1 + 1 + hashLength + suffix.length();
+
+    if (fileName.length() < minLength || fileName[0] == '.')
+        return false;
+    if (fileName.find_first_of(std::string("/\\:\0", 4)) != std::string::npos)
+        return false;
+    if (fileName.compare(fileName.length() - suffix.length(), suffix.length(), suffix) != 0)
+        return false;
+
+    const size_t hashPos = fileName.length() - suffix.length() - hashLength;
+    if (fileName[hashPos - 1] != '-')
+        return false;
+    for (size_t i = hashPos; i < hashPos + hashLength; ++i)
+    {
+        const char c = fileName[i];
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f')))
+            return false;
+    }
+    return true;
+}
+
+} // unnamed namespace
+
+// ThreadError
+
+ThreadError::ThreadError()
+    : id_(0)
+{
+    ThreadErrorRegistry &registry = getThreadErrorRegistry();
+    boost::mutex::scoped_lock lock(registry.mutex);
+    id_ = registry.nextId++;
+    registry.liveIds.insert(id_);
+}
+
+ThreadError::~ThreadError()
+{
+    ThreadErrorRegistry &registry = getThreadErrorRegistry();
+    boost::mutex::scoped_lock lock(registry.mutex);
+    registry.liveIds.erase(id_);
+    registry.numDestroyed.fetch_add(1, boost::memory_order_release);
+}
+
+Error & ThreadError::get() const
+{
+    ThreadErrors *errors = threadErrors.get();
+    if (!errors)
+    {
+        errors = new ThreadErrors;
+        threadErrors.reset(errors);
+    }
+
+    // Errors of destroyed objects are dropped by each thread on its next
+    // access, the lock is only taken after an object was destroyed
+    ThreadErrorRegistry &registry = getThreadErrorRegistry();
+    const unsigned int numDestroyed = registry.numDestroyed.load(boost::memory_order_acquire);
+    if (numDestroyed != errors->numDestroyed)
+    {
+        boost::mutex::scoped_lock lock(registry.mutex);
+        for (std::map<uint64_t, Error>::iterator it = errors->errors.begin(); it != errors->errors.end(); )
+        {
+            if (registry.liveIds.count(it->first))
+                ++it;
+            else
+                errors->errors.erase(it++);
+        }
+        errors->numDestroyed = numDestroyed;
+    }
+    return errors->errors[id_];
+}
 
 Context::Context()
     : KIARA::World()
     , securityConfiguration_(Global::getSecurityConfiguration())
     , module_()
     , runtimeContext_(0)
+    , ioService_(new KIARA::Transport::AsioNetworkContext)
+    , connectionPool_()
+    , connectionPoolCreated_(false)
 {
     runtimeContext_ = KIARA::RuntimeContext::create(world());
     runtimeContext_->setSearchPaths(Global::getModuleSearchPath().c_str());
@@ -100,7 +221,7 @@ KIARA_Type * Context::declareStructType(const char *name, int numMembers, KIARA_
 {
     if (numMembers < 0)
     {
-        error_.set(KIARA_INVALID_VALUE, "DeclareStruct: number of struct members is negative");
+        error_.get().set(KIARA_INVALID_VALUE, "DeclareStruct: number of struct members is negative");
         return 0;
     }
 
@@ -111,12 +232,12 @@ KIARA_Type * Context::declareStructType(const char *name, int numMembers, KIARA_
         KIARA::Type::Ptr mty = unwrapType(member.type);
         if (!mty)
         {
-            error_.set(KIARA_INVALID_VALUE, "DeclareStruct: struct member type is NULL");
+            error_.get().set(KIARA_INVALID_VALUE, "DeclareStruct: struct member type is NULL");
             return 0;
         }
         ty->setElementAt(i, mty);
+        ty->setElementNameAt(i, member.name ? member.name : "");
         KIARA::ElementData &data = ty->getElementDataAt(i);
-        data.setName(member.name ? member.name : "");
         data.setAttributeValue<KIARA::NativeOffsetAttr>(member.offset);
     }
 
@@ -128,7 +249,7 @@ KIARA_Type * Context::declareStructType(const char *name, int numMembers, KIARA_
         }
         catch (KIARA::Exception &e)
         {
-            error_.set(KIARA_INVALID_OPERATION, e.what());
+            error_.get().set(KIARA_INVALID_OPERATION, e.what());
             return 0;
         }
     }
@@ -146,9 +267,11 @@ KIARA::TypePtr Context::getTypeFromDeclTypeGetter(KIARA_GetDeclType declTypeGett
 {
     assert(declTypeGetter != 0);
 
-    // FIXME For C++ we need to use global lock around declTypeGetter
-    //       because declarations use static function variables
-    const KIARA_DeclType * declType = declTypeGetter();
+    const KIARA_DeclType * declType;
+    {
+        boost::mutex::scoped_lock lock(declTypeGetterMutex);
+        declType = declTypeGetter();
+    }
 
     return getTypeFromDeclType(declType, error);
 }
@@ -285,6 +408,10 @@ KIARA::TypePtr Context::getTypeFromDeclType(const KIARA_DeclType *declType, Erro
     assert(declType != 0);
     error.clear();
 
+    // Conversion is serialized because declCacheMap_ exposes recursive
+    // struct types before their members are resolved.
+    Lock lock(getMutex());
+
     DeclCacheMap::iterator it = declCacheMap_.find(declType);
     if (it != declCacheMap_.end())
         return it->second;
@@ -737,8 +864,78 @@ KIARA_Type * Context::getTypeFromDecl(KIARA_GetDeclType declTypeGetter, Error &e
 
 bool Context::loadIDL(std::istream &in, const std::string &fileName)
 {
-    KIARA::IDLParserContext ctx(module_, in, fileName);
-    return ctx.parse();
+    KIARA::MemoryBuffer buffer;
+    if (!buffer.read(in))
+        return false;
+    return loadIDL(buffer.begin(), buffer.end(), fileName);
+}
+
+bool Context::loadIDL(const char *begin, const char *end, const std::string &fileName)
+{
+    const std::string idlHash = KIARA::ContentHash().update(begin, end - begin).toHexString();
+
+    {
+        boost::mutex::scoped_lock lock(cacheMutex_);
+        while (loadingIDLHashes_.find(idlHash) != loadingIDLHashes_.end())
+            idlLoadedCond_.wait(lock);
+        if (loadedIDLHashes_.find(idlHash) != loadedIDLHashes_.end())
+            return true;
+        loadingIDLHashes_.insert(idlHash);
+    }
+
+    bool result = false;
+    try
+    {
+        KIARA::IDLParserContext ctx(module_, begin, end, fileName);
+        result = ctx.parse();
+    }
+    catch (...)
+    {
+        finishIDLLoad(idlHash, 0);
+        throw;
+    }
+    if (result)
+    {
+        const ContextSnapshot::IDLEntry entry(fileName, std::string(begin, end));
+        finishIDLLoad(idlHash, &entry);
+    }
+    else
+        finishIDLLoad(idlHash, 0);
+    return result;
+}
+
+void Context::finishIDLLoad(const std::string &idlHash, const ContextSnapshot::IDLEntry *entry)
+{
+    boost::mutex::scoped_lock lock(cacheMutex_);
+    loadingIDLHashes_.erase(idlHash);
+    if (entry)
+    {
+        loadedIDLHashes_.insert(idlHash);
+        loadedIDLs_.push_back(*entry);
+    }
+    idlLoadedCond_.notify_all();
+}
+
+bool Context::isIDLLoaded(const std::string &idlHash) const
+{
+    boost::mutex::scoped_lock lock(cacheMutex_);
+    return loadedIDLHashes_.find(idlHash) != loadedIDLHashes_.end();
+}
+
+bool Context::getCachedServerConfiguration(const std::string &uri, CachedServerConfiguration &dest) const
+{
+    boost::mutex::scoped_lock lock(cacheMutex_);
+    std::map<std::string, CachedServerConfiguration>::const_iterator it = serverConfigurationCache_.find(uri);
+    if (it == serverConfigurationCache_.end())
+        return false;
+    dest = it->second;
+    return true;
+}
+
+void Context::cacheServerConfiguration(const std::string &uri, const CachedServerConfiguration &src)
+{
+    boost::mutex::scoped_lock lock(cacheMutex_);
+    serverConfigurationCache_[uri] = src;
 }
 
 bool Context::loadIDLFromURL(const std::string &url)
@@ -747,8 +944,7 @@ bool Context::loadIDLFromURL(const std::string &url)
     bool result = KIARA::URLLoader::load(url, idlContents);
     if (!result)
         return false;
-    std::istringstream iss(idlContents);
-    return loadIDL(iss, url);
+    return loadIDL(idlContents.data(), idlContents.data() + idlContents.size(), url);
 }
 
 bool Context::loadIDLFromURL(KIARA::URLLoader::Connection * handle, const std::string &url)
@@ -757,22 +953,191 @@ bool Context::loadIDLFromURL(KIARA::URLLoader::Connection * handle, const std::s
     bool result = KIARA::URLLoader::load(handle, url, idlContents);
     if (!result)
         return false;
-    std::istringstream iss(idlContents);
-    return loadIDL(iss, url);
+    return loadIDL(idlContents.data(), idlContents.data() + idlContents.size(), url);
 }
 
 bool Context::loadIDL(const std::string &fileName)
 {
-    std::ifstream inf(fileName.c_str());
-    return loadIDL(inf, fileName);
+    KIARA::MemoryBuffer buffer;
+    if (!buffer.open(fileName))
+        return false;
+    return loadIDL(buffer.begin(), buffer.end(), fileName);
 }
 
 KIARA_Result Context::loadLLVMModule(const std::string &fileName)
 {
+    boost::mutex::scoped_lock lock(cacheMutex_);
     llvmModuleNames_.push_back(fileName);
     return KIARA_SUCCESS;
 }
 
+std::vector<std::string> Context::getLLVMModuleNames() const
+{
+    boost::mutex::scoped_lock lock(cacheMutex_);
+    return llvmModuleNames_;
+}
+
+const KIARA::Transport::ConnectionPool::Ptr & Context::getConnectionPool()
+{
+    Lock lock(getMutex());
+    if (!connectionPoolCreated_)
+    {
+        KIARA::ConnectionPoolConfiguration config = Global::getConnectionPoolConfiguration();
+        if (config.enabled)
+            connectionPool_.reset(new KIARA::Transport::ConnectionPool(config));
+        connectionPoolCreated_ = true;
+    }
+    return connectionPool_;
+}
+
+const std::string & Context::getJITTelemetryJSON()
+{
+    std::ostringstream out;
+    KIARA::writeJITTelemetryJSON(out,
+                                 getRuntimeContext().getJITStatistics(),
+                                 getRuntimeContext().getJITCompileRecords());
+    jitTelemetryJSON_ = out.str();
+    return jitTelemetryJSON_;
+}
+
+bool Context::saveSnapshot(const std::string &fileName)
+{
+    KIARA::ContextSnapshot snapshot;
+    snapshot.libraryVersion = KIARA::ContextSnapshot::getLibraryVersion();
+
+    {
+        boost::mutex::scoped_lock lock(cacheMutex_);
+        snapshot.idls = loadedIDLs_;
+        snapshot.llvmModuleNames = llvmModuleNames_;
+        for (std::map<std::string, CachedServerConfiguration>::const_iterator it = serverConfigurationCache_.begin(),
+            end = serverConfigurationCache_.end(); it != end; ++it)
+        {
+            KIARA::ContextSnapshot::ServerConfigurationEntry entry;
+            entry.uri = it->first;
+            entry.etag = it->second.etag;
+            entry.contentHash = it->second.contentHash;
+            entry.json = it->second.configuration.toJSON();
+            snapshot.serverConfigurations.push_back(entry);
+        }
+    }
+
+    const std::vector<std::string> cacheFiles = getRuntimeContext().getRuntimeCacheFiles();
+    for (std::vector<std::string>::const_iterator it = cacheFiles.begin(), end = cacheFiles.end(); it != end; ++it)
+    {
+        KIARA::MemoryBuffer buffer;
+        if (!buffer.open(*it))
+        {
+            DFC_DEBUG("Runtime cache file "<<*it<<" is not available, skipped");
+            continue;
+        }
+        snapshot.runtimeCacheFiles.push_back(KIARA::ContextSnapshot::FileEntry(
+            boost::filesystem::path(*it).filename().string(),
+            std::string(buffer.begin(), buffer.end())));
+    }
+
+    std::string errorMsg;
+    if (!snapshot.write(fileName, &errorMsg))
+    {
+        setError(KIARA_OUTPUT_ERROR, "Could not write snapshot: "+errorMsg);
+        return false;
+    }
+    return true;
+}
+
+bool Context::restoreSnapshot(const std::string &fileName)
+{
+    KIARA::ContextSnapshot snapshot;
+    std::string errorMsg;
+    if (!snapshot.read(fileName, &errorMsg))
+    {
+        setError(KIARA_INPUT_ERROR, "Could not read snapshot: "+errorMsg);
+        return false;
+    }
+
+    if (snapshot.libraryVersion != KIARA::ContextSnapshot::getLibraryVersion())
+    {
+        setError(KIARA_INIT_ERROR, "Snapshot was created by KIARA "+snapshot.libraryVersion+
+            ", running "+KIARA::ContextSnapshot::getLibraryVersion());
+        return false;
+    }
+
+    // File names are joined with the runtime cache directory, reject anything
+    // that could point outside of it before anything is restored.
+    for (std::vector<KIARA::ContextSnapshot::FileEntry>::const_iterator it = snapshot.runtimeCacheFiles.begin(),
+        end = snapshot.runtimeCacheFiles.end(); it != end; ++it)
+    {
+        if (!isRuntimeCacheFileName(it->fileName))
+        {
+            setError(KIARA_INPUT_ERROR, "Invalid runtime cache file name '"+it->fileName+"' in snapshot");
+            return false;
+        }
+    }
+
+    for (std::vector<KIARA::ContextSnapshot::IDLEntry>::const_iterator it = snapshot.idls.begin(),
+        end = snapshot.idls.end(); it != end; ++it)
+    {
+        const char *begin = it->contents.data();
+        if (!loadIDL(begin, begin + it->contents.size(), it->fileName))
+        {
+            setError(KIARA_INIT_ERROR, "Could not load IDL '"+it->fileName+"' from snapshot");
+            return false;
+        }
+    }
+
+    for (std::vector<std::string>::const_iterator it = snapshot.llvmModuleNames.begin(),
+        end = snapshot.llvmModuleNames.end(); it != end; ++it)
+    {
+        loadLLVMModule(*it);
+    }
+
+    for (std::vector<KIARA::ContextSnapshot::ServerConfigurationEntry>::const_iterator it = snapshot.serverConfigurations.begin(),
+        end = snapshot.serverConfigurations.end(); it != end; ++it)
+    {
+        CachedServerConfiguration cachedConfig;
+        if (!cachedConfig.configuration.fromJSON(it->json))
+            continue;
+        cachedConfig.etag = it->etag;
+        cachedConfig.contentHash = it->contentHash;
+        cacheServerConfiguration(it->uri, cachedConfig);
+    }
+
+    // Compiled runtime modules are found by runtime environments through the
+    // runtime cache, existing files are never overwritten.
+    const KIARA::JITConfiguration &jitConfig = Global::getJITConfiguration();
+    if (jitConfig.useRuntimeCache && !jitConfig.runtimeCacheDir.empty() && !snapshot.runtimeCacheFiles.empty())
+    {
+        boost::system::error_code ec;
+        boost::filesystem::create_directories(jitConfig.runtimeCacheDir, ec);
+
+        for (std::vector<KIARA::ContextSnapshot::FileEntry>::const_iterator it = snapshot.runtimeCacheFiles.begin(),
+            end = snapshot.runtimeCacheFiles.end(); it != end; ++it)
+        {
+            const boost::filesystem::path cachePath = boost::filesystem::path(jitConfig.runtimeCacheDir) / it->fileName;
+            if (boost::filesystem::exists(cachePath, ec))
+                continue;
+
+            std::ostringstream tmpPath;
+            tmpPath << cachePath.string() << ".tmp" << boost::filesystem::unique_path().string();
+            {
+                std::ofstream out(tmpPath.str().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+                out.write(it->contents.data(), it->contents.size());
+                if (!out)
+                {
+                    out.close();
+                    boost::filesystem::remove(tmpPath.str(), ec);
+                    DFC_DEBUG("Could not write runtime cache file "<<cachePath.string());
+                    continue;
+                }
+            }
+            boost::filesystem::rename(tmpPath.str(), cachePath, ec);
+            if (ec)
+                boost::filesystem::remove(tmpPath.str(), ec);
+        }
+    }
+
+    return true;
+}
+
 // KIARA_Base
 
 Base::Base(Context *context) :
@@ -855,6 +1220,11 @@ int kiaraFinalize(void)
     return KIARA::Impl::Global::finalize();
 }
 
+double kiaraGetTime(void)
+{
+    return KIARA::Timer::now();
+}
+
 KIARA_Context * kiaraNewContext()
 {
     if (!KIARA::Impl::Global::isInitialized())
@@ -862,6 +1232,33 @@ KIARA_Context * kiaraNewContext()
     return KIARA::Impl::wrap(new KIARA::Impl::Context);
 }
 
+KIARA_Context * kiaraNewContextFromSnapshot(const char *fileName)
+{
+    if (!KIARA::Impl::Global::isInitialized() || !fileName)
+        return 0;
+    KIARA::Impl::Context *context = new KIARA::Impl::Context;
+    if (!context->restoreSnapshot(fileName))
+    {
+        DFC_DEBUG("Could not restore context from snapshot: "<<context->getErrorMessage());
+        delete context;
+        return 0;
+    }
+    return KIARA::Impl::wrap(context);
+}
+
+KIARA_Result kiaraSaveContextSnapshot(KIARA_Context *context, const char *fileName)
+{
+    assert(context != 0);
+    if (!fileName)
+    {
+        KIARA::Impl::unwrap(context)->setError(KIARA_INVALID_ARGUMENT, "Snapshot file name is NULL");
+        return KIARA_INVALID_ARGUMENT;
+    }
+    if (!KIARA::Impl::unwrap(context)->saveSnapshot(fileName))
+        return KIARA::Impl::unwrap(context)->getErrorCode();
+    return KIARA_SUCCESS;
+}
+
 int kiaraFreeContext(KIARA_Context *context)
 {
     delete KIARA::Impl::unwrap(context);
@@ -1038,6 +1435,80 @@ KIARA_FuncObj * kiaraGenerateClientFuncObj(KIARA_Connection *connection, const c
     return KIARA::Impl::unwrap(connection)->generateClientFuncObj(idlMethodName, declTypeGetter, mapping);
 }
 
+KIARA_Result kiaraFreeFuncObj(KIARA_FuncObj *funcObj)
+{
+    assert(funcObj != 0 && funcObj->base.connection != 0);
+    if (!KIARA::Impl::unwrap(funcObj->base.connection)->freeFuncObj(funcObj))
+        return KIARA_INVALID_ARGUMENT;
+    return KIARA_SUCCESS;
+}
+
+KIARA_Result kiaraSendConnectionData(KIARA_Connection *conn, const void *data, size_t dataSize, kr_dbuffer_t *destBuf)
+{
+    assert(conn != 0);
+    return KIARA::Impl::unwrap(conn)->sendData(data, dataSize, destBuf);
+}
+
+static void copyJITStatistics(const KIARA::JITStatistics &src, KIARA_JITStatistics *dest)
+{
+    dest->codeSize = src.codeSize;
+    dest->dataSize = src.dataSize;
+    dest->numStages = src.numStages;
+}
+
+KIARA_Result kiaraGetConnectionJITStatistics(KIARA_Connection *connection, KIARA_JITStatistics *stats)
+{
+    assert(connection != 0 && stats != 0);
+    copyJITStatistics(KIARA::Impl::unwrap(connection)->getRuntimeEnvironment().getJITStatistics(), stats);
+    return KIARA_SUCCESS;
+}
+
+KIARA_Result kiaraGetContextJITStatistics(KIARA_Context *ctx, KIARA_JITStatistics *stats)
+{
+    assert(ctx != 0 && stats != 0);
+    copyJITStatistics(KIARA::Impl::unwrap(ctx)->getRuntimeContext().getJITStatistics(), stats);
+    return KIARA_SUCCESS;
+}
+
+const char * kiaraGetContextJITTelemetry(KIARA_Context *ctx)
+{
+    assert(ctx != 0);
+    return KIARA::Impl::unwrap(ctx)->getJITTelemetryJSON().c_str();
+}
+
+size_t kiaraGetConnectionNumJITCompileRecords(KIARA_Connection *connection)
+{
+    assert(connection != 0);
+    return KIARA::Impl::unwrap(connection)->getRuntimeEnvironment().getJITCompileRecords().size();
+}
+
+KIARA_Result kiaraGetConnectionJITCompileRecord(KIARA_Connection *connection, size_t index, KIARA_JITCompileRecord *record)
+{
+    assert(connection != 0 && record != 0);
+    const KIARA::JITCompileRecordList &records =
+        KIARA::Impl::unwrap(connection)->getRuntimeEnvironment().getJITCompileRecords();
+    if (index >= records.size())
+        return KIARA_INVALID_ARGUMENT;
+
+    const KIARA::JITCompileRecord &src = records[index];
+    record->name = src.name.c_str();
+    record->kind = src.kind.c_str();
+    record->irgenTime = src.irgenTime;
+    record->evalTime = src.evalTime;
+    record->optTime = src.optTime;
+    record->linkTime = src.linkTime;
+    record->finalizeTime = src.finalizeTime;
+    record->codeSize = src.codeSize;
+    record->numLinkedExterns = src.numLinkedExterns;
+    return KIARA_SUCCESS;
+}
+
+const char * kiaraGetConnectionJITTelemetry(KIARA_Connection *connection)
+{
+    assert(connection != 0);
+    return KIARA::Impl::unwrap(connection)->getJITTelemetryJSON().c_str();
+}
+
 KIARA_Type * kiaraDeclareOpaqueType(KIARA_Context *ctx, const char *name)
 {
     // TODO implement
@@ -1225,12 +1696,98 @@ KIARA_Result kiaraRunServer(KIARA_Server * server)
     return KIARA::Impl::unwrap(server)->run();
 }
 
+// Publish/Subscribe
+
+KIARA_Connection * kiaraNewPublisher(KIARA_Context *context, const char *url, const char *protocol)
+{
+    assert(context != 0 && url != 0 && protocol != 0);
+    if (KIARA::Impl::unwrap(context)->isError())
+        return 0;
+
+    std::auto_ptr<KIARA::Impl::Publisher> publisher(
+        new KIARA::Impl::Publisher(KIARA::Impl::unwrap(context), url, protocol));
+    if (publisher->isError())
+    {
+        KIARA::Impl::unwrap(context)->setError(publisher->getErrorCode(), publisher->getErrorMessage());
+        publisher.reset();
+    }
+
+    return KIARA::Impl::wrap(publisher.release());
+}
+
+KIARA_Result kiaraLoadPublisherIDLFromString(KIARA_Connection *publisher, const char *idlLanguage, const char *idlContents)
+{
+    assert(publisher != 0);
+    KIARA::Impl::Publisher *p = dynamic_cast<KIARA::Impl::Publisher*>(KIARA::Impl::unwrap(publisher));
+    if (!p)
+        return KIARA_INVALID_ARGUMENT;
+    return p->loadIDLFromString(idlLanguage, idlContents);
+}
+
+KIARA_Result kiaraSetPublisherTopic(KIARA_Connection *publisher, const char *topic)
+{
+    assert(publisher != 0 && topic != 0);
+    KIARA::Impl::Publisher *p = dynamic_cast<KIARA::Impl::Publisher*>(KIARA::Impl::unwrap(publisher));
+    if (!p)
+        return KIARA_INVALID_ARGUMENT;
+    p->setTopic(topic);
+    return KIARA_SUCCESS;
+}
+
+KIARA_Subscriber * kiaraSubscribe(KIARA_Context *context, const char *url, const char *protocol, const char *topic, KIARA_Service *service)
+{
+    assert(context != 0 && url != 0 && protocol != 0 && service != 0);
+    if (KIARA::Impl::unwrap(context)->isError())
+        return 0;
+
+    std::auto_ptr<KIARA::Impl::Subscriber> subscriber(
+        new KIARA::Impl::Subscriber(KIARA::Impl::unwrap(context), url, protocol,
+                                    topic ? topic : "", KIARA::Impl::unwrap(service)));
+    if (subscriber->isError())
+    {
+        KIARA::Impl::unwrap(context)->setError(subscriber->getErrorCode(), subscriber->getErrorMessage());
+        subscriber.reset();
+    }
+
+    return KIARA::Impl::wrap(subscriber.release());
+}
+
+const char * kiaraGetSubscriberError(KIARA_Subscriber *subscriber)
+{
+    assert(subscriber != 0);
+    return KIARA::Impl::unwrap(subscriber)->getErrorMessage();
+}
+
+KIARA_Result kiaraRunSubscriber(KIARA_Subscriber *subscriber)
+{
+    assert(subscriber != 0);
+    return KIARA::Impl::unwrap(subscriber)->run();
+}
+
+void kiaraStopSubscriber(KIARA_Subscriber *subscriber)
+{
+    assert(subscriber != 0);
+    KIARA::Impl::unwrap(subscriber)->stop();
+}
+
+KIARA_Result kiaraFreeSubscriber(KIARA_Subscriber *subscriber)
+{
+    delete KIARA::Impl::unwrap(subscriber);
+    return KIARA_SUCCESS;
+}
+
 const char * kiaraGetSecretKeyText(KIARA_Connection *connection, const char *keyName)
 {
     assert(connection != 0);
     return KIARA::Impl::unwrap(connection)->getContext()->getSecurityConfiguraton().encryptionPassword.c_str();
 }
 
+const char * kiaraGetSecretKeyCipherName(KIARA_Connection *connection, const char *keyName)
+{
+    assert(connection != 0);
+    return KIARA::Impl::unwrap(connection)->getContext()->getSecurityConfiguraton().encryptionCipher.c_str();
+}
+
 // Version
 
 int kiaraGetVersionMajor(void)
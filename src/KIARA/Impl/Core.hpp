@@ -20,17 +20,23 @@
 #define KIARA_IMPL_CORE_HPP_INCLUDED
 
 #include <KIARA/Common/Config.hpp>
+#include <KIARA/Common/stdint.h>
 #include <KIARA/kiara.h>
 #include <KIARA/kiara_macros.h>
 #include <KIARA/Core/LibraryInit.hpp>
 #include <KIARA/DB/Module.hpp>
 #include <KIARA/Transport/Server.hpp>
+#include <KIARA/Transport/ConnectionPool.hpp>
 #include <KIARA/DB/LibraryConfiguration.hpp>
 #include <KIARA/Utils/ServerConfiguration.hpp>
+#include <KIARA/Utils/ContextSnapshot.hpp>
 #include <KIARA/Utils/PathFinder.hpp>
 #include <KIARA/Utils/URLLoader.hpp>
 #include <boost/asio/io_service.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include <set>
+#include <map>
 #include "API.h"
 
 namespace KIARA
@@ -58,6 +64,16 @@ public:
 
     static KIARA::JITConfiguration getJITConfiguration() { return libraryConfiguration_.getJITConfiguration(); }
 
+    static KIARA::ConnectionPoolConfiguration getConnectionPoolConfiguration() { return libraryConfiguration_.getConnectionPoolConfiguration(); }
+
+    static KIARA::WorkerPoolConfiguration getWorkerPoolConfiguration() { return libraryConfiguration_.getWorkerPoolConfiguration(); }
+
+    static KIARA::PubSubConfiguration getPubSubConfiguration() { return libraryConfiguration_.getPubSubConfiguration(); }
+
+    static KIARA::SharedMemoryConfiguration getSharedMemoryConfiguration() { return libraryConfiguration_.getSharedMemoryConfiguration(); }
+
+    static KIARA::LocalTransportConfiguration getLocalTransportConfiguration() { return libraryConfiguration_.getLocalTransportConfiguration(); }
+
 private:
     static bool initialized_;
     static LibraryConfiguration libraryConfiguration_;
@@ -109,12 +125,44 @@ private:
     std::string message_;
 };
 
+/// Error state kept separately for each thread. Objects can be used
+/// from multiple threads, each thread sees only errors of its own calls.
+/// Errors are stored in a thread local map under an id that is never
+/// reused. After the object was destroyed each thread drops its error
+/// on its next access to any ThreadError, or when it exits.
+class ThreadError
+{
+public:
+
+    ThreadError();
+
+    ~ThreadError();
+
+    Error & get() const;
+
+private:
+    uint64_t id_;
+
+    ThreadError(const ThreadError &);
+    ThreadError & operator=(const ThreadError &);
+};
+
 class Context : public KIARA::World
 {
 public:
 
     typedef std::map<const KIARA_DeclType *, KIARA::TypePtr> DeclCacheMap;
 
+    /// Server configuration received by a client connection
+    struct CachedServerConfiguration
+    {
+        std::string etag;           // entity tag sent by the server, may be empty
+        uint64_t contentHash;       // ContentHash of the JSON text
+        KIARA::ServerConfiguration configuration;
+
+        CachedServerConfiguration() : etag(), contentHash(0), configuration() { }
+    };
+
     Context();
 
     virtual ~Context();
@@ -128,22 +176,22 @@ public:
 
     const KIARA::Module::Ptr & getModule() const { return module_; }
 
-    Error & getError() { return error_; }
+    Error & getError() { return error_.get(); }
 
-    const Error & getError() const { return error_; }
+    const Error & getError() const { return error_.get(); }
 
-    bool isError() const { return error_.isError(); }
+    bool isError() const { return error_.get().isError(); }
 
-    const char * getErrorMessage() const { return error_.getMessage(); }
+    const char * getErrorMessage() const { return error_.get().getMessage(); }
 
-    KIARA_Result getErrorCode() const { return error_.getErrorCode(); }
+    KIARA_Result getErrorCode() const { return error_.get().getErrorCode(); }
 
     void setError(KIARA_Result errorCode, const std::string &errorMessage)
     {
-        error_.set(errorCode, errorMessage);
+        error_.get().set(errorCode, errorMessage);
     }
 
-    void clearError() { error_.clear(); }
+    void clearError() { error_.get().clear(); }
 
     KIARA_Type * wrapType(const KIARA::Type::Ptr &type)
     {
@@ -195,29 +243,70 @@ public:
 
     bool loadIDL(const std::string &fileName);
     bool loadIDL(std::istream &in, const std::string &fileName);
+    /// IDL texts are content addressed: loading of an already loaded
+    /// text succeeds without parsing and reuses the registered types.
+    /// Concurrent loads of the same text wait for the first one.
+    bool loadIDL(const char *begin, const char *end, const std::string &fileName);
     bool loadIDLFromURL(const std::string &url);
     bool loadIDLFromURL(KIARA::URLLoader::Connection * handle, const std::string &url);
 
+    /// Returns true when the IDL text with the ContentHash (as hex string) was loaded
+    bool isIDLLoaded(const std::string &idlHash) const;
+
+    /// Server configurations are cached per server URL for revalidation
+    bool getCachedServerConfiguration(const std::string &uri, CachedServerConfiguration &dest) const;
+    void cacheServerConfiguration(const std::string &uri, const CachedServerConfiguration &src);
+
     KIARA_Result loadLLVMModule(const std::string &fileName);
 
-    const std::vector<std::string> & getLLVMModuleNames() const { return llvmModuleNames_; }
+    std::vector<std::string> getLLVMModuleNames() const;
+
+    /// Returns pool of transport connections shared by client connections,
+    /// null when pooling is disabled by the library configuration.
+    const KIARA::Transport::ConnectionPool::Ptr & getConnectionPool();
 
     KIARA::RuntimeContext & getRuntimeContext()
     {
         return *runtimeContext_;
     }
 
+    /// Returns JIT telemetry of all environments as JSON,
+    /// string is valid until the next call.
+    const std::string & getJITTelemetryJSON();
+
+    /// Writes loaded IDL, LLVM module names, cached server configurations
+    /// and runtime cache files used by this context to a snapshot file.
+    bool saveSnapshot(const std::string &fileName);
+
+    /// Restores state saved by saveSnapshot into this (new) context.
+    bool restoreSnapshot(const std::string &fileName);
+
 private:
     KIARA::SecurityConfiguration securityConfiguration_;
     KIARA::Module::Ptr module_;
-    Error error_;
+    ThreadError error_;
     KIARA::TypeSet types_;
     DeclCacheMap declCacheMap_;
 
+    // cacheMutex_ guards the IDL and server configuration caches and
+    // llvmModuleNames_, it is never held while IDL is parsed.
+    mutable boost::mutex cacheMutex_;
+    boost::condition_variable idlLoadedCond_;
+    std::set<std::string> loadingIDLHashes_;
+    std::set<std::string> loadedIDLHashes_;
+    std::vector<ContextSnapshot::IDLEntry> loadedIDLs_; // in load order
+    std::map<std::string, CachedServerConfiguration> serverConfigurationCache_;
+
     KIARA::RuntimeContext *runtimeContext_;
 //    boost::asio::io_service ioService_;
     KIARA::Transport::AsioNetworkContext::Ptr ioService_;
+    KIARA::Transport::ConnectionPool::Ptr connectionPool_;
+    bool connectionPoolCreated_;
     std::vector<std::string> llvmModuleNames_;
+    std::string jitTelemetryJSON_;
+
+    /// Marks the IDL as loaded when entry is not 0 and wakes up waiting loads
+    void finishIDLLoad(const std::string &idlHash, const ContextSnapshot::IDLEntry *entry);
 };
 
 class Base
@@ -235,31 +324,31 @@ public:
         return *getContext();
     }
 
-    Error & getError() { return error_; }
+    Error & getError() { return error_.get(); }
 
-    const Error & getError() const { return error_; }
+    const Error & getError() const { return error_.get(); }
 
-    bool isError() const { return error_.isError(); }
+    bool isError() const { return error_.get().isError(); }
 
-    const char * getErrorMessage() const { return error_.getMessage(); }
+    const char * getErrorMessage() const { return error_.get().getMessage(); }
 
-    KIARA_Result getErrorCode() const { return error_.getErrorCode(); }
+    KIARA_Result getErrorCode() const { return error_.get().getErrorCode(); }
 
     void setError(KIARA_Result errorCode, const std::string &errorMessage)
     {
-        error_.set(errorCode, errorMessage);
+        error_.get().set(errorCode, errorMessage);
     }
 
     void setError(const Error &error)
     {
-        error_ = error;
+        error_.get() = error;
     }
 
-    void clearError() { error_.clear(); }
+    void clearError() { error_.get().clear(); }
 
 protected:
 
-    Error error_;
+    ThreadError error_;
 
 private:
     Context *context_;
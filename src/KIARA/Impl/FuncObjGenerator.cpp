@@ -29,6 +29,7 @@
 #include <KIARA/Impl/Core.hpp>
 #include <KIARA/Impl/Network.hpp>
 #include <KIARA/Impl/Interpreter.hpp>
+#include <KIARA/Impl/SerializationProgram.hpp>
 #include <KIARA/Core/Exception.hpp>
 #include <KIARA/IDL/IDLParserContext.hpp>
 #include <KIARA/Compiler/PrettyPrinter.hpp>
@@ -182,6 +183,43 @@ KIARA_FuncObj * Connection::generateClientFuncObj(const char *idlMethodName, KIA
 
     DFC_DEBUG(*fty);
 
+    // one-way messages are never answered, nothing can be returned to the caller
+    if (isOneway())
+    {
+        if (serviceMethodType->getReturnType() != KIARA::VoidType::get(getWorld()))
+        {
+            setError(KIARA_INVALID_ARGUMENT,
+                    std::string("one-way method '")+serviceMethodName+"' must return void");
+            return 0;
+        }
+        if (nativeMap.find("$result") != nativeMap.end() || nativeMap.find("$exception") != nativeMap.end())
+        {
+            setError(KIARA_INVALID_ARGUMENT,
+                    std::string("one-way method '")+serviceMethodName+"' can't have output parameters");
+            return 0;
+        }
+    }
+
+    if (!getRuntimeEnvironment().isCompilationSupported())
+    {
+        // compilation is not supported, use serialization interpreter
+        ClientCallProgram *program = new ClientCallProgram;
+        if (!program->compile(getRuntimeEnvironment(), serviceMethodName, serviceMethodType, fty, isOneway(), getError()))
+        {
+            delete program;
+            return 0;
+        }
+
+        KIARA_FuncObj *fobj = createFuncObj();
+        fobj->base.vafunc = KIARA_Interpreter;
+        fobj->base.funcType = getContext()->wrapType(fty);
+        fobj->base.userData.p = program;
+        fobj->func = fty->getAttributeValue<KIARA::WrapperFuncAttr>();
+
+        funcObjects_[fty] = fobj;
+        return fobj;
+    }
+
     using namespace KIARA::Compiler;
 
     DFC_DEBUG("INFO: Creating wrapper for function: "<<*fty);
@@ -288,9 +326,12 @@ KIARA_FuncObj * Connection::generateClientFuncObj(const char *idlMethodName, KIA
 
 
         TBlock ioBlock = NamedBlock("ioBlock", getWorld());
-        // send message
+        // send message, one-way messages have no response
         ioBlock->addExpr(
-            assign(statusVar, sendMessageSync(connVar, msgVar, msgVar)));
+            assign(statusVar, sendMessageSync(connVar, msgVar,
+                                              isOneway() ?
+                                              TExpr(KIARA::IR::PrimLiteral::getNullPtr(getWorld())) :
+                                              TExpr(msgVar))));
 
         // get types
         KIARA::Type::Ptr resultIDLType = serviceMethodType->getReturnType();
@@ -308,7 +349,7 @@ KIARA_FuncObj * Connection::generateClientFuncObj(const char *idlMethodName, KIA
         }
 
         // exception handling
-        if (exceptionNativeType)
+        if (exceptionNativeType && !isOneway())
         {
             TExpr exceptionExpr = builder.lookupExpr("$exception");
             BOOST_ASSERT(exceptionExpr->getExprType() == exceptionNativeType);
@@ -333,7 +374,11 @@ KIARA_FuncObj * Connection::generateClientFuncObj(const char *idlMethodName, KIA
 
         // generate deserialization of outputs
 
-        if (resultIDLType != KIARA::VoidType::get(getWorld()))
+        if (isOneway())
+        {
+            // results of one-way messages are never received
+        }
+        else if (resultIDLType != KIARA::VoidType::get(getWorld()))
         {
             if (resultNativeType)
             {
@@ -375,21 +420,11 @@ KIARA_FuncObj * Connection::generateClientFuncObj(const char *idlMethodName, KIA
     DFC_DEBUG("FUNC : "<<func->toString());
 
     KIARA_FuncObj *fobj = createFuncObj();
-    if (getRuntimeEnvironment().isCompilationSupported())
-    {
-        void *funcPtr = getRuntimeEnvironment().compileFunction(func, genCtx, "KIARA_FUNC");
-        assert(funcPtr != 0);
+    void *funcPtr = getRuntimeEnvironment().compileFunction(func, genCtx, "KIARA_FUNC");
+    assert(funcPtr != 0);
 
-        fobj->func = (KIARA_Func)funcPtr;
-        fobj->base.funcType = getContext()->wrapType(fty);
-    }
-    else
-    {
-        // compilation is not supported
-        fobj->base.vafunc = KIARA_Interpreter; // interpreter
-        fobj->base.funcType = getContext()->wrapType(fty);
-        fobj->func = fty->getAttributeValue<KIARA::WrapperFuncAttr>();
-    }
+    fobj->func = (KIARA_Func)funcPtr;
+    fobj->base.funcType = getContext()->wrapType(fty);
 
     funcObjects_[fty] = fobj;
     return fobj;
@@ -31,8 +31,14 @@
 
 extern "C" {
 
+/// Client function of func objects created without JIT,
+/// userData.p is a KIARA::Impl::ClientCallProgram
 int KIARA_Interpreter(KIARA_FuncObj * closure, void *args[], size_t num_args);
 
+/// Synchronous handler of service func objects created without JIT,
+/// userData.p is a KIARA::Impl::ServiceCallProgram
+KIARA_Result KIARA_ServiceInterpreter(KIARA_ServiceFuncObj *closure, KIARA_Message *outMsg, KIARA_Message *inMsg);
+
 }
 
 #endif /* KIARA_KIARA_IMPL_INTERPRETER_IMPL_HPP_INCLUDED */
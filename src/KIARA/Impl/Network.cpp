@@ -24,17 +24,24 @@
  */
 
 #include "Network.hpp"
+#include "Interpreter.hpp"
+#include "SerializationProgram.hpp"
 #include <KIARA/Runtime/RuntimeContext.hpp>
 #include <KIARA/Runtime/RuntimeEnvironment.hpp>
 #include <KIARA/Utils/URL.hpp>
+#include <KIARA/Utils/Hash.hpp>
 #include <KIARA/IDL/IDLWriter.hpp>
 #include <KIARA/Transport/Transport.hpp>
 #include <KIARA/Transport/HttpTransport.hpp>
 #include <KIARA/Transport/TcpBlockTransport.hpp>
+#include <KIARA/Transport/ShmTransport.hpp>
+#include <KIARA/Transport/ZmqLocalTransport.hpp>
 #include <KIARA/CDT/kr_dumpdata.h>
 #include <uriparser/Uri.h>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
+#include <cstring>
 #include <unistd.h>
 #include "../Transport/KT_Zeromq.hpp"
 #include "../Transport/KT_HTTP_Parser.hpp"
@@ -53,7 +60,7 @@ namespace Impl
 	
 void callback_handler ( KIARA::Transport::KT_Msg&, KIARA::Transport::KT_Session*, KIARA::Transport::KT_Connection* );
 
-DBuffer* callback_handler_mt ( KIARA::Transport::KT_Msg&, KIARA::Transport::KT_Session*, KIARA::Transport::KT_Connection* );
+void callback_handler_mt ( const DBuffer&, DBuffer&, KIARA::Transport::KT_Session*, KIARA::Transport::KT_Connection* );
 	
 /// Connection
 
@@ -64,6 +71,7 @@ Connection::Connection(Context *context, const std::string &transportName)
     , transportName_(transportName)
     , runtimeEnvironment_(0)
     , transportConnection_()
+    , sendData_(0)
 {
 }
 
@@ -86,14 +94,78 @@ KIARA_FuncObj * Connection::createFuncObj()
     fobj->base.vafunc = 0;
     fobj->base.connection = wrap(this);
     fobj->base.funcType = 0;
+    fobj->base.userData.p = 0;
     return fobj;
 }
 
 void Connection::destroyFuncObj(KIARA_FuncObj *funcObj)
 {
+    // release compiled code or interpreter program
+    if (funcObj->base.vafunc == KIARA_Interpreter)
+        delete static_cast<ClientCallProgram*>(funcObj->base.userData.p);
+    else if (funcObj->func && !funcObj->base.vafunc && runtimeEnvironment_)
+        runtimeEnvironment_->releaseFunction((void*)funcObj->func);
     delete funcObj;
 }
 
+KIARA_Result Connection::sendData(const void *data, size_t dataSize, kr_dbuffer_t *destBuf)
+{
+    if (!sendData_)
+        return KIARA_FAILURE;
+    return sendData_(wrap(this), data, dataSize, destBuf);
+}
+
+KIARA_Result Connection::callTransport(const void *data, size_t dataSize, kr_dbuffer_t *destBuf)
+{
+    if (!transportConnection_)
+    {
+        setError(KIARA_NETWORK_ERROR, "No transport connection");
+        return KIARA_NETWORK_ERROR;
+    }
+
+    // Request is borrowed, destination buffer is swapped in and out
+    const DBuffer request(const_cast<void*>(data), dataSize, dataSize, DBuffer::dont_free_tag());
+    DBuffer response;
+    response.swap(destBuf);
+
+    std::string errorMsg;
+    bool success = transportConnection_->call(request, response, &errorMsg);
+
+    response.swap(destBuf);
+
+    if (!success)
+    {
+        setError(KIARA_NETWORK_ERROR, errorMsg);
+        return KIARA_NETWORK_ERROR;
+    }
+    return KIARA_SUCCESS;
+}
+
+const std::string & Connection::getJITTelemetryJSON()
+{
+    std::ostringstream out;
+    KIARA::writeJITTelemetryJSON(out,
+                                 getRuntimeEnvironment().getJITStatistics(),
+                                 getRuntimeEnvironment().getJITCompileRecords());
+    jitTelemetryJSON_ = out.str();
+    return jitTelemetryJSON_;
+}
+
+bool Connection::freeFuncObj(KIARA_FuncObj *funcObj)
+{
+    for (FuncObjMap::iterator it = funcObjects_.begin(), end = funcObjects_.end();
+            it != end; ++it)
+    {
+        if (it->second == funcObj)
+        {
+            funcObjects_.erase(it);
+            destroyFuncObj(funcObj);
+            return true;
+        }
+    }
+    return false;
+}
+
 // ClientConnection
 
 ClientConnection::ClientConnection(Context *context, const std::string &uri)
@@ -149,8 +221,15 @@ ClientConnection::ClientConnection(Context *context, const std::string &uri)
 		std::cerr << "Session object was not set" << std::endl;
 	}
 
+    // revalidate cached configuration of the server
+    Context::CachedServerConfiguration cachedConfig;
+    const bool isCached = context->getCachedServerConfiguration(uri, cachedConfig);
+
 	KIARA::Transport::KT_Msg request;
-	std::string payload ( "GET /service HTTP/1.1\r\nUser-Agent: KIARA\r\nHost: localhost:5555\r\n\r\n" );
+	std::string payload ( "GET /service HTTP/1.1\r\nUser-Agent: KIARA\r\nHost: localhost:5555\r\n" );
+	if (isCached && !cachedConfig.etag.empty())
+		payload += "If-None-Match: " + cachedConfig.etag + "\r\n";
+	payload += "\r\n";
 
 	request.set_payload(payload);
 
@@ -172,22 +251,44 @@ ClientConnection::ClientConnection(Context *context, const std::string &uri)
         setError(KIARA_CONNECTION_ERROR, "Could not load server configuration");
         return;
     }*/
-    KIARA::ServerConfiguration serverConfig;
-	
-    if (!serverConfig.fromJSON(parser.get_payload()))
+
+    if (isCached && parser.get_status_code() == 304)
     {
-        KIARA::URLLoader::deleteConnection(urlLoaderConnection_);
-        urlLoaderConnection_ = 0;
-        setError(KIARA_CONNECTION_ERROR, "Could not parse server configuration");
-        return;
+        DFC_DEBUG("Server configuration of "<<uri<<" not modified");
+    }
+    else
+    {
+        serverConfigText = parser.get_payload();
+        const uint64_t contentHash = KIARA::ContentHash::hash(serverConfigText);
+
+        // servers without entity tags are revalidated by the content
+        if (!isCached || contentHash != cachedConfig.contentHash)
+        {
+            if (!cachedConfig.configuration.fromJSON(serverConfigText))
+            {
+                KIARA::URLLoader::deleteConnection(urlLoaderConnection_);
+                urlLoaderConnection_ = 0;
+                setError(KIARA_CONNECTION_ERROR, "Could not parse server configuration");
+                return;
+            }
+            cachedConfig.contentHash = contentHash;
+        }
+        cachedConfig.etag = parser.get_etag();
+        context->cacheServerConfiguration(uri, cachedConfig);
     }
 
-    // load IDL
+    KIARA::ServerConfiguration &serverConfig = cachedConfig.configuration;
 
-    if (!serverConfig.idlContents.empty())
+    // load IDL, types of an already loaded IDL are reused
+
+    if (!serverConfig.idlHash.empty() && context->isIDLLoaded(serverConfig.idlHash))
+    {
+        DFC_DEBUG("IDL of "<<uri<<" is already loaded");
+    }
+    else if (!serverConfig.idlContents.empty())
     {
-        std::istringstream iss(serverConfig.idlContents);
-        if (!context->loadIDL(iss, uri))
+        const std::string &idl = serverConfig.idlContents;
+        if (!context->loadIDL(idl.data(), idl.data() + idl.size(), uri))
         {
             setError(KIARA_CONNECTION_ERROR, "Could not parse IDL from configuration string");
             return;
@@ -231,6 +332,10 @@ ClientConnection::ClientConnection(Context *context, const std::string &uri)
 
         const Transport::Transport *t = Transport::Transport::getTransportByName(si.transport.name.c_str());
 
+        // skip transports that can't reach the server, e.g. shared memory of a remote host
+        if (t && !t->isAvailable(KIARA::URL::resolve(uri, si.transport.url)))
+            continue;
+
         if (t)
         {
             // we change selected endpoint only if priority is higher
@@ -284,6 +389,7 @@ ClientConnection::ClientConnection(Context *context, const std::string &uri)
     //getRuntimeEnvironment().registerExternalFunction("getConnection", (void*)nh.getConnection);
     //getRuntimeEnvironment().registerExternalFunction("getServiceConnection", (void*)nh.getServiceConnection);
     getRuntimeEnvironment().registerExternalFunction("sendData", (void*)nh.sendData);
+    sendData_ = nh.sendData;
 
     URL configUrl(uri);
     if (!configUrl.isValid())
@@ -296,8 +402,21 @@ ClientConnection::ClientConnection(Context *context, const std::string &uri)
 
     DFC_DEBUG("Open connection to: "<<uri_);
 
+    // TCP connections to the same peer share pooled sockets
     boost::system::error_code ec;
-    setTransportConnection(transport->openConnection(uri_, context->getIOService(), &ec));
+    URL transportUrl(uri_);
+    KIARA::Transport::ConnectionPool::Ptr pool;
+    if (strcmp(transport->getName(), "tcp") == 0)
+        pool = context->getConnectionPool();
+    if (pool && transportUrl.isValid())
+    {
+        setTransportConnection(pool->openConnection(transportUrl.host,
+            static_cast<unsigned short>(atoi(transportUrl.port.c_str())), &ec));
+    }
+    else
+    {
+        setTransportConnection(transport->openConnection(uri_, context->getIOService(), &ec));
+    }
     if (ec)
     {
         setError(KIARA_NETWORK_ERROR, boost::lexical_cast<std::string>(ec));
@@ -307,6 +426,12 @@ ClientConnection::ClientConnection(Context *context, const std::string &uri)
         (KIARA_GetMimeType)(intptr_t)
         getRuntimeEnvironment().requestPointerToFunction("getMimeType");
     mimeType_ = getMimeType_();
+
+    if (KIARA::Transport::HttpClientConnection::Ptr httpConn =
+        boost::dynamic_pointer_cast<KIARA::Transport::HttpClientConnection>(getTransportConnection()))
+    {
+        httpConn->setContentType(mimeType_);
+    }
 }
 
 ClientConnection::ClientConnection(
@@ -429,6 +554,8 @@ Server::Server(
     , configHost_(address)
     , configPort_(port)
     , configPath_(configPath)
+    , idlContentsValid_(false)
+    , configGeneration_(0)
 {
     // listen for negotiation connections
     addPortListener(configHost_, configPort_, "http");
@@ -436,6 +563,13 @@ Server::Server(
 
 Server::~Server()
 {
+    // no shared memory requests must be running while service handlers are deleted
+    for (TransportEntryList::iterator it = transportEntries_.begin(), end = transportEntries_.end(); it != end; ++it)
+    {
+        if (it->second->shmServer)
+            it->second->shmServer->stop();
+    }
+
     for (ServiceHandlerMap::iterator it = serviceHandlers_.begin(), end = serviceHandlers_.end(); it != end; ++it)
     {
         delete it->second;
@@ -463,6 +597,13 @@ bool Server::addPortListener(const std::string &host, unsigned int port, const s
     const Transport::Transport *transport =
         Transport::Transport::getTransportByName(transportName.c_str());
 
+    if (dynamic_cast<const Transport::ZmqLocalTransport *>(transport))
+    {
+        setError(KIARA_NETWORK_ERROR, "Transport "+transportName
+            +" is served together with tcp, use a tcp URL for port "+boost::lexical_cast<std::string>(port));
+        return false;
+    }
+
     TransportEntry::Ptr tentry(new TransportEntry(transport));
     transportEntries_[hostAndPort] = tentry;
     /*listen(host, boost::lexical_cast<std::string>(port),
@@ -479,16 +620,35 @@ bool Server::addPortListener(const std::string &host, unsigned int port, const s
 		std::cout << "Server::addPortListener TCP: "<<host<<":"<<port<<" "<<transportName << std::endl;
 		config.set_application_type ( KT_REQUESTREPLYMT );
 	}
+	KIARA::WorkerPoolConfiguration workerPoolConfig = Global::getWorkerPoolConfiguration();
+	config.set_worker_threads( workerPoolConfig.numWorkers );
+	config.set_cpu_affinity( workerPoolConfig.cpuAffinity );
 	config.set_transport_layer( KT_TCP );
 	config.set_hostname( host );
 	config.set_port_number( port );
 	config.set_config_path(configPath_);
 
+	// The router of a tcp port also serves clients in the same process and
+	// on the same host over ZeroMQ inproc and ipc endpoints
+	if(!transportName.compare("tcp")) {
+		KIARA::LocalTransportConfiguration localConfig = Global::getLocalTransportConfiguration();
+		const char *localTransportNames[] = { "inproc", "ipc" };
+		for (size_t i = 0; i < sizeof(localTransportNames) / sizeof(localTransportNames[0]); ++i) {
+			const Transport::ZmqLocalTransport *localTransport = static_cast<const Transport::ZmqLocalTransport *>(
+				Transport::Transport::getTransportByName(localTransportNames[i]));
+			if (localTransport && localTransport->isEnabled(localConfig)) {
+				config.add_endpoint( localTransport->getTransportLayer(),
+					localTransport->getEndpointHostName(localConfig, host, port), port );
+				tentry->localTransports.push_back(localTransport);
+			}
+		}
+	}
+
 	KIARA::Transport::KT_Connection* connection = new KIARA::Transport::KT_Zeromq ();
 	connection->set_configuration (config);
 
 	if(connection->get_configuration().get_application_type() == KT_REQUESTREPLYMT) {
-		connection->register_callback_str( &callback_handler_mt );
+		connection->register_request_handler( &callback_handler_mt );
 	}
 	else {
 		connection->register_callback( &callback_handler );
@@ -498,109 +658,80 @@ bool Server::addPortListener(const std::string &host, unsigned int port, const s
 	
 	connection->get_session()->begin()->second->set_k_user_data(this);
 	//End ZMQ implementation
+
+	// Clients on the same host can call tcp services over shared memory
+	KIARA::SharedMemoryConfiguration shmConfig = Global::getSharedMemoryConfiguration();
+	if (!transportName.compare("tcp") && shmConfig.enabled)
+	{
+		Transport::ShmServer::Ptr shmServer(new Transport::ShmServer(shmConfig, port,
+			boost::bind(&Server::handleSharedMemoryRequest, this, host, port, _1, _2)));
+		std::string errorMsg;
+		if (shmServer->start(&errorMsg))
+			tentry->shmServer = shmServer;
+		else
+			DFC_DEBUG("Shared memory transport disabled for port "<<port<<": "<<errorMsg);
+	}
 	return true;
 }
 
-DBuffer* callback_handler_mt ( KIARA::Transport::KT_Msg& msg, KIARA::Transport::KT_Session* sess, KIARA::Transport::KT_Connection* connection ) {
-	std::string payload = "";
-	std::string res = "";
-	DBuffer *response = new DBuffer();
-	
+void Server::handleSharedMemoryRequest(const std::string &host, unsigned int port, const DBuffer &request, DBuffer &response)
+{
+	Transport::TcpBlockAddress::Ptr addr(
+		new Transport::TcpBlockAddress(host, port, Transport::Transport::getTransportByName("tcp")));
+
+	if (ServiceHandler *serviceHandler = findAcceptingServiceHandler(addr))
+	{
+		serviceHandler->performCall(0, request, response);
+	}
+}
+
+void callback_handler_mt ( const DBuffer& request, DBuffer& response, KIARA::Transport::KT_Session* sess, KIARA::Transport::KT_Connection* connection ) {
+	// Called concurrently by all worker threads of the port
 	Server *server = (Server*) sess->get_k_user_data();
 	
 	if(connection->get_configuration().get_application_type() == KT_REQUESTREPLYMT) {
-		std::vector<char> answer_vector = msg.get_payload();
-		std::string answer(answer_vector.begin(), answer_vector.end());
-		
-		KIARA::Transport::TcpBlockTransport *myTransport = new KIARA::Transport::TcpBlockTransport();
 		Transport::TcpBlockAddress::Ptr addr(
 			new Transport::TcpBlockAddress(
 				connection->get_configuration().get_hostname(),
 				connection->get_configuration().get_port_number(),
-				myTransport
+				Transport::Transport::getTransportByName("tcp")
 			)
 		);
 		
 		if (ServiceHandler *serviceHandler = server->findAcceptingServiceHandler(addr))
 		{
-			
-			serviceHandler->performCallZmq((const char*)msg.get_payload_binary(), msg.get_size(), response);
-			res.append(response->data());
-			
-			std::string res_final;
-			res_final = res.substr(0, response->size());
-			payload = res_final;
+			serviceHandler->performCall(0, request, response);
 		}
 	}
-	
-	return response;
 }
 
 void callback_handler ( KIARA::Transport::KT_Msg& msg, KIARA::Transport::KT_Session* sess, KIARA::Transport::KT_Connection* connection ) {
 	
 	std::string payload = "";
-	std::string res = "";
 	
 	Server *server = (Server*) sess->get_k_user_data();
 	
 	if(connection->get_configuration().get_application_type() == KT_STREAM) {
-		std::cout << "HTTP request handling" << std::endl;
-		KIARA::Transport::KT_HTTP_Parser parser (msg);
-		
-		if(parser.get_url().compare( 0, connection->get_configuration().get_config_path().length(), connection->get_configuration().get_config_path()) == 0)
-		{
-			KIARA::ServerConfiguration serverConfiguration;
-			server->generateServerConfiguration(serverConfiguration, connection->get_configuration().get_hostname(), "");
-			std::string config = serverConfiguration.toJSON();
-			payload = KIARA::Transport::KT_HTTP_Responder::generate_200_OK( std::vector<char> (config.begin(), config.end() ) );
-		}
-		else 
-		{
-			KIARA::Transport::HttpTransport *myTransport = new KIARA::Transport::HttpTransport();
-			Transport::HttpAddress::Ptr addr(
-				new Transport::HttpAddress(
-					connection->get_configuration().get_hostname(),
-					connection->get_configuration().get_port_number(),
-					parser.get_url().substr( 0, strlen(parser.get_url().c_str()) ),
-					myTransport
-				)
-			);
-			if (ServiceHandler *serviceHandler = server->findAcceptingServiceHandler(addr))
-			{
-				DBuffer *response = new DBuffer();
-				serviceHandler->performCallZmq(parser.get_payload().c_str(), strlen(parser.get_payload().c_str()), response);
-				res.append(response->data());
-
-				std::string res_final;
-				res_final = res.substr(0, response->size());
-
-				payload = KIARA::Transport::KT_HTTP_Responder::generate_200_OK( std::vector<char> (res_final.begin(), res_final.end() ) );
-			}
-		}
+		server->handleHttpStream(msg, sess, connection);
+		return;
 	}
 	if(connection->get_configuration().get_application_type() == KT_REQUESTREPLY) {
-		std::cout << "TCP request handling" << std::endl;
-		std::vector<char> answer_vector = msg.get_payload();
-		std::string answer(answer_vector.begin(), answer_vector.end());
+		std::vector<char> *body = msg.get_payload_ptr();
 		
-		KIARA::Transport::TcpBlockTransport *myTransport = new KIARA::Transport::TcpBlockTransport();
 		Transport::TcpBlockAddress::Ptr addr(
 			new Transport::TcpBlockAddress(
 				connection->get_configuration().get_hostname(),
 				connection->get_configuration().get_port_number(),
-				myTransport
+				Transport::Transport::getTransportByName("tcp")
 			)
 		);
 		
 		if (ServiceHandler *serviceHandler = server->findAcceptingServiceHandler(addr))
 		{
-			DBuffer *response = new DBuffer();
-			serviceHandler->performCallZmq(answer.c_str(), answer.length(), response);
-			res.append(response->data());
-			
-			std::string res_final;
-			res_final = res.substr(0, response->size());
-			payload = res_final;
+			const DBuffer request(body->empty() ? 0 : &(*body)[0], body->size(), body->size(), DBuffer::dont_free_tag());
+			DBuffer response;
+			serviceHandler->performCall(0, request, response);
+			payload.assign(response.begin(), response.end());
 		}
 	}
 
@@ -610,6 +741,135 @@ void callback_handler ( KIARA::Transport::KT_Msg& msg, KIARA::Transport::KT_Sess
 	connection->send ( message, (*sess), 0 );
 }
 
+void Server::handleHttpStream(Transport::KT_Msg &msg, Transport::KT_Session *sess, Transport::KT_Connection *connection)
+{
+    const std::vector<char> &peer = sess->get_identifier();
+    const std::vector<char> &received = *msg.get_payload_ptr();
+
+    HttpStream stream;
+    {
+        boost::mutex::scoped_lock lock(httpStreamsMutex_);
+        HttpStreamMap::iterator it = httpStreams_.find(peer);
+
+        // ZMQ_STREAM passes an empty message when a peer connects or disconnects
+        if (received.empty())
+        {
+            if (it != httpStreams_.end())
+                httpStreams_.erase(it);
+            return;
+        }
+
+        if (it != httpStreams_.end())
+        {
+            std::swap(stream, it->second);
+            httpStreams_.erase(it);
+        }
+    }
+
+    const char *data = &received[0];
+    size_t size = received.size();
+    bool keepAlive = true;
+    while (keepAlive && size > 0)
+    {
+        if (!stream.parser)
+            stream.parser.reset(new Transport::KT_HTTP_Parser());
+        Transport::KT_HTTP_Parser &parser = *stream.parser;
+
+        // the parser keeps its state, so every received byte is parsed once
+        const size_t parsedSize = parser.execute(data, size);
+        data += parsedSize;
+        size -= parsedSize;
+
+        std::string response;
+        if (!parser.is_header_complete() && parser.get_parsed_size() > MAX_HTTP_HEADER_SIZE)
+        {
+            const std::string reason("Request header too large");
+            response = Transport::KT_HTTP_Responder::generate_431_REQUEST_HEADER_FIELDS_TOO_LARGE(std::vector<char>(reason.begin(), reason.end()));
+            keepAlive = false;
+        }
+        else if (!parser.is_valid())
+        {
+            const std::string reason("Invalid HTTP request");
+            response = Transport::KT_HTTP_Responder::generate_400_BAD_REQUEST(std::vector<char>(reason.begin(), reason.end()));
+            keepAlive = false;
+        }
+        else if (parser.get_body_size() + parser.get_missing_size() > MAX_HTTP_BODY_SIZE)
+        {
+            // the announced Content-Length is rejected before the body is received
+            const std::string reason("Request body too large");
+            response = Transport::KT_HTTP_Responder::generate_413_PAYLOAD_TOO_LARGE(std::vector<char>(reason.begin(), reason.end()));
+            keepAlive = false;
+        }
+        else if (!parser.is_complete())
+        {
+            break;
+        }
+        else
+        {
+            response = handleHttpRequest(parser, connection);
+            keepAlive = parser.should_keep_alive();
+            stream.parser.reset();
+        }
+
+        Transport::KT_Msg message;
+        message.set_payload(response);
+        connection->send(message, *sess, 0);
+    }
+
+    if (!keepAlive)
+    {
+        // an empty message closes the connection of a ZMQ_STREAM socket,
+        // the state of the peer is dropped with stream
+        std::string empty;
+        Transport::KT_Msg message;
+        message.set_payload(empty);
+        connection->send(message, *sess, 0);
+        return;
+    }
+
+    if (stream.parser)
+    {
+        // wait for the rest of an incomplete request
+        boost::mutex::scoped_lock lock(httpStreamsMutex_);
+        std::swap(httpStreams_[peer], stream);
+    }
+}
+
+std::string Server::handleHttpRequest(Transport::KT_HTTP_Parser &parser, Transport::KT_Connection *connection)
+{
+    const Transport::KT_Configuration &portConfig = connection->get_configuration();
+
+    if (parser.get_url().compare(0, portConfig.get_config_path().length(), portConfig.get_config_path()) == 0)
+    {
+        ConfigurationResponse::Ptr config = getConfigurationResponse(portConfig.get_hostname());
+        if (matchesETag(parser.get_if_none_match(), config->etag))
+            return Transport::KT_HTTP_Responder::generate_304_NOT_MODIFIED(config->etag);
+        return Transport::KT_HTTP_Responder::generate_200_OK(config->json.data(), config->json.size(),
+            Transport::KT_HTTP_Responder::Content_Type::_application_json, config->etag);
+    }
+
+    Transport::HttpAddress::Ptr addr(
+        new Transport::HttpAddress(
+            portConfig.get_hostname(),
+            portConfig.get_port_number(),
+            parser.get_url(),
+            Transport::Transport::getTransportByName("http")
+        )
+    );
+    if (ServiceHandler *serviceHandler = findAcceptingServiceHandler(addr))
+    {
+        std::string body = parser.get_payload();
+        const DBuffer request(body.empty() ? 0 : &body[0], body.size(), body.size(), DBuffer::dont_free_tag());
+        DBuffer response;
+        serviceHandler->performCall(0, request, response);
+
+        return Transport::KT_HTTP_Responder::generate_200_OK(std::vector<char>(response.begin(), response.end()));
+    }
+
+    const std::string reason("No service at " + parser.get_url());
+    return Transport::KT_HTTP_Responder::generate_404_NOT_FOUND(std::vector<char>(reason.begin(), reason.end()));
+}
+
 Transport::RequestResult Server::handleRequest(
     Server::ServerConnectionHandler &handler,
     const Transport::Connection::Ptr &connection,
@@ -618,11 +878,10 @@ Transport::RequestResult Server::handleRequest(
 {
     DFC_DEBUG("Server::handleRequest: transport name: "<<request.getTransport()->getName());
 
-    // FIXME CAUTION !!!
-    // FIXME This code is run in multithreaded context, be careful what data structures
-    //       are accessed there.
-    //       Don't access without mutexes:
-    //       - KIARA Database (Type System, IDL information, etc.)
+    // CAUTION: This code is run in multithreaded context, be careful what data structures
+    //          are accessed there. The KIARA database (World, Module, Namespace) and
+    //          reference counting of its objects are synchronized, other state
+    //          of the server and the connections is not.
 
     if (strcmp(request.getTransport()->getName(), "http") == 0)
     {
@@ -641,9 +900,18 @@ Transport::RequestResult Server::handleRequest(
 
         if (requestPath == configPath_)
         {
-            ServerConfiguration serverConfiguration;
-            generateServerConfiguration(serverConfiguration, connection->getLocalHostName(), connection->getRemoteHostName());
-            res.setTextResponse(serverConfiguration.toJSON(), "application/json");
+            ConfigurationResponse::Ptr config = getConfigurationResponse(connection->getLocalHostName());
+            Transport::HttpMessage::HeaderList::const_iterator ifNoneMatch = req.findHeader("If-None-Match");
+            if (ifNoneMatch != req.headers_end() && matchesETag(ifNoneMatch->value, config->etag))
+            {
+                res.clear();
+                res.setResponseHeaders("application/json", Transport::HttpResponse::NOT_MODIFIED);
+            }
+            else
+            {
+                res.setTextResponse(config->json, "application/json");
+            }
+            res.addHeader("ETag", config->etag);
             return Transport::SEND_RESPONSE;
         }
 		
@@ -709,12 +977,99 @@ void Server::generateServerConfiguration(
         serverInfo.transport.url = serviceUrl.toString();
 
         serverConfiguration.servers.push_back(serverInfo);
+
+        // advertise the shared memory, inproc and ipc endpoints of the port,
+        // clients select them by priority when they run on the same host
+        TransportEntryList::const_iterator entry =
+            transportEntries_.find(HostAndPort(it->first->getHostName(), it->first->getPort()));
+        if (entry == transportEntries_.end())
+            continue;
+
+        std::vector<const char *> localTransportNames;
+        if (entry->second->shmServer)
+            localTransportNames.push_back("shm");
+        for (size_t i = 0; i < entry->second->localTransports.size(); ++i)
+            localTransportNames.push_back(entry->second->localTransports[i]->getName());
+
+        for (size_t i = 0; i < localTransportNames.size(); ++i)
+        {
+            serviceUrl.scheme = localTransportNames[i];
+            serverInfo.transport.name = localTransportNames[i];
+            serverInfo.transport.url = serviceUrl.toString();
+            serverConfiguration.servers.push_back(serverInfo);
+        }
+    }
+
+    boost::mutex::scoped_lock lock(configCacheMutex_);
+    if (!idlContentsValid_)
+    {
+        idlContents_.clear();
+        idlHash_.clear();
+        for (ServiceSet::iterator it = services_.begin(), end = services_.end(); it != end; ++it)
+        {
+            idlContents_ += (*it)->getIDLContents();
+        }
+        if (!idlContents_.empty())
+            idlHash_ = KIARA::ContentHash().update(idlContents_).toHexString();
+        idlContentsValid_ = true;
+    }
+    serverConfiguration.idlContents = idlContents_;
+    serverConfiguration.idlHash = idlHash_;
+}
+
+Server::ConfigurationResponse::Ptr Server::getConfigurationResponse(const std::string &localHostName)
+{
+    unsigned int generation;
+    {
+        boost::mutex::scoped_lock lock(configCacheMutex_);
+        ConfigurationCache::const_iterator it = configCache_.find(localHostName);
+        if (it != configCache_.end())
+            return it->second;
+        generation = configGeneration_;
     }
 
-    for (ServiceSet::iterator it = services_.begin(), end = services_.end(); it != end; ++it)
+    // Render outside of the lock, concurrent requests for the same host may render twice
+    ServerConfiguration serverConfiguration;
+    generateServerConfiguration(serverConfiguration, localHostName, "");
+
+    boost::shared_ptr<ConfigurationResponse> response(new ConfigurationResponse);
+    response->json = serverConfiguration.toJSON();
+    response->etag = "\"" + KIARA::ContentHash().update(response->json).toHexString() + "\"";
+
+    boost::mutex::scoped_lock lock(configCacheMutex_);
+    // Don't cache a response rendered from services that were changed meanwhile
+    if (generation == configGeneration_)
+        configCache_[localHostName] = response;
+    return response;
+}
+
+bool Server::matchesETag(const std::string &ifNoneMatch, const std::string &etag)
+{
+    // If-None-Match: "*" | 1#( [ "W/" ] quoted-string )
+    std::string::size_type pos = 0;
+    while (pos < ifNoneMatch.length())
     {
-        serverConfiguration.idlContents += (*it)->getIDLContents();
+        std::string::size_type next = ifNoneMatch.find(',', pos);
+        if (next == std::string::npos)
+            next = ifNoneMatch.length();
+        std::string tag = boost::algorithm::trim_copy(ifNoneMatch.substr(pos, next - pos));
+        if (tag.compare(0, 2, "W/") == 0)
+            tag.erase(0, 2);
+        if (tag == "*" || tag == etag)
+            return true;
+        pos = next + 1;
     }
+    return false;
+}
+
+void Server::invalidateConfigurationCache()
+{
+    boost::mutex::scoped_lock lock(configCacheMutex_);
+    configCache_.clear();
+    idlContents_.clear();
+    idlHash_.clear();
+    idlContentsValid_ = false;
+    ++configGeneration_;
 }
 
 KIARA_Result Server::addService(const char *path, const char *protocol, Service *service)
@@ -787,6 +1142,7 @@ KIARA_Result Server::addService(const char *path, const char *protocol, Service
         serviceHandlers_.push_back(std::make_pair(address, handler));
     }
     services_.insert(service);
+    invalidateConfigurationCache();
     return KIARA_SUCCESS;
 }
 
@@ -805,6 +1161,7 @@ KIARA_Result Server::removeService(Service *service)
     }
 
     services_.erase(service);
+    invalidateConfigurationCache();
 
     return status;
 }
@@ -924,10 +1281,6 @@ ServiceHandler::ServiceHandler(Service *service, const Transport::Transport *tra
     createResponseMessage_ =
         (KIARA_CreateResponseMessage)(intptr_t)
         getRuntimeEnvironment().requestPointerToFunction("createResponseMessage");
-	
-	createResponseMessageZmq_ =
-        (KIARA_CreateResponseMessageZmq)(intptr_t)
-        getRuntimeEnvironment().requestPointerToFunction("createResponseMessageZmq");
 
     getMessageMethodName_ =
         (KIARA_GetMessageMethodName)(intptr_t)
@@ -983,11 +1336,17 @@ KIARA_ServiceFuncObj * ServiceHandler::createServiceFuncObj()
     fobj->base.syncHandler = 0;
     fobj->base.connection = 0;
     fobj->base.funcType = 0;
+    fobj->base.userData.p = 0;
     return fobj;
 }
 
 void ServiceHandler::destroyServiceFuncObj(KIARA_ServiceFuncObj *funcObj)
 {
+    // release compiled code or interpreter program
+    if (funcObj->base.syncHandler == KIARA_ServiceInterpreter)
+        delete static_cast<ServiceCallProgram*>(funcObj->base.userData.p);
+    else if (funcObj->base.syncHandler && runtimeEnvironment_)
+        runtimeEnvironment_->releaseFunction((void*)funcObj->base.syncHandler);
     delete funcObj;
 }
 
@@ -1048,55 +1407,24 @@ void ServiceHandler::dbgSimulateCall(const char *requestData)
     freeMessage_(inMsg);
 }
 
-void ServiceHandler::performCallZmq(const char *in_data, size_t in_size, DBuffer *response)
+KIARA_Result ServiceHandler::performOnewayCall(const char *data, size_t dataSize)
 {
-	KIARA_Message *inMsg = createRequestMessageFromData_(in_data, in_size);
-	if (!inMsg)
-    {
+    KIARA_Message *inMsg = createRequestMessageFromData_(data, dataSize);
+    if (!inMsg)
+        return KIARA_FAILURE;
 
-        KIARA_Message *outMsg = createResponseMessageZmq_(0);
-        setGenericErrorMessage_(outMsg, KIARA_FAILURE, "Invalid request data");
-        //getMessageData_(outMsg, responseData.get_dbuffer());
-        freeMessage_(outMsg);
-    }
-    else
+    KIARA_Result result = KIARA_FAILURE;
+    const char *methodName = getMessageMethodName_(inMsg);
+    DispatchMap::iterator it = methodName ? dispatchMap_.find(methodName) : dispatchMap_.end();
+    if (it != dispatchMap_.end())
     {
-
-        const char *methodName = getMessageMethodName_(inMsg);
-
-        DispatchMap::iterator it = dispatchMap_.find(methodName);
-
-        if (it == dispatchMap_.end())
-        {
-            KIARA_Message *outMsg = createResponseMessageZmq_(0);
-            std::string errorStr = "No such method: " + std::string(methodName);
-            setGenericErrorMessage_(outMsg, KIARA_FAILURE, errorStr.c_str());
-            getMessageData_(outMsg, response->get_dbuffer());
-            freeMessage_(outMsg);
-            return;
-        }
-
-        KIARA_Message *outMsg = createResponseMessageZmq_(inMsg);
-        /** FIXME Temporary solution */
-        KIARA_ServiceFuncObj funcObj;
-        memcpy(&funcObj, it->second, sizeof(KIARA_ServiceFuncObj));
-        //funcObj.base.connection = wrap((void*));
-		
-        KIARA_Result result = funcObj.base.syncHandler(&funcObj, outMsg, inMsg);
-
-        if (result == KIARA_SUCCESS || result == KIARA_EXCEPTION)
-        {
-            getMessageData_(outMsg, response->get_dbuffer());
-        }
-        else
-        {
-            setGenericErrorMessage_(outMsg, result, kiaraGetErrorName(result));
-            getMessageData_(outMsg, response->get_dbuffer());
-        }
-
+        KIARA_Message *outMsg = createResponseMessage_(0, inMsg);
+        result = it->second->base.syncHandler(it->second, outMsg, inMsg);
         freeMessage_(outMsg);
-        freeMessage_(inMsg);
     }
+
+    freeMessage_(inMsg);
+    return result;
 }
 
 void ServiceHandler::performCall(Connection *connection, const DBuffer &requestData, DBuffer &responseData)
@@ -1121,6 +1449,7 @@ void ServiceHandler::performCall(Connection *connection, const DBuffer &requestD
             setGenericErrorMessage_(outMsg, KIARA_FAILURE, errorStr.c_str());
             getMessageData_(outMsg, responseData.get_dbuffer());
             freeMessage_(outMsg);
+            freeMessage_(inMsg);
             return;
         }
 
@@ -1129,14 +1458,14 @@ void ServiceHandler::performCall(Connection *connection, const DBuffer &requestD
         /** FIXME Temporary solution */
         KIARA_ServiceFuncObj funcObj;
         memcpy(&funcObj, it->second, sizeof(KIARA_ServiceFuncObj));
-        funcObj.base.connection = wrap(connection);
+        if (connection)
+            funcObj.base.connection = wrap(connection);
 
         KIARA_Result result = funcObj.base.syncHandler(&funcObj, outMsg, inMsg);
 
         if (result == KIARA_SUCCESS || result == KIARA_EXCEPTION)
         {
             getMessageData_(outMsg, responseData.get_dbuffer());
-			std::cout << responseData.data() << std::endl;
         }
         else
         {
@@ -1189,8 +1518,7 @@ KIARA_Result Service::loadIDLFromString(const char *idlLanguage, const char *idl
         setError(KIARA_INVALID_ARGUMENT, std::string("Could not parse IDL, unknown language: ")+idlLanguage);
         return getErrorCode();
     }
-    std::istringstream iss(idlContents);
-    if (!getContext()->loadIDL(iss, "<string>"))
+    if (!getContext()->loadIDL(idlContents, idlContents + strlen(idlContents), "<string>"))
     {
         setError(KIARA_INVALID_OPERATION, "Could not parse IDL from string");
         return getErrorCode();
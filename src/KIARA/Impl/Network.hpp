@@ -28,7 +28,11 @@
 
 #include <KIARA/Common/Config.hpp>
 #include <KIARA/Impl/Core.hpp>
+#include <KIARA/Impl/API.h>
 #include <KIARA/Utils/DBuffer.hpp>
+#include <KIARA/Transport/ShmTransport.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/shared_ptr.hpp>
 
 namespace KIARA
 {
@@ -37,6 +41,10 @@ namespace Transport
 {
 class HttpResponse;
 class HttpRequest;
+class KT_Msg;
+class KT_Session;
+class KT_Connection;
+class KT_HTTP_Parser;
 }
 
 namespace Impl
@@ -58,6 +66,9 @@ public:
     KIARA_FuncObj * createFuncObj();
     void destroyFuncObj(KIARA_FuncObj *funcObj);
 
+    /// Removes function object generated by generateClientFuncObj and destroys it.
+    bool freeFuncObj(KIARA_FuncObj *funcObj);
+
     KIARA_FuncObj * generateClientFuncObj(const char *idlMethodName, KIARA_GetDeclType declTypeGetter, const char *mapping);
 
     KIARA_ConnectionData * getConnectionData() const { return data_; }
@@ -65,8 +76,24 @@ public:
 
     virtual const char * getConnectionURI() const = 0;
 
+    /// Returns true when generated function objects only send their
+    /// arguments and never receive a response.
+    virtual bool isOneway() const { return false; }
+
+    /// Sends data via transport selected for this connection
+    KIARA_Result sendData(const void *data, size_t dataSize, kr_dbuffer_t *destBuf);
+
+    /// Performs request/reply over the transport connection without copying
+    /// the request, the reply is appended to destBuf. Used by the sendData
+    /// implementations of the transports.
+    KIARA_Result callTransport(const void *data, size_t dataSize, kr_dbuffer_t *destBuf);
+
     KIARA::RuntimeEnvironment & getRuntimeEnvironment() const { return *runtimeEnvironment_; }
 
+    /// Returns JIT telemetry of the connection as JSON,
+    /// string is valid until the next call.
+    const std::string & getJITTelemetryJSON();
+
     const KIARA::Transport::Connection::Ptr & getTransportConnection() const
     {
         return transportConnection_;
@@ -78,6 +105,8 @@ protected:
     std::string transportName_;
     KIARA::RuntimeEnvironment *runtimeEnvironment_;
     KIARA::Transport::Connection::Ptr transportConnection_;
+    KIARA_SendData sendData_;
+    std::string jitTelemetryJSON_;
 
     void setTransportName(const std::string &transportName) { transportName_ = transportName; }
     void setTransportConnection(const KIARA::Transport::Connection::Ptr &transportConnection)
@@ -108,6 +137,9 @@ public:
 
     const std::string & getMimeType() const { return mimeType_; }
 
+    /// Serializes calls on transports that can't be used concurrently
+    boost::mutex & getTransportMutex() { return transportMutex_; }
+
 private:
     std::string uri_;
     KIARA_InitNetworkFunc initFunc_;
@@ -116,6 +148,7 @@ private:
 
     KIARA::URLLoader::Connection *urlLoaderConnection_;
     std::string mimeType_;
+    boost::mutex transportMutex_;
 };
 
 struct ServiceFuncRecord
@@ -164,9 +197,12 @@ public:
 
     void dbgSimulateCall(const char *requestData);
 
+    /// Dispatches a request and stores the serialized response in responseData.
+    /// connection is NULL when the request was received by a KT_* server socket.
     void performCall(Connection *connection, const DBuffer &requestData, DBuffer &responseData);
-	
-	void performCallZmq(const char *in_data, size_t in_size, DBuffer *response);
+
+    /// Dispatches a one-way message, the response of the called function is discarded.
+    KIARA_Result performOnewayCall(const char *data, size_t dataSize);
 
     KIARA::RuntimeEnvironment & getRuntimeEnvironment() const { return *runtimeEnvironment_; }
 
@@ -181,7 +217,6 @@ protected:
     DispatchMap dispatchMap_;
     KIARA_CreateRequestMessageFromData createRequestMessageFromData_;
     KIARA_CreateResponseMessage createResponseMessage_;
-	KIARA_CreateResponseMessageZmq createResponseMessageZmq_;
     KIARA_GetMessageMethodName getMessageMethodName_;
     KIARA_FreeMessage freeMessage_;
     KIARA_GetMessageData getMessageData_;
@@ -242,6 +277,28 @@ public:
         const std::string &localHostName,
         const std::string &remoteHostName);
 
+    /// Serialized server configuration, shared read-only between request handlers
+    struct ConfigurationResponse
+    {
+        typedef boost::shared_ptr<const ConfigurationResponse> Ptr;
+
+        std::string json;   // ServerConfiguration::toJSON() text
+        std::string etag;   // quoted ContentHash of json
+    };
+
+    /// Returns the configuration as seen from localHostName.
+    /// The response is rendered once and reused until addService or removeService is called.
+    ConfigurationResponse::Ptr getConfigurationResponse(const std::string &localHostName);
+
+    /// Returns true when the If-None-Match header value matches etag.
+    static bool matchesETag(const std::string &ifNoneMatch, const std::string &etag);
+
+    /// Handles data received from a peer on a http port. Requests may span
+    /// several messages, and a message may contain several pipelined
+    /// requests, which are answered in order. Messages of a peer must be
+    /// passed one at a time in the order of arrival.
+    void handleHttpStream(Transport::KT_Msg &msg, Transport::KT_Session *sess, Transport::KT_Connection *connection);
+
 private:
 
     typedef std::pair<std::string, unsigned int> HostAndPort;
@@ -254,15 +311,22 @@ private:
 
         const Transport::Transport *transport;
         unsigned int numServices;
+        Transport::ShmServer::Ptr shmServer;   // serves a tcp port to local clients
+        std::vector<const Transport::Transport *> localTransports; // ipc and inproc endpoints of a tcp port
 
         TransportEntry(const Transport::Transport *transport)
             : transport(transport)
             , numServices(0)
+            , shmServer()
+            , localTransports()
         { }
     };
 
     bool addPortListener(const std::string &host, unsigned int port, const std::string &transportName);
 
+    /// Dispatches a request received over shared memory to the tcp service at host:port
+    void handleSharedMemoryRequest(const std::string &host, unsigned int port, const DBuffer &request, DBuffer &response);
+
     TransportEntry::Ptr getTransportEntry(const std::string &host, unsigned int port);
 
     Transport::RequestResult handleRequest(
@@ -281,9 +345,44 @@ private:
 
     typedef std::map<HostAndPort, TransportEntry::Ptr> TransportEntryList;
 
+    typedef std::map<std::string, ConfigurationResponse::Ptr> ConfigurationCache; // local host name to response
+
+    /// Limits of requests received on a http port, larger ones are answered
+    /// with 431 or 413 and the connection is closed
+    enum
+    {
+        MAX_HTTP_HEADER_SIZE = 64 * 1024,
+        MAX_HTTP_BODY_SIZE = 16 * 1024 * 1024
+    };
+
+    /// State of a http connection that did not receive a complete request yet
+    struct HttpStream
+    {
+        boost::shared_ptr<Transport::KT_HTTP_Parser> parser; // parses the request incrementally
+
+        HttpStream() : parser() { }
+    };
+
+    typedef std::map<std::vector<char>, HttpStream> HttpStreamMap; // peer identity to its state
+
+    /// Returns the response to a complete http request
+    std::string handleHttpRequest(Transport::KT_HTTP_Parser &parser, Transport::KT_Connection *connection);
+
+    void invalidateConfigurationCache();
+
     ServiceSet services_;
     ServiceHandlerMap serviceHandlers_;
     TransportEntryList transportEntries_;
+
+    boost::mutex httpStreamsMutex_;     // guards httpStreams_
+    HttpStreamMap httpStreams_;
+
+    boost::mutex configCacheMutex_;     // guards all members below
+    ConfigurationCache configCache_;
+    std::string idlContents_;           // IDL of all services, valid if idlContentsValid_
+    std::string idlHash_;
+    bool idlContentsValid_;
+    unsigned int configGeneration_;     // incremented on each invalidation
 };
 
 DEFINE_WRAPPER_FUNCTIONS(::KIARA::Impl::Connection, ::KIARA_Connection)
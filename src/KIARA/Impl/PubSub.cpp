@@ -0,0 +1,311 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013, 2014  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * PubSub.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#include "PubSub.hpp"
+#include <KIARA/Runtime/RuntimeContext.hpp>
+#include <KIARA/Runtime/RuntimeEnvironment.hpp>
+#include <KIARA/Transport/Transport.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+#include <zmq.h>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+
+#define DFC_DO_DEBUG
+#include <DFC/Utils/Debug.hpp>
+
+namespace KIARA
+{
+
+namespace Impl
+{
+
+namespace
+{
+
+// Time after which a blocked receive checks whether the subscriber is stopped
+const int SUBSCRIBER_POLL_INTERVAL = 100; // milliseconds
+
+std::string zmqErrorMessage()
+{
+    return std::string("ZeroMQ error: ") + zmq_strerror(zmq_errno());
+}
+
+void setSocketOptions(void *socket, int highWaterMarkOption, unsigned int highWaterMark, bool conflate)
+{
+    const int hwm = static_cast<int>(highWaterMark);
+    zmq_setsockopt(socket, highWaterMarkOption, &hwm, sizeof(hwm));
+    if (conflate)
+    {
+        const int on = 1;
+        zmq_setsockopt(socket, ZMQ_CONFLATE, &on, sizeof(on));
+    }
+}
+
+} // unnamed namespace
+
+/// Publisher
+
+Publisher::Publisher(Context *context, const std::string &url, const std::string &protocolName)
+    : Connection(context, "zmq")
+    , url_(url)
+    , topic_()
+    , zmqContext_(0)
+    , socket_(0)
+{
+    std::string errorMsg;
+
+    runtimeEnvironment_ = context->getRuntimeContext().createEnvironment();
+    if (!runtimeEnvironment_)
+    {
+        setError(KIARA_INIT_ERROR, "Could not create runtime environment");
+        return;
+    }
+
+    if (!runtimeEnvironment_->startInitialization(&errorMsg))
+    {
+        setError(KIARA_INIT_ERROR, "Could not initialize runtime environment: "+errorMsg);
+        return;
+    }
+
+    const std::vector<std::string> & llvmModuleNames = context->getLLVMModuleNames();
+    for (std::vector<std::string>::const_iterator it = llvmModuleNames.begin(),
+        end = llvmModuleNames.end(); it != end; ++it)
+    {
+        DFC_DEBUG("Loading LLVM module "<<*it);
+        if (!getRuntimeEnvironment().loadModule(*it, &errorMsg))
+        {
+            setError(KIARA_CONNECTION_ERROR, "Could not load " + (*it) + " module: " + errorMsg);
+            return;
+        }
+    }
+
+    if (!getRuntimeEnvironment().loadComponent(protocolName, &errorMsg))
+    {
+        setError(KIARA_CONNECTION_ERROR, "Could not load " + protocolName + " component: "+errorMsg);
+        return;
+    }
+
+    if (!getRuntimeEnvironment().finishInitialization(&errorMsg))
+    {
+        setError(KIARA_INIT_ERROR, "Could not finish initialization of runtime environment: "+errorMsg);
+        return;
+    }
+
+    getRuntimeEnvironment().registerExternalFunction("sendData", (void*)&Publisher::sendDataCallback);
+    sendData_ = &Publisher::sendDataCallback;
+
+    const PubSubConfiguration config = Global::getPubSubConfiguration();
+
+    zmqContext_ = zmq_ctx_new();
+    socket_ = zmq_socket(zmqContext_, ZMQ_PUB);
+    if (!socket_)
+    {
+        setError(KIARA_NETWORK_ERROR, zmqErrorMessage());
+        return;
+    }
+    setSocketOptions(socket_, ZMQ_SNDHWM, config.sendHighWaterMark, config.conflate);
+
+    DFC_DEBUG("Publish on: "<<url_);
+    if (zmq_bind(socket_, url_.c_str()) != 0)
+    {
+        setError(KIARA_NETWORK_ERROR, "Could not bind to "+url_+": "+zmqErrorMessage());
+        return;
+    }
+}
+
+Publisher::~Publisher()
+{
+    if (socket_)
+        zmq_close(socket_);
+    if (zmqContext_)
+        zmq_ctx_term(zmqContext_);
+}
+
+KIARA_Result Publisher::loadIDLFromString(const char *idlLanguage, const char *idlContents)
+{
+    if (!boost::algorithm::iequals(idlLanguage, "KIARA"))
+    {
+        setError(KIARA_INVALID_ARGUMENT, std::string("Could not parse IDL, unknown language: ")+idlLanguage);
+        return getErrorCode();
+    }
+    if (!getContext()->loadIDL(idlContents, idlContents + strlen(idlContents), "<string>"))
+    {
+        setError(KIARA_INVALID_OPERATION, "Could not parse IDL from string");
+        return getErrorCode();
+    }
+    return KIARA_SUCCESS;
+}
+
+KIARA_Result Publisher::publish(const void *data, size_t dataSize)
+{
+    if (!socket_)
+        return KIARA_NETWORK_ERROR;
+
+    zmq_msg_t msg;
+    if (zmq_msg_init_size(&msg, topic_.size() + 1 + dataSize) != 0)
+    {
+        setError(KIARA_NETWORK_ERROR, zmqErrorMessage());
+        return getErrorCode();
+    }
+
+    char *dest = static_cast<char*>(zmq_msg_data(&msg));
+    memcpy(dest, topic_.data(), topic_.size());
+    dest[topic_.size()] = '\0';
+    memcpy(dest + topic_.size() + 1, data, dataSize);
+
+    if (zmq_msg_send(&msg, socket_, 0) == -1)
+    {
+        zmq_msg_close(&msg);
+        setError(KIARA_NETWORK_ERROR, zmqErrorMessage());
+        return getErrorCode();
+    }
+    return KIARA_SUCCESS;
+}
+
+KIARA_Result Publisher::sendDataCallback(KIARA_Connection *conn, const void *data, size_t dataSize, kr_dbuffer_t *destBuf)
+{
+    // sendData is registered only in the runtime environment of publishers
+    return static_cast<Publisher*>(unwrap(conn))->publish(data, dataSize);
+}
+
+/// Subscriber
+
+Subscriber::Subscriber(
+        Context *context,
+        const std::string &url,
+        const std::string &protocolName,
+        const std::string &topic,
+        Service *service)
+    : Base(context)
+    , url_(url)
+    , serviceHandler_(0)
+    , zmqContext_(0)
+    , socket_(0)
+    , mutex_()
+    , stopping_(false)
+{
+    assert(service != 0);
+
+    // Messages are dispatched the same way as requests of a server
+    serviceHandler_ = new ServiceHandler(service, Transport::Transport::getTransportByName("tcp"), protocolName);
+    if (serviceHandler_->isError())
+    {
+        setError(serviceHandler_->getError());
+        return;
+    }
+
+    const PubSubConfiguration config = Global::getPubSubConfiguration();
+
+    zmqContext_ = zmq_ctx_new();
+    socket_ = zmq_socket(zmqContext_, ZMQ_SUB);
+    if (!socket_)
+    {
+        setError(KIARA_NETWORK_ERROR, zmqErrorMessage());
+        return;
+    }
+    setSocketOptions(socket_, ZMQ_RCVHWM, config.receiveHighWaterMark, config.conflate);
+
+    const int timeout = SUBSCRIBER_POLL_INTERVAL;
+    zmq_setsockopt(socket_, ZMQ_RCVTIMEO, &timeout, sizeof(timeout));
+    zmq_setsockopt(socket_, ZMQ_SUBSCRIBE, topic.data(), topic.size());
+
+    DFC_DEBUG("Subscribe to: "<<url_<<" topic: "<<topic);
+    if (zmq_connect(socket_, url_.c_str()) != 0)
+    {
+        setError(KIARA_NETWORK_ERROR, "Could not connect to "+url_+": "+zmqErrorMessage());
+        return;
+    }
+}
+
+Subscriber::~Subscriber()
+{
+    if (socket_)
+        zmq_close(socket_);
+    if (zmqContext_)
+        zmq_ctx_term(zmqContext_);
+    delete serviceHandler_;
+}
+
+bool Subscriber::isStopping()
+{
+    boost::mutex::scoped_lock lock(mutex_);
+    return stopping_;
+}
+
+void Subscriber::stop()
+{
+    boost::mutex::scoped_lock lock(mutex_);
+    stopping_ = true;
+}
+
+KIARA_Result Subscriber::run()
+{
+    if (isError())
+        return getErrorCode();
+
+    {
+        boost::mutex::scoped_lock lock(mutex_);
+        stopping_ = false;
+    }
+
+    zmq_msg_t msg;
+    zmq_msg_init(&msg);
+    while (!isStopping())
+    {
+        if (zmq_msg_recv(&msg, socket_, 0) == -1)
+        {
+            if (zmq_errno() == EAGAIN || zmq_errno() == EINTR)
+                continue;
+            zmq_msg_close(&msg);
+            setError(KIARA_NETWORK_ERROR, zmqErrorMessage());
+            return getErrorCode();
+        }
+
+        // skip the topic
+        const char *data = static_cast<const char*>(zmq_msg_data(&msg));
+        const size_t size = zmq_msg_size(&msg);
+        const char *payload = static_cast<const char*>(memchr(data, '\0', size));
+        if (!payload)
+        {
+            DFC_DEBUG("Subscriber: message without topic separator dropped");
+            continue;
+        }
+        ++payload;
+
+        KIARA_Result result = serviceHandler_->performOnewayCall(payload, size - (payload - data));
+        if (result != KIARA_SUCCESS && result != KIARA_EXCEPTION)
+        {
+            DFC_DEBUG("Subscriber: dispatch failed: "<<kiaraGetErrorName(result));
+        }
+    }
+    zmq_msg_close(&msg);
+
+    return KIARA_SUCCESS;
+}
+
+} // namespace Impl
+
+} // namespace KIARA
@@ -0,0 +1,120 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013, 2014  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * PubSub.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef KIARA_IMPL_PUBSUB_HPP_INCLUDED
+#define KIARA_IMPL_PUBSUB_HPP_INCLUDED
+
+#include <KIARA/Common/Config.hpp>
+#include <KIARA/Impl/Network.hpp>
+#include <KIARA/DB/PubSubConfiguration.hpp>
+#include <boost/thread/mutex.hpp>
+#include <string>
+
+namespace KIARA
+{
+
+namespace Impl
+{
+
+/// Connection that publishes messages on a ZeroMQ PUB socket.
+///
+/// Function objects generated for a publisher serialize their arguments
+/// with the selected protocol and send them as one-way messages to all
+/// subscribers, results of IDL methods are never received.
+///
+/// Each message is a single frame [topic]['\0'][payload], so subscribers
+/// filter by topic prefix and conflation can be used.
+class Publisher : public Connection
+{
+public:
+
+    Publisher(Context *context, const std::string &url, const std::string &protocolName);
+
+    ~Publisher();
+
+    const char * getConnectionURI() const { return url_.c_str(); }
+
+    bool isOneway() const { return true; }
+
+    /// Loads IDL describing the published service methods
+    KIARA_Result loadIDLFromString(const char *idlLanguage, const char *idlContents);
+
+    /// Topic of all messages published after this call
+    void setTopic(const std::string &topic) { topic_ = topic; }
+
+    const std::string & getTopic() const { return topic_; }
+
+    /// Sends data tagged with the current topic
+    KIARA_Result publish(const void *data, size_t dataSize);
+
+private:
+    std::string url_;
+    std::string topic_;
+    void *zmqContext_;
+    void *socket_;
+
+    static KIARA_Result sendDataCallback(KIARA_Connection *conn, const void *data, size_t dataSize, kr_dbuffer_t *destBuf);
+};
+
+/// Receives messages of publishers and dispatches them to the functions
+/// registered in a service.
+class Subscriber : public Base
+{
+public:
+
+    /// Connects to the publisher at url and subscribes to all messages
+    /// whose topic starts with topic, empty topic receives all messages.
+    Subscriber(Context *context, const std::string &url, const std::string &protocolName,
+               const std::string &topic, Service *service);
+
+    ~Subscriber();
+
+    /// Receives and dispatches messages until stop() is called.
+    KIARA_Result run();
+
+    /// Requests run() to return, can be called from any thread
+    /// including service functions called by run().
+    void stop();
+
+    const std::string & getURL() const { return url_; }
+
+private:
+    std::string url_;
+    ServiceHandler *serviceHandler_;
+    void *zmqContext_;
+    void *socket_;
+    boost::mutex mutex_;    // guards stopping_
+    bool stopping_;
+
+    bool isStopping();
+};
+
+DEFINE_WRAPPER_FUNCTIONS(::KIARA::Impl::Subscriber, ::KIARA_Subscriber)
+
+} // namespace Impl
+
+} // namespace KIARA
+
+#endif /* KIARA_IMPL_PUBSUB_HPP_INCLUDED */
@@ -28,7 +28,19 @@
 #include <KIARA/kiara_security.h>
 #include <cstring>
 #include <cassert>
+#include <climits>
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/thread/tss.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <openssl/crypto.h>
 #include <openssl/evp.h>
+#include <openssl/rand.h>
 //#include <cstdio>
 
 // This code is based on example from http://saju.net.in/blog/?p=36
@@ -41,7 +53,11 @@ struct KIARA_SymmetricKey
 
     KIARA_SymmetricKey(const EVP_CIPHER *evpcipher = 0) : evpcipher(evpcipher) { }
     KIARA_SymmetricKey(const KIARA_Cipher *cipher = 0) : evpcipher((const EVP_CIPHER*)cipher) { }
-    ~KIARA_SymmetricKey() { }
+    ~KIARA_SymmetricKey()
+    {
+        OPENSSL_cleanse(key, sizeof(key));
+        OPENSSL_cleanse(iv, sizeof(iv));
+    }
 
     KIARA_Result initFromText(const char *text)
     {
@@ -177,9 +193,407 @@ struct KIARA_CipherContext
 };
 
 
+namespace
+{
+
+/// Nonce and tag sizes of all supported AEAD ciphers
+enum { AEAD_NONCE_SIZE = 12, AEAD_TAG_SIZE = 16 };
+
+/// Sealed data ends with [chunk size : uint32 LE][nonce]
+enum { AEAD_TRAILER_SIZE = 4 + AEAD_NONCE_SIZE };
+
+enum { DEFAULT_CHUNK_SIZE = 256 * 1024 };
+
+inline uint32_t getUInt32LE(const unsigned char data[4])
+{
+    return ((uint32_t)data[0] |
+            ((uint32_t)data[1] << 8) |
+            ((uint32_t)data[2] << 16) |
+            ((uint32_t)data[3] << 24));
+}
+
+inline void setUInt32LE(uint32_t num, unsigned char data[4])
+{
+    data[0] = num & 0xff;
+    data[1] = (num>>8) & 0xff;
+    data[2] = (num>>16) & 0xff;
+    data[3] = (num>>24) & 0xff;
+}
+
+/// Number of chunks of sealed data with size bytes of plaintext
+inline size_t getNumChunks(size_t size, size_t chunkSize)
+{
+    return size ? (size + chunkSize - 1) / chunkSize : 1;
+}
+
+/// Per-thread cipher state used by the in-place AEAD functions.
+///
+/// The EVP context keeps the expanded key schedule of the last used key,
+/// consecutive messages with the same key only set a new nonce.
+/// Keys derived from key texts are cached, so EVP_BytesToKey runs once per
+/// thread and key text instead of once per message. The cache is keyed by
+/// a digest of the text and holds at most MAX_KEYS keys, the least recently
+/// used one is evicted. Keys are wiped when evicted and when the thread exits.
+struct ThreadCipherState
+{
+    enum { MAX_KEYS = 16 };
+
+    struct CachedKey
+    {
+        KIARA_SymmetricKey *key;
+        unsigned long lastUse;
+    };
+
+    typedef std::map<std::pair<const EVP_CIPHER *, std::string>, CachedKey> KeyMap;
+
+    EVP_CIPHER_CTX *ctx;
+    const EVP_CIPHER *cipher;
+    unsigned char key[EVP_MAX_KEY_LENGTH];
+    int enc; // -1 when no key is set up
+    KeyMap keys;
+    unsigned long numKeyUses;
+
+    ThreadCipherState()
+        : ctx(EVP_CIPHER_CTX_new())
+        , cipher(0)
+        , enc(-1)
+        , keys()
+        , numKeyUses(0)
+    { }
+
+    ~ThreadCipherState()
+    {
+        for (KeyMap::iterator it = keys.begin(), end = keys.end(); it != end; ++it)
+            delete it->second.key;
+        OPENSSL_cleanse(key, sizeof(key));
+        EVP_CIPHER_CTX_free(ctx);
+    }
+
+    /// Evicts the least recently used key
+    void evictKey()
+    {
+        KeyMap::iterator oldest = keys.begin();
+        for (KeyMap::iterator it = keys.begin(), end = keys.end(); it != end; ++it)
+        {
+            if (it->second.lastUse < oldest->second.lastUse)
+                oldest = it;
+        }
+        delete oldest->second.key;
+        keys.erase(oldest);
+    }
+
+    /// Initializes the context for a new message, enc is 1 for encryption and 0 for decryption
+    bool init(const KIARA_SymmetricKey *key, int enc, const unsigned char *nonce);
+};
+
+boost::thread_specific_ptr<ThreadCipherState> threadCipherState;
+
+ThreadCipherState * getThreadCipherState()
+{
+    ThreadCipherState *state = threadCipherState.get();
+    if (!state)
+    {
+        state = new ThreadCipherState;
+        threadCipherState.reset(state);
+    }
+    return state->ctx ? state : 0;
+}
+
+bool ThreadCipherState::init(const KIARA_SymmetricKey *k, int e, const unsigned char *nonce)
+{
+    const int keyLength = EVP_CIPHER_key_length(k->evpcipher);
+    if (enc != e || cipher != k->evpcipher || memcmp(key, k->key, keyLength) != 0)
+    {
+        enc = -1;
+        if (!EVP_CipherInit_ex(ctx, k->evpcipher, NULL, NULL, NULL, e) ||
+            !EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_IVLEN, AEAD_NONCE_SIZE, NULL) ||
+            !EVP_CipherInit_ex(ctx, NULL, NULL, k->key, nonce, e))
+            return false;
+        cipher = k->evpcipher;
+        memcpy(key, k->key, keyLength);
+        enc = e;
+        return true;
+    }
+    return EVP_CipherInit_ex(ctx, NULL, NULL, NULL, nonce, e) != 0;
+}
+
+/// Encryption or decryption of all chunks of a buffer.
+///
+/// Every chunk is authenticated with its own tag. The nonce of a chunk is
+/// the message nonce with the chunk index mixed into the last four bytes and
+/// a flag for the last chunk, so chunks can't be reordered, dropped or
+/// appended without failing authentication. The chunk size and plaintext
+/// size are additional authenticated data of every chunk, so the chunk size
+/// in the unauthenticated trailer can't be changed either.
+struct ChunkJob
+{
+    const KIARA_SymmetricKey *key;
+    int enc;
+    unsigned char *data;
+    size_t size;
+    size_t chunkSize;
+    size_t numChunks;
+    unsigned char *tags;
+    const unsigned char *nonce;
+
+    // guarded by CipherThreadPool::mutex_
+    size_t nextChunk;
+    size_t completedChunks;
+    bool failed;
+
+    ChunkJob(const KIARA_SymmetricKey *key, int enc, unsigned char *data, size_t size,
+             size_t chunkSize, unsigned char *tags, const unsigned char *nonce)
+        : key(key)
+        , enc(enc)
+        , data(data)
+        , size(size)
+        , chunkSize(chunkSize)
+        , numChunks(getNumChunks(size, chunkSize))
+        , tags(tags)
+        , nonce(nonce)
+        , nextChunk(0)
+        , completedChunks(0)
+        , failed(false)
+    { }
+
+    bool processChunk(size_t index) const;
+};
+
+bool ChunkJob::processChunk(size_t index) const
+{
+    ThreadCipherState *state = getThreadCipherState();
+    if (!state)
+        return false;
+
+    unsigned char chunkNonce[AEAD_NONCE_SIZE];
+    memcpy(chunkNonce, nonce, AEAD_NONCE_SIZE);
+    if (index + 1 == numChunks)
+        chunkNonce[7] ^= 1;
+    chunkNonce[8] ^= (index >> 24) & 0xff;
+    chunkNonce[9] ^= (index >> 16) & 0xff;
+    chunkNonce[10] ^= (index >> 8) & 0xff;
+    chunkNonce[11] ^= index & 0xff;
+
+    unsigned char *chunk = data + index * chunkSize;
+    const int chunkLength = static_cast<int>(std::min(chunkSize, size - index * chunkSize));
+    unsigned char *tag = tags + index * AEAD_TAG_SIZE;
+
+    unsigned char aad[12];
+    setUInt32LE(static_cast<uint32_t>(chunkSize), aad);
+    setUInt32LE(static_cast<uint32_t>(size), aad + 4);
+    setUInt32LE(static_cast<uint32_t>(static_cast<uint64_t>(size) >> 32), aad + 8);
+
+    int outl, foutl, aadl;
+    bool ok;
+    if (enc)
+    {
+        ok = state->init(key, 1, chunkNonce) &&
+            EVP_EncryptUpdate(state->ctx, NULL, &aadl, aad, sizeof(aad)) &&
+            EVP_EncryptUpdate(state->ctx, chunk, &outl, chunk, chunkLength) &&
+            EVP_EncryptFinal_ex(state->ctx, chunk + outl, &foutl) &&
+            EVP_CIPHER_CTX_ctrl(state->ctx, EVP_CTRL_GCM_GET_TAG, AEAD_TAG_SIZE, tag);
+    }
+    else
+    {
+        ok = state->init(key, 0, chunkNonce) &&
+            EVP_DecryptUpdate(state->ctx, NULL, &aadl, aad, sizeof(aad)) &&
+            EVP_DecryptUpdate(state->ctx, chunk, &outl, chunk, chunkLength) &&
+            EVP_CIPHER_CTX_ctrl(state->ctx, EVP_CTRL_GCM_SET_TAG, AEAD_TAG_SIZE, tag) &&
+            EVP_DecryptFinal_ex(state->ctx, chunk + outl, &foutl) > 0;
+    }
+
+    if (!ok)
+    {
+        // Failed authentication leaves the context usable, other errors might not
+        state->enc = -1;
+        return false;
+    }
+    assert(outl + foutl == chunkLength);
+    return true;
+}
+
+/// Threads processing chunks of large buffers in parallel.
+///
+/// The calling thread works on its own job as well, so jobs complete even
+/// when all workers are busy. After the first chunk failed authentication
+/// the remaining chunks of the job are skipped.
+class CipherThreadPool
+{
+public:
+
+    CipherThreadPool()
+        : numThreads_(0)
+        , chunkSize_(DEFAULT_CHUNK_SIZE)
+        , generation_(0)
+    { }
+
+    ~CipherThreadPool()
+    {
+        stopWorkers();
+    }
+
+    unsigned getNumThreads()
+    {
+        boost::mutex::scoped_lock lock(mutex_);
+        return getNumThreadsUnlocked();
+    }
+
+    void setNumThreads(unsigned numThreads)
+    {
+        {
+            boost::mutex::scoped_lock lock(mutex_);
+            numThreads_ = numThreads;
+        }
+        stopWorkers();
+    }
+
+    size_t getChunkSize()
+    {
+        boost::mutex::scoped_lock lock(mutex_);
+        return chunkSize_;
+    }
+
+    void setChunkSize(size_t chunkSize)
+    {
+        boost::mutex::scoped_lock lock(mutex_);
+        chunkSize_ = chunkSize;
+    }
+
+    /// Processes all chunks of the job, returns false when any chunk failed
+    bool run(ChunkJob &job);
+
+private:
+
+    unsigned getNumThreadsUnlocked() const
+    {
+        if (numThreads_)
+            return numThreads_;
+        const unsigned n = boost::thread::hardware_concurrency();
+        return n ? n : 1;
+    }
+
+    /// Returns index of next chunk to process, mutex_ must be locked
+    size_t claimChunk(ChunkJob &job)
+    {
+        const size_t index = job.nextChunk++;
+        if (job.nextChunk == job.numChunks)
+            jobs_.erase(std::find(jobs_.begin(), jobs_.end(), &job));
+        return index;
+    }
+
+    /// Processes a claimed chunk, mutex_ must be locked by lock
+    void processChunk(ChunkJob &job, size_t index, boost::mutex::scoped_lock &lock)
+    {
+        const bool skip = job.failed;
+        lock.unlock();
+        const bool ok = skip || job.processChunk(index);
+        lock.lock();
+        if (!ok)
+            job.failed = true;
+        if (++job.completedChunks == job.numChunks)
+            doneCond_.notify_all();
+    }
+
+    void worker(unsigned generation);
+
+    void stopWorkers();
+
+    boost::mutex mutex_;
+    boost::condition_variable workCond_;
+    boost::condition_variable doneCond_;
+    std::deque<ChunkJob*> jobs_;
+    std::vector<boost::thread*> threads_;
+    unsigned numThreads_; // 0 - one thread per core
+    size_t chunkSize_;
+    unsigned generation_; // incremented to stop current workers
+};
+
+bool CipherThreadPool::run(ChunkJob &job)
+{
+    boost::mutex::scoped_lock lock(mutex_);
+
+    const unsigned numThreads = getNumThreadsUnlocked();
+    if (job.numChunks == 1 || numThreads == 1)
+    {
+        lock.unlock();
+        for (size_t i = 0; i < job.numChunks; ++i)
+        {
+            if (!job.processChunk(i))
+                return false;
+        }
+        return true;
+    }
+
+    if (threads_.empty())
+    {
+        for (unsigned i = 1; i < numThreads; ++i)
+            threads_.push_back(new boost::thread(&CipherThreadPool::worker, this, generation_));
+    }
+
+    jobs_.push_back(&job);
+    workCond_.notify_all();
+
+    while (job.nextChunk < job.numChunks)
+        processChunk(job, claimChunk(job), lock);
+
+    while (job.completedChunks < job.numChunks)
+        doneCond_.wait(lock);
+
+    return !job.failed;
+}
+
+void CipherThreadPool::worker(unsigned generation)
+{
+    boost::mutex::scoped_lock lock(mutex_);
+    while (generation == generation_)
+    {
+        if (jobs_.empty())
+        {
+            workCond_.wait(lock);
+            continue;
+        }
+        ChunkJob &job = *jobs_.front();
+        processChunk(job, claimChunk(job), lock);
+    }
+}
+
+void CipherThreadPool::stopWorkers()
+{
+    std::vector<boost::thread*> threads;
+    {
+        boost::mutex::scoped_lock lock(mutex_);
+        ++generation_;
+        threads.swap(threads_);
+    }
+    workCond_.notify_all();
+
+    for (std::vector<boost::thread*>::iterator it = threads.begin(), end = threads.end(); it != end; ++it)
+    {
+        (*it)->join();
+        delete *it;
+    }
+}
+
+CipherThreadPool cipherThreadPool;
+
+} // unnamed namespace
+
 const KIARA_Cipher * kiaraGetCipher(const char *name)
 {
-    return (const KIARA_Cipher*)EVP_aes_256_cbc();
+    if (!name || strcmp(name, "aes-256-cbc") == 0)
+        return (const KIARA_Cipher*)EVP_aes_256_cbc();
+    if (strcmp(name, KIARA_DEFAULT_AEAD_CIPHER) == 0)
+        return (const KIARA_Cipher*)EVP_aes_256_gcm();
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L && !defined(OPENSSL_NO_CHACHA) && !defined(OPENSSL_NO_POLY1305)
+    if (strcmp(name, "chacha20-poly1305") == 0)
+        return (const KIARA_Cipher*)EVP_chacha20_poly1305();
+#endif
+    return 0;
+}
+
+int kiaraIsAEADCipher(const KIARA_Cipher *cipher)
+{
+    return cipher && (EVP_CIPHER_flags((const EVP_CIPHER*)cipher) & EVP_CIPH_FLAG_AEAD_CIPHER) != 0;
 }
 
 KIARA_SymmetricKey * kiaraNewSymmetricKey(const KIARA_Cipher *cipher)
@@ -237,3 +651,137 @@ KIARA_Result kiaraDecrypt(KIARA_CipherContext *cipherContext, kr_dbuffer_t *plai
     assert(cipherContext != 0);
     return cipherContext->decrypt(plaintext, ciphertext);
 }
+
+const KIARA_SymmetricKey * kiaraGetThreadSymmetricKey(const KIARA_Cipher *cipher, const char *text)
+{
+    assert(cipher != 0);
+    assert(text != 0);
+    ThreadCipherState *state = getThreadCipherState();
+    if (!state)
+        return 0;
+
+    // Key texts are not kept in memory, only their digests
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digestSize = 0;
+    if (!EVP_Digest(text, strlen(text), digest, &digestSize, EVP_sha256(), NULL))
+        return 0;
+
+    const EVP_CIPHER *evpcipher = (const EVP_CIPHER*)cipher;
+    const ThreadCipherState::KeyMap::key_type cacheKey(evpcipher, std::string(reinterpret_cast<char *>(digest), digestSize));
+    ThreadCipherState::KeyMap::iterator it = state->keys.find(cacheKey);
+    if (it != state->keys.end())
+    {
+        it->second.lastUse = ++state->numKeyUses;
+        return it->second.key;
+    }
+
+    KIARA_SymmetricKey *key = new KIARA_SymmetricKey(evpcipher);
+    if (key->initFromText(text) != KIARA_SUCCESS)
+    {
+        delete key;
+        return 0;
+    }
+    if (state->keys.size() >= ThreadCipherState::MAX_KEYS)
+        state->evictKey();
+    ThreadCipherState::CachedKey &cached = state->keys[cacheKey];
+    cached.key = key;
+    cached.lastUse = ++state->numKeyUses;
+    return key;
+}
+
+KIARA_Result kiaraSealInPlace(const KIARA_SymmetricKey *key, kr_dbuffer_t *buffer)
+{
+    assert(key != 0);
+    assert(buffer != 0);
+    if (!kiaraIsAEADCipher((const KIARA_Cipher*)key->evpcipher))
+        return KIARA_ENCRYPTION_FAILED;
+
+    const size_t size = kr_dbuffer_size(buffer);
+    const size_t chunkSize = cipherThreadPool.getChunkSize();
+    const size_t numChunks = getNumChunks(size, chunkSize);
+    const size_t tagsSize = numChunks * AEAD_TAG_SIZE;
+    if (numChunks > 0xffffffff || !kr_dbuffer_resize(buffer, size + tagsSize + AEAD_TRAILER_SIZE))
+        return KIARA_ENCRYPTION_FAILED;
+
+    unsigned char *data = reinterpret_cast<unsigned char *>(kr_dbuffer_data(buffer));
+    unsigned char *tags = data + size;
+    unsigned char *trailer = tags + tagsSize;
+    unsigned char *nonce = trailer + 4;
+
+    setUInt32LE(static_cast<uint32_t>(chunkSize), trailer);
+    if (RAND_bytes(nonce, AEAD_NONCE_SIZE) != 1)
+    {
+        kr_dbuffer_resize(buffer, size);
+        return KIARA_ENCRYPTION_FAILED;
+    }
+
+    ChunkJob job(key, 1, data, size, chunkSize, tags, nonce);
+    if (!cipherThreadPool.run(job))
+    {
+        kr_dbuffer_resize(buffer, size);
+        return KIARA_ENCRYPTION_FAILED;
+    }
+
+    return KIARA_SUCCESS;
+}
+
+KIARA_Result kiaraOpenInPlace(const KIARA_SymmetricKey *key, kr_dbuffer_t *buffer)
+{
+    assert(key != 0);
+    assert(buffer != 0);
+    if (!kiaraIsAEADCipher((const KIARA_Cipher*)key->evpcipher))
+        return KIARA_DECRYPTION_FAILED;
+
+    const size_t sealedSize = kr_dbuffer_size(buffer);
+    if (sealedSize < AEAD_TRAILER_SIZE + AEAD_TAG_SIZE)
+        return KIARA_DECRYPTION_FAILED;
+
+    unsigned char *data = reinterpret_cast<unsigned char *>(kr_dbuffer_data(buffer));
+    unsigned char *trailer = data + sealedSize - AEAD_TRAILER_SIZE;
+    const size_t chunkSize = getUInt32LE(trailer);
+    if (chunkSize == 0 || chunkSize > INT_MAX)
+        return KIARA_DECRYPTION_FAILED;
+
+    // Ciphertext and tags: (numChunks-1) full chunks, a last chunk of
+    // 0 < n <= chunkSize bytes (or an empty single chunk), one tag per chunk
+    const size_t bodySize = sealedSize - AEAD_TRAILER_SIZE;
+    const size_t numChunks = (bodySize + chunkSize + AEAD_TAG_SIZE - 1) / (chunkSize + AEAD_TAG_SIZE);
+    if (bodySize < numChunks * AEAD_TAG_SIZE)
+        return KIARA_DECRYPTION_FAILED;
+    const size_t size = bodySize - numChunks * AEAD_TAG_SIZE;
+    if (getNumChunks(size, chunkSize) != numChunks)
+        return KIARA_DECRYPTION_FAILED;
+
+    ChunkJob job(key, 0, data, size, chunkSize, data + size, trailer + 4);
+    if (!cipherThreadPool.run(job))
+    {
+        // chunks are decrypted in place, never leave unauthenticated plaintext behind
+        OPENSSL_cleanse(data, size);
+        kr_dbuffer_resize(buffer, 0);
+        return KIARA_DECRYPTION_FAILED;
+    }
+
+    kr_dbuffer_resize(buffer, size);
+    return KIARA_SUCCESS;
+}
+
+KIARA_Result kiaraSetCipherThreads(int numThreads)
+{
+    if (numThreads < 0)
+        return KIARA_INVALID_ARGUMENT;
+    cipherThreadPool.setNumThreads(numThreads);
+    return KIARA_SUCCESS;
+}
+
+int kiaraGetCipherThreads(void)
+{
+    return static_cast<int>(cipherThreadPool.getNumThreads());
+}
+
+KIARA_Result kiaraSetCipherChunkSize(size_t chunkSize)
+{
+    if (chunkSize == 0 || chunkSize > INT_MAX)
+        return KIARA_INVALID_ARGUMENT;
+    cipherThreadPool.setChunkSize(chunkSize);
+    return KIARA_SUCCESS;
+}
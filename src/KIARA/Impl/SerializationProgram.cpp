@@ -0,0 +1,973 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * SerializationProgram.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+#define KIARA_LIB
+#include "SerializationProgram.hpp"
+#include <KIARA/Impl/Core.hpp>
+#include <KIARA/DB/Attributes.hpp>
+#include <KIARA/DB/TypeUtils.hpp>
+#include <KIARA/IRGen/IRGen.hpp>
+#include <KIARA/Runtime/RuntimeEnvironment.hpp>
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+
+// #define DFC_DO_DEBUG
+#include <DFC/Utils/Debug.hpp>
+
+namespace KIARA
+{
+
+namespace Impl
+{
+
+namespace
+{
+
+typedef ProtocolFunctions PF;
+
+// signatures of readMessage_<kind> / writeMessage_<kind>
+typedef KIARA_Result (*WriteIntFunc)(KIARA_Message *, int);
+typedef KIARA_Result (*WriteI8Func)(KIARA_Message *, int8_t);
+typedef KIARA_Result (*WriteU8Func)(KIARA_Message *, uint8_t);
+typedef KIARA_Result (*WriteI16Func)(KIARA_Message *, int16_t);
+typedef KIARA_Result (*WriteU16Func)(KIARA_Message *, uint16_t);
+typedef KIARA_Result (*WriteI32Func)(KIARA_Message *, int32_t);
+typedef KIARA_Result (*WriteU32Func)(KIARA_Message *, uint32_t);
+typedef KIARA_Result (*WriteI64Func)(KIARA_Message *, int64_t);
+typedef KIARA_Result (*WriteU64Func)(KIARA_Message *, uint64_t);
+typedef KIARA_Result (*WriteFloatFunc)(KIARA_Message *, float);
+typedef KIARA_Result (*WriteDoubleFunc)(KIARA_Message *, double);
+typedef KIARA_Result (*WriteStringFunc)(KIARA_Message *, const char *);
+typedef KIARA_Result (*ReadFunc)(KIARA_Message *, void *);
+
+inline KIARA_Result writePrim(const PF &pf, PF::PrimKind kind, KIARA_Message *msg, const char *p)
+{
+    const KIARA_GenericFunc f = pf.writePrim[kind];
+    switch (kind)
+    {
+        case PF::PRIM_BOOLEAN:  return ((WriteIntFunc)f)(msg, *(const int*)p);
+        case PF::PRIM_I8:       return ((WriteI8Func)f)(msg, *(const int8_t*)p);
+        case PF::PRIM_U8:       return ((WriteU8Func)f)(msg, *(const uint8_t*)p);
+        case PF::PRIM_I16:      return ((WriteI16Func)f)(msg, *(const int16_t*)p);
+        case PF::PRIM_U16:      return ((WriteU16Func)f)(msg, *(const uint16_t*)p);
+        case PF::PRIM_I32:      return ((WriteI32Func)f)(msg, *(const int32_t*)p);
+        case PF::PRIM_U32:      return ((WriteU32Func)f)(msg, *(const uint32_t*)p);
+        case PF::PRIM_I64:      return ((WriteI64Func)f)(msg, *(const int64_t*)p);
+        case PF::PRIM_U64:      return ((WriteU64Func)f)(msg, *(const uint64_t*)p);
+        case PF::PRIM_FLOAT:    return ((WriteFloatFunc)f)(msg, *(const float*)p);
+        case PF::PRIM_DOUBLE:   return ((WriteDoubleFunc)f)(msg, *(const double*)p);
+        case PF::PRIM_STRING:   return ((WriteStringFunc)f)(msg, *(const char * const *)p);
+        default:                return KIARA_FAILURE;
+    }
+}
+
+inline KIARA_Result readPrim(const PF &pf, PF::PrimKind kind, KIARA_Message *msg, char *p)
+{
+    // all read functions receive a pointer to the destination
+    return ((ReadFunc)pf.readPrim[kind])(msg, p);
+}
+
+inline size_t loadSize(const char *p, size_t width)
+{
+    switch (width)
+    {
+        case 1: return *(const uint8_t*)p;
+        case 2: return *(const uint16_t*)p;
+        case 4: return *(const uint32_t*)p;
+        case 8: return static_cast<size_t>(*(const uint64_t*)p);
+        default: return 0;
+    }
+}
+
+inline void storeSize(char *p, size_t width, size_t size)
+{
+    switch (width)
+    {
+        case 1: *(uint8_t*)p = static_cast<uint8_t>(size); break;
+        case 2: *(uint16_t*)p = static_cast<uint16_t>(size); break;
+        case 4: *(uint32_t*)p = static_cast<uint32_t>(size); break;
+        case 8: *(uint64_t*)p = size; break;
+    }
+}
+
+struct LoopFrame
+{
+    char *base;     // base of the enclosing value
+    size_t index;
+    size_t count;
+};
+
+inline size_t alignOffset(size_t offset, size_t alignment)
+{
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+/// Returns byte size of native type, 0 when unknown
+size_t getNativeSize(const Type::Ptr &type)
+{
+    Type::Ptr ty = TypeUtils::removeTypedefs(type);
+    if (PrimType::Ptr primTy = dyn_cast<PrimType>(ty))
+        return primTy->getByteSize();
+    if (isa<PtrType>(ty))
+        return sizeof(void*);
+    if (ty->hasAttributeValue<NativeSizeAttr>())
+        return ty->getAttributeValue<NativeSizeAttr>();
+    return 0;
+}
+
+bool getPrimKind(const Type::Ptr &idlType, PF::PrimKind &kind, Type::Ptr &natIdlType)
+{
+    World &world = idlType->getWorld();
+
+#define _TYPEMAP(abstract, native, primKind)                            \
+    if (canonicallyEqual(idlType, world.KIARA_JOIN(type_,abstract)()))  \
+    {                                                                   \
+        kind = primKind;                                                \
+        natIdlType = world.KIARA_JOIN(type_c_,native)();                \
+        return true;                                                    \
+    }
+
+    _TYPEMAP(boolean, int, PF::PRIM_BOOLEAN)
+    _TYPEMAP(i8, int8_t, PF::PRIM_I8)
+    _TYPEMAP(u8, uint8_t, PF::PRIM_U8)
+    _TYPEMAP(i16, int16_t, PF::PRIM_I16)
+    _TYPEMAP(u16, uint16_t, PF::PRIM_U16)
+    _TYPEMAP(i32, int32_t, PF::PRIM_I32)
+    _TYPEMAP(u32, uint32_t, PF::PRIM_U32)
+    _TYPEMAP(i64, int64_t, PF::PRIM_I64)
+    _TYPEMAP(u64, uint64_t, PF::PRIM_U64)
+    _TYPEMAP(float, float, PF::PRIM_FLOAT)
+    _TYPEMAP(double, double, PF::PRIM_DOUBLE)
+    _TYPEMAP(string, char_ptr, PF::PRIM_STRING)
+
+#undef _TYPEMAP
+
+    return false;
+}
+
+template <class FuncPtr>
+inline bool resolveFunction(RuntimeEnvironment &env, const std::string &name, FuncPtr &func, std::string *errorMsg)
+{
+    func = (FuncPtr)(intptr_t)env.requestPointerToFunction(name, errorMsg);
+    return func != 0;
+}
+
+} // unnamed namespace
+
+#define SP_ERROR(error, code, msg)              \
+    do {                                        \
+        std::ostringstream msgs;                \
+        msgs << msg;                            \
+        (error).set((code), msgs.str());        \
+        return false;                           \
+    } while (false)
+
+// ProtocolFunctions
+
+ProtocolFunctions::ProtocolFunctions()
+{
+    memset(this, 0, sizeof(*this));
+}
+
+const char * ProtocolFunctions::getPrimKindName(PrimKind kind)
+{
+    static const char * const names[NUM_PRIM_KINDS] = {
+        "boolean", "i8", "u8", "i16", "u16", "i32", "u32",
+        "i64", "u64", "float", "double", "string"
+    };
+    return kind < NUM_PRIM_KINDS ? names[kind] : "";
+}
+
+bool ProtocolFunctions::resolve(RuntimeEnvironment &env, std::string *errorMsg)
+{
+#define _RESOLVE(name)                                                          \
+    if (!resolveFunction(env, #name, name, errorMsg))                           \
+        return false;
+
+    _RESOLVE(createRequestMessage)
+    _RESOLVE(sendMessageSync)
+    _RESOLVE(freeMessage)
+    _RESOLVE(writeStructBegin)
+    _RESOLVE(writeStructEnd)
+    _RESOLVE(writeFieldBegin)
+    _RESOLVE(writeFieldEnd)
+    _RESOLVE(readStructBegin)
+    _RESOLVE(readStructEnd)
+    _RESOLVE(readFieldBegin)
+    _RESOLVE(readFieldEnd)
+    _RESOLVE(writeArrayBegin)
+    _RESOLVE(writeArrayEnd)
+    _RESOLVE(readArrayBegin)
+    _RESOLVE(readArrayEnd)
+
+#undef _RESOLVE
+
+    for (int i = 0; i < NUM_PRIM_KINDS; ++i)
+    {
+        const std::string kindName = getPrimKindName(static_cast<PrimKind>(i));
+        if (!resolveFunction(env, "writeMessage_" + kindName, writePrim[i], errorMsg) ||
+            !resolveFunction(env, "readMessage_" + kindName, readPrim[i], errorMsg))
+            return false;
+    }
+    return true;
+}
+
+// SerializationProgram
+
+SerializationProgram::SerializationProgram()
+    : code_()
+    , names_()
+    , needsDestroy_(false)
+{
+}
+
+SerializationProgram::Instruction & SerializationProgram::addInstruction(
+    Opcode opcode, size_t offset, const std::string &name)
+{
+    Instruction instr;
+    memset(&instr, 0, sizeof(instr));
+    instr.opcode = opcode;
+    instr.offset = offset;
+    if (!name.empty())
+    {
+        names_.push_back(name);
+        instr.name = names_.back().c_str();
+    }
+    else
+        instr.name = "";
+    code_.push_back(instr);
+    return code_.back();
+}
+
+bool SerializationProgram::compile(
+    const Type::Ptr &idlType, const ElementData &idlTypeData,
+    const Type::Ptr &natType, Error &error)
+{
+    code_.clear();
+    names_.clear();
+    needsDestroy_ = false;
+
+    std::vector<Type::Ptr> activeTypes;
+    if (!emit(idlType, idlTypeData, natType, 0, 0, activeTypes, error))
+        return false;
+
+    addInstruction(OP_RETURN);
+    return true;
+}
+
+bool SerializationProgram::emit(
+    const Type::Ptr &idlType, const ElementData &idlTypeData,
+    const Type::Ptr &natType, size_t offset, size_t arrayDepth,
+    std::vector<Type::Ptr> &activeTypes, Error &error)
+{
+    const Type::Ptr natValueType = TypeUtils::removeTypedefs(natType);
+
+    if (IRGen::isEncryptedIDLType(IRGen::TypeInfo(idlType, idlTypeData)))
+        SP_ERROR(error, KIARA_UNSUPPORTED_FEATURE,
+                 "encrypted type '"<<idlType->getTypeName()<<"' is not supported by the interpreter");
+
+    if (StructType::Ptr idlStructType = dyn_cast<StructType>(idlType))
+    {
+        StructType::Ptr natStructType = dyn_cast<StructType>(natValueType);
+        if (!natStructType)
+            SP_ERROR(error, KIARA_INVALID_OPERATION,
+                     "type mismatch in interpreter: IDL struct type '"<<idlStructType->getTypeName()
+                     <<"' cannot be mapped to '"<<natType->getTypeName()<<"' native type");
+
+        if (std::find(activeTypes.begin(), activeTypes.end(), Type::Ptr(idlStructType)) != activeTypes.end())
+            SP_ERROR(error, KIARA_UNSUPPORTED_FEATURE,
+                     "recursive type '"<<idlStructType->getTypeName()<<"' is not supported by the interpreter");
+        activeTypes.push_back(idlStructType);
+
+        addInstruction(OP_STRUCT_BEGIN, 0, idlStructType->getTypeName());
+
+        for (size_t i = 0, numElems = idlStructType->getNumElements(); i < numElems; ++i)
+        {
+            Type::Ptr elemType = idlStructType->getElementAt(i);
+            const ElementData &elemData = idlStructType->getElementDataAt(i);
+            const std::string &elemName = elemData.getName();
+            const size_t natElemIndex = natStructType->getElementIndexByName(elemName);
+
+            if (natElemIndex == StructType::npos)
+                SP_ERROR(error, KIARA_INVALID_ARGUMENT,
+                         "Could not create serializer for native struct type '"
+                         <<natStructType->getTypeName()<<"', no element '"<<elemName
+                         <<"' found required by the IDL struct type '"
+                         <<idlStructType->getTypeName()<<"'");
+
+            const ElementData &natElemData = natStructType->getElementDataAt(natElemIndex);
+
+            // members with a main member annotation are not serialized
+            if (natElemData.hasAttributeValue<MainMemberAttr>())
+                continue;
+
+            if (!natElemData.hasAttributeValue<NativeOffsetAttr>())
+                SP_ERROR(error, KIARA_UNSUPPORTED_FEATURE,
+                         "unknown offset of element '"<<elemName<<"' in native struct type '"
+                         <<natStructType->getTypeName()<<"'");
+
+            const size_t elemOffset = offset + natElemData.getAttributeValue<NativeOffsetAttr>();
+            Type::Ptr natElemType = natStructType->getElementAt(natElemIndex);
+
+            addInstruction(OP_FIELD_BEGIN, 0, elemName);
+
+            if (ArrayType::Ptr idlArrayType = dyn_cast<ArrayType>(elemType))
+            {
+                // array is represented by a pointer and a dependent size member
+                const std::vector<std::string> *dependentMembers =
+                    natElemData.getAttributeValuePtr<DependentMembersAttr>();
+                if (!dependentMembers || dependentMembers->empty())
+                    SP_ERROR(error, KIARA_INVALID_ARGUMENT,
+                             "array representation as a pointer require dependent expression with the array size: "
+                             <<natElemType->getTypeName());
+
+                const size_t sizeIndex = natStructType->getElementIndexByName(dependentMembers->front());
+                if (sizeIndex == StructType::npos)
+                    SP_ERROR(error, KIARA_INVALID_ARGUMENT,
+                             "Could not create serializer for native struct type '"
+                             <<natStructType->getTypeName()<<"', no dependent element '"
+                             <<dependentMembers->front()<<"' found in the native struct type '"
+                             <<natStructType->getTypeName()<<"'");
+
+                const ElementData &sizeData = natStructType->getElementDataAt(sizeIndex);
+                PrimType::Ptr sizeType = dyn_cast<PrimType>(
+                    TypeUtils::removeTypedefs(natStructType->getElementAt(sizeIndex)));
+                if (!sizeType || !sizeType->isInteger() || !sizeData.hasAttributeValue<NativeOffsetAttr>())
+                    SP_ERROR(error, KIARA_UNSUPPORTED_FEATURE,
+                             "array size member '"<<dependentMembers->front()<<"' of native struct type '"
+                             <<natStructType->getTypeName()<<"' must be an integer with known offset");
+
+                if (!emitArray(idlArrayType, natElemType, elemOffset,
+                               offset + sizeData.getAttributeValue<NativeOffsetAttr>(),
+                               sizeType->getByteSize(), arrayDepth, activeTypes, error))
+                    return false;
+            }
+            else if (!emit(elemType, elemData, natElemType, elemOffset, arrayDepth, activeTypes, error))
+                return false;
+
+            addInstruction(OP_FIELD_END);
+        }
+
+        addInstruction(OP_STRUCT_END);
+        activeTypes.pop_back();
+        return true;
+    }
+
+    if (isa<ArrayType>(idlType))
+        SP_ERROR(error, KIARA_INVALID_ARGUMENT,
+                 "array representation as a pointer require dependent expression with the array size: "
+                 <<natType->getTypeName());
+
+    PF::PrimKind kind;
+    Type::Ptr natIdlType;
+    if (!getPrimKind(idlType, kind, natIdlType))
+        SP_ERROR(error, KIARA_UNSUPPORTED_FEATURE,
+                 "unsupported abstract type in interpreter: "<<idlType->getTypeName());
+
+    if (kind == PF::PRIM_STRING ?
+            !TypeUtils::isCStringPtrType(natValueType) :
+            !canonicallyEqual(natIdlType, natValueType))
+        SP_ERROR(error, KIARA_INVALID_OPERATION,
+                 "type mismatch in interpreter: provided native type: "
+                 <<natType->getTypeName()
+                 <<", service method require native type: "
+                 <<natIdlType->getTypeName()
+                 <<", or compatible for abstract type: "
+                 <<idlType->getTypeName());
+
+    if (kind == PF::PRIM_STRING)
+        needsDestroy_ = true;
+
+    addInstruction(OP_PRIM, offset).primKind = kind;
+    return true;
+}
+
+bool SerializationProgram::emitArray(
+    const ArrayType::Ptr &idlArrayType, const Type::Ptr &natType,
+    size_t offset, size_t sizeOffset, size_t sizeWidth, size_t arrayDepth,
+    std::vector<Type::Ptr> &activeTypes, Error &error)
+{
+    PtrType::Ptr natArrayType = dyn_cast<PtrType>(TypeUtils::removeTypedefs(natType));
+    if (!natArrayType)
+        SP_ERROR(error, KIARA_INVALID_OPERATION,
+                 "type mismatch in interpreter: IDL array type '"<<idlArrayType->getTypeName()
+                 <<"' cannot be mapped to '"<<natType->getTypeName()<<"' native type");
+
+    if (arrayDepth >= MAX_ARRAY_DEPTH)
+        SP_ERROR(error, KIARA_UNSUPPORTED_FEATURE,
+                 "arrays nested deeper than "<<MAX_ARRAY_DEPTH<<" levels are not supported by the interpreter");
+
+    const size_t elementSize = getNativeSize(natArrayType->getElementType());
+    if (elementSize == 0)
+        SP_ERROR(error, KIARA_UNSUPPORTED_FEATURE,
+                 "unknown size of native array element type '"
+                 <<natArrayType->getElementType()->getTypeName()<<"'");
+
+    needsDestroy_ = true;
+
+    const size_t beginIndex = code_.size();
+    {
+        Instruction &instr = addInstruction(OP_ARRAY_BEGIN, offset);
+        instr.sizeOffset = sizeOffset;
+        instr.sizeWidth = sizeWidth;
+        instr.elementSize = elementSize;
+    }
+
+    // element instructions use offsets relative to the element
+    if (!emit(idlArrayType->getElementType(), ElementData(), natArrayType->getElementType(),
+              0, arrayDepth + 1, activeTypes, error))
+        return false;
+
+    addInstruction(OP_ARRAY_END).jump = beginIndex + 1;
+    code_[beginIndex].jump = code_.size();
+    return true;
+}
+
+KIARA_Result SerializationProgram::serialize(const ProtocolFunctions &pf, KIARA_Message *msg, const void *value) const
+{
+    const Instruction *code = &code_[0];
+    char *base = (char*)value;
+    LoopFrame stack[MAX_ARRAY_DEPTH];
+    size_t depth = 0;
+    KIARA_Result status = KIARA_SUCCESS;
+
+    for (size_t pc = 0; ; ++pc)
+    {
+        const Instruction &instr = code[pc];
+        switch (instr.opcode)
+        {
+            case OP_PRIM:
+                status = writePrim(pf, instr.primKind, msg, base + instr.offset);
+                break;
+            case OP_STRUCT_BEGIN:
+                status = pf.writeStructBegin(msg, instr.name);
+                break;
+            case OP_STRUCT_END:
+                status = pf.writeStructEnd(msg);
+                break;
+            case OP_FIELD_BEGIN:
+                status = pf.writeFieldBegin(msg, instr.name);
+                break;
+            case OP_FIELD_END:
+                status = pf.writeFieldEnd(msg);
+                break;
+            case OP_ARRAY_BEGIN:
+            {
+                const size_t count = loadSize(base + instr.sizeOffset, instr.sizeWidth);
+                status = pf.writeArrayBegin(msg, count);
+                if (status != KIARA_SUCCESS)
+                    break;
+                char *data = *(char**)(base + instr.offset);
+                if (count == 0 || !data)
+                {
+                    status = pf.writeArrayEnd(msg);
+                    pc = instr.jump - 1;
+                    break;
+                }
+                LoopFrame &frame = stack[depth++];
+                frame.base = base;
+                frame.index = 0;
+                frame.count = count;
+                base = data;
+            }
+            break;
+            case OP_ARRAY_END:
+            {
+                LoopFrame &frame = stack[depth-1];
+                const Instruction &begin = code[instr.jump - 1];
+                if (++frame.index < frame.count)
+                {
+                    base += begin.elementSize;
+                    pc = instr.jump - 1;
+                    break;
+                }
+                base = frame.base;
+                --depth;
+                status = pf.writeArrayEnd(msg);
+            }
+            break;
+            case OP_RETURN:
+                return KIARA_SUCCESS;
+        }
+        if (status != KIARA_SUCCESS)
+            return status;
+    }
+}
+
+KIARA_Result SerializationProgram::deserialize(const ProtocolFunctions &pf, KIARA_Message *msg, void *value) const
+{
+    const Instruction *code = &code_[0];
+    char *base = (char*)value;
+    LoopFrame stack[MAX_ARRAY_DEPTH];
+    size_t depth = 0;
+    KIARA_Result status = KIARA_SUCCESS;
+
+    for (size_t pc = 0; ; ++pc)
+    {
+        const Instruction &instr = code[pc];
+        switch (instr.opcode)
+        {
+            case OP_PRIM:
+                status = readPrim(pf, instr.primKind, msg, base + instr.offset);
+                break;
+            case OP_STRUCT_BEGIN:
+                status = pf.readStructBegin(msg);
+                break;
+            case OP_STRUCT_END:
+                status = pf.readStructEnd(msg);
+                break;
+            case OP_FIELD_BEGIN:
+                status = pf.readFieldBegin(msg, instr.name);
+                break;
+            case OP_FIELD_END:
+                status = pf.readFieldEnd(msg);
+                break;
+            case OP_ARRAY_BEGIN:
+            {
+                size_t count = 0;
+                char **dataPtr = (char**)(base + instr.offset);
+
+                // same as generated deserializer: old array is replaced
+                free(*dataPtr);
+                *dataPtr = 0;
+                storeSize(base + instr.sizeOffset, instr.sizeWidth, 0);
+
+                status = pf.readArrayBegin(msg, &count);
+                if (status != KIARA_SUCCESS)
+                    break;
+                if (count == 0)
+                {
+                    status = pf.readArrayEnd(msg);
+                    pc = instr.jump - 1;
+                    break;
+                }
+                char *data = (char*)calloc(count, instr.elementSize);
+                if (!data)
+                {
+                    status = KIARA_FAILURE;
+                    break;
+                }
+                *dataPtr = data;
+                storeSize(base + instr.sizeOffset, instr.sizeWidth, count);
+
+                LoopFrame &frame = stack[depth++];
+                frame.base = base;
+                frame.index = 0;
+                frame.count = count;
+                base = data;
+            }
+            break;
+            case OP_ARRAY_END:
+            {
+                LoopFrame &frame = stack[depth-1];
+                const Instruction &begin = code[instr.jump - 1];
+                if (++frame.index < frame.count)
+                {
+                    base += begin.elementSize;
+                    pc = instr.jump - 1;
+                    break;
+                }
+                base = frame.base;
+                --depth;
+                status = pf.readArrayEnd(msg);
+            }
+            break;
+            case OP_RETURN:
+                return KIARA_SUCCESS;
+        }
+        if (status != KIARA_SUCCESS)
+            return status;
+    }
+}
+
+void SerializationProgram::destroy(void *value, bool freeStrings) const
+{
+    if (!needsDestroy_)
+        return;
+
+    const Instruction *code = &code_[0];
+    char *base = (char*)value;
+    LoopFrame stack[MAX_ARRAY_DEPTH];
+    size_t depth = 0;
+
+    for (size_t pc = 0; ; ++pc)
+    {
+        const Instruction &instr = code[pc];
+        switch (instr.opcode)
+        {
+            case OP_PRIM:
+                if (freeStrings && instr.primKind == PF::PRIM_STRING)
+                {
+                    char **strPtr = (char**)(base + instr.offset);
+                    free(*strPtr);
+                    *strPtr = 0;
+                }
+                break;
+            case OP_ARRAY_BEGIN:
+            {
+                char **dataPtr = (char**)(base + instr.offset);
+                const size_t count = loadSize(base + instr.sizeOffset, instr.sizeWidth);
+                if (count == 0 || !*dataPtr)
+                {
+                    free(*dataPtr);
+                    *dataPtr = 0;
+                    storeSize(base + instr.sizeOffset, instr.sizeWidth, 0);
+                    pc = instr.jump - 1;
+                    break;
+                }
+                LoopFrame &frame = stack[depth++];
+                frame.base = base;
+                frame.index = 0;
+                frame.count = count;
+                base = *dataPtr;
+            }
+            break;
+            case OP_ARRAY_END:
+            {
+                LoopFrame &frame = stack[depth-1];
+                const Instruction &begin = code[instr.jump - 1];
+                if (++frame.index < frame.count)
+                {
+                    base += begin.elementSize;
+                    pc = instr.jump - 1;
+                    break;
+                }
+                base = frame.base;
+                --depth;
+                char **dataPtr = (char**)(base + begin.offset);
+                free(*dataPtr);
+                *dataPtr = 0;
+                storeSize(base + begin.sizeOffset, begin.sizeWidth, 0);
+            }
+            break;
+            case OP_RETURN:
+                return;
+            default:
+                break;
+        }
+    }
+}
+
+// ClientCallProgram
+
+ClientCallProgram::ClientCallProgram()
+    : methodName_()
+    , protocol_()
+    , inputs_()
+    , result_()
+    , hasResult_(false)
+    , oneway_(false)
+    , numArgs_(0)
+{
+}
+
+bool ClientCallProgram::compile(
+    RuntimeEnvironment &env,
+    const std::string &serviceMethodName,
+    const FunctionType::Ptr &serviceMethodType,
+    const FunctionType::Ptr &funcType,
+    bool oneway,
+    Error &error)
+{
+    std::string errorMsg;
+    if (!protocol_.resolve(env, &errorMsg))
+        SP_ERROR(error, KIARA_INIT_ERROR, "Protocol does not support interpreter: "<<errorMsg);
+
+    methodName_ = serviceMethodName;
+    numArgs_ = funcType->getNumParams();
+    oneway_ = oneway;
+
+    // map native argument names to indices
+    std::map<std::string, size_t> nativeIndices;
+    for (size_t i = 0; i < numArgs_; ++i)
+        nativeIndices[funcType->getParamName(i)] = i;
+
+    if (nativeIndices.count("$exception"))
+        SP_ERROR(error, KIARA_UNSUPPORTED_FEATURE,
+                 "'$exception' argument of '"<<serviceMethodName<<"' is not supported by the interpreter");
+
+    inputs_.resize(serviceMethodType->getNumParams());
+    for (size_t i = 0; i < serviceMethodType->getNumParams(); ++i)
+    {
+        const std::string &argName = serviceMethodType->getParamName(i);
+        std::map<std::string, size_t>::const_iterator it = nativeIndices.find(argName);
+        if (it == nativeIndices.end())
+            SP_ERROR(error, KIARA_INVALID_OPERATION,
+                     "no mapping for argument '"<<argName
+                     <<"' of IDL service method '"<<serviceMethodName<<"'");
+
+        const Type::Ptr idlType = serviceMethodType->getParamType(i);
+        const Type::Ptr natType = funcType->getParamType(it->second);
+        Type::Ptr natValueType = natType;
+        Argument &arg = inputs_[i];
+        arg.index = it->second;
+        arg.dereference = false;
+
+        // Pointer (T*) is stored as a pointer to pointer (T**),
+        // reference (T&) is stored as a pointer (T*)
+        if (PtrType::Ptr pty = dyn_cast<PtrType>(natType))
+        {
+            if (!TypeUtils::isCStringPtrType(natType))
+            {
+                arg.dereference = true;
+                natValueType = pty->getElementType();
+            }
+        }
+        else if (RefType::Ptr rty = dyn_cast<RefType>(natType))
+            natValueType = rty->getElementType();
+
+        if (!arg.program.compile(idlType, serviceMethodType->getParamElementDataAt(i), natValueType, error))
+            return false;
+    }
+
+    hasResult_ = false;
+    const Type::Ptr resultIDLType = serviceMethodType->getReturnType();
+    if (!resultIDLType)
+        SP_ERROR(error, KIARA_INVALID_OPERATION, "Missing IDL service method result");
+
+    if (!oneway_ && resultIDLType != VoidType::get(resultIDLType->getWorld()))
+    {
+        std::map<std::string, size_t>::const_iterator it = nativeIndices.find("$result");
+        if (it == nativeIndices.end())
+            SP_ERROR(error, KIARA_INVALID_OPERATION, "Missing native '$result' function argument");
+
+        const Type::Ptr natType = funcType->getParamType(it->second);
+        Type::Ptr natValueType;
+        result_.index = it->second;
+        if (PtrType::Ptr pty = dyn_cast<PtrType>(natType))
+        {
+            result_.dereference = true;
+            natValueType = pty->getElementType();
+        }
+        else if (RefType::Ptr rty = dyn_cast<RefType>(natType))
+        {
+            result_.dereference = false;
+            natValueType = rty->getElementType();
+        }
+        else
+            SP_ERROR(error, KIARA_INVALID_ARGUMENT, "result type must be a pointer or reference");
+
+        if (!result_.program.compile(resultIDLType, serviceMethodType->getReturnElementData(), natValueType, error))
+            return false;
+        hasResult_ = true;
+    }
+
+    return true;
+}
+
+KIARA_Result ClientCallProgram::call(KIARA_FuncObj *closure, void *args[], size_t numArgs) const
+{
+    if (numArgs != numArgs_)
+        return KIARA_INVALID_ARGUMENT;
+
+    KIARA_Connection *conn = closure->base.connection;
+    KIARA_Message *msg = protocol_.createRequestMessage(conn, methodName_.c_str(), methodName_.length());
+    if (!msg)
+        return KIARA_FAILURE;
+
+    KIARA_Result status = KIARA_SUCCESS;
+    for (std::vector<Argument>::const_iterator it = inputs_.begin(), end = inputs_.end(); it != end; ++it)
+    {
+        status = it->program.serialize(protocol_, msg, getValuePtr(args, *it));
+        if (status != KIARA_SUCCESS)
+            break;
+    }
+
+    if (status == KIARA_SUCCESS)
+        status = protocol_.sendMessageSync(conn, msg, oneway_ ? 0 : msg);
+
+    if (status == KIARA_SUCCESS && hasResult_)
+        status = result_.program.deserialize(protocol_, msg, getValuePtr(args, result_));
+
+    protocol_.freeMessage(msg);
+    return status;
+}
+
+// ServiceCallProgram
+
+ServiceCallProgram::ServiceCallProgram()
+    : protocol_()
+    , params_()
+    , inputs_()
+    , result_()
+    , hasResult_(false)
+    , frameSize_(0)
+{
+}
+
+bool ServiceCallProgram::compile(
+    RuntimeEnvironment &env,
+    const FunctionType::Ptr &serviceMethodType,
+    const FunctionType::Ptr &funcType,
+    Error &error)
+{
+    std::string errorMsg;
+    if (!protocol_.resolve(env, &errorMsg))
+        SP_ERROR(error, KIARA_INIT_ERROR, "Protocol does not support interpreter: "<<errorMsg);
+
+    const size_t numParams = funcType->getNumParams();
+    const size_t alignment = 2 * sizeof(void*);
+
+    // Frame layout: array of argument pointers followed by parameter storage
+    std::map<std::string, size_t> nativeIndices;
+    std::vector<Type::Ptr> valueTypes(numParams);
+    size_t frameSize = numParams * sizeof(void*);
+    params_.resize(numParams);
+    for (size_t i = 0; i < numParams; ++i)
+    {
+        const std::string &paramName = funcType->getParamName(i);
+        const Type::Ptr natType = funcType->getParamType(i);
+        Parameter &param = params_[i];
+        param.slotOffset = npos;
+        nativeIndices[paramName] = i;
+
+        if (paramName == "$exception")
+            SP_ERROR(error, KIARA_UNSUPPORTED_FEATURE,
+                     "'$exception' argument of service function is not supported by the interpreter");
+
+        valueTypes[i] = natType;
+        if (PtrType::Ptr pty = dyn_cast<PtrType>(natType))
+        {
+            // strings are passed by value, other pointers refer to storage in the frame
+            if (!TypeUtils::isCStringPtrType(natType) || paramName == "$result")
+            {
+                frameSize = alignOffset(frameSize, sizeof(void*));
+                param.slotOffset = frameSize;
+                frameSize += sizeof(void*);
+                valueTypes[i] = pty->getElementType();
+            }
+        }
+        else if (RefType::Ptr rty = dyn_cast<RefType>(natType))
+            valueTypes[i] = rty->getElementType();
+
+        const size_t valueSize = getNativeSize(valueTypes[i]);
+        if (valueSize == 0)
+            SP_ERROR(error, KIARA_UNSUPPORTED_FEATURE,
+                     "unknown size of native type '"<<valueTypes[i]->getTypeName()
+                     <<"' of argument '"<<paramName<<"'");
+
+        frameSize = alignOffset(frameSize, alignment);
+        param.valueOffset = frameSize;
+        frameSize += valueSize;
+    }
+    frameSize_ = alignOffset(frameSize, alignment);
+
+    inputs_.resize(serviceMethodType->getNumParams());
+    for (size_t i = 0; i < serviceMethodType->getNumParams(); ++i)
+    {
+        const std::string &argName = serviceMethodType->getParamName(i);
+        std::map<std::string, size_t>::const_iterator it = nativeIndices.find(argName);
+        if (it == nativeIndices.end())
+            SP_ERROR(error, KIARA_INVALID_OPERATION,
+                     "no mapping for argument '"<<argName<<"' of IDL service method");
+
+        inputs_[i].paramIndex = it->second;
+        if (!inputs_[i].program.compile(serviceMethodType->getParamType(i),
+                                        serviceMethodType->getParamElementDataAt(i),
+                                        valueTypes[it->second], error))
+            return false;
+    }
+
+    hasResult_ = false;
+    const Type::Ptr resultIDLType = serviceMethodType->getReturnType();
+    if (!resultIDLType)
+        SP_ERROR(error, KIARA_INVALID_OPERATION, "Missing IDL service method result");
+
+    if (resultIDLType != VoidType::get(resultIDLType->getWorld()))
+    {
+        std::map<std::string, size_t>::const_iterator it = nativeIndices.find("$result");
+        if (it == nativeIndices.end())
+            SP_ERROR(error, KIARA_INVALID_OPERATION, "Missing native '$result' function argument");
+
+        result_.paramIndex = it->second;
+        if (!result_.program.compile(resultIDLType, serviceMethodType->getReturnElementData(),
+                                     valueTypes[it->second], error))
+            return false;
+        hasResult_ = true;
+    }
+
+    return true;
+}
+
+KIARA_Result ServiceCallProgram::call(KIARA_ServiceFuncObj *closure, KIARA_Message *outMsg, KIARA_Message *inMsg) const
+{
+    union
+    {
+        char data[FRAME_BUFFER_SIZE];
+        void *p;
+        double d;
+        int64_t i;
+    } frameBuffer;
+
+    char *frame = frameSize_ <= sizeof(frameBuffer) ? frameBuffer.data : (char*)malloc(frameSize_);
+    if (!frame)
+        return KIARA_FAILURE;
+    memset(frame, 0, frameSize_);
+
+    void **args = (void**)frame;
+    const size_t numParams = params_.size();
+    for (size_t i = 0; i < numParams; ++i)
+    {
+        const Parameter &param = params_[i];
+        if (param.slotOffset != npos)
+        {
+            *(void**)(frame + param.slotOffset) = frame + param.valueOffset;
+            args[i] = frame + param.slotOffset;
+        }
+        else
+            args[i] = frame + param.valueOffset;
+    }
+
+    KIARA_Result status = KIARA_SUCCESS;
+    for (std::vector<Argument>::const_iterator it = inputs_.begin(), end = inputs_.end(); it != end; ++it)
+    {
+        status = it->program.deserialize(protocol_, inMsg,
+                                         frame + params_[it->paramIndex].valueOffset);
+        if (status != KIARA_SUCCESS)
+            break;
+    }
+
+    if (status == KIARA_SUCCESS)
+        status = closure->base.vafunc(closure, args, numParams);
+
+    if (status == KIARA_SUCCESS && hasResult_)
+        status = result_.program.serialize(protocol_, outMsg,
+                                           frame + params_[result_.paramIndex].valueOffset);
+
+    for (std::vector<Argument>::const_iterator it = inputs_.begin(), end = inputs_.end(); it != end; ++it)
+        it->program.destroy(frame + params_[it->paramIndex].valueOffset, true);
+    if (hasResult_)
+        result_.program.destroy(frame + params_[result_.paramIndex].valueOffset, false);
+
+    if (frame != frameBuffer.data)
+        free(frame);
+    return status;
+}
+
+} // namespace Impl
+
+} // namespace KIARA
@@ -0,0 +1,257 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * SerializationProgram.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef KIARA_IMPL_SERIALIZATIONPROGRAM_HPP_INCLUDED
+#define KIARA_IMPL_SERIALIZATIONPROGRAM_HPP_INCLUDED
+
+#include <KIARA/Common/Config.hpp>
+#include <KIARA/kiara.h>
+#include <KIARA/DB/DerivedTypes.hpp>
+#include <string>
+#include <vector>
+#include <deque>
+
+namespace KIARA
+{
+
+class RuntimeEnvironment;
+
+namespace Impl
+{
+
+class Error;
+
+/// Protocol functions called by the serialization interpreter.
+/// They are resolved once from the protocol component, so a call
+/// does not perform any symbol lookups.
+struct ProtocolFunctions
+{
+    enum PrimKind
+    {
+        PRIM_BOOLEAN,
+        PRIM_I8,
+        PRIM_U8,
+        PRIM_I16,
+        PRIM_U16,
+        PRIM_I32,
+        PRIM_U32,
+        PRIM_I64,
+        PRIM_U64,
+        PRIM_FLOAT,
+        PRIM_DOUBLE,
+        PRIM_STRING,
+        NUM_PRIM_KINDS
+    };
+
+    typedef KIARA_Message * (*CreateRequestMessageFunc)(KIARA_Connection *conn, const char *name, size_t nameLength);
+    typedef KIARA_Result (*SendMessageSyncFunc)(KIARA_Connection *conn, KIARA_Message *outMsg, KIARA_Message *inMsg);
+    typedef void (*FreeMessageFunc)(KIARA_Message *msg);
+    typedef KIARA_Result (*MessageFunc)(KIARA_Message *msg);
+    typedef KIARA_Result (*MessageNameFunc)(KIARA_Message *msg, const char *name);
+    typedef KIARA_Result (*WriteArrayBeginFunc)(KIARA_Message *msg, size_t size);
+    typedef KIARA_Result (*ReadArrayBeginFunc)(KIARA_Message *msg, size_t *size);
+
+    CreateRequestMessageFunc createRequestMessage;
+    SendMessageSyncFunc sendMessageSync;
+    FreeMessageFunc freeMessage;
+
+    MessageNameFunc writeStructBegin;
+    MessageFunc writeStructEnd;
+    MessageNameFunc writeFieldBegin;
+    MessageFunc writeFieldEnd;
+    MessageFunc readStructBegin;
+    MessageFunc readStructEnd;
+    MessageNameFunc readFieldBegin;
+    MessageFunc readFieldEnd;
+    WriteArrayBeginFunc writeArrayBegin;
+    MessageFunc writeArrayEnd;
+    ReadArrayBeginFunc readArrayBegin;
+    MessageFunc readArrayEnd;
+
+    // writeMessage_<kind> and readMessage_<kind> indexed by PrimKind
+    KIARA_GenericFunc writePrim[NUM_PRIM_KINDS];
+    KIARA_GenericFunc readPrim[NUM_PRIM_KINDS];
+
+    ProtocolFunctions();
+
+    bool resolve(RuntimeEnvironment &env, std::string *errorMsg = 0);
+
+    static const char * getPrimKindName(PrimKind kind);
+};
+
+/// Flat instruction list that serializes, deserializes or destroys
+/// a native value of a single IDL type. Nested structures are inlined,
+/// arrays are executed as loops over their element instructions.
+class SerializationProgram
+{
+public:
+
+    enum Opcode
+    {
+        OP_PRIM,            // read/write primitive value at offset
+        OP_STRUCT_BEGIN,
+        OP_STRUCT_END,
+        OP_FIELD_BEGIN,
+        OP_FIELD_END,
+        OP_ARRAY_BEGIN,     // pointer at offset, number of elements at sizeOffset
+        OP_ARRAY_END,
+        OP_RETURN
+    };
+
+    struct Instruction
+    {
+        Opcode opcode;
+        ProtocolFunctions::PrimKind primKind;
+        size_t offset;          // offset of the value relative to the current base
+        size_t sizeOffset;      // OP_ARRAY_BEGIN: offset of the array size member
+        size_t sizeWidth;       // OP_ARRAY_BEGIN: byte size of the array size member
+        size_t elementSize;     // OP_ARRAY_BEGIN: native size of the array element
+        size_t jump;            // OP_ARRAY_BEGIN: instruction after the loop, OP_ARRAY_END: loop body
+        const char *name;       // struct or field name
+    };
+
+    /// Maximal nesting of arrays
+    enum { MAX_ARRAY_DEPTH = 8 };
+
+    SerializationProgram();
+
+    /// Creates program for IDL type idlType stored in the native type natType
+    bool compile(const Type::Ptr &idlType, const ElementData &idlTypeData,
+                 const Type::Ptr &natType, Error &error);
+
+    /// True when destroy() has anything to free
+    bool needsDestroy() const { return needsDestroy_; }
+
+    KIARA_Result serialize(const ProtocolFunctions &pf, KIARA_Message *msg, const void *value) const;
+
+    KIARA_Result deserialize(const ProtocolFunctions &pf, KIARA_Message *msg, void *value) const;
+
+    /// Frees arrays and, when freeStrings is true, strings allocated by deserialize()
+    void destroy(void *value, bool freeStrings) const;
+
+    const std::vector<Instruction> & getInstructions() const { return code_; }
+
+private:
+    std::vector<Instruction> code_;
+    std::deque<std::string> names_;
+    bool needsDestroy_;
+
+    bool emit(const Type::Ptr &idlType, const ElementData &idlTypeData,
+              const Type::Ptr &natType, size_t offset, size_t arrayDepth,
+              std::vector<Type::Ptr> &activeTypes, Error &error);
+
+    bool emitArray(const ArrayType::Ptr &idlArrayType, const Type::Ptr &natType,
+                   size_t offset, size_t sizeOffset, size_t sizeWidth, size_t arrayDepth,
+                   std::vector<Type::Ptr> &activeTypes, Error &error);
+
+    Instruction & addInstruction(Opcode opcode, size_t offset = 0, const std::string &name = "");
+};
+
+/// Interpreted client stub: serializes arguments, performs call
+/// and deserializes the result.
+class ClientCallProgram
+{
+public:
+
+    ClientCallProgram();
+
+    /// One-way programs only send the message and ignore the result.
+    bool compile(RuntimeEnvironment &env,
+                 const std::string &serviceMethodName,
+                 const FunctionType::Ptr &serviceMethodType,
+                 const FunctionType::Ptr &funcType,
+                 bool oneway,
+                 Error &error);
+
+    KIARA_Result call(KIARA_FuncObj *closure, void *args[], size_t numArgs) const;
+
+private:
+    struct Argument
+    {
+        size_t index;       // index in the args array
+        bool dereference;   // args[index] is a pointer to the pointer to the value
+        SerializationProgram program;
+    };
+
+    std::string methodName_;
+    ProtocolFunctions protocol_;
+    std::vector<Argument> inputs_; // in order of IDL arguments
+    Argument result_;
+    bool hasResult_;
+    bool oneway_;
+    size_t numArgs_;
+
+    static void * getValuePtr(void *args[], const Argument &arg)
+    {
+        void *p = args[arg.index];
+        return arg.dereference ? *(void**)p : p;
+    }
+};
+
+/// Interpreted service handler: deserializes arguments into a call frame,
+/// calls the service function and serializes the result.
+class ServiceCallProgram
+{
+public:
+
+    ServiceCallProgram();
+
+    bool compile(RuntimeEnvironment &env,
+                 const FunctionType::Ptr &serviceMethodType,
+                 const FunctionType::Ptr &funcType,
+                 Error &error);
+
+    KIARA_Result call(KIARA_ServiceFuncObj *closure, KIARA_Message *outMsg, KIARA_Message *inMsg) const;
+
+private:
+    struct Parameter
+    {
+        size_t slotOffset;  // offset of the pointer passed to the function, npos when passed by value
+        size_t valueOffset; // offset of the value storage
+    };
+
+    struct Argument
+    {
+        size_t paramIndex;
+        SerializationProgram program;
+    };
+
+    enum { FRAME_BUFFER_SIZE = 512 };
+
+    ProtocolFunctions protocol_;
+    std::vector<Parameter> params_;
+    std::vector<Argument> inputs_; // in order of IDL arguments
+    Argument result_;
+    bool hasResult_;
+    size_t frameSize_;
+
+    static const size_t npos = static_cast<size_t>(-1);
+};
+
+} // namespace Impl
+
+} // namespace KIARA
+
+#endif /* KIARA_IMPL_SERIALIZATIONPROGRAM_HPP_INCLUDED */
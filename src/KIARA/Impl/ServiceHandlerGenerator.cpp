@@ -47,6 +47,8 @@
 #include <boost/algorithm/string/predicate.hpp>
 
 #include "KIARA/Impl/Network.hpp"
+#include "KIARA/Impl/Interpreter.hpp"
+#include "KIARA/Impl/SerializationProgram.hpp"
 #include "KIARA/Runtime/RuntimeEnvironment.hpp"
 #include "KIARA/IRGen/IRGen.hpp"
 
@@ -223,6 +225,36 @@ KIARA_Result ServiceHandler::compileServiceFunc(
 
     DFC_DEBUG(*fty);
 
+    if (!getRuntimeEnvironment().isCompilationSupported())
+    {
+        // compilation is not supported, use serialization interpreter
+        KIARA_VAServiceFunc serviceWrapperFunc = fty->getAttributeValue<KIARA::ServiceWrapperFuncAttr>();
+        if (!serviceWrapperFunc)
+        {
+            setError(KIARA_INVALID_OPERATION,
+                "function type has no registered service wrapper function");
+            return getErrorCode();
+        }
+
+        ServiceCallProgram *program = new ServiceCallProgram;
+        if (!program->compile(getRuntimeEnvironment(), serviceMethodType, fty, getError()))
+        {
+            delete program;
+            return getErrorCode();
+        }
+
+        KIARA_ServiceFuncObj *serviceFuncObj = createServiceFuncObj();
+        serviceFuncObj->base.vafunc = serviceWrapperFunc;
+        serviceFuncObj->base.syncHandler = KIARA_ServiceInterpreter;
+        serviceFuncObj->base.funcType = getContext()->wrapType(fty);
+        serviceFuncObj->base.userData.p = program;
+        serviceFuncObj->func = serviceFuncPtr;
+
+        installServiceFunc(idlMethodName, serviceFuncPtr, serviceFuncObj);
+
+        return KIARA_SUCCESS;
+    }
+
     using namespace KIARA::Compiler;
 
     DFC_DEBUG("INFO: Creating service handler for function: "<<*fty);
@@ -732,26 +764,18 @@ KIARA_Result ServiceHandler::compileServiceFunc(
 
     DFC_DEBUG("FUNC : "<<func->toString());
 
-    if (getRuntimeEnvironment().isCompilationSupported())
-    {
-        void *funcPtr = getRuntimeEnvironment().compileFunction(func, genCtx, "KIARA_SERVICE");
-        assert(funcPtr != 0);
+    void *funcPtr = getRuntimeEnvironment().compileFunction(func, genCtx, "KIARA_SERVICE");
+    assert(funcPtr != 0);
 
-        KIARA_SyncServiceHandler serviceHandler = (KIARA_SyncServiceHandler)funcPtr;
+    KIARA_SyncServiceHandler serviceHandler = (KIARA_SyncServiceHandler)funcPtr;
 
-        KIARA_ServiceFuncObj *serviceFuncObj = createServiceFuncObj();
-        serviceFuncObj->base.syncHandler = serviceHandler;
-        serviceFuncObj->base.funcType = getContext()->wrapType(fty);
+    KIARA_ServiceFuncObj *serviceFuncObj = createServiceFuncObj();
+    serviceFuncObj->base.syncHandler = serviceHandler;
+    serviceFuncObj->base.funcType = getContext()->wrapType(fty);
 
-        installServiceFunc(idlMethodName, serviceFuncPtr, serviceFuncObj);
+    installServiceFunc(idlMethodName, serviceFuncPtr, serviceFuncObj);
 
-        return KIARA_SUCCESS;
-    }
-    else
-    {
-        setError(KIARA_UNSUPPORTED_FEATURE, "Registration with interpreter not implemented yet");
-        return getErrorCode();
-    }
+    return KIARA_SUCCESS;
 }
 
 } // namespace Impl
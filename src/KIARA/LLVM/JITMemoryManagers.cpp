@@ -146,10 +146,41 @@ KIARA::Compiler::StagingMemoryManager::StagingMemoryManager(CompilerUnit & compi
 	: llvm::SectionMemoryManager()
 	, mangler()
 	, unit(compilerUnit)
+	, codeSize(0)
+	, dataSize(0)
 {}
 
 KIARA::Compiler::StagingMemoryManager::~StagingMemoryManager() {}
 
+#if (LLVM_VERSION_MAJOR >= 3 && LLVM_VERSION_MINOR >= 4)
+uint8_t * KIARA::Compiler::StagingMemoryManager::allocateCodeSection(uintptr_t Size, unsigned Alignment, unsigned SectionID,
+                                                                     llvm::StringRef SectionName)
+{
+	codeSize += Size;
+	return SectionMemoryManager::allocateCodeSection(Size, Alignment, SectionID, SectionName);
+}
+
+uint8_t * KIARA::Compiler::StagingMemoryManager::allocateDataSection(uintptr_t Size, unsigned Alignment, unsigned SectionID,
+                                                                     llvm::StringRef SectionName, bool IsReadOnly)
+{
+	dataSize += Size;
+	return SectionMemoryManager::allocateDataSection(Size, Alignment, SectionID, SectionName, IsReadOnly);
+}
+#else
+uint8_t * KIARA::Compiler::StagingMemoryManager::allocateCodeSection(uintptr_t Size, unsigned Alignment, unsigned SectionID)
+{
+	codeSize += Size;
+	return SectionMemoryManager::allocateCodeSection(Size, Alignment, SectionID);
+}
+
+uint8_t * KIARA::Compiler::StagingMemoryManager::allocateDataSection(uintptr_t Size, unsigned Alignment, unsigned SectionID,
+                                                                     bool IsReadOnly)
+{
+	dataSize += Size;
+	return SectionMemoryManager::allocateDataSection(Size, Alignment, SectionID, IsReadOnly);
+}
+#endif
+
 void * KIARA::Compiler::StagingMemoryManager::getPointerToNamedFunction(const std::string &Name, bool AbortOnFailure)
 {
 	// librar symbol look-up
@@ -26,6 +26,7 @@
 #ifndef KIARA_LLVM_JITMEMORYMANAGERS_HPP_INCLUDED
 #define KIARA_LLVM_JITMEMORYMANAGERS_HPP_INCLUDED
 
+#include "llvm/Config/llvm-config.h"
 #include "llvm/ExecutionEngine/SectionMemoryManager.h"
 #include "llvm/ExecutionEngine/JITEventListener.h"
 #include "SymbolMangler.hpp"
@@ -74,12 +75,30 @@ namespace Compiler
 
 		CompilerUnit & unit;
 
+		// bytes allocated for code and data sections of the stage
+		size_t codeSize;
+		size_t dataSize;
+
 	public:
 		StagingMemoryManager(CompilerUnit & compilerUnit);
 
 		virtual ~StagingMemoryManager();
 
+#if (LLVM_VERSION_MAJOR >= 3 && LLVM_VERSION_MINOR >= 4)
+		virtual uint8_t *allocateCodeSection(uintptr_t Size, unsigned Alignment, unsigned SectionID,
+		                                     llvm::StringRef SectionName);
+		virtual uint8_t *allocateDataSection(uintptr_t Size, unsigned Alignment, unsigned SectionID,
+		                                     llvm::StringRef SectionName, bool IsReadOnly);
+#else
+		virtual uint8_t *allocateCodeSection(uintptr_t Size, unsigned Alignment, unsigned SectionID);
+		virtual uint8_t *allocateDataSection(uintptr_t Size, unsigned Alignment, unsigned SectionID,
+		                                     bool IsReadOnly);
+#endif
+
 		virtual void *getPointerToNamedFunction(const std::string &Name, bool AbortOnFailure = true);
+
+		size_t getCodeSize() const { return codeSize; }
+		size_t getDataSize() const { return dataSize; }
 	};
 
 	class MyJITEventListener: public llvm::JITEventListener
@@ -657,6 +657,42 @@ void llvmRemoveUnusedGlobalVariables(llvm::Module *module)
         globals[i]->eraseFromParent();
 }
 
+unsigned int llvmRemoveDuplicateDefinitions(llvm::Module *dest, llvm::Module *src)
+{
+    unsigned int numRemoved = 0;
+
+    for (llvm::Module::iterator it = src->begin(), end = src->end(); it != end; ++it)
+    {
+        llvm::Function *F = it;
+        if (F->isDeclaration() || F->hasLocalLinkage())
+            continue;
+
+        llvm::Function *destF = dest->getFunction(F->getName());
+        if (!destF || destF->isDeclaration())
+            continue;
+
+        F->deleteBody();
+        ++numRemoved;
+    }
+
+    for (llvm::Module::global_iterator it = src->global_begin(), end = src->global_end(); it != end; ++it)
+    {
+        llvm::GlobalVariable *GV = it;
+        if (GV->isDeclaration() || GV->hasLocalLinkage())
+            continue;
+
+        llvm::GlobalVariable *destGV = dest->getGlobalVariable(GV->getName(), true);
+        if (!destGV || destGV->isDeclaration())
+            continue;
+
+        GV->setInitializer(0);
+        GV->setLinkage(llvm::GlobalValue::ExternalLinkage);
+        ++numRemoved;
+    }
+
+    return numRemoved;
+}
+
 void llvmRemoveVoidFunctionCall(llvm::Function *fun)
 {
     // find all calls to the function
@@ -151,6 +151,11 @@ KIARA_API void llvmRemoveUnusedFunctionsExcept(llvm::Module *module,
 
 KIARA_API void llvmRemoveUnusedGlobalVariables(llvm::Module *module);
 
+/// Turns all externally visible definitions in src that are already defined
+/// in dest into declarations, so that src can be linked into dest without
+/// symbol conflicts. Returns number of removed definitions.
+KIARA_API unsigned int llvmRemoveDuplicateDefinitions(llvm::Module *dest, llvm::Module *src);
+
 KIARA_API void llvmRemoveVoidFunctionCall(llvm::Function *fun);
 
 /// Load LLVM plugin, uses LLVM's PluginLoader class
@@ -0,0 +1,116 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * JITTelemetry.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+#define KIARA_LIB
+#include "JITTelemetry.hpp"
+#include <ostream>
+#include <cstdio>
+
+namespace KIARA
+{
+
+namespace
+{
+
+void writeJSONString(std::ostream &out, const std::string &str)
+{
+    out << '"';
+    for (std::string::const_iterator it = str.begin(), end = str.end(); it != end; ++it)
+    {
+        const unsigned char c = static_cast<unsigned char>(*it);
+        switch (c)
+        {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (c < 0x20)
+                {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out << buf;
+                }
+                else
+                    out << *it;
+        }
+    }
+    out << '"';
+}
+
+} // unnamed namespace
+
+void writeJITTelemetryJSON(std::ostream &out,
+                           const JITStatistics &stats,
+                           const JITCompileRecordList &records)
+{
+    JITCompileRecord total;
+    for (JITCompileRecordList::const_iterator it = records.begin(), end = records.end(); it != end; ++it)
+    {
+        total.irgenTime += it->irgenTime;
+        total.evalTime += it->evalTime;
+        total.optTime += it->optTime;
+        total.linkTime += it->linkTime;
+        total.finalizeTime += it->finalizeTime;
+        total.codeSize += it->codeSize;
+        total.numLinkedExterns += it->numLinkedExterns;
+    }
+
+    out << "{\n"
+        << "  \"codeSize\": " << stats.codeSize << ",\n"
+        << "  \"dataSize\": " << stats.dataSize << ",\n"
+        << "  \"numStages\": " << stats.numStages << ",\n"
+        << "  \"numCompiled\": " << records.size() << ",\n"
+        << "  \"totalTime\": " << total.getTotalTime() << ",\n"
+        << "  \"phases\": { "
+        << "\"irgen\": " << total.irgenTime << ", "
+        << "\"eval\": " << total.evalTime << ", "
+        << "\"opt\": " << total.optTime << ", "
+        << "\"link\": " << total.linkTime << ", "
+        << "\"finalize\": " << total.finalizeTime << " },\n"
+        << "  \"functions\": [";
+
+    for (JITCompileRecordList::const_iterator it = records.begin(), end = records.end(); it != end; ++it)
+    {
+        out << (it == records.begin() ? "\n" : ",\n")
+            << "    { \"name\": ";
+        writeJSONString(out, it->name);
+        out << ", \"kind\": ";
+        writeJSONString(out, it->kind);
+        out << ", \"irgen\": " << it->irgenTime
+            << ", \"eval\": " << it->evalTime
+            << ", \"opt\": " << it->optTime
+            << ", \"link\": " << it->linkTime
+            << ", \"finalize\": " << it->finalizeTime
+            << ", \"total\": " << it->getTotalTime()
+            << ", \"codeSize\": " << it->codeSize
+            << ", \"numLinkedExterns\": " << it->numLinkedExterns
+            << " }";
+    }
+
+    out << (records.empty() ? "]\n" : "\n  ]\n") << "}\n";
+}
+
+} // namespace KIARA
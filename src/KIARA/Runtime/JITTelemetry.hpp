@@ -0,0 +1,95 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * JITTelemetry.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef KIARA_RUNTIME_JITTELEMETRY_HPP_INCLUDED
+#define KIARA_RUNTIME_JITTELEMETRY_HPP_INCLUDED
+
+#include <KIARA/Common/Config.hpp>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace KIARA
+{
+
+/// Memory used by the JIT-compiled code
+struct JITStatistics
+{
+    size_t codeSize;   // bytes of machine code
+    size_t dataSize;   // bytes of data sections
+    size_t numStages;  // number of separately freed code units
+
+    JITStatistics() : codeSize(0), dataSize(0), numStages(0) { }
+
+    JITStatistics & operator+=(const JITStatistics &other)
+    {
+        codeSize += other.codeSize;
+        dataSize += other.dataSize;
+        numStages += other.numStages;
+        return *this;
+    }
+};
+
+/// Time spent in each phase of compiling a single stub, in seconds
+struct JITCompileRecord
+{
+    std::string name;           // name of the compiled function
+    std::string kind;           // KIARA_FUNC or KIARA_SERVICE
+    double irgenTime;           // building IR expressions
+    double evalTime;            // translating IR to LLVM IR (Evaluator::compile)
+    double optTime;             // optimization passes
+    double linkTime;            // linking of native functions
+    double finalizeTime;        // machine code generation and finalization
+    size_t codeSize;            // bytes of machine code emitted for the stub
+    size_t numLinkedExterns;    // native functions linked for the stub
+
+    JITCompileRecord()
+        : name()
+        , kind()
+        , irgenTime(0.0)
+        , evalTime(0.0)
+        , optTime(0.0)
+        , linkTime(0.0)
+        , finalizeTime(0.0)
+        , codeSize(0)
+        , numLinkedExterns(0)
+    { }
+
+    double getTotalTime() const
+    {
+        return irgenTime + evalTime + optTime + linkTime + finalizeTime;
+    }
+};
+
+typedef std::vector<JITCompileRecord> JITCompileRecordList;
+
+/// Writes statistics and compile records as a JSON object
+KIARA_API void writeJITTelemetryJSON(std::ostream &out,
+                                     const JITStatistics &stats,
+                                     const JITCompileRecordList &records);
+
+} // namespace KIARA
+
+#endif /* KIARA_RUNTIME_JITTELEMETRY_HPP_INCLUDED */
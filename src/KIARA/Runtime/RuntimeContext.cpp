@@ -31,6 +31,7 @@
 
 #include "RuntimeContext.hpp"
 #include "RuntimeEnvironment.hpp"
+#include "KIARA/Impl/Core.hpp"
 
 #ifdef HAVE_LLVM
 #include "llvm/Config/llvm-config.h"
@@ -77,6 +78,43 @@ RuntimeContext::RuntimeContext(World &world)
 RuntimeContext::~RuntimeContext()
 { }
 
+JITStatistics RuntimeContext::getJITStatistics() const
+{
+    JITStatistics stats;
+    boost::mutex::scoped_lock lock(mutex_);
+    for (std::set<RuntimeEnvironment *>::const_iterator it = environments_.begin(),
+        end = environments_.end(); it != end; ++it)
+    {
+        stats += (*it)->getJITStatistics();
+    }
+    return stats;
+}
+
+JITCompileRecordList RuntimeContext::getJITCompileRecords() const
+{
+    JITCompileRecordList records;
+    boost::mutex::scoped_lock lock(mutex_);
+    for (std::set<RuntimeEnvironment *>::const_iterator it = environments_.begin(),
+        end = environments_.end(); it != end; ++it)
+    {
+        const JITCompileRecordList &envRecords = (*it)->getJITCompileRecords();
+        records.insert(records.end(), envRecords.begin(), envRecords.end());
+    }
+    return records;
+}
+
+void RuntimeContext::addRuntimeCacheFile(const std::string &path)
+{
+    boost::mutex::scoped_lock lock(mutex_);
+    runtimeCacheFiles_.insert(path);
+}
+
+std::vector<std::string> RuntimeContext::getRuntimeCacheFiles() const
+{
+    boost::mutex::scoped_lock lock(mutex_);
+    return std::vector<std::string>(runtimeCacheFiles_.begin(), runtimeCacheFiles_.end());
+}
+
 void RuntimeContext::setSearchPaths(const char *pathList)
 {
     pathFinder_.setSearchPathsFromPathList(pathList);
@@ -90,7 +128,9 @@ std::string RuntimeContext::findPath(const std::string &fileName, std::string *e
 RuntimeContext * RuntimeContext::create(World & world)
 {
 #ifdef HAVE_LLVM
-    return new LLVMRuntimeContext(world);
+    if (!KIARA::Impl::Global::getJITConfiguration().useInterpreter)
+        return new LLVMRuntimeContext(world);
+    return new InterpreterRuntimeContext(world);
 #else
     return new InterpreterRuntimeContext(world);
 #endif
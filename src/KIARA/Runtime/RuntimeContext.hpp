@@ -30,6 +30,10 @@
 #include <KIARA/DB/World.hpp>
 #include <KIARA/DB/DerivedTypes.hpp>
 #include <KIARA/Utils/PathFinder.hpp>
+#include <KIARA/Runtime/JITTelemetry.hpp>
+#include <boost/thread/mutex.hpp>
+#include <set>
+#include <vector>
 
 #ifdef HAVE_LLVM
 namespace llvm
@@ -45,6 +49,7 @@ class RuntimeEnvironment;
 
 class KIARA_API RuntimeContext
 {
+    friend class RuntimeEnvironment;
 public:
 
     virtual ~RuntimeContext();
@@ -85,6 +90,18 @@ public:
 
     static RuntimeContext * create(World & world);
 
+    /// Returns statistics summed over all live environments
+    JITStatistics getJITStatistics() const;
+
+    /// Returns compile records of all live environments
+    JITCompileRecordList getJITCompileRecords() const;
+
+    /// Records a runtime cache file (precompiled KL module) used by an environment
+    void addRuntimeCacheFile(const std::string &path);
+
+    /// Returns paths of all runtime cache files used by environments of this context
+    std::vector<std::string> getRuntimeCacheFiles() const;
+
 protected:
     RuntimeContext(World &world);
 private:
@@ -98,6 +115,11 @@ private:
     KIARA::PtrType::Ptr userTypePtrType_;
     KIARA::PtrType::Ptr dbufferPtrType_;
     KIARA::PtrType::Ptr binaryStreamPtrType_;
+    // Environments are created and destroyed by worker threads of
+    // transports, mutex_ guards all members below.
+    mutable boost::mutex mutex_;
+    std::set<RuntimeEnvironment *> environments_;
+    std::set<std::string> runtimeCacheFiles_;
 };
 
 class KIARA_API InterpreterRuntimeContext : public RuntimeContext
@@ -25,11 +25,21 @@
 #define KIARA_LIB
 #include "RuntimeEnvironment.hpp"
 #include "RuntimeContext.hpp"
+#include "KIARA/Impl/Core.hpp"
 
 #ifdef HAVE_LLVM
 #include "KIARA/Compiler/IRUtils.hpp"
 #include "KIARA/Compiler/LLVM/Evaluator.hpp"
 #include "KIARA/LLVM/Utils.hpp"
+#include "KIARA/Utils/Timer.hpp"
+#include "KIARA/Common/Version.h"
+#include "KIARA/kiara.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/Host.h"
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
 #endif
 
 // #define DFC_DO_DEBUG
@@ -40,13 +50,52 @@ namespace KIARA
 
 RuntimeEnvironment::RuntimeEnvironment(RuntimeContext &context)
     : context_(context)
-{ }
+    , maxCompileRecords_(KIARA::Impl::Global::getJITConfiguration().maxCompileRecords)
+{
+    boost::mutex::scoped_lock lock(context_.mutex_);
+    context_.environments_.insert(this);
+}
 
 RuntimeEnvironment::~RuntimeEnvironment()
-{ }
+{
+    boost::mutex::scoped_lock lock(context_.mutex_);
+    context_.environments_.erase(this);
+}
+
+void RuntimeEnvironment::addJITCompileRecord(const JITCompileRecord &record, void *funcPtr)
+{
+    if (maxCompileRecords_ == 0)
+        return;
+
+    // Long running servers compile stubs for every connection,
+    // keep only the most recent records.
+    if (compileRecords_.size() >= maxCompileRecords_)
+    {
+        const size_t numDropped = compileRecords_.size() - maxCompileRecords_ + 1;
+        compileRecords_.erase(compileRecords_.begin(), compileRecords_.begin() + numDropped);
+        compileRecordFuncs_.erase(compileRecordFuncs_.begin(), compileRecordFuncs_.begin() + numDropped);
+    }
+    compileRecords_.push_back(record);
+    compileRecordFuncs_.push_back(funcPtr);
+}
+
+void RuntimeEnvironment::removeJITCompileRecord(void *funcPtr)
+{
+    for (size_t i = 0; i < compileRecordFuncs_.size(); ++i)
+    {
+        if (compileRecordFuncs_[i] == funcPtr)
+        {
+            compileRecords_.erase(compileRecords_.begin() + i);
+            compileRecordFuncs_.erase(compileRecordFuncs_.begin() + i);
+            return;
+        }
+    }
+}
 
 InterpreterRuntimeEnvironment::InterpreterRuntimeEnvironment(InterpreterRuntimeContext &context)
     : RuntimeEnvironment(context)
+    , component_()
+    , externalFunctions_()
 {
 
 }
@@ -68,20 +117,29 @@ bool InterpreterRuntimeEnvironment::finishInitialization(std::string *errorMsg)
 
 bool InterpreterRuntimeEnvironment::loadModule(const std::string &name, std::string *errorMsg)
 {
-    // TODO what should we do here ?
-    return false;
+    // LLVM modules contain only code used by generated serializers,
+    // the interpreter does not need them.
+    DFC_DEBUG("Interpreter: ignoring module "<<name);
+    return true;
 }
 
 bool InterpreterRuntimeEnvironment::loadComponent(const std::string &name, std::string *errorMsg)
 {
-    // TODO what should we do here ?
-    return false;
+    const std::string fileName = SharedLibrary::getPlatformFileName(name+"_kp");
+    std::string path = getRuntimeContext().findPath(fileName, errorMsg);
+    if (path.empty())
+    {
+        if (errorMsg)
+            *errorMsg = "Could not find '" + fileName + "' component library";
+        return false;
+    }
+    return component_.load(path, errorMsg);
 }
 
 bool InterpreterRuntimeEnvironment::registerExternalFunction(const std::string & symbolName, void * symbolPtr)
 {
-    // TODO what should we do here ?
-    return false;
+    externalFunctions_[symbolName] = symbolPtr;
+    return true;
 }
 
 Compiler::Scope::Ptr InterpreterRuntimeEnvironment::getTopScope()
@@ -102,16 +160,79 @@ void * InterpreterRuntimeEnvironment::compileFunction(
 
 void * InterpreterRuntimeEnvironment::requestPointerToFunction(const std::string &funcName, std::string *errorMsg)
 {
-    // TODO what should we do here ?
-    return 0;
+    SymbolMap::const_iterator it = externalFunctions_.find(funcName);
+    if (it != externalFunctions_.end())
+        return it->second;
+
+    void *funcPtr = component_.getSymbol(funcName);
+    if (!funcPtr && errorMsg)
+        *errorMsg = "No function '" + funcName + "' in " +
+            (component_.isLoaded() ? component_.getPath() : std::string("runtime environment"));
+    return funcPtr;
 }
 
 #ifdef HAVE_LLVM
 
+static bool readFileToString(const std::string &fileName, std::string &contents)
+{
+    std::ifstream in(fileName.c_str(), std::ios::in | std::ios::binary);
+    if (!in)
+        return false;
+    std::ostringstream oss;
+    oss << in.rdbuf();
+    contents = oss.str();
+    return !in.bad();
+}
+
 LLVMRuntimeEnvironment::LLVMRuntimeEnvironment(LLVMRuntimeContext &context)
     : RuntimeEnvironment(context)
     , evaluator_(0)
+    , useRuntimeCache_(false)
+    , runtimeCacheDir_()
+    , cacheKey_()
 {
+    JITConfiguration jitConfig = KIARA::Impl::Global::getJITConfiguration();
+    useRuntimeCache_ = jitConfig.useRuntimeCache && !jitConfig.runtimeCacheDir.empty();
+    runtimeCacheDir_ = jitConfig.runtimeCacheDir;
+
+    // Cached bitcode depends on the library and compiler versions
+    const char *revision = kiaraGetRepositoryRevision();
+    cacheKey_.update(KIARA_VERSION)
+        .update(revision)
+        .update(LLVM_VERSION_MAJOR * 100 + LLVM_VERSION_MINOR)
+        .update(llvm::sys::getProcessTriple())
+        .update(jitConfig.useLegacyJIT ? 1 : 0);
+
+    // Builds without repository revision can't be told apart by the
+    // version, use the contents of all runtime KL sources instead.
+    if (useRuntimeCache_ && !*revision)
+    {
+        static const char *runtimeSources[] = { "stdlib.kl", "api.kl" };
+        for (size_t i = 0; i < sizeof(runtimeSources)/sizeof(runtimeSources[0]); ++i)
+        {
+            std::string contents;
+            std::string path = context.findPath(runtimeSources[i]);
+            if (path.empty() || !readFileToString(path, contents))
+            {
+                DFC_DEBUG("Could not hash runtime source "<<runtimeSources[i]<<", runtime cache disabled");
+                useRuntimeCache_ = false;
+                break;
+            }
+            cacheKey_.update(contents);
+        }
+    }
+
+    // Cached api.kl is optimized with the configured pipeline
+    cacheKey_.update(jitConfig.optLevel)
+        .update(jitConfig.loopVectorize ? 1 : 0)
+        .update(jitConfig.slpVectorize ? 1 : 0)
+        .update(jitConfig.unrollThreshold);
+    for (std::vector<std::string>::const_iterator it = jitConfig.passPipeline.begin(),
+        end = jitConfig.passPipeline.end(); it != end; ++it)
+    {
+        cacheKey_.update(*it);
+    }
+
     evaluator_ = new KIARA::Compiler::Evaluator(
         context.getWorld(),
         context.getLLVMContext()/*KIARA::llvmGetGlobalContext()*/);
@@ -129,7 +250,7 @@ LLVMRuntimeEnvironment::LLVMRuntimeEnvironment(LLVMRuntimeContext &context)
 
 bool LLVMRuntimeEnvironment::startInitialization(std::string *errorMsg)
 {
-    if (!includeFile("stdlib.kl", errorMsg))
+    if (!includeCachedFile("stdlib.kl", false, errorMsg))
         return false;
 
     return true;
@@ -137,11 +258,9 @@ bool LLVMRuntimeEnvironment::startInitialization(std::string *errorMsg)
 
 bool LLVMRuntimeEnvironment::finishInitialization(std::string *errorMsg)
 {
-    if (!includeFile("api.kl", errorMsg))
+    if (!includeCachedFile("api.kl", true, errorMsg))
         return false;
 
-    evaluator_->optimizeModule();
-
     return true;
 }
 
@@ -168,20 +287,36 @@ void * LLVMRuntimeEnvironment::compileFunction(
     std::string *errorMsg)
 {
     DFC_DEBUG("Compile function: "<<func->getName());
+
+    JITCompileRecord record;
+    record.name = func->getName();
+    record.kind = infoHint;
+
+    Timer timer;
+    record.irgenTime = Timer::now() - genCtx.startTime;
+
     for (std::vector<KIARA::IR::IRExpr::Ptr>::const_iterator it = genCtx.expressions.begin(),
             end = genCtx.expressions.end(); it != end; ++it)
     {
         evaluator_->compile(*it);
     }
 
+    // Helper functions are shared with functions compiled later,
+    // only the code of func itself is freed on releaseFunction.
+    evaluator_->pinCompiledCode();
+
     llvm::Value *llvmFunc = evaluator_->compile(func);
+    record.evalTime = timer.lap();
 
     DFC_IFDEBUG(evaluator_->writeModule(infoHint+"_NO_OPT.bc"));
+    timer.restart();
 
     evaluator_->optimizeFunction(llvmFunc);
     // evaluator_->optimizeModule();
+    record.optTime = timer.lap();
 
     DFC_IFDEBUG(evaluator_->writeModule(infoHint+".bc"));
+    timer.restart();
 
     functionLinkMap_.insert(genCtx.functionLinkMap.begin(), genCtx.functionLinkMap.end());
 
@@ -191,13 +326,21 @@ void * LLVMRuntimeEnvironment::compileFunction(
         // FIXME This code assumes that functions are never overridden
         if (!evaluator_->isFunctionGenerated(it->first))
         {
-            evaluator_->linkNativeFuncOrReplaceWithImpl(it->first, it->second.funcPtr, it->second.funcName);
+            if (evaluator_->linkNativeFuncOrReplaceWithImpl(it->first, it->second.funcPtr, it->second.funcName))
+                ++record.numLinkedExterns;
         }
     }
+    record.linkTime = timer.lap();
 
     DFC_DEBUG("LLVM FUNC: "<<KIARA::llvmToString(llvmFunc));
+    timer.restart();
+
+    const size_t codeSize = evaluator_->getJITCodeSize();
+    void *funcPtr = evaluator_->acquirePointerToFunction(llvmFunc);
+    record.finalizeTime = timer.lap();
+    record.codeSize = evaluator_->getJITCodeSize() - codeSize;
 
-    void *funcPtr = evaluator_->getPointerToFunction(llvmFunc);
+    addJITCompileRecord(record, funcPtr);
     return funcPtr;
 }
 
@@ -206,6 +349,21 @@ void * LLVMRuntimeEnvironment::requestPointerToFunction(const std::string &funcN
     return evaluator_->getPointerToFunction(funcName);
 }
 
+void LLVMRuntimeEnvironment::releaseFunction(void *funcPtr)
+{
+    removeJITCompileRecord(funcPtr);
+    evaluator_->releasePointerToFunction(funcPtr);
+}
+
+JITStatistics LLVMRuntimeEnvironment::getJITStatistics() const
+{
+    JITStatistics stats;
+    stats.codeSize = evaluator_->getJITCodeSize();
+    stats.dataSize = evaluator_->getJITDataSize();
+    stats.numStages = evaluator_->getNumJITStages();
+    return stats;
+}
+
 bool LLVMRuntimeEnvironment::includeFile(const std::string &fileName, std::string *errorMsg)
 {
     std::string path = getRuntimeContext().findPath(fileName, errorMsg);
@@ -238,6 +396,96 @@ bool LLVMRuntimeEnvironment::loadModule(const std::string &fileName, std::string
             errorMsg->swap(tmpErrorMsg);
         return false;
     }
+
+    updateCacheKey(path);
+    return true;
+}
+
+void LLVMRuntimeEnvironment::updateCacheKey(const std::string &path)
+{
+    if (!useRuntimeCache_)
+        return;
+
+    // For binary modules it is enough to track file identity
+    boost::system::error_code ec;
+    cacheKey_.update(path);
+    cacheKey_.update(static_cast<uint64_t>(boost::filesystem::file_size(path, ec)));
+    cacheKey_.update(static_cast<uint64_t>(boost::filesystem::last_write_time(path, ec)));
+}
+
+bool LLVMRuntimeEnvironment::includeCachedFile(const std::string &fileName, bool optimize, std::string *errorMsg)
+{
+    std::string path = getRuntimeContext().findPath(fileName, errorMsg);
+    if (path.empty())
+    {
+        if (errorMsg)
+            *errorMsg = "Could not find include '" + fileName + "' file";
+        return false;
+    }
+
+    std::string cachePath;
+    if (useRuntimeCache_)
+    {
+        std::string contents;
+        if (readFileToString(path, contents))
+        {
+            cacheKey_.update(fileName).update(contents);
+            boost::filesystem::path p(runtimeCacheDir_);
+            p /= boost::filesystem::path(fileName).stem().string() + "-" + cacheKey_.toHexString() + ".bc";
+            cachePath = p.string();
+        }
+    }
+
+    if (!cachePath.empty() && boost::filesystem::exists(cachePath))
+    {
+        std::string tmpErrorMsg;
+        // Optimized cache files contain optimized versions of all definitions
+        // that are in the active module now, e.g. of stdlib.kl and components.
+        if (evaluator_->linkPrecompiledModule(cachePath, optimize, tmpErrorMsg))
+        {
+            DFC_DEBUG("Using cached runtime module "<<cachePath);
+            getRuntimeContext().addRuntimeCacheFile(cachePath);
+            // Parse the file in order to populate the scope, code is not generated again
+            evaluator_->setReuseExistingDefinitions(true);
+            evaluator_->includeFile(path);
+            evaluator_->setReuseExistingDefinitions(false);
+            return true;
+        }
+        DFC_DEBUG("Could not use cached runtime module "<<cachePath<<": "<<tmpErrorMsg);
+    }
+
+    // FIXME: pass errorMsg to includeFile
+    evaluator_->includeFile(path);
+
+    if (optimize)
+        evaluator_->optimizeModule();
+
+    if (!cachePath.empty())
+    {
+        // Write to a temporary file first, so that concurrently starting
+        // processes never see a partially written module.
+        boost::system::error_code ec;
+        boost::filesystem::create_directories(runtimeCacheDir_, ec);
+
+        std::ostringstream tmpPath;
+        tmpPath << cachePath << ".tmp" << boost::filesystem::unique_path().string();
+
+        std::string tmpErrorMsg;
+        if (evaluator_->writeModule(tmpPath.str(), tmpErrorMsg))
+        {
+            boost::filesystem::rename(tmpPath.str(), cachePath, ec);
+            if (ec)
+                boost::filesystem::remove(tmpPath.str(), ec);
+            else
+                getRuntimeContext().addRuntimeCacheFile(cachePath);
+        }
+        else
+        {
+            DFC_DEBUG("Could not write runtime cache file "<<cachePath<<": "<<tmpErrorMsg);
+            boost::filesystem::remove(tmpPath.str(), ec);
+        }
+    }
+
     return true;
 }
 
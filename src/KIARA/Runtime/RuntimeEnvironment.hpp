@@ -29,8 +29,12 @@
 #include <KIARA/Common/Config.hpp>
 #include <KIARA/Compiler/Scope.hpp>
 #include <KIARA/IRGen/IRGen.hpp>
+#include <KIARA/Utils/Hash.hpp>
+#include <KIARA/Utils/SharedLibrary.hpp>
+#include <KIARA/Runtime/JITTelemetry.hpp>
 
 #include <string>
+#include <map>
 
 #ifdef HAVE_LLVM
 namespace KIARA
@@ -74,10 +78,29 @@ public:
 
     virtual void * requestPointerToFunction(const std::string &funcName, std::string *errorMsg = 0) = 0;
 
+    /// Releases function returned by compileFunction, its code is freed
+    /// when not used by other functions anymore.
+    virtual void releaseFunction(void *funcPtr) { }
+
+    virtual JITStatistics getJITStatistics() const { return JITStatistics(); }
+
+    /// Returns compile time breakdown of the functions compiled by compileFunction
+    /// that are not released yet, at most JITConfiguration::maxCompileRecords
+    /// of the most recently compiled ones.
+    const JITCompileRecordList & getJITCompileRecords() const { return compileRecords_; }
+
 protected:
     RuntimeEnvironment(RuntimeContext &context);
+
+    void addJITCompileRecord(const JITCompileRecord &record, void *funcPtr);
+
+    /// Drops compile record of a released function
+    void removeJITCompileRecord(void *funcPtr);
 private:
     RuntimeContext &context_;
+    size_t maxCompileRecords_;
+    JITCompileRecordList compileRecords_;
+    std::vector<void *> compileRecordFuncs_; // compiled function of each record
 };
 
 class InterpreterRuntimeContext;
@@ -111,6 +134,12 @@ public:
     virtual ~InterpreterRuntimeEnvironment();
 
 private:
+    typedef std::map<std::string, void *> SymbolMap;
+
+    // Protocol component compiled to a native shared library
+    SharedLibrary component_;
+    SymbolMap externalFunctions_;
+
     InterpreterRuntimeEnvironment(InterpreterRuntimeContext &context);
 };
 
@@ -151,13 +180,31 @@ public:
 
     virtual void * requestPointerToFunction(const std::string &funcName, std::string *errorMsg = 0);
 
+    virtual void releaseFunction(void *funcPtr);
+
+    virtual JITStatistics getJITStatistics() const;
+
     bool includeFile(const std::string &fileName, std::string *errorMsg = 0);
     bool loadPluginLibrary(const std::string &libName, std::string *errorMsg = 0);
     bool writeModule(const std::string &fileName, std::string *errorMsg = 0);
 
+    /// Like includeFile but uses precompiled bitcode from the runtime cache
+    /// when available, and stores compiled result into the cache otherwise.
+    /// When optimize is true, active module is optimized before caching,
+    /// and on a cache hit the cached definitions replace the unoptimized
+    /// ones that are already in the active module.
+    bool includeCachedFile(const std::string &fileName, bool optimize, std::string *errorMsg = 0);
+
 private:
     KIARA::Compiler::Evaluator *evaluator_;
     FunctionLinkMap functionLinkMap_; // this map records all external functions
+    bool useRuntimeCache_;
+    std::string runtimeCacheDir_;
+    // Identifies everything that was compiled or loaded into the environment
+    // so far, cached code is only valid for the same sequence of inputs.
+    ContentHash cacheKey_;
+
+    void updateCacheKey(const std::string &path);
 
     LLVMRuntimeEnvironment(LLVMRuntimeContext &context);
 };
@@ -0,0 +1,524 @@
+/*
+ * ConnectionPool.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#include "ConnectionPool.hpp"
+#include <zmq.h>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <sstream>
+#include <cstring>
+#include <cerrno>
+#include <map>
+#include <stdint.h>
+
+#define DFC_DO_DEBUG
+#include <DFC/Utils/Debug.hpp>
+
+namespace KIARA
+{
+namespace Transport
+{
+
+/// Physical connection to a peer
+struct ConnectionPool::Channel
+{
+    std::string host;
+    unsigned short port;
+    std::string endpoint;
+    void *socket;                   // created and used by the I/O thread only
+    unsigned int numUsers;          // number of logical connections
+    uint32_t nextRequestId;
+    boost::posix_time::ptime lastUsed;
+    bool closed;                    // removed from the pool, socket will be closed
+    std::map<uint32_t, PendingCall*> pending; // used by the I/O thread only
+
+    Channel(const std::string &host, unsigned short port)
+        : host(host)
+        , port(port)
+        , endpoint("tcp://" + host + ":" + boost::lexical_cast<std::string>(port))
+        , socket(0)
+        , numUsers(0)
+        , nextRequestId(0)
+        , lastUsed(boost::posix_time::microsec_clock::universal_time())
+        , closed(false)
+        , pending()
+    { }
+};
+
+struct ConnectionPool::PendingCall
+{
+    ChannelPtr channel;
+    uint32_t id;
+    const void *data;
+    size_t dataSize;
+    kr_dbuffer_t *destBuf;
+    boost::posix_time::ptime deadline; // not_a_date_time when the call never expires
+    bool done;
+    std::string errorMsg;           // empty on success
+    boost::condition_variable cond;
+
+    PendingCall(const ChannelPtr &channel, const void *data, size_t dataSize, kr_dbuffer_t *destBuf)
+        : channel(channel)
+        , id(0)
+        , data(data)
+        , dataSize(dataSize)
+        , destBuf(destBuf)
+        , deadline()
+        , done(false)
+        , errorMsg()
+    { }
+};
+
+namespace
+{
+
+std::string zmqErrorMessage()
+{
+    return std::string("ZeroMQ error: ") + zmq_strerror(zmq_errno());
+}
+
+bool sendRequest(void *socket, uint32_t id, const void *data, size_t dataSize)
+{
+    return zmq_send(socket, &id, sizeof(id), ZMQ_SNDMORE) != -1 &&
+           zmq_send(socket, 0, 0, ZMQ_SNDMORE) != -1 &&
+           zmq_send(socket, data, dataSize, 0) != -1;
+}
+
+/// Receives one [request id][empty][payload] reply without blocking.
+/// Returns false when no message is available, id is 0xffffffff if the message was malformed.
+bool receiveReply(void *socket, uint32_t &id, zmq_msg_t &payload)
+{
+    id = 0xffffffff;
+    std::vector<zmq_msg_t> frames;
+    int more = 0;
+    do
+    {
+        zmq_msg_t frame;
+        zmq_msg_init(&frame);
+        if (zmq_msg_recv(&frame, socket, frames.empty() ? ZMQ_DONTWAIT : 0) == -1)
+        {
+            zmq_msg_close(&frame);
+            break;
+        }
+        frames.push_back(frame);
+        more = zmq_msg_more(&frames.back());
+    } while (more);
+
+    if (frames.empty())
+        return false;
+
+    if (frames.size() == 3 && zmq_msg_size(&frames[0]) == sizeof(id) && zmq_msg_size(&frames[1]) == 0)
+    {
+        memcpy(&id, zmq_msg_data(&frames[0]), sizeof(id));
+        zmq_msg_move(&payload, &frames[2]);
+    }
+
+    for (size_t i = 0; i < frames.size(); ++i)
+        zmq_msg_close(&frames[i]);
+    return true;
+}
+
+} // unnamed namespace
+
+/// ConnectionPool
+
+ConnectionPool::ConnectionPool(const ConnectionPoolConfiguration &config)
+    : config_(config)
+    , mutex_()
+    , zmqContext_(zmq_ctx_new())
+    , wakeSender_(0)
+    , wakeReceiver_(0)
+    , stopping_(false)
+    , channels_()
+    , outgoing_()
+    , thread_(0)
+{
+    std::ostringstream oss;
+    oss << "inproc://kiara-connection-pool-" << static_cast<const void*>(this);
+    const std::string wakeEndpoint = oss.str();
+
+    int linger = 0;
+    wakeReceiver_ = zmq_socket(zmqContext_, ZMQ_PAIR);
+    zmq_setsockopt(wakeReceiver_, ZMQ_LINGER, &linger, sizeof(linger));
+    zmq_bind(wakeReceiver_, wakeEndpoint.c_str());
+    wakeSender_ = zmq_socket(zmqContext_, ZMQ_PAIR);
+    zmq_setsockopt(wakeSender_, ZMQ_LINGER, &linger, sizeof(linger));
+    zmq_connect(wakeSender_, wakeEndpoint.c_str());
+
+    thread_ = new boost::thread(boost::bind(&ConnectionPool::run, this));
+}
+
+ConnectionPool::~ConnectionPool()
+{
+    {
+        boost::mutex::scoped_lock lock(mutex_);
+        stopping_ = true;
+        wakeup();
+    }
+    thread_->join();
+    delete thread_;
+
+    zmq_close(wakeSender_);
+    zmq_close(wakeReceiver_);
+    zmq_ctx_term(zmqContext_);
+}
+
+size_t ConnectionPool::getNumChannels() const
+{
+    boost::mutex::scoped_lock lock(mutex_);
+    return channels_.size();
+}
+
+void ConnectionPool::wakeup()
+{
+    // When the send would block the I/O thread has pending wakeups anyway
+    zmq_send(wakeSender_, 0, 0, ZMQ_DONTWAIT);
+}
+
+Connection::Ptr ConnectionPool::openConnection(const std::string &host, unsigned short port, boost::system::error_code *errorCode)
+{
+    ChannelPtr channel = acquireChannel(host, port, errorCode);
+    if (!channel)
+        return Connection::Ptr();
+    return Connection::Ptr(new PooledConnection(shared_from_this(), channel));
+}
+
+ConnectionPool::ChannelPtr ConnectionPool::acquireChannel(const std::string &host, unsigned short port, boost::system::error_code *errorCode)
+{
+    boost::mutex::scoped_lock lock(mutex_);
+
+    // Find least used channel to the peer
+    ChannelPtr best;
+    unsigned int numPeerChannels = 0;
+    for (std::vector<ChannelPtr>::const_iterator it = channels_.begin(), end = channels_.end(); it != end; ++it)
+    {
+        if ((*it)->port != port || (*it)->host != host)
+            continue;
+        ++numPeerChannels;
+        if (!best || (*it)->numUsers < best->numUsers)
+            best = *it;
+    }
+
+    // Multiplex only when no further channel can be opened or an unused one exists
+    bool canOpen = (!best || best->numUsers > 0) && numPeerChannels < config_.maxConnectionsPerPeer;
+    if (canOpen && channels_.size() >= config_.maxConnections)
+    {
+        // Make room by closing the longest unused channel to another peer
+        std::vector<ChannelPtr>::iterator victim = channels_.end();
+        for (std::vector<ChannelPtr>::iterator it = channels_.begin(), end = channels_.end(); it != end; ++it)
+        {
+            if ((*it)->numUsers == 0 && ((*it)->port != port || (*it)->host != host) &&
+                (victim == channels_.end() || (*it)->lastUsed < (*victim)->lastUsed))
+                victim = it;
+        }
+        if (victim != channels_.end())
+        {
+            DFC_DEBUG("ConnectionPool: close idle channel to "<<(*victim)->endpoint);
+            (*victim)->closed = true;
+            channels_.erase(victim);
+        }
+        else
+            canOpen = false;
+    }
+
+    if (canOpen)
+    {
+        best.reset(new Channel(host, port));
+        channels_.push_back(best);
+        DFC_DEBUG("ConnectionPool: open channel to "<<best->endpoint);
+    }
+    else if (!best)
+    {
+        if (errorCode)
+            errorCode->assign(boost::system::errc::resource_unavailable_try_again, boost::system::system_category());
+        return ChannelPtr();
+    }
+
+    ++best->numUsers;
+    wakeup();
+    return best;
+}
+
+void ConnectionPool::releaseChannel(const ChannelPtr &channel)
+{
+    boost::mutex::scoped_lock lock(mutex_);
+    if (--channel->numUsers == 0)
+        channel->lastUsed = boost::posix_time::microsec_clock::universal_time();
+}
+
+bool ConnectionPool::call(const ChannelPtr &channel, const void *data, size_t dataSize, kr_dbuffer_t *destBuf, std::string *errorMsg)
+{
+    PendingCall pendingCall(channel, data, dataSize, destBuf);
+
+    boost::mutex::scoped_lock lock(mutex_);
+    if (stopping_ || channel->closed)
+    {
+        if (errorMsg)
+            *errorMsg = "Connection pool is closed";
+        return false;
+    }
+
+    pendingCall.id = channel->nextRequestId++;
+    if (config_.callTimeout > 0)
+        pendingCall.deadline = boost::posix_time::microsec_clock::universal_time() +
+            boost::posix_time::milliseconds(config_.callTimeout);
+    outgoing_.push_back(&pendingCall);
+    wakeup();
+
+    // I/O thread completes the call also when its deadline expires
+    while (!pendingCall.done)
+        pendingCall.cond.wait(lock);
+
+    channel->lastUsed = boost::posix_time::microsec_clock::universal_time();
+
+    if (!pendingCall.errorMsg.empty())
+    {
+        if (errorMsg)
+            *errorMsg = pendingCall.errorMsg;
+        return false;
+    }
+    return true;
+}
+
+void ConnectionPool::run()
+{
+    std::vector<ChannelPtr> active;     // channels with open sockets
+    std::vector<PendingCall*> toSend;
+    std::vector<PendingCall*> finished;
+    std::vector<zmq_pollitem_t> pollItems;
+    long pollTimeout = config_.idleTimeout > 0 ? std::min<long>(config_.idleTimeout, 1000) : 1000;
+    if (config_.callTimeout > 0)
+        pollTimeout = std::min<long>(pollTimeout, config_.callTimeout);
+    const int linger = 0;
+
+    for (;;)
+    {
+        {
+            boost::mutex::scoped_lock lock(mutex_);
+
+            // Complete calls processed in the previous iteration
+            for (std::vector<PendingCall*>::iterator it = finished.begin(), end = finished.end(); it != end; ++it)
+            {
+                (*it)->done = true;
+                (*it)->cond.notify_one();
+            }
+            finished.clear();
+
+            // Close idle channels, an idle timeout of 0 keeps them open
+            const boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+            for (std::vector<ChannelPtr>::iterator it = channels_.begin(); config_.idleTimeout > 0 && it != channels_.end();)
+            {
+                if ((*it)->numUsers == 0 && (*it)->pending.empty() &&
+                    now - (*it)->lastUsed >= boost::posix_time::milliseconds(config_.idleTimeout))
+                {
+                    DFC_DEBUG("ConnectionPool: close idle channel to "<<(*it)->endpoint);
+                    (*it)->closed = true;
+                    it = channels_.erase(it);
+                }
+                else
+                    ++it;
+            }
+
+            if (stopping_)
+            {
+                for (std::vector<ChannelPtr>::iterator it = channels_.begin(), end = channels_.end(); it != end; ++it)
+                    (*it)->closed = true;
+                channels_.clear();
+            }
+
+            // Synchronize sockets with the channel list
+            for (std::vector<ChannelPtr>::iterator it = active.begin(); it != active.end();)
+            {
+                if ((*it)->closed)
+                {
+                    for (std::map<uint32_t, PendingCall*>::iterator pit = (*it)->pending.begin(),
+                         pend = (*it)->pending.end(); pit != pend; ++pit)
+                    {
+                        pit->second->errorMsg = "Connection closed";
+                        pit->second->done = true;
+                        pit->second->cond.notify_one();
+                    }
+                    (*it)->pending.clear();
+                    zmq_close((*it)->socket);
+                    (*it)->socket = 0;
+                    it = active.erase(it);
+                }
+                else
+                    ++it;
+            }
+            for (std::vector<ChannelPtr>::iterator it = channels_.begin(), end = channels_.end(); it != end; ++it)
+            {
+                if ((*it)->socket)
+                    continue;
+                (*it)->socket = zmq_socket(zmqContext_, ZMQ_DEALER);
+                zmq_setsockopt((*it)->socket, ZMQ_LINGER, &linger, sizeof(linger));
+                if (zmq_connect((*it)->socket, (*it)->endpoint.c_str()) != 0)
+                {
+                    DFC_DEBUG("ConnectionPool: could not connect to "<<(*it)->endpoint<<": "<<zmqErrorMessage());
+                }
+                active.push_back(*it);
+            }
+
+            if (stopping_)
+            {
+                for (std::deque<PendingCall*>::iterator it = outgoing_.begin(), end = outgoing_.end(); it != end; ++it)
+                {
+                    (*it)->errorMsg = "Connection pool is closed";
+                    (*it)->done = true;
+                    (*it)->cond.notify_one();
+                }
+                outgoing_.clear();
+                break;
+            }
+
+            toSend.assign(outgoing_.begin(), outgoing_.end());
+            outgoing_.clear();
+        }
+
+        for (std::vector<PendingCall*>::iterator it = toSend.begin(), end = toSend.end(); it != end; ++it)
+        {
+            PendingCall *pendingCall = *it;
+            Channel &channel = *pendingCall->channel;
+            if (!channel.socket)
+            {
+                pendingCall->errorMsg = "Connection closed";
+                finished.push_back(pendingCall);
+            }
+            else if (!sendRequest(channel.socket, pendingCall->id, pendingCall->data, pendingCall->dataSize))
+            {
+                pendingCall->errorMsg = zmqErrorMessage();
+                finished.push_back(pendingCall);
+            }
+            else
+                channel.pending[pendingCall->id] = pendingCall;
+        }
+        toSend.clear();
+
+        if (!finished.empty())
+            continue;
+
+        pollItems.resize(active.size() + 1);
+        pollItems[0].socket = wakeReceiver_;
+        pollItems[0].fd = 0;
+        pollItems[0].events = ZMQ_POLLIN;
+        pollItems[0].revents = 0;
+        for (size_t i = 0; i < active.size(); ++i)
+        {
+            pollItems[i+1].socket = active[i]->socket;
+            pollItems[i+1].fd = 0;
+            pollItems[i+1].events = ZMQ_POLLIN;
+            pollItems[i+1].revents = 0;
+        }
+
+        if (zmq_poll(&pollItems[0], static_cast<int>(pollItems.size()), pollTimeout) == -1)
+        {
+            if (zmq_errno() == EINTR)
+                continue;
+            DFC_DEBUG("ConnectionPool: "<<zmqErrorMessage());
+            break;
+        }
+
+        if (pollItems[0].revents & ZMQ_POLLIN)
+        {
+            while (zmq_recv(wakeReceiver_, 0, 0, ZMQ_DONTWAIT) != -1)
+                ;
+        }
+
+        for (size_t i = 0; i < active.size(); ++i)
+        {
+            if (!(pollItems[i+1].revents & ZMQ_POLLIN))
+                continue;
+
+            Channel &channel = *active[i];
+            uint32_t id;
+            zmq_msg_t payload;
+            zmq_msg_init(&payload);
+            while (receiveReply(channel.socket, id, payload))
+            {
+                std::map<uint32_t, PendingCall*>::iterator it = channel.pending.find(id);
+                if (it != channel.pending.end())
+                {
+                    PendingCall *pendingCall = it->second;
+                    channel.pending.erase(it);
+                    kr_dbuffer_append_mem(pendingCall->destBuf, zmq_msg_data(&payload), zmq_msg_size(&payload));
+                    finished.push_back(pendingCall);
+                }
+                else
+                {
+                    DFC_DEBUG("ConnectionPool: dropped reply from "<<channel.endpoint);
+                }
+                zmq_msg_close(&payload);
+                zmq_msg_init(&payload);
+            }
+            zmq_msg_close(&payload);
+        }
+
+        // Fail calls whose replies did not arrive in time, late replies are dropped
+        if (config_.callTimeout > 0)
+        {
+            const boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+            for (size_t i = 0; i < active.size(); ++i)
+            {
+                std::map<uint32_t, PendingCall*> &pending = active[i]->pending;
+                for (std::map<uint32_t, PendingCall*>::iterator it = pending.begin(); it != pending.end();)
+                {
+                    if (now >= it->second->deadline)
+                    {
+                        it->second->errorMsg = "Call timed out";
+                        finished.push_back(it->second);
+                        pending.erase(it++);
+                    }
+                    else
+                        ++it;
+                }
+            }
+        }
+    }
+
+    for (std::vector<ChannelPtr>::iterator it = active.begin(), end = active.end(); it != end; ++it)
+    {
+        if ((*it)->socket)
+        {
+            zmq_close((*it)->socket);
+            (*it)->socket = 0;
+        }
+    }
+}
+
+/// PooledConnection
+
+PooledConnection::PooledConnection(const ConnectionPool::Ptr &pool, const ConnectionPool::ChannelPtr &channel)
+    : pool_(pool)
+    , channel_(channel)
+{
+}
+
+PooledConnection::~PooledConnection()
+{
+    pool_->releaseChannel(channel_);
+}
+
+bool PooledConnection::call(const DBuffer &request, DBuffer &response, std::string *errorMsg)
+{
+    return pool_->call(channel_, request.data(), request.size(), response.get_dbuffer(), errorMsg);
+}
+
+std::string PooledConnection::getRemoteHostName() const
+{
+    return channel_->host;
+}
+
+unsigned short PooledConnection::getRemotePort() const
+{
+    return channel_->port;
+}
+
+} // namespace Transport
+} // namespace KIARA
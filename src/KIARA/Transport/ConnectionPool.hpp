@@ -0,0 +1,119 @@
+/*
+ * ConnectionPool.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef KIARA_TRANSPORT_CONNECTIONPOOL_HPP_INCLUDED
+#define KIARA_TRANSPORT_CONNECTIONPOOL_HPP_INCLUDED
+
+#include "Transport.hpp"
+#include <KIARA/DB/ConnectionPoolConfiguration.hpp>
+#include <KIARA/CDT/kr_dbuffer.h>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace KIARA
+{
+namespace Transport
+{
+
+class ConnectionPool;
+typedef boost::shared_ptr<ConnectionPool> ConnectionPoolPtr;
+
+/// Pool of ZeroMQ DEALER sockets shared by the client connections of a context.
+///
+/// Each request is sent as [request id][empty][payload]. The REQ/REP envelope
+/// handling of the server echoes the request id back, replies are dispatched
+/// to the waiting caller by it, so calls from many threads and logical
+/// connections can be in flight on a single socket.
+///
+/// All sockets are owned by a single I/O thread, callers only enqueue requests
+/// and wait for their replies. The I/O thread fails calls without reply after
+/// ConnectionPoolConfiguration::callTimeout.
+class ConnectionPool : public boost::enable_shared_from_this<ConnectionPool>, private boost::noncopyable
+{
+public:
+    typedef ConnectionPoolPtr Ptr;
+
+    struct Channel;
+    typedef boost::shared_ptr<Channel> ChannelPtr;
+
+    explicit ConnectionPool(const ConnectionPoolConfiguration &config);
+
+    ~ConnectionPool();
+
+    const ConnectionPoolConfiguration & getConfiguration() const { return config_; }
+
+    /// Returns a logical connection to tcp://host:port that shares a pooled socket.
+    /// Returns null pointer and sets errorCode when the pool is exhausted.
+    Connection::Ptr openConnection(const std::string &host, unsigned short port, boost::system::error_code *errorCode = 0);
+
+    /// Number of open sockets
+    size_t getNumChannels() const;
+
+private:
+    friend class PooledConnection;
+
+    struct PendingCall;
+
+    ChannelPtr acquireChannel(const std::string &host, unsigned short port, boost::system::error_code *errorCode);
+
+    void releaseChannel(const ChannelPtr &channel);
+
+    bool call(const ChannelPtr &channel, const void *data, size_t dataSize, kr_dbuffer_t *destBuf, std::string *errorMsg);
+
+    /// I/O thread main loop
+    void run();
+
+    /// Wakes up the I/O thread, mutex_ must be locked
+    void wakeup();
+
+    ConnectionPoolConfiguration config_;
+    mutable boost::mutex mutex_;     // guards all members below
+    void *zmqContext_;
+    void *wakeSender_;
+    void *wakeReceiver_;             // used by the I/O thread only
+    bool stopping_;
+    std::vector<ChannelPtr> channels_;
+    std::deque<PendingCall*> outgoing_;
+    boost::thread *thread_;
+};
+
+/// Logical connection multiplexed over a pooled socket
+class PooledConnection : public Connection
+{
+public:
+    typedef boost::shared_ptr<PooledConnection> Ptr;
+
+    PooledConnection(const ConnectionPool::Ptr &pool, const ConnectionPool::ChannelPtr &channel);
+
+    ~PooledConnection();
+
+    bool call(const DBuffer &request, DBuffer &response, std::string *errorMsg = 0);
+
+    std::string getRemoteHostName() const;
+
+    unsigned short getRemotePort() const;
+
+    std::string getLocalHostName() const { return ""; }
+
+    unsigned short getLocalPort() const { return 0; }
+
+protected:
+
+    void handleStart() { }
+
+private:
+    ConnectionPool::Ptr pool_;
+    ConnectionPool::ChannelPtr channel_;
+};
+
+} // namespace Transport
+} // namespace KIARA
+
+#endif /* KIARA_TRANSPORT_CONNECTIONPOOL_HPP_INCLUDED */
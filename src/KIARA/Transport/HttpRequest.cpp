@@ -18,6 +18,7 @@ HttpRequest::HttpRequest(const Transport *transport)
     , uri()
     , httpVersionMajor(0)
     , httpVersionMinor(0)
+    , keepAlive(true)
 {
 }
 
@@ -28,6 +29,7 @@ void HttpRequest::clear()
     uri.clear();
     httpVersionMajor = 0;
     httpVersionMinor = 0;
+    keepAlive = true;
 }
 
 } // namespace Transport
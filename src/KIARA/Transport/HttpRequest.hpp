@@ -29,6 +29,8 @@ public:
     std::string uri;
     int httpVersionMajor;
     int httpVersionMinor;
+    /// False when the client requested the connection to be closed after the response
+    bool keepAlive;
 
     HttpRequest(const Transport *transport);
 
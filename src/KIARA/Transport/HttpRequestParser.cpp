@@ -167,6 +167,7 @@ public:
         This->request->method = http_method_str((enum http_method)parser->method);
         This->request->httpVersionMajor = parser->http_major;
         This->request->httpVersionMinor = parser->http_minor;
+        This->request->keepAlive = http_should_keep_alive(parser) != 0;
 
         DFC_DEBUG("Method: "<<This->request->method);
         DFC_DEBUG("URI: "<<This->request->uri);
@@ -183,6 +184,10 @@ public:
         DFC_IFDEBUG(kr_dump_data("body: ", stderr, (unsigned char*)This->request->getPayload().data(), This->request->getPayloadSize(), 1));
         DFC_DEBUG("http_parser: MESSAGE COMPLETE !");
 
+        // Stop after each request, pipelined requests following in the same
+        // buffer are parsed after this one was handled.
+        http_parser_pause(parser, 1);
+
         return 0;
     }
 };
@@ -204,7 +209,12 @@ void HttpRequestParser::reset()
 HttpRequestParser::Status HttpRequestParser::parse(HttpRequest& req, const char *data, size_t len, size_t &parsedLen)
 {
     parsedLen = pimpl_->execute(req, data, len);
-    if (pimpl_->parser.upgrade)
+    if (HTTP_PARSER_ERRNO(&pimpl_->parser) == HPE_PAUSED)
+    {
+        // paused on message completion, the rest of data belongs to the next request
+        http_parser_pause(&pimpl_->parser, 0);
+    }
+    else if (pimpl_->parser.upgrade)
     {
         /* handle new protocol */
         DFC_DEBUG("http_parser: upgrade");
@@ -5,9 +5,16 @@
  *      Author: Dmitri Rubinstein
  */
 #include "HttpTransport.hpp"
+#include "http_parser.h"
 #include <KIARA/Impl/Network.hpp>
 #include <DFC/Base/Utils/StaticInit.hpp>
 #include <KIARA/Utils/URL.hpp>
+#include <boost/array.hpp>
+#include <boost/lexical_cast.hpp>
+#include <cstring>
+#include <cerrno>
+#include <poll.h>
+#include <sys/socket.h>
 
 #define DFC_DO_DEBUG
 #include <DFC/Utils/Debug.hpp>
@@ -122,36 +129,13 @@ HttpConnection::HttpConnection(const NetworkContext::Ptr& ctx, const Transport *
     , bufferSize_(0)
     , parserStatus_(HttpRequestParser::PARSING_FINISHED)
     , readInProgress_(false)
+    , closeAfterWrite_(false)
 {}
 
 HttpConnection::~HttpConnection()
 {
 }
 
-namespace
-{
-class DummyConnection: public Connection
-{
-public:
-
-    typedef boost::shared_ptr<DummyConnection> Ptr;
-
-    explicit DummyConnection() { }
-
-    ~DummyConnection() { }
-
-    virtual void handleStart() { }
-
-    std::string getRemoteHostName() const { return ""; }
-
-    unsigned short getRemotePort() const { return 0; }
-
-    std::string getLocalHostName() const { return ""; }
-
-    unsigned short getLocalPort() const { return 0; }
-};
-} // unnamed namespace
-
 extern "C" {
 
 static ::KIARA_Connection * http_getConnection(::KIARA_FuncObj *funcObj)
@@ -168,6 +152,15 @@ static int http_sendData(::KIARA_Connection *conn, const void *msgData, size_t m
 {
    int result = 0;
 
+   KIARA::Impl::ClientConnection *cconn = ((KIARA::Impl::ClientConnection*)conn);
+
+   // Persistent connection, concurrent calls are pipelined
+   if (cconn->getTransportConnection())
+       return cconn->callTransport(msgData, msgDataSize, destBuf);
+
+   // URL loader connection can't be shared by concurrent calls
+   boost::mutex::scoped_lock lock(((KIARA::Impl::ClientConnection*)conn)->getTransportMutex());
+
    std::string errorMsg;
    if (!KIARA::URLLoader::sendData(
        ((KIARA::Impl::ClientConnection*)conn)->getURLLoaderConnection(),
@@ -215,11 +208,28 @@ transports_[tinfo.getName()] = tinfo;
 */
 
 Connection::Ptr HttpTransport::openConnection(
-    const std::string &url,
+    const std::string &_url,
     const NetworkContext::Ptr& ctx,
     boost::system::error_code *errorCode) const
 {
-    return DummyConnection::Ptr(new DummyConnection);
+    URL url(_url);
+    if (!url.isValid() || url.scheme != getName())
+    {
+        if (errorCode)
+            errorCode->assign(boost::system::errc::invalid_argument, boost::system::system_category());
+        return Connection::Ptr();
+    }
+
+    std::string path = url.path.empty() ? "/" : url.path;
+    if (!url.query.empty())
+        path += "?" + url.query;
+
+    HttpClientConnection::Ptr result(
+        new HttpClientConnection(ctx ? ctx : NetworkContext::Ptr(new AsioNetworkContext),
+                                 url.host, url.port.empty() ? "80" : url.port, path));
+    if (!result->open(errorCode))
+        return Connection::Ptr();
+    return result;
 }
 
 Connection::Ptr HttpTransport::createConnection(
@@ -350,6 +360,11 @@ void HttpConnection::handleBuffer(char *bufferBegin, std::size_t bytesTransferre
         if (parserStatus_ == HttpRequestParser::PARSING_FINISHED)
         {
             handleRequest(request_, response_);
+
+            // Keep the connection open for further requests unless the client asked to close it
+            closeAfterWrite_ = !request_.keepAlive;
+            response_.setHeader("Connection", request_.keepAlive ? "keep-alive" : "close");
+
             std::vector<boost::asio::const_buffer> buffers;
             response_.toBuffers(buffers);
             startWriteBuffers(buffers);
@@ -362,7 +377,9 @@ void HttpConnection::handleBuffer(char *bufferBegin, std::size_t bytesTransferre
     }
     else if (parserStatus_ == HttpRequestParser::PARSING_FAILED)
     {
-        response_.setDefaultHTMLResponse(HttpResponse::BAD_REQUEST);
+        // we can't find the start of the next request, close after the response
+        closeAfterWrite_ = true;
+        response_.setDefaultHTMLResponse(HttpResponse::BAD_REQUEST, false);
         std::vector<boost::asio::const_buffer> buffers;
         response_.toBuffers(buffers);
         startWriteBuffers(buffers);
@@ -375,17 +392,20 @@ void HttpConnection::handleBuffer(char *bufferBegin, std::size_t bytesTransferre
 
 void HttpConnection::handleWrite(const boost::system::error_code& e)
 {
-    if (!e)
-        handleStart();
-#if 0
-    // following code should be executed when connection to be closed by server
     if (!e)
     {
-        // Initiate graceful connection closure.
-        boost::system::error_code ignored_ec;
-        socket_.shutdown(boost::asio::ip::tcp::getSocket::shutdown_both, ignored_ec);
+        if (closeAfterWrite_)
+        {
+            // Initiate graceful connection closure.
+            boost::system::error_code ignored_ec;
+            getSocket().shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignored_ec);
+        }
+        else
+        {
+            // Idle keep-alive connections stay open until the client closes them
+            handleStart();
+        }
     }
-#endif
 
     // No new asynchronous operations are started. This means that all shared_ptr
     // references to the connection object will disappear and the object will be
@@ -393,6 +413,292 @@ void HttpConnection::handleWrite(const boost::system::error_code& e)
     // destructor closes the socket.
 }
 
+/// HttpClientConnection
+
+namespace
+{
+
+struct ResponseParserState
+{
+    kr_dbuffer_t *body;
+    bool complete;
+};
+
+int responseBodyCB(http_parser *parser, const char *at, size_t length)
+{
+    ResponseParserState *state = static_cast<ResponseParserState*>(parser->data);
+    kr_dbuffer_append_mem(state->body, at, length);
+    return 0;
+}
+
+int responseCompleteCB(http_parser *parser)
+{
+    static_cast<ResponseParserState*>(parser->data)->complete = true;
+    // Following bytes belong to the next pipelined response
+    http_parser_pause(parser, 1);
+    return 0;
+}
+
+http_parser_settings makeResponseParserSettings()
+{
+    http_parser_settings settings;
+    memset(&settings, 0, sizeof(settings));
+    settings.on_body = responseBodyCB;
+    settings.on_message_complete = responseCompleteCB;
+    return settings;
+}
+
+const http_parser_settings responseParserSettings = makeResponseParserSettings();
+
+} // unnamed namespace
+
+HttpClientConnection::HttpClientConnection(const NetworkContext::Ptr& ctx, const std::string &hostName,
+                                           const std::string &port, const std::string &path, size_t bufferSize)
+    : detail::NetworkContextHolder(ctx)
+    , BufferedTcpConnection(ctx, bufferSize)
+    , hostName_(hostName)
+    , port_(port)
+    , contentType_("application/octet-stream")
+    , readTimeout_(DEFAULT_READ_TIMEOUT)
+    , requestPrefix_("POST " + path + " HTTP/1.1\r\n"
+                     "Host: " + hostName + ":" + port + "\r\n"
+                     "Connection: keep-alive\r\n")
+    , requestHeader_()
+    , nextTicket_(0)
+    , nowServing_(0)
+    , connected_(false)
+    , readOffset_(0)
+    , readSize_(0)
+{
+}
+
+HttpClientConnection::~HttpClientConnection()
+{
+}
+
+bool HttpClientConnection::open(boost::system::error_code *errorCode)
+{
+    boost::asio::ip::tcp::resolver resolver(getSocket().get_io_service());
+    boost::asio::ip::tcp::resolver::query query(hostName_, port_);
+    boost::system::error_code error = boost::asio::error::host_not_found;
+    boost::asio::ip::tcp::resolver::iterator endpoint_iterator = resolver.resolve(query, error);
+    boost::asio::ip::tcp::resolver::iterator end;
+
+    while (endpoint_iterator != end)
+    {
+        getSocket().close();
+        getSocket().connect(*endpoint_iterator++, error);
+        if (!error)
+            break;
+    }
+    if (error)
+    {
+        if (errorCode)
+            *errorCode = error;
+        return false;
+    }
+
+    // Requests are written as header and payload, don't wait for more data
+    getSocket().set_option(boost::asio::ip::tcp::no_delay(true), error);
+
+    readOffset_ = 0;
+    readSize_ = 0;
+    connected_ = true;
+    return true;
+}
+
+const unsigned int HttpClientConnection::DEFAULT_READ_TIMEOUT;
+
+bool HttpClientConnection::call(const DBuffer &request, DBuffer &response, std::string *errorMsg)
+{
+    // A request over a reused connection can meet the server closing it.
+    // POST is not idempotent, retry once over a new connection only when
+    // the server can't have seen any part of the request.
+    for (int attempt = 0; ; ++attempt)
+    {
+        unsigned long ticket;
+        bool sent = false;
+        bool written = writeRequest(request.data(), request.size(), ticket, sent, errorMsg);
+        if (readResponse(ticket, !written, response.get_dbuffer(), errorMsg))
+            return true;
+        if (sent || attempt > 0)
+            return false;
+        DFC_DEBUG("HttpClientConnection: connection to "<<hostName_<<":"<<port_<<" lost, reconnecting");
+    }
+}
+
+bool HttpClientConnection::isClosedByServer()
+{
+    // No response is outstanding, so any readable data means end of stream
+    // or a broken server, the connection can't be used in both cases.
+    struct pollfd pfd;
+    pfd.fd = getSocket().native_handle();
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    return readSize_ != 0 || ::poll(&pfd, 1, 0) != 0;
+}
+
+bool HttpClientConnection::waitReadable(boost::system::error_code &ec)
+{
+    if (readTimeout_ == 0)
+        return true;
+
+    struct pollfd pfd;
+    pfd.fd = getSocket().native_handle();
+    pfd.events = POLLIN;
+    for (;;)
+    {
+        pfd.revents = 0;
+        int result = ::poll(&pfd, 1, static_cast<int>(readTimeout_));
+        if (result > 0)
+            return true;
+        if (result == 0)
+        {
+            ec = boost::asio::error::timed_out;
+            return false;
+        }
+        if (errno != EINTR)
+        {
+            ec.assign(errno, boost::system::system_category());
+            return false;
+        }
+    }
+}
+
+bool HttpClientConnection::writeRequest(const void *data, size_t dataSize, unsigned long &ticket,
+                                        bool &sent, std::string *errorMsg)
+{
+    sent = false;
+    boost::mutex::scoped_lock writeLock(writeMutex_);
+    {
+        boost::mutex::scoped_lock lock(stateMutex_);
+        // An idle connection closed by the server is detected before
+        // anything is written, so the request is sent over a new one
+        if (connected_ && nowServing_ == nextTicket_ && isClosedByServer())
+        {
+            DFC_DEBUG("HttpClientConnection: connection to "<<hostName_<<":"<<port_<<" closed by server, reconnecting");
+            connected_ = false;
+        }
+
+        if (!connected_)
+        {
+            // Responses to the requests sent over the old connection must be read first
+            while (nowServing_ != nextTicket_)
+                stateCond_.wait(lock);
+
+            ticket = nextTicket_++;
+            boost::system::error_code ec;
+            if (!open(&ec))
+            {
+                if (errorMsg)
+                    *errorMsg = "Could not connect to " + hostName_ + ":" + port_ + ": " + ec.message();
+                return false;
+            }
+        }
+        else
+            ticket = nextTicket_++;
+    }
+
+    requestHeader_ = requestPrefix_;
+    requestHeader_ += "Content-Type: ";
+    requestHeader_ += contentType_;
+    requestHeader_ += "\r\nContent-Length: ";
+    requestHeader_ += boost::lexical_cast<std::string>(dataSize);
+    requestHeader_ += "\r\n\r\n";
+
+    boost::array<boost::asio::const_buffer, 2> bufs = {{
+        boost::asio::buffer(requestHeader_),
+        boost::asio::buffer(data, dataSize)
+    }};
+
+    boost::system::error_code error;
+    sent = boost::asio::write(getSocket(), bufs, error) != 0;
+    if (error)
+    {
+        if (errorMsg)
+            *errorMsg = "Could not send HTTP request: " + error.message();
+        return false;
+    }
+    return true;
+}
+
+bool HttpClientConnection::readResponse(unsigned long ticket, bool writeFailed, kr_dbuffer_t *destBuf,
+                                        std::string *errorMsg)
+{
+    {
+        boost::mutex::scoped_lock lock(stateMutex_);
+        while (nowServing_ != ticket)
+            stateCond_.wait(lock);
+        if (!connected_ || writeFailed)
+        {
+            connected_ = false;
+            ++nowServing_;
+            stateCond_.notify_all();
+            if (errorMsg && !writeFailed)
+                *errorMsg = "HTTP connection to " + hostName_ + ":" + port_ + " was closed";
+            return false;
+        }
+    }
+
+    ResponseParserState state = { destBuf, false };
+    http_parser parser;
+    http_parser_init(&parser, HTTP_RESPONSE);
+    parser.data = &state;
+
+    std::string error;
+    bool received = false;
+    while (!state.complete)
+    {
+        if (readSize_ == 0)
+        {
+            boost::system::error_code ec;
+            readOffset_ = 0;
+            if (waitReadable(ec))
+                readSize_ = getSocket().read_some(boost::asio::buffer(getBufferData(), getBufferSize()), ec);
+            if (ec)
+            {
+                readSize_ = 0;
+                // Response without Content-Length ends with the connection
+                if (ec == boost::asio::error::eof && received)
+                    http_parser_execute(&parser, &responseParserSettings, 0, 0);
+                if (!state.complete)
+                    error = "Could not receive HTTP response: " + ec.message();
+                break;
+            }
+        }
+
+        received = true;
+        size_t parsed = http_parser_execute(&parser, &responseParserSettings, getBufferData() + readOffset_, readSize_);
+        readOffset_ += parsed;
+        readSize_ -= parsed;
+
+        if (HTTP_PARSER_ERRNO(&parser) != HPE_OK && HTTP_PARSER_ERRNO(&parser) != HPE_PAUSED)
+        {
+            error = std::string("Invalid HTTP response: ") + http_errno_description(HTTP_PARSER_ERRNO(&parser));
+            break;
+        }
+    }
+
+    if (state.complete && parser.status_code >= 400)
+        error = "HTTP request failed with status " + boost::lexical_cast<std::string>(parser.status_code);
+
+    {
+        boost::mutex::scoped_lock lock(stateMutex_);
+        if (!state.complete || !http_should_keep_alive(&parser))
+            connected_ = false;
+        ++nowServing_;
+        stateCond_.notify_all();
+    }
+
+    if (!error.empty())
+    {
+        if (errorMsg)
+            *errorMsg = error;
+        return false;
+    }
+    return true;
+}
+
 static HttpTransport httpTransport;
 
 DFC_STATIC_INIT_FUNC
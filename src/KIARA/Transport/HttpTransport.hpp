@@ -13,7 +13,10 @@
 #include "HttpRequest.hpp"
 #include "HttpRequestHandler.hpp"
 #include "HttpRequestParser.hpp"
+#include <KIARA/CDT/kr_dbuffer.h>
 #include <boost/asio/ip/address.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include <string>
 
 namespace KIARA
@@ -120,6 +123,117 @@ private:
 
     /// True if currently a async read is in progress
     bool readInProgress_;
+
+    /// True if the connection is closed after the response was written
+    bool closeAfterWrite_;
+};
+
+namespace detail
+{
+
+/// Keeps the network context alive until the socket using it is destroyed.
+/// Must be a base class preceding TcpConnection.
+struct NetworkContextHolder
+{
+    explicit NetworkContextHolder(const NetworkContext::Ptr& ctx) : networkContext_(ctx) { }
+
+    NetworkContext::Ptr networkContext_;
+};
+
+} // namespace detail
+
+class HttpClientConnection;
+typedef boost::shared_ptr<HttpClientConnection> HttpClientConnectionPtr;
+
+/// Persistent HTTP/1.1 connection to a server.
+///
+/// Requests are sent with keep-alive and pipelined: concurrent callers write
+/// their requests back to back and read the responses in the same order.
+/// The read buffer of BufferedTcpConnection is kept across responses, so
+/// bytes of the next pipelined response are not lost. When the server
+/// closes the connection it is reopened by the next request.
+///
+/// A request is only retried when none of its bytes were sent, a request
+/// that may have reached the server is never repeated. A response that does
+/// not arrive within the read timeout fails the call and closes the
+/// connection.
+class HttpClientConnection: private detail::NetworkContextHolder, public BufferedTcpConnection
+{
+public:
+
+    typedef HttpClientConnectionPtr Ptr;
+
+    HttpClientConnection(const NetworkContext::Ptr& ctx, const std::string &hostName,
+                         const std::string &port, const std::string &path, size_t bufferSize = 8192);
+
+    virtual ~HttpClientConnection();
+
+    bool open(boost::system::error_code *errorCode = 0);
+
+    /// Content type of the requests, must be set before the first call
+    void setContentType(const std::string &contentType) { contentType_ = contentType; }
+
+    /// Milliseconds to wait for data of a response, 0 waits forever.
+    /// Must be set before the first call.
+    void setReadTimeout(unsigned int readTimeout) { readTimeout_ = readTimeout; }
+
+    unsigned int getReadTimeout() const { return readTimeout_; }
+
+    /// Default read timeout in milliseconds
+    static const unsigned int DEFAULT_READ_TIMEOUT = 60000;
+
+    const std::string & getContentType() const { return contentType_; }
+
+    /// Sends POST request and appends the response body,
+    /// blocks until the response arrives. Can be called from multiple threads.
+    bool call(const DBuffer &request, DBuffer &response, std::string *errorMsg = 0);
+
+protected:
+
+    /// All I/O is synchronous
+    void handleStart() { }
+
+    void handleRead(const boost::system::error_code& e, std::size_t bytesTransferred) { }
+
+    void handleWrite(const boost::system::error_code& e) { }
+
+private:
+
+    /// Writes request and returns the ticket for reading its response.
+    /// On failure the ticket must still be passed to readResponse, sent is
+    /// set when any byte of the request was passed to the socket.
+    bool writeRequest(const void *data, size_t dataSize, unsigned long &ticket,
+                      bool &sent, std::string *errorMsg);
+
+    /// Waits until all previous responses were read and reads the response
+    /// to the request with the ticket.
+    bool readResponse(unsigned long ticket, bool writeFailed, kr_dbuffer_t *destBuf, std::string *errorMsg);
+
+    /// True when the server closed the idle connection.
+    /// Requires that all responses were read.
+    bool isClosedByServer();
+
+    /// Waits until the socket is readable, false on timeout
+    bool waitReadable(boost::system::error_code &ec);
+
+    std::string hostName_;
+    std::string port_;
+    std::string contentType_;
+    unsigned int readTimeout_;
+    std::string requestPrefix_;     // request line and constant headers
+    std::string requestHeader_;     // guarded by writeMutex_
+
+    boost::mutex writeMutex_;       // serializes writes and assignment of tickets
+    unsigned long nextTicket_;      // guarded by writeMutex_
+
+    boost::mutex stateMutex_;       // guards members below
+    boost::condition_variable stateCond_;
+    unsigned long nowServing_;      // ticket of the response to be read next
+    bool connected_;
+
+    // unread data in the buffer, used by the reader of the current response only
+    size_t readOffset_;
+    size_t readSize_;
 };
 
 } // namespace Transport
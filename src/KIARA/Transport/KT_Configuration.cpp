@@ -149,6 +149,65 @@ void KT_Configuration::negotiation ( neg_ctx_t* neg_ctx )   {
             this->set_port_number(port_number);
         }
 
+        /**
+         * @brief Builds the ZeroMQ endpoint of a host.
+         * @param transport_layer Communication protocol.
+         * @param hostname Hostname, path of the socket for KT_IPC, name of
+         *   the endpoint for KT_INPROC.
+         * @param port_number Port number, not used by KT_IPC and omitted by
+         *   KT_INPROC when zero.
+         * @return The endpoint, empty if the transport layer is not supported.
+         */
+        std::string KT_Configuration::make_endpoint(unsigned int transport_layer,
+                const std::string& hostname, unsigned int port_number) {
+
+            // Example: tcp://domain.tld:1234, ipc:///tmp/kiara-1234.ipc
+            // or inproc://kiara/localhost:1234
+            std::string endpoint;
+            switch (transport_layer) {
+                case KT_TCP:
+                    endpoint = "tcp://" + hostname + ":" + std::to_string(port_number);
+                    break;
+                case KT_IPC:
+                    endpoint = "ipc://" + hostname;
+                    break;
+                case KT_INPROC:
+                    endpoint = "inproc://" + hostname;
+                    if (0 != port_number)
+                        endpoint += ":" + std::to_string(port_number);
+                    break;
+                default:
+                    // Technically ZeroMQ also supports udp and sctp.
+                    break;
+            }
+            return endpoint;
+        }
+
+        /**
+         * @brief Endpoint of the configured transport layer, hostname and port.
+         * @return The endpoint, empty if the transport layer is not supported.
+         */
+        std::string KT_Configuration::get_endpoint() const {
+            return make_endpoint(_transport_layer, _hostname, _port_number);
+        }
+
+        /**
+         * @brief Adds an endpoint a listener binds in addition to its own.
+         * @param transport_layer Communication protocol.
+         * @param hostname Hostname, path or name of the endpoint.
+         * @param port_number Port number.
+         * @return false if the transport layer is not supported.
+         */
+        bool KT_Configuration::add_endpoint(unsigned int transport_layer,
+                const std::string& hostname, unsigned int port_number) {
+
+            std::string endpoint = make_endpoint(transport_layer, hostname, port_number);
+            if (endpoint.empty())
+                return false;
+            _additional_endpoints.push_back(endpoint);
+            return true;
+        }
+
 } // end of namespace Transport
 } // end of namespace KIARA
 
@@ -10,6 +10,7 @@
 #define KT_CONFIGURATION_HPP
 
 #include <string>
+#include <vector>
 #include "KT_Configuration_glob.h"
 #include "negotiation.h"
 
@@ -37,6 +38,16 @@ private:
   unsigned int _crypto_layer = 0;
   unsigned int _application_layer = 0;
   unsigned int _application_type = 0;
+  // Worker threads of KT_REQUESTREPLYMT servers, 0 selects the number of
+  // cores. Dispatch threads of the reactor of other servers, 0 selects one.
+  unsigned int _worker_threads = 0;
+  // Requests received by a socket of the reactor that may wait for their
+  // dispatch, the socket is not polled while it has that many. 0 for no limit.
+  unsigned int _max_queued_requests = 1000;
+  // Pin worker threads to CPU cores
+  bool _cpu_affinity = false;
+  // Endpoints bound in addition to the one of hostname and port
+  std::vector<std::string> _additional_endpoints;
   
 public:
 
@@ -73,6 +84,30 @@ public:
   {
 	  _port_number = portNumber;
   }
+  unsigned int get_worker_threads() const
+  {
+	  return _worker_threads;
+  }
+  void set_worker_threads(unsigned int worker_threads)
+  {
+	  _worker_threads = worker_threads;
+  }
+  unsigned int get_max_queued_requests() const
+  {
+	  return _max_queued_requests;
+  }
+  void set_max_queued_requests(unsigned int max_queued_requests)
+  {
+	  _max_queued_requests = max_queued_requests;
+  }
+  bool get_cpu_affinity() const
+  {
+	  return _cpu_affinity;
+  }
+  void set_cpu_affinity(bool cpu_affinity)
+  {
+	  _cpu_affinity = cpu_affinity;
+  }
   void set_crypto_layer ( kt_crypto_layer crypto_layer );
   kt_crypto_layer get_crypto_layer ( ) const;
   void set_application_layer ( kt_application_layer application_layer );
@@ -81,6 +116,32 @@ public:
   kt_application_type get_application_type ( ) const;
   void set_host (kt_transport_layer transport_layer, std::string hostname, unsigned int port_number);
 
+  /**
+   * @brief Builds the ZeroMQ endpoint of a host.
+   *
+   * For KT_IPC the hostname is the path of the socket and the port is
+   * ignored, for KT_INPROC it is the name of the endpoint.
+   * @return The endpoint, empty if the transport layer is not supported.
+   */
+  static std::string make_endpoint (kt_transport_layer transport_layer,
+          const std::string& hostname, unsigned int port_number);
+
+  /**
+   * @brief Endpoint of the configured transport layer, hostname and port.
+   */
+  std::string get_endpoint ( ) const;
+
+  /**
+   * @brief Lets a listener also accept connections on another endpoint,
+   *   e.g. serve a TCP port also over KT_IPC and KT_INPROC.
+   * @return false if the transport layer is not supported.
+   */
+  bool add_endpoint (kt_transport_layer transport_layer, const std::string& hostname, unsigned int port_number);
+  const std::vector<std::string>& get_additional_endpoints ( ) const
+  {
+	  return _additional_endpoints;
+  }
+
 };
 } // end of Transport namespace
 } // end of KIARA namespace
@@ -27,6 +27,11 @@ typedef unsigned int kt_transport_layer;
 #define KT_DCCP  33
 #define KT_SCTP 132
 
+// transports between processes of a host and threads of a process, these
+// are not IP protocols and use numbers beyond the 8 bits of RFC 790
+#define KT_IPC    256
+#define KT_INPROC 257
+
 /* TODO: This needs some more fine tuning like setting the protocol level,
  * desired algorithms, key exchanges etc.
  * <habl> 21.08.2013
@@ -23,6 +23,17 @@
 namespace KIARA {
 namespace Transport {
 
+class KT_Connection;
+
+/**
+ * @brief Handler of requests served by the worker pool.
+ *
+ * The request is borrowed from the received message, the handler appends
+ * the reply to the response buffer which is then passed to the transport
+ * without copying.
+ */
+typedef std::function<void(const DBuffer& request, DBuffer& response, KT_Session*, KT_Connection*)> KT_RequestHandler;
+
 /**
  * @class The abstract class acting as interface for concrete implementations
  *   like KT_Zeromq.cpp Also note that certain methods are not overwritten in
@@ -41,7 +52,7 @@ protected:
   std::map< std::string, KT_Session* >* _sessions;
   KT_Configuration _configuration;
   std::function<void(KT_Msg&, KT_Session*, KT_Connection*)> _std_callback;
-  std::function<DBuffer*(KT_Msg&, KT_Session*, KT_Connection*)> _std_callback_str;
+  KT_RequestHandler _request_handler;
   
 public:
 
@@ -80,6 +91,24 @@ public:
   virtual int
   recv (KT_Session& session,  KT_Msg& ret, int linger = 0) = 0;
 
+  /**
+   * @brief Send a payload to remote host without copying it to a KT_Msg.
+   * @return int 0 if successful.
+   * @param payload Borrowed for the duration of the call.
+   */
+
+  virtual int
+  send (const DBuffer& payload, KT_Session& session) = 0;
+
+  /**
+   * @brief Receive a message and append its payload to a buffer.
+   * @return int 0 if successful.
+   * @param ret Buffer to which the payload is appended.
+   */
+
+  virtual int
+  recv (KT_Session& session, DBuffer& ret) = 0;
+
   /**
    * @brief Disconnect from remote host.
    * @param session The session/connection to disconnect from.
@@ -98,7 +127,7 @@ public:
   register_callback (std::function<void(KT_Msg&, KT_Session*, KT_Connection*)>) = 0;
   
   virtual int
-  register_callback_str (std::function<DBuffer*(KT_Msg&, KT_Session*, KT_Connection*)>) = 0;
+  register_request_handler (KT_RequestHandler handler) = 0;
 
   /**
    * @brief bind requires a valid callback handler which is called when a message is
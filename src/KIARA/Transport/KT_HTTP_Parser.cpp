@@ -8,6 +8,8 @@
  */
 
 #include "KT_HTTP_Parser.hpp"
+#include <strings.h>
+#include <climits>
 
 namespace KIARA
 {
@@ -20,13 +22,73 @@ namespace Transport
  */
 KT_HTTP_Parser::KT_HTTP_Parser (KT_Msg& msg)
 {
-    http_parser_settings settings;
-	
+    init ();
+    execute ( msg.get_payload().data(), msg.get_payload().size() );
+}
+
+/**
+ * @brief Parses the first message of data, data may contain only a part of
+ *   it or be followed by further pipelined messages.
+ * @param data The received data.
+ * @param size The size of the data.
+ */
+KT_HTTP_Parser::KT_HTTP_Parser (const char* data, size_t size)
+{
+    init ();
+    execute ( data, size );
+}
+
+/**
+ * @brief Instantiate the parser for a message that is received in parts,
+ *   which are passed to execute().
+ */
+KT_HTTP_Parser::KT_HTTP_Parser ()
+{
+    init ();
+}
+
+void KT_HTTP_Parser::init ()
+{
 	tmp_parser_fields *parser_fields;
 	parser_fields = new tmp_parser_fields;
 	parser_fields->host = new std::string("0");
 	parser_fields->body = new std::string;
 	parser_fields->query_string = new std::string;
+	parser_fields->etag = new std::string;
+	parser_fields->if_none_match = new std::string;
+	parser_fields->value = 0;
+	parser_fields->in_value = false;
+	parser_fields->headers_complete = false;
+	parser_fields->message_complete = false;
+
+    parser = (http_parser*) malloc ( sizeof ( http_parser ) );
+    http_parser_init ( parser, HTTP_BOTH );
+
+    parser->data = parser_fields;
+    parsed_size = 0;
+
+    payload = parser_fields->body;
+	query_string = parser_fields->query_string;
+	method = parser->method;
+	status_code = parser->status_code;
+	host = parser_fields->host;
+	etag = parser_fields->etag;
+	if_none_match = parser_fields->if_none_match;
+}
+
+/**
+ * @brief Parses the next part of the first message, the parser keeps its
+ *   state between the calls so that every byte is parsed once.
+ * @param data The received data following the previously parsed ones.
+ * @param size The size of the data.
+ * @return Number of bytes that belong to the first message.
+ */
+size_t KT_HTTP_Parser::execute (const char* data, size_t size)
+{
+    if (is_complete() || !is_valid())
+        return 0;
+
+    http_parser_settings settings;
 
     // seems that we have to 0 all unused callback hooks
     // srsly ... save initializing? Anyone?
@@ -37,25 +99,18 @@ KT_HTTP_Parser::KT_HTTP_Parser (KT_Msg& msg)
     settings.on_header_field = 0;
     settings.on_header_value = 0;
 
+    settings.on_message_complete = message_complete_cb;
+    settings.on_headers_complete = headers_complete_cb;
     settings.on_body = body_cb;
 	settings.on_url = url_cb;
 	settings.on_header_field = header_field_cb;
 	settings.on_header_value = header_value_cb;
 
-    parser = (http_parser*) malloc ( sizeof ( http_parser ) );
-    http_parser_init ( parser, HTTP_BOTH );
-
-    parser->data = parser_fields;
-    http_parser_execute ( parser, &settings, msg.get_payload().data(), \
-        msg.get_payload().size() );
-	
-    payload = ((tmp_parser_fields*)parser->data)->body;
-	query_string = ((tmp_parser_fields*)parser->data)->query_string;
+    const size_t size_parsed = http_parser_execute ( parser, &settings, data, size );
+    parsed_size += size_parsed;
 	method = parser->method;
 	status_code = parser->status_code;
-	host = ((tmp_parser_fields*)parser->data)->host;
-	identifier = ((tmp_parser_fields*)parser->data)->host;
-	*identifier += *((tmp_parser_fields*)parser->data)->query_string;
+    return size_parsed;
 }
 
 /**
@@ -63,10 +118,77 @@ KT_HTTP_Parser::KT_HTTP_Parser (KT_Msg& msg)
  */
 KT_HTTP_Parser::~KT_HTTP_Parser()
 {
-    //delete (static_cast<std::string*>(parser->data));
+    delete host;
+    delete query_string;
+    delete payload;
+    delete etag;
+    delete if_none_match;
+    delete (static_cast<tmp_parser_fields*>(parser->data));
     free (parser);
 }
 
+/**
+ * @return false if the data are not a valid HTTP message.
+ */
+bool KT_HTTP_Parser::is_valid() const
+{
+	return HPE_OK == HTTP_PARSER_ERRNO(parser) || HPE_PAUSED == HTTP_PARSER_ERRNO(parser);
+}
+
+/**
+ * @return true if all headers of the first message were parsed.
+ */
+bool KT_HTTP_Parser::is_header_complete() const
+{
+	return ((tmp_parser_fields*)parser->data)->headers_complete;
+}
+
+/**
+ * @return true if the data contain the complete first message.
+ */
+bool KT_HTTP_Parser::is_complete() const
+{
+	return ((tmp_parser_fields*)parser->data)->message_complete;
+}
+
+/**
+ * @return Number of bytes of the first message, following bytes belong
+ *   to the next message. All data if the message is not complete.
+ */
+size_t KT_HTTP_Parser::get_parsed_size() const
+{
+	return parsed_size;
+}
+
+/**
+ * @return Number of bytes missing to complete the first message if its
+ *   body has a Content-Length, zero if it's complete or not known yet.
+ */
+size_t KT_HTTP_Parser::get_missing_size() const
+{
+	if (is_complete() || !is_valid() || (parser->flags & F_CHUNKED) ||
+			ULLONG_MAX == parser->content_length || 0 == parser->content_length)
+		return 0;
+	return static_cast<size_t>(parser->content_length);
+}
+
+/**
+ * @return Number of body bytes of the first message parsed so far.
+ */
+size_t KT_HTTP_Parser::get_body_size() const
+{
+	return payload->size();
+}
+
+/**
+ * @return true if the connection stays open after the response to the
+ *   first message.
+ */
+bool KT_HTTP_Parser::should_keep_alive() const
+{
+	return 0 != http_should_keep_alive(parser);
+}
+
 /**
  * @brief Internal method to get the payload.
  * @return String with the payload.
@@ -88,7 +210,17 @@ std::string KT_HTTP_Parser::get_host()
 
 std::string KT_HTTP_Parser::get_identifier()
 {
-	return NULL != identifier ? *identifier : std::string("");
+	return get_host() + get_url();
+}
+
+std::string KT_HTTP_Parser::get_etag()
+{
+	return NULL != etag ? *etag : std::string("");
+}
+
+std::string KT_HTTP_Parser::get_if_none_match()
+{
+	return NULL != if_none_match ? *if_none_match : std::string("");
 }
 
 int KT_HTTP_Parser::get_status_code()
@@ -110,36 +242,38 @@ std::ostream& operator<< (std::ostream& lhs, KT_HTTP_Parser& rhs)
 }
 
 /**
- * @brief Callback called when the HTTP body is found.
+ * @brief Callback called when the HTTP body is found, may be called
+ * multiple times with consecutive parts of the body.
  */
 int body_cb (http_parser* p, char const* at, size_t len)
 {
 	tmp_parser_fields *parser_fields;
 	parser_fields = (tmp_parser_fields*) p->data;
-	parser_fields->body->resize(len);
-    parser_fields->body->insert (0, at, len);
-    return 0;
+	parser_fields->body->append (at, len);
+	return 0;
 }
 
 int url_cb (http_parser* p, char const* at, size_t len)
 {
 	tmp_parser_fields *parser_fields;
 	parser_fields = (tmp_parser_fields*) p->data;
-    parser_fields->query_string->resize (len);
-    parser_fields->query_string->insert (0, at, len);
-    return 0;
+	parser_fields->query_string->append (at, len);
+	return 0;
 }
 
+/**
+ * @brief Callbacks called with the header fields and values, may be called
+ * multiple times with consecutive parts of a field or a value.
+ */
 int header_field_cb (http_parser* p, char const* at, size_t len)
 {
-	std::string field;
-	field.resize (len);
-    field.insert (0, at, len);
-	if(field.compare(0, 4, "Host") == 0) {
-		tmp_parser_fields *parser_fields;
-		parser_fields = (tmp_parser_fields*) p->data;
-		parser_fields->host = new std::string("1");;
+	tmp_parser_fields *parser_fields;
+	parser_fields = (tmp_parser_fields*) p->data;
+	if (parser_fields->in_value) {
+		parser_fields->field.clear();
+		parser_fields->in_value = false;
 	}
+	parser_fields->field.append (at, len);
     return 0;
 }
 
@@ -147,13 +281,45 @@ int header_value_cb (http_parser* p, char const* at, size_t len)
 {
 	tmp_parser_fields *parser_fields;
 	parser_fields = (tmp_parser_fields*) p->data;
-	if(parser_fields->host->compare(0, 4, "1") == 0) {
-		parser_fields->host->clear();
-		parser_fields->host->resize (len);
-		parser_fields->host->insert (0, at, len);
+	if (!parser_fields->in_value) {
+		const char *field = parser_fields->field.c_str();
+		if (strcasecmp(field, "ETag") == 0)
+			parser_fields->value = parser_fields->etag;
+		else if (strcasecmp(field, "If-None-Match") == 0)
+			parser_fields->value = parser_fields->if_none_match;
+		else if (parser_fields->field.compare(0, 4, "Host") == 0)
+			parser_fields->value = parser_fields->host;
+		else
+			parser_fields->value = 0;
+		if (parser_fields->value)
+			parser_fields->value->clear();
+		parser_fields->in_value = true;
 	}
+	if (parser_fields->value)
+		parser_fields->value->append (at, len);
     return 0;
 }
 
+int headers_complete_cb (http_parser* p)
+{
+	tmp_parser_fields *parser_fields;
+	parser_fields = (tmp_parser_fields*) p->data;
+	parser_fields->headers_complete = true;
+	return 0;
+}
+
+/**
+ * @brief Callback called when the message is complete, stops the parser
+ * so that following pipelined messages are not parsed.
+ */
+int message_complete_cb (http_parser* p)
+{
+	tmp_parser_fields *parser_fields;
+	parser_fields = (tmp_parser_fields*) p->data;
+	parser_fields->message_complete = true;
+	http_parser_pause (p, 1);
+	return 0;
+}
+
 } /* namespace Transport */
 } /* namespace KIARA */
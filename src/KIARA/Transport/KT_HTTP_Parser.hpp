@@ -24,32 +24,56 @@ int body_cb (http_parser* p, char const* at, size_t len);
 int url_cb (http_parser* p, char const* at, size_t len);
 int header_field_cb (http_parser* p, char const* at, size_t len);
 int header_value_cb (http_parser* p, char const* at, size_t len);
+int headers_complete_cb (http_parser* p);
+int message_complete_cb (http_parser* p);
 
 class KT_HTTP_Parser
 {
 public:
 	KT_HTTP_Parser (KT_Msg& msg);
+	KT_HTTP_Parser (const char* data, size_t size);
+	KT_HTTP_Parser ();
 	virtual ~KT_HTTP_Parser();
+	size_t execute (const char* data, size_t size);
+	bool is_valid() const;
+	bool is_header_complete() const;
+	bool is_complete() const;
+	size_t get_parsed_size() const;
+	size_t get_missing_size() const;
+	size_t get_body_size() const;
+	bool should_keep_alive() const;
 	std::string get_payload();
 	std::string get_url();
 	std::string get_host();
 	std::string get_identifier();
+	std::string get_etag();
+	std::string get_if_none_match();
 	int get_status_code();
 	int method;
 private:
 	friend std::ostream& operator<< (std::ostream& lhs, KT_HTTP_Parser& rhs);
+	void init ();
 	http_parser* parser;
-	std::string* identifier;
 	std::string* host;
 	std::string* query_string;
 	std::string* payload;
+	std::string* etag;
+	std::string* if_none_match;
 	int status_code;
+	size_t parsed_size;
 };
 
 typedef struct {
 	std::string* host;
 	std::string* query_string;
 	std::string* body;
+	std::string* etag;
+	std::string* if_none_match;
+	std::string* value;         // field of the header value being parsed or 0
+	std::string field;          // name of the header field being parsed
+	bool in_value;
+	bool headers_complete;
+	bool message_complete;
 } tmp_parser_fields;
 
 } /* namespace Transport */
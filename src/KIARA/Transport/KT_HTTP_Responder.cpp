@@ -22,7 +22,26 @@ std::string generate_200_OK(std::vector<char> payload)
 	response += content_length(payload);
 	response += header_delimiter;
 	response.append(payload.data(), payload.size());
-	response += "\r\n";
+	return response;
+}
+
+std::string generate_200_OK(const char *data, size_t size, const char *content_type, const std::string &etag)
+{
+	std::string response(HTTP_Code::_200);
+	response += content_type;
+	response += "ETag: " + etag + "\r\n";
+	response += "Content-Length: " + std::to_string(size);
+	response += header_delimiter;
+	response.append(data, size);
+	return response;
+}
+
+std::string generate_304_NOT_MODIFIED(const std::string &etag)
+{
+	std::string response(HTTP_Code::_304);
+	response += "ETag: " + etag + "\r\n";
+	response += "Content-Length: 0";
+	response += header_delimiter;
 	return response;
 }
 
@@ -34,7 +53,6 @@ std::string generate_400_BAD_REQUEST(
 	response += content_length(payload);
 	response += header_delimiter;
 	response.append(payload.data(), payload.size());
-	response += "\r\n";
 	return response;
 }
 
@@ -46,7 +64,6 @@ std::string generate_401_UNAUTHORIZED(
 	response += content_length(payload);
 	response += header_delimiter;
 	response.append(payload.data(), payload.size());
-	response += "\r\n";
 	return response;
 }
 
@@ -57,7 +74,26 @@ std::string generate_404_NOT_FOUND(std::vector<char> payload)
 	response += content_length(payload);
 	response += header_delimiter;
 	response.append(payload.data(), payload.size());
-	response += "\r\n";
+	return response;
+}
+
+std::string generate_413_PAYLOAD_TOO_LARGE(std::vector<char> payload)
+{
+	std::string response(HTTP_Code::_413);
+	response += Content_Type::_text_plain;
+	response += content_length(payload);
+	response += header_delimiter;
+	response.append(payload.data(), payload.size());
+	return response;
+}
+
+std::string generate_431_REQUEST_HEADER_FIELDS_TOO_LARGE(std::vector<char> payload)
+{
+	std::string response(HTTP_Code::_431);
+	response += Content_Type::_text_plain;
+	response += content_length(payload);
+	response += header_delimiter;
+	response.append(payload.data(), payload.size());
 	return response;
 }
 
@@ -69,7 +105,6 @@ std::string generate_500_INTERNAL_SERVER_ERROR(
 	response += content_length(payload);
 	response += header_delimiter;
 	response.append(payload.data(), payload.size());
-	response += "\r\n";
 	return response;
 }
 
@@ -98,15 +133,21 @@ std::string content_length(std::vector<char> payload)
 const char* header_delimiter = "\r\n\r\n";
 
 namespace HTTP_Code {
-	const char* _200 = "HTTP/1.0 200 OK\r\n";
-	const char* _400 = "HTTP/1.0 400 BAD REQUEST";
-	const char* _401 = "HTTP/1.0 401 UNAUTHORIZED";
-	const char* _404 = "HTTP/1.0 404 NOT FOUND";
-	const char* _500 = "HTTP/1.0 500 INTERNAL SERVER ERROR";
+	// The length of all responses is given by Content-Length, HTTP/1.1
+	// clients keep the connection open and may pipeline requests
+	const char* _200 = "HTTP/1.1 200 OK\r\n";
+	const char* _304 = "HTTP/1.1 304 NOT MODIFIED\r\n";
+	const char* _400 = "HTTP/1.1 400 BAD REQUEST\r\n";
+	const char* _401 = "HTTP/1.1 401 UNAUTHORIZED\r\n";
+	const char* _404 = "HTTP/1.1 404 NOT FOUND\r\n";
+	const char* _413 = "HTTP/1.1 413 PAYLOAD TOO LARGE\r\n";
+	const char* _431 = "HTTP/1.1 431 REQUEST HEADER FIELDS TOO LARGE\r\n";
+	const char* _500 = "HTTP/1.1 500 INTERNAL SERVER ERROR\r\n";
 }
 
 namespace Content_Type {
 	const char* _text_plain  = "Content-Type: text/plain\r\n";
+	const char* _application_json  = "Content-Type: application/json\r\n";
 }
 
 } /* namespace KT_HTTP_Responder */
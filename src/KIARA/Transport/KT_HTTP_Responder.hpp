@@ -27,6 +27,21 @@ namespace KT_HTTP_Responder
      * @return The generated response.
      */
 	std::string generate_200_OK (std::vector<char> payload);
+    /**
+     * @brief Generate a HTTP 200 response with payload and entity tag.
+     * @param data The payload or HTTP Body.
+     * @param size The payload size.
+     * @param content_type The Content-Type header line, e.g. Content_Type::_application_json.
+     * @param etag The quoted entity tag of the payload.
+     * @return The generated response.
+     */
+	std::string generate_200_OK (const char *data, size_t size, const char *content_type, const std::string &etag);
+    /**
+     * @brief Generate a HTTP 304 response without payload.
+     * @param etag The quoted entity tag the client already has.
+     * @return The generated response.
+     */
+	std::string generate_304_NOT_MODIFIED (const std::string &etag);
     /**
      * @brief Generate a HTTP 400 response with payload.
      * @param payload The payload or HTTP Body.
@@ -45,6 +60,18 @@ namespace KT_HTTP_Responder
      * @return The generated response.
      */
 	std::string generate_404_NOT_FOUND(std::vector<char> payload);
+    /**
+     * @brief Generate a HTTP 413 response with payload.
+     * @param payload The payload or HTTP Body.
+     * @return The generated response.
+     */
+	std::string generate_413_PAYLOAD_TOO_LARGE(std::vector<char> payload);
+    /**
+     * @brief Generate a HTTP 431 response with payload.
+     * @param payload The payload or HTTP Body.
+     * @return The generated response.
+     */
+	std::string generate_431_REQUEST_HEADER_FIELDS_TOO_LARGE(std::vector<char> payload);
     /**
      * @brief Generate a HTTP 500 response with payload.
      * @param payload The payload or HTTP Body.
@@ -77,9 +104,12 @@ namespace KT_HTTP_Responder
 	namespace HTTP_Code
 	{
 		extern const char* _200;
+		extern const char* _304;
 		extern const char* _400;
 		extern const char* _401;
 		extern const char* _404;
+		extern const char* _413;
+		extern const char* _431;
 		extern const char* _500;
 	}
 
@@ -89,6 +119,7 @@ namespace KT_HTTP_Responder
 	namespace Content_Type
 	{
 		extern const char* _text_plain;
+		extern const char* _application_json;
 	}
 } /* namespace KT_HTTP_Responder */
 
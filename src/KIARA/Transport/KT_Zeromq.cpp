@@ -1,32 +1,344 @@
 #include "KT_Zeromq.hpp"
 #include <iostream>
+#include <algorithm>
+#include <mutex>
+#include <set>
+#include <sstream>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 namespace KIARA {
 namespace Transport {
 
-KT_Zeromq::KT_Zeromq() {
+namespace {
+
+/**
+ * @brief Frees response memory handed over to ZeroMQ.
+ * @param hint The kr_dbuffer_free_fn of the buffer, NULL if the memory was
+ *   allocated by kr_dbuffer.
+ */
+void free_released_buffer(void* data, void* hint) {
+    if (hint)
+        ((kr_dbuffer_free_fn) hint)(data);
+    else
+        free(data);
+}
+
+/**
+ * @brief Context shared by all connections of the process.
+ *
+ * inproc endpoints are only reachable by sockets of the same context. The
+ * context is never terminated as termination would wait for all sockets.
+ */
+zmq::context_t& shared_context() {
+    static zmq::context_t* context = new zmq::context_t(1);
+    return *context;
+}
+
+bool is_inproc(const std::string& endpoint) {
+    return 0 == endpoint.compare(0, 9, "inproc://");
+}
+
+/// inproc endpoints bound by any connection of the process
+std::mutex inproc_mutex;
+std::set<std::string> inproc_endpoints;
+
+} // unnamed namespace
+
+KT_Zeromq::KT_Zeromq()
+    : proxy_thread(nullptr)
+    , reactor_thread(nullptr)
+    , wake_sender(nullptr)
+    , wake_receiver(nullptr)
+    , reactor_stopping(false)
+    , requests_in_flight(0) {
     _context = zmq_ctx_new();
 	zmq::context_t _context_mt(1);
 }
 
 KT_Zeromq::~KT_Zeromq() {
+    // The bound sockets must be closed before the context is destroyed
+    unbind();
+    {
+        std::lock_guard<std::mutex> lock(inproc_mutex);
+        for (const std::string& endpoint : _inproc_endpoints)
+            inproc_endpoints.erase(endpoint);
+    }
     zmq_ctx_destroy(_context);
 }
 
 /**
- * @brief Poller function run in a separate thread which calls the callback.
- * @param socket Indicates on which socket it polls. (Unused)
- * @param endpoint The endpoint on which the polling occurs.
+ * @brief Checks if an inproc endpoint is bound in this process.
+ * @param endpoint The endpoint, e.g. inproc://kiara/localhost:1234
+ */
+bool
+KT_Zeromq::is_inproc_bound(const std::string& endpoint) {
+    std::lock_guard<std::mutex> lock(inproc_mutex);
+    return inproc_endpoints.count(endpoint) != 0;
+}
+
+/**
+ * @brief Selects the context of the sockets facing the remote hosts.
+ * @return The shared context if an inproc endpoint is configured.
+ */
+void*
+KT_Zeromq::get_context() {
+    bool inproc = KT_INPROC == _configuration.get_transport_layer();
+    for (const std::string& endpoint : _configuration.get_additional_endpoints())
+        inproc = inproc || is_inproc(endpoint);
+    return inproc ? (void*) shared_context() : _context;
+}
+
+/**
+ * @brief Starts the reactor and the dispatch threads unless they are running.
+ * @return Zero on success, non-zero on failure.
+ */
+int
+KT_Zeromq::start_reactor() {
+    std::lock_guard<std::mutex> lock(reactor_mutex);
+    if (nullptr != reactor_thread)
+        return 0;
+
+    std::ostringstream oss;
+    oss << "inproc://kt-reactor-" << static_cast<const void*>(this);
+    const std::string wake_endpoint = oss.str();
+
+    int linger = 0;
+    wake_receiver = zmq_socket(_context, ZMQ_PAIR);
+    wake_sender = zmq_socket(_context, ZMQ_PAIR);
+    if (nullptr == wake_receiver || nullptr == wake_sender ||
+            0 != zmq_bind(wake_receiver, wake_endpoint.c_str()) ||
+            0 != zmq_connect(wake_sender, wake_endpoint.c_str())) {
+        int errcode = errno;
+        if (wake_receiver)
+            zmq_close(wake_receiver);
+        if (wake_sender)
+            zmq_close(wake_sender);
+        wake_receiver = wake_sender = nullptr;
+        errno = errcode;
+        return -1;
+    }
+    zmq_setsockopt(wake_receiver, ZMQ_LINGER, &linger, sizeof(linger));
+    zmq_setsockopt(wake_sender, ZMQ_LINGER, &linger, sizeof(linger));
+
+    // By default dispatch with a single thread, each bound connection has
+    // its own dispatch threads
+    unsigned int num_threads = _configuration.get_worker_threads();
+    if (0 == num_threads)
+        num_threads = 1;
+
+    reactor_stopping = false;
+    for (unsigned int i = 0; i != num_threads; ++i)
+        dispatch_threads.push_back(new std::thread(&KT_Zeromq::dispatcher, this));
+    reactor_thread = new std::thread(&KT_Zeromq::reactor, this);
+    return 0;
+}
+
+/**
+ * @brief Wakes up the reactor blocked in zmq_poll.
+ * @note Requires reactor_mutex to be locked.
  */
 void
-KT_Zeromq::poller(void* socket, std::string endpoint) {
-    // Find the session according to the endpoint.
-    KT_Session* sess = _sessions->find(endpoint)->second;
-    while (!interupted) {
-        KT_Msg* msg = new KT_Msg;
-        // Receive the incoming message and dispatch it to the callback.
-        if (0 == recv(*sess, *msg, 0))
-            _std_callback(*msg, sess, this);
+KT_Zeromq::wakeup() {
+    // A full pipe already wakes up the reactor
+    char signal = 0;
+    zmq_send(wake_sender, &signal, 1, ZMQ_DONTWAIT);
+}
+
+/**
+ * @brief Checks if a socket belongs to a session served by the reactor.
+ */
+bool
+KT_Zeromq::is_reactor_socket(void* socket) {
+    std::lock_guard<std::mutex> lock(reactor_mutex);
+    for (KT_Session* session : reactor_sessions) {
+        if (session->get_socket() == socket)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Queues a reply which is sent by the reactor, the sockets of bound
+ *   sessions are only used by the reactor thread.
+ * @return Zero if successful, non-zero on failure.
+ */
+int
+KT_Zeromq::queue_reply(KT_Session& session, const void* data, size_t size) {
+    Reply reply;
+    reply.session = session;
+    reply.payload.assign((const char*) data, (const char*) data + size);
+
+    std::lock_guard<std::mutex> lock(reactor_mutex);
+    reply_queue.push_back(std::move(reply));
+    wakeup();
+    return 0;
+}
+
+/**
+ * @brief Event loop run in a separate thread, polls the sockets of all
+ *   bound sessions with zmq_poll and hands received requests over to the
+ *   dispatch threads, replies are sent when they were queued.
+ *
+ * On unbind the reactor stops receiving and terminates after the replies
+ * to all requests received before were sent.
+ */
+void
+KT_Zeromq::reactor() {
+    std::vector<zmq_pollitem_t> items;
+    std::vector<KT_Session*> sessions;
+    std::deque<Reply> replies;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(reactor_mutex);
+            replies.swap(reply_queue);
+            for (Reply& reply : replies) {
+                std::vector<void*>::iterator it =
+                    std::find(busy_sockets.begin(), busy_sockets.end(), reply.session.get_socket());
+                if (it != busy_sockets.end())
+                    busy_sockets.erase(it);
+            }
+
+            if (reactor_stopping && 0 == requests_in_flight && replies.empty())
+                break;
+
+            // Rebuild the poll set, sessions may have been bound meanwhile
+            items.clear();
+            sessions.clear();
+            zmq_pollitem_t wake_item = { wake_receiver, 0, ZMQ_POLLIN, 0 };
+            items.push_back(wake_item);
+            if (!reactor_stopping) {
+                const unsigned int max_queued = _configuration.get_max_queued_requests();
+                for (KT_Session* session : reactor_sessions) {
+                    if (std::find(busy_sockets.begin(), busy_sockets.end(), session->get_socket()) != busy_sockets.end())
+                        continue;
+                    // Leave further requests to ZeroMQ, whose high water
+                    // mark pushes back on the peers
+                    std::map<void*, unsigned int>::const_iterator backlog = socket_backlogs.find(session->get_socket());
+                    if (0 != max_queued && backlog != socket_backlogs.end() && backlog->second >= max_queued)
+                        continue;
+                    zmq_pollitem_t item = { session->get_socket(), 0, ZMQ_POLLIN, 0 };
+                    items.push_back(item);
+                    sessions.push_back(session);
+                }
+            }
+        }
+
+        for (Reply& reply : replies) {
+            if (0 != send_identity(reply.session) ||
+                    0 != send_payload(reply.session, reply.payload.data(), reply.payload.size()))
+                std::cerr << "Failed to send reply: " << zmq_strerror(errno) << std::endl;
+        }
+        if (!replies.empty()) {
+            replies.clear();
+            continue;
+        }
+
+        if (-1 == zmq_poll(items.data(), items.size(), -1)) {
+            if (EINTR == errno)
+                continue;
+            std::cerr << "Failed to poll: " << zmq_strerror(errno) << std::endl;
+            break;
+        }
+
+        if (items[0].revents & ZMQ_POLLIN) {
+            char signal;
+            while (zmq_recv(wake_receiver, &signal, 1, ZMQ_DONTWAIT) >= 0)
+                ;
+        }
+
+        for (size_t i = 1; i < items.size(); ++i) {
+            if (!(items[i].revents & ZMQ_POLLIN))
+                continue;
+
+            // The copy of the session keeps the identity of the peer
+            Dispatch dispatch;
+            dispatch.message.reset(new KT_Msg);
+            dispatch.session = *sessions[i - 1];
+            if (0 != recv(dispatch.session, *dispatch.message, 0))
+                continue;
+
+            std::lock_guard<std::mutex> lock(reactor_mutex);
+            if (KT_REQUESTREPLY == _configuration.get_application_type())
+                busy_sockets.push_back(dispatch.session.get_socket());
+            ++requests_in_flight;
+            ++socket_backlogs[dispatch.session.get_socket()];
+
+            const Peer peer(dispatch.session.get_socket(), dispatch.session.get_identifier());
+            PeerQueue& queue = peer_queues[peer];
+            queue.requests.push_back(std::move(dispatch));
+            if (!queue.busy && 1 == queue.requests.size()) {
+                ready_peers.push_back(peer);
+                dispatch_ready.notify_one();
+            }
+        }
+    }
+}
+
+/**
+ * @brief Run by the dispatch threads, calls the callback for the requests
+ *   received by the reactor.
+ *
+ * Requests of different peers are dispatched concurrently, requests of the
+ * same peer one after another in the order they were received, e.g. the
+ * chunks of a KT_STREAM connection.
+ */
+void
+KT_Zeromq::dispatcher() {
+    std::unique_lock<std::mutex> lock(reactor_mutex);
+    while (true) {
+        if (ready_peers.empty()) {
+            // Requests of busy peers are made ready by the thread
+            // dispatching the peer when it is done
+            if (reactor_stopping)
+                return;
+            dispatch_ready.wait(lock);
+            continue;
+        }
+
+        const Peer peer = std::move(ready_peers.front());
+        ready_peers.pop_front();
+        // The queue of a busy peer is only erased by the thread dispatching it
+        std::map<Peer, PeerQueue>::iterator queue = peer_queues.find(peer);
+        Dispatch dispatch = std::move(queue->second.requests.front());
+        queue->second.requests.pop_front();
+        queue->second.busy = true;
+
+        lock.unlock();
+        _std_callback(*dispatch.message, &dispatch.session, this);
+        lock.lock();
+
+        queue->second.busy = false;
+        if (queue->second.requests.empty()) {
+            peer_queues.erase(queue);
+        } else {
+            ready_peers.push_back(peer);
+            dispatch_ready.notify_one();
+        }
+
+        std::map<void*, unsigned int>::iterator backlog = socket_backlogs.find(dispatch.session.get_socket());
+        if (0 == --backlog->second)
+            socket_backlogs.erase(backlog);
+
+        // A ZMQ_REP socket is stuck until it sent a reply, send an empty one
+        // if the callback did not reply
+        void* socket = dispatch.session.get_socket();
+        if (std::find(busy_sockets.begin(), busy_sockets.end(), socket) != busy_sockets.end()) {
+            bool replied = false;
+            for (Reply& reply : reply_queue)
+                replied = replied || reply.session.get_socket() == socket;
+            if (!replied) {
+                Reply reply;
+                reply.session = dispatch.session;
+                reply_queue.push_back(std::move(reply));
+            }
+        }
+
+        --requests_in_flight;
+        wakeup();
     }
 }
 
@@ -38,33 +350,34 @@ KT_Zeromq::poller(void* socket, std::string endpoint) {
  */
 void* KT_Zeromq::create_socket(unsigned int socket_type, bool listener) {
     void* socket = nullptr;
+    void* context = get_context();
     int errcode = 0;
 
     // Differentiate between the socket types and then if they act as listener.
     switch (socket_type) {
         case KT_STREAM:
         case KT_WEBSERVER:
-            socket = zmq_socket(_context, ZMQ_STREAM);
+            socket = zmq_socket(context, ZMQ_STREAM);
             errcode = errno;
             break;
         case KT_REQUESTREPLY:
             if (listener) {
-                socket = zmq_socket(_context, ZMQ_REP);
+                socket = zmq_socket(context, ZMQ_REP);
             } else {
-                socket = zmq_socket(_context, ZMQ_REQ);
+                socket = zmq_socket(context, ZMQ_REQ);
             }
             errcode = errno;
             break;
         case KT_PUBLISHSUBSCRIBE:
             if (listener) {
-                socket = zmq_socket(_context, ZMQ_PUB);
+                socket = zmq_socket(context, ZMQ_PUB);
             } else {
-                socket = zmq_socket(_context, ZMQ_SUB);
+                socket = zmq_socket(context, ZMQ_SUB);
             }
             errcode = errno;
             break;
 		case KT_REQUESTREPLYMT:
-			socket = zmq_socket(_context, ZMQ_STREAM);
+			socket = zmq_socket(context, ZMQ_STREAM);
             errcode = errno;
 			break;
         default:
@@ -94,31 +407,22 @@ KT_Zeromq::connect(KT_Session** ret) {
 
     KT_Configuration config = get_configuration();
 
-    // Build the hostname to connect to
+    // Build the endpoint to connect to
     // Example: tcp://domain.tld:1234
-    // FIXME: memory leak
-    std::string* binding_name = new std::string;
-
-    // Currently only tcp is supported, but technically ZeroMQ also supports
-    // udp and sctp.
-    if (KT_TCP == config.get_transport_layer()) {
-        binding_name->append("tcp://");
-    } else {
+    std::string binding_name = config.get_endpoint();
+
+    if (binding_name.empty()) {
+        zmq_close(socket);
+        errno = EPROTONOSUPPORT;
         return -1;
     }
 
-    // Build hostname and port
-    binding_name->append(config.get_hostname());
-    binding_name->append(":");
-    binding_name->append(std::to_string(config.get_port_number()));
-
-    // FIXME: fix dangerous pointer to underlying data structure
-    const char* host = binding_name->c_str();
-
     // Actually connect to the remote host.
-    int rc = zmq_connect(socket, host);
+    int rc = zmq_connect(socket, binding_name.c_str());
 
     if (0 != rc) {
+        errcode = errno;
+        zmq_close(socket);
         errno = errcode;
         return -1;
     }
@@ -141,10 +445,10 @@ KT_Zeromq::connect(KT_Session** ret) {
 
     KT_Session* session = new KT_Session();
     session->set_socket(socket);
-    session->set_endpoint(*binding_name);
+    session->set_endpoint(binding_name);
     std::vector<char> identifier(id, id + id_size);
     session->set_identifier(std::move(identifier));
-    _sessions->insert(std::make_pair(*binding_name, session));
+    _sessions->insert(std::make_pair(binding_name, session));
 
     *ret = session;
 
@@ -160,8 +464,44 @@ KT_Zeromq::connect(KT_Session** ret) {
  */
 int
 KT_Zeromq::send(KT_Msg& message, KT_Session& session, int linger) {
-    // If the application is using ZMQ_STREAM send first the identity of
-    // the connection to ZeroMQ otherwise it won't know where to send the message.
+    if (is_reactor_socket(session.get_socket())) {
+        if (message.is_binary_transport())
+            return queue_reply(session, message.get_payload_binary(), message.get_size());
+        return queue_reply(session, message.get_payload().data(), message.get_payload().size());
+    }
+
+    if (0 != send_identity(session))
+        return -1;
+
+    // Now actually send the passed message.
+    if (message.is_binary_transport())
+        return send_payload(session, message.get_payload_binary(), message.get_size());
+    return send_payload(session, message.get_payload().data(), message.get_payload().size());
+}
+
+/**
+ * @brief Send a payload to remote host.
+ * @param payload Borrowed for the duration of the call, ZeroMQ copies it.
+ * @param session Session object to identify the remote target.
+ * @return Zero if successful, non-zero on failure.
+ */
+int
+KT_Zeromq::send(const DBuffer& payload, KT_Session& session) {
+    if (is_reactor_socket(session.get_socket()))
+        return queue_reply(session, payload.data(), payload.size());
+
+    if (0 != send_identity(session))
+        return -1;
+    return send_payload(session, payload.data(), payload.size());
+}
+
+/**
+ * @brief If the application is using ZMQ_STREAM send first the identity of
+ *   the connection to ZeroMQ otherwise it won't know where to send the message.
+ * @return Zero if successful, non-zero on failure.
+ */
+int
+KT_Zeromq::send_identity(KT_Session& session) {
     switch (_configuration.get_application_type()) {
         case (KT_STREAM):
         case (KT_WEBSERVER):
@@ -173,21 +513,17 @@ KT_Zeromq::send(KT_Msg& message, KT_Session& session, int linger) {
                 return -1;
             }
     }
+    return 0;
+}
 
-    // Now actually send the passed message.
-	int rc;
-	if(message.is_binary_transport()) {
-		rc = zmq_send(session.get_socket(), message.get_payload_binary(), message.get_size(), 0);
-	}
-	else {
-		rc = zmq_send(session.get_socket(), message.get_payload().data(), message.get_payload().size(), 0);
-	}
+int
+KT_Zeromq::send_payload(KT_Session& session, const void* data, size_t size) {
+    int rc = zmq_send(session.get_socket(), data, size, 0);
     int errcode = errno;
-    if (message.get_payload().size() != static_cast<std::vector<char>::size_type> (rc)) {
+    if (size != static_cast<size_t> (rc)) {
         errno = errcode;
         return -1;
     }
-
     return 0;
 }
 
@@ -205,24 +541,9 @@ int
 KT_Zeromq::recv(KT_Session& session, KT_Msg& ret, int linger) {
     KT_Msg message;
     std::vector<char> buffer;
-    std::vector<char> identifier;
     int size;
 
-    // If the application uses ZMQ_STREAM first remove the identity and store
-    // it in the session object.
-    switch (_configuration.get_application_type()) {
-        case (KT_STREAM):
-        case (KT_WEBSERVER):
-            //std::cerr << "KT_STREAM, stripping zmq_identity" << std::endl;
-            zmq_msg_t id;
-            zmq_msg_init(&id);
-            size = zmq_msg_recv(&id, session.get_socket(), 0);
-            identifier.resize(size_t(size));
-            char* id_ptr = (char*) zmq_msg_data(&id);
-            identifier = std::vector<char>(id_ptr, id_ptr + size);
-            session.set_identifier(std::move(identifier));
-            zmq_msg_close(&id);
-    }
+    recv_identity(session);
 
     // Retrieve the actual message.
     zmq_msg_t msg;
@@ -234,18 +555,62 @@ KT_Zeromq::recv(KT_Session& session, KT_Msg& ret, int linger) {
         return -1;
     }
 
-    // Store the received payload in the KT_Msg *ret
-	ret.set_payload((const void*) zmq_msg_data(&msg));
-	ret.set_size((size_t)size);
+    // Store the received payload in the KT_Msg *ret, the binary payload
+    // must point to the copy as the message data are released below.
     char* msg_ptr = (char*) zmq_msg_data(&msg);
     buffer = std::vector<char>(msg_ptr, msg_ptr + size);
 
     ret.set_payload(buffer);
+    ret.set_payload((const void*) ret.get_payload_ptr()->data());
+    ret.set_size((size_t)size);
     zmq_msg_close(&msg);
 
     return 0;
 }
 
+/**
+ * @brief Receive a message from remote host and append its payload.
+ * @param session The session on which to receive the message.
+ * @param ret Buffer to which the payload is appended.
+ * @return Zero if successful, non-zero on failure.
+ */
+int
+KT_Zeromq::recv(KT_Session& session, DBuffer& ret) {
+    recv_identity(session);
+
+    zmq_msg_t msg;
+    zmq_msg_init(&msg);
+    int size = zmq_msg_recv(&msg, session.get_socket(), 0);
+    if (-1 == size) {
+        zmq_msg_close(&msg);
+        return -1;
+    }
+
+    int rc = ret.append_mem(zmq_msg_data(&msg), (size_t)size) ? 0 : -1;
+    zmq_msg_close(&msg);
+    return rc;
+}
+
+/**
+ * @brief If the application uses ZMQ_STREAM remove the identity and store
+ *   it in the session object.
+ */
+void
+KT_Zeromq::recv_identity(KT_Session& session) {
+    switch (_configuration.get_application_type()) {
+        case (KT_STREAM):
+        case (KT_WEBSERVER):
+            zmq_msg_t id;
+            zmq_msg_init(&id);
+            int size = zmq_msg_recv(&id, session.get_socket(), 0);
+            if (size >= 0) {
+                char* id_ptr = (char*) zmq_msg_data(&id);
+                session.set_identifier(std::vector<char>(id_ptr, id_ptr + size));
+            }
+            zmq_msg_close(&id);
+    }
+}
+
 /**
  * @brief Disconnect from remote host.
  * @param session Terminate this current session/connection.
@@ -270,9 +635,14 @@ KT_Zeromq::register_callback(std::function<void(KT_Msg&, KT_Session*, KT_Connect
     return 0;
 }
 
+/**
+ * @brief Register the handler of requests served by the worker pool
+ *   of a KT_REQUESTREPLYMT connection.
+ * @param handler Function to be called by the workers for each request.
+ */
 int
-KT_Zeromq::register_callback_str(std::function<DBuffer*(KT_Msg&, KT_Session*, KT_Connection*) > callback) {
-    _std_callback_str = callback;
+KT_Zeromq::register_request_handler(KT_RequestHandler handler) {
+    _request_handler = handler;
     return 0;
 }
 
@@ -295,105 +665,149 @@ KT_Zeromq::bind(void) {
         return -1;
     }
 
-    // Build the hostname to connect to
+    // Build the endpoint to bind to
     // Example: tcp://domain.tld:1234
     KT_Configuration config = get_configuration();
-    // memory leak
-    std::string* binding_name = new std::string;
-    
-    // Currently only tcp is supported, but technically ZeroMQ also supports
-    // udp and sctp.
-    if (KT_TCP == config.get_transport_layer()) {
-        binding_name->append("tcp://");
-    } else {
+    std::string binding_name = config.get_endpoint();
+
+    if (binding_name.empty()) {
+        zmq_close(socket);
+        errno = EPROTONOSUPPORT;
         return -1;
     }
 
-    // Build hostname and port
-    binding_name->append(config.get_hostname());
-    binding_name->append(":");
-    binding_name->append(std::to_string(config.get_port_number()));
+    // inproc endpoints are registered before they are bound by the proxy
+    // thread, ZeroMQ queues connections to endpoints that are not yet bound.
+    {
+        std::lock_guard<std::mutex> lock(inproc_mutex);
+        if (is_inproc(binding_name))
+            _inproc_endpoints.push_back(binding_name);
+        for (const std::string& endpoint : config.get_additional_endpoints()) {
+            if (is_inproc(endpoint))
+                _inproc_endpoints.push_back(endpoint);
+        }
+        inproc_endpoints.insert(_inproc_endpoints.begin(), _inproc_endpoints.end());
+    }
 	
 	KT_Session* session = new KT_Session();
     // Actually bind the socket.
 	if(_configuration.get_application_type() == KT_REQUESTREPLYMT){
-		proxy_thread = new std::thread(&KT_Zeromq::proxy, this, session, binding_name->c_str());
-		session->set_endpoint(binding_name->c_str());
-		_sessions->insert(std::make_pair(binding_name->c_str(), session));
+		proxy_thread = new std::thread(&KT_Zeromq::proxy, this, session, binding_name);
+		session->set_endpoint(binding_name);
+		_sessions->insert(std::make_pair(binding_name, session));
 		return 0;
 	}
 	else {
-		int rc = zmq_bind(socket, binding_name->c_str());
+		int rc = zmq_bind(socket, binding_name.c_str());
 		errcode = errno;
 		if (0 != rc) {
 			errno = errcode;
 			return -1;
 		}
+		for (const std::string& endpoint : config.get_additional_endpoints()) {
+			if (0 != zmq_bind(socket, endpoint.c_str()))
+				std::cerr << "Failed to bind " << endpoint << ": " << zmq_strerror(errno) << std::endl;
+		}
 		session->set_socket(socket);
 	}
 
     // Create a new session and store it as a member
     
     
-    session->set_endpoint(binding_name->c_str());
-    _sessions->insert(std::make_pair(binding_name->c_str(), session));
+    session->set_endpoint(binding_name);
+    _sessions->insert(std::make_pair(binding_name, session));
 
-    // Except if it's Publish/Subscribe start a poller thread listening forf
-    // incoming messages which are later dispatched to the callback function.
-    // Be advised that this code does not check for race-conditions or other
-    // multi-threading specific problems. In short: This code is not thread-safe!
+    // Except if it's Publish/Subscribe hand the socket over to the reactor
+    // which receives incoming messages and dispatches them to the callback
+    // function. From now on the socket is only used by the reactor thread.
     if (KT_PUBLISHSUBSCRIBE != _configuration.get_application_type()) {
-        interupted = false;
-        poller_thread = new std::thread(&KT_Zeromq::poller, this, socket, binding_name->c_str());
+        if (0 != start_reactor())
+            return -1;
+        std::lock_guard<std::mutex> lock(reactor_mutex);
+        reactor_sessions.push_back(session);
+        wakeup();
     }
     return 0;
 }
 
 void
 KT_Zeromq::proxy(KT_Session* session, std::string binding_name) {
-	zmq::socket_t clients (_context_mt, ZMQ_ROUTER);
+	// Clients of inproc endpoints connect through the shared context
+	zmq::context_t& clients_context =
+		get_context() == _context ? _context_mt : shared_context();
+	zmq::socket_t clients (clients_context, ZMQ_ROUTER);
 	clients.bind (binding_name.c_str());
+	for (const std::string& endpoint : _configuration.get_additional_endpoints()) {
+		try {
+			clients.bind (endpoint.c_str());
+		} catch (const zmq::error_t& e) {
+			std::cerr << "Failed to bind " << endpoint << ": " << e.what() << std::endl;
+		}
+	}
 	session->set_socket(clients);
 	zmq::socket_t workers(_context_mt, ZMQ_DEALER);
 	workers.bind ("inproc://workers");
-	
-	for (int thread_nbr = 0; thread_nbr != 1; thread_nbr++) {
-		worker_thread = new std::thread(&KT_Zeromq::worker, this, (void *) &_context_mt, binding_name);
-		std::cout << "Adding Thread " << worker_thread->get_id() << std::endl;
+
+	// By default serve with one worker per hardware thread
+	unsigned int num_workers = _configuration.get_worker_threads();
+	if (0 == num_workers)
+		num_workers = std::thread::hardware_concurrency();
+	if (0 == num_workers)
+		num_workers = 1;
+
+	for (unsigned int worker_index = 0; worker_index != num_workers; ++worker_index) {
+		worker_threads.push_back(new std::thread(&KT_Zeromq::worker, this, session, worker_index));
 	}
 	zmq::proxy (clients, workers, NULL);
 }
 
 void
-KT_Zeromq::worker(void *arg, std::string endpoint){
-	zmq::context_t *context = (zmq::context_t *) arg;
-	zmq::socket_t socket (*context, ZMQ_REP);
+KT_Zeromq::worker(KT_Session* session, unsigned int worker_index){
+#ifdef __linux__
+	if (_configuration.get_cpu_affinity()) {
+		const unsigned int num_cpus = std::thread::hardware_concurrency();
+		if (0 != num_cpus) {
+			cpu_set_t cpuset;
+			CPU_ZERO(&cpuset);
+			CPU_SET(worker_index % num_cpus, &cpuset);
+			pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+		}
+	}
+#endif
+
+	zmq::socket_t socket (_context_mt, ZMQ_REP);
 	socket.connect ("inproc://workers");
+
+	zmq::message_t request;
+	DBuffer response;
+
 	while (true) {
-        //  Wait for next request from client
-        zmq::message_t request;
-        socket.recv (&request);
-		
-		char* msg_ptr = (char*) request.data();
-		//std::cout << msg_ptr << std::endl;
-		
-		KT_Msg* ret = new KT_Msg;
-		
-		ret->set_payload( (const void*) request.data() );
-		ret->set_size( (size_t) request.size() );
-		KT_Session* sess = _sessions->find(endpoint)->second;
+		//  Wait for next request from client
+		if (!socket.recv (&request))
+			continue;
+
+		// The request is borrowed from the received message
+		const DBuffer request_data(request.data(), request.size(), request.size(), DBuffer::dont_free_tag());
+		response.clear();
+
 		//call kiara
-		DBuffer *res = _std_callback_str(*ret, sess, this);
-		
-		std::cout << res->data() << std::endl;
-		
-		std::string resp;
-		//std::cout << std::this_thread::get_id() << std::endl;
-        //  Send reply back to client
-        zmq::message_t reply((int)res->size());
-        memcpy ((void *) reply.data(), res->data(), (int)res->size());
-        socket.send (reply);
-    }
+		_request_handler(request_data, response, session, this);
+
+		//  Send reply back to client, memory owned by the response is
+		//  handed over to ZeroMQ instead of being copied
+		const size_t res_size = response.size();
+		if (res_size && response.free_fn() != kr_dbuffer_dont_free) {
+			kr_dbuffer_free_fn free_fn = response.free_fn();
+			zmq::message_t reply(response.release(), res_size, free_released_buffer, (void*) free_fn);
+			socket.send (reply);
+		}
+		else {
+			zmq::message_t reply(res_size);
+			if (res_size)
+				memcpy (reply.data(), response.data(), res_size);
+			socket.send (reply);
+		}
+	}
 }
 
 /**
@@ -402,8 +816,39 @@ KT_Zeromq::worker(void *arg, std::string endpoint){
  */
 int
 KT_Zeromq::unbind() {
-    interupted = true;
-    poller_thread->join();
+    {
+        std::lock_guard<std::mutex> lock(reactor_mutex);
+        if (nullptr == reactor_thread)
+            return 0;
+        reactor_stopping = true;
+        wakeup();
+    }
+    reactor_thread->join();
+    delete reactor_thread;
+
+    // The dispatch queue is empty, the reactor waits for all requests
+    dispatch_ready.notify_all();
+    for (std::thread* thread : dispatch_threads) {
+        thread->join();
+        delete thread;
+    }
+    dispatch_threads.clear();
+
+    for (KT_Session* session : reactor_sessions) {
+        zmq_close(session->get_socket());
+        _sessions->erase(session->get_endpoint());
+        delete session;
+    }
+    reactor_sessions.clear();
+    busy_sockets.clear();
+    peer_queues.clear();
+    ready_peers.clear();
+    socket_backlogs.clear();
+
+    zmq_close(wake_sender);
+    zmq_close(wake_receiver);
+    wake_sender = wake_receiver = nullptr;
+    reactor_thread = nullptr;
     return 0;
 }
 
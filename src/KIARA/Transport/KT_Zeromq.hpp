@@ -28,6 +28,12 @@
 #include <string>
 #include <thread>
 #include <vector>
+#include <deque>
+#include <map>
+#include <utility>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
 #include <KIARA/Utils/DBuffer.hpp>
 
 #include "k_transport.h"
@@ -49,14 +55,71 @@ namespace Transport {
 class KT_Zeromq : public KT_Connection
 {
 private:
-    /// Thread used for polling. Requires C++11 with std::thread support
-	std::thread* poller_thread;
-	std::thread* worker_thread;
+	/// Request received by the reactor, handed over to the dispatch threads
+	struct Dispatch {
+		std::unique_ptr<KT_Msg> message;
+		/// Copy of the bound session carrying the identity of the peer
+		KT_Session session;
+	};
+	/// Socket and identity of a peer, requests of the same peer are
+	/// dispatched one after another in the order they were received
+	typedef std::pair<void*, std::vector<char> > Peer;
+	/// Requests of a peer waiting for their dispatch
+	struct PeerQueue {
+		std::deque<Dispatch> requests;
+		/// A request of the peer is being dispatched
+		bool busy = false;
+	};
+	/// Reply of a dispatch thread, sent by the reactor
+	struct Reply {
+		KT_Session session;
+		std::vector<char> payload;
+	};
+
+	/// Worker threads of the KT_REQUESTREPLYMT proxy
+	std::vector<std::thread*> worker_threads;
 	std::thread* proxy_thread;
-    /// Indicates if the poller thread has to terminate, it' not acting as signal.
-	bool interupted;
-	void poller(void* socket, std::string endpoint);
+	/// inproc endpoints bound by this connection
+	std::vector<std::string> _inproc_endpoints;
+
+	/// Polls the sockets of all bound sessions, see reactor()
+	std::thread* reactor_thread;
+	/// Threads calling the callback for the requests received by the reactor
+	std::vector<std::thread*> dispatch_threads;
+	/// Wakes up the reactor when sessions or replies were added
+	void* wake_sender;
+	void* wake_receiver;
+	/// Guards all members below
+	std::mutex reactor_mutex;
+	std::condition_variable dispatch_ready;
+	bool reactor_stopping;
+	std::vector<KT_Session*> reactor_sessions;
+	/// Sockets of KT_REQUESTREPLY sessions waiting for their reply, ZMQ_REP
+	/// sockets must not receive before the reply was sent
+	std::vector<void*> busy_sockets;
+	/// Peers with received requests that were not dispatched yet
+	std::map<Peer, PeerQueue> peer_queues;
+	/// Peers with queued requests and none being dispatched, in the order
+	/// they became ready
+	std::deque<Peer> ready_peers;
+	/// Number of requests of each socket that were not dispatched yet,
+	/// see KT_Configuration::get_max_queued_requests()
+	std::map<void*, unsigned int> socket_backlogs;
+	std::deque<Reply> reply_queue;
+	unsigned int requests_in_flight;
+
+	int start_reactor();
+	void reactor();
+	void dispatcher();
+	void wakeup();
+	bool is_reactor_socket(void* socket);
+	int queue_reply(KT_Session& session, const void* data, size_t size);
+
+	void* get_context();
 	void* create_socket(unsigned int socket_type, bool listener);
+	int send_identity(KT_Session& session);
+	int send_payload(KT_Session& session, const void* data, size_t size);
+	void recv_identity(KT_Session& session);
 
 public:
 
@@ -78,6 +141,12 @@ public:
 
   int
   recv(KT_Session& session, KT_Msg& ret, int linger = 0);
+
+  int
+  send(const DBuffer& payload, KT_Session& session);
+
+  int
+  recv(KT_Session& session, DBuffer& ret);
   
   int
   disconnect(KT_Session& session);
@@ -86,18 +155,39 @@ public:
   register_callback(std::function<void(KT_Msg&, KT_Session*, KT_Connection*)>);
   
   int
-  register_callback_str(std::function<DBuffer*(KT_Msg&, KT_Session*, KT_Connection*)>);
+  register_request_handler(KT_RequestHandler handler);
   
+  /**
+   * @brief Serves requests dispatched by the proxy.
+   * @param session Session of the listening endpoint.
+   * @param worker_index Index of the worker, used for CPU affinity.
+   */
   void
-  worker(void *arg, std::string endpoint);
+  worker(KT_Session* session, unsigned int worker_index);
   
   void
   proxy(KT_Session* session, std::string binding_name);
 
+  /**
+   * @brief Binds the configured endpoint, the session is served by the
+   *   reactor of this connection together with all sessions bound before.
+   */
   int bind(void);
 
+  /**
+   * @brief Stops the reactor after the replies to all requests received so
+   *   far were sent and closes the bound sockets.
+   * @note The proxy of KT_REQUESTREPLYMT connections is not stopped.
+   */
   int unbind(void);
 
+  /**
+   * @brief Checks if an inproc endpoint is bound by a connection of this
+   *   process.
+   * @param endpoint The endpoint, e.g. inproc://kiara/localhost:1234
+   */
+  static bool is_inproc_bound(const std::string& endpoint);
+
 }; // end of KT_Connection class
 } // end of Transport namespace
 } // end of KIARA namespace
@@ -0,0 +1,1025 @@
+/*
+ * ShmTransport.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#include "ShmTransport.hpp"
+#include <KIARA/Impl/Network.hpp>
+#include <KIARA/Common/stdint.h>
+#include <KIARA/Utils/URL.hpp>
+#include <DFC/Base/Utils/StaticInit.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <sstream>
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#define DFC_DO_DEBUG
+#include <DFC/Utils/Debug.hpp>
+
+namespace KIARA
+{
+namespace Transport
+{
+
+namespace
+{
+
+const uint32_t SHM_MAGIC = 0x314d534b; // "KSM1"
+
+/// Time after which a waiting thread checks whether the peer is still alive
+const int WAIT_TIMEOUT_MS = 100;
+
+/// Ring buffer of a single direction. The producer advances head,
+/// the consumer tail, both counters wrap around at 2^32.
+struct ShmRingHeader
+{
+    uint32_t head;
+    char pad0[60];
+    uint32_t tail;
+    char pad1[60];
+    uint32_t seq;       // futex word, incremented to wake up waiters
+    uint32_t waiters;   // number of threads sleeping on seq
+    uint32_t closed;
+    char pad2[52];
+};
+
+/// Segment layout: header, request ring data, response ring data
+struct ShmSegmentHeader
+{
+    uint32_t magic;
+    uint32_t ringSize;
+    char pad[56];
+    ShmRingHeader rings[2];
+};
+
+enum { REQUEST_RING = 0, RESPONSE_RING = 1 };
+
+inline void cpuRelax()
+{
+#if defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+#endif
+}
+
+#ifdef __linux__
+
+inline void futexWait(uint32_t *addr, uint32_t value, int timeoutMs)
+{
+    struct timespec timeout;
+    timeout.tv_sec = timeoutMs / 1000;
+    timeout.tv_nsec = (timeoutMs % 1000) * 1000000L;
+    // the segment is mapped by two processes, so no FUTEX_PRIVATE_FLAG
+    syscall(SYS_futex, addr, FUTEX_WAIT, value, &timeout, 0, 0);
+}
+
+inline void futexWake(uint32_t *addr)
+{
+    syscall(SYS_futex, addr, FUTEX_WAKE, INT_MAX, 0, 0, 0);
+}
+
+#else
+
+inline void futexWait(uint32_t *addr, uint32_t value, int timeoutMs)
+{
+    // no futex, poll the ring buffer once per millisecond
+    usleep(1000);
+}
+
+inline void futexWake(uint32_t *addr)
+{
+}
+
+#endif
+
+inline uint32_t roundUpToPowerOfTwo(uint32_t value)
+{
+    uint32_t result = 1;
+    while (result < value)
+        result <<= 1;
+    return result;
+}
+
+inline void setCloseOnExec(int fd)
+{
+    fcntl(fd, F_SETFD, fcntl(fd, F_GETFD) | FD_CLOEXEC);
+}
+
+/// Returns an unlinked shared memory object of the specified size
+int createSharedMemory(size_t size)
+{
+    static unsigned int counter = 0;
+    for (int attempt = 0; attempt < 16; ++attempt)
+    {
+        std::ostringstream oss;
+        oss<<"/kiara-shm-"<<getpid()<<"-"<<__sync_fetch_and_add(&counter, 1);
+        const std::string name = oss.str();
+
+        int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0)
+        {
+            if (errno == EEXIST)
+                continue;
+            return -1;
+        }
+        // the object is released when the last mapping and descriptor are gone
+        shm_unlink(name.c_str());
+        setCloseOnExec(fd);
+
+        if (ftruncate(fd, size) != 0)
+        {
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+    errno = EEXIST;
+    return -1;
+}
+
+bool makeSocketAddress(const std::string &path, struct sockaddr_un &addr)
+{
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.length() >= sizeof(addr.sun_path))
+    {
+        errno = ENAMETOOLONG;
+        return false;
+    }
+    memcpy(addr.sun_path, path.c_str(), path.length() + 1);
+    return true;
+}
+
+/// Checks that path is a directory (not a symbolic link) owned by the
+/// effective user and not accessible by anybody else, creates it with
+/// mode 0700 when create is true and it does not exist yet.
+bool checkPrivateDirectory(const std::string &path, bool create, std::string *errorMsg)
+{
+    if (create && ::mkdir(path.c_str(), 0700) != 0 && errno != EEXIST)
+    {
+        if (errorMsg)
+            *errorMsg = path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    struct stat st;
+    if (::lstat(path.c_str(), &st) != 0)
+    {
+        if (errorMsg)
+            *errorMsg = path + ": " + std::strerror(errno);
+        return false;
+    }
+    if (!S_ISDIR(st.st_mode) || st.st_uid != ::geteuid() || (st.st_mode & 077) != 0)
+    {
+        if (errorMsg)
+            *errorMsg = path + ": not a directory with mode 0700 owned by the user";
+        errno = EACCES;
+        return false;
+    }
+    return true;
+}
+
+/// True when a server accepts connections on the Unix socket at addr,
+/// a socket left by a server that was not shut down refuses them
+bool isSocketInUse(const struct sockaddr_un &addr)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return false;
+    const bool inUse = connect(fd, reinterpret_cast<const struct sockaddr*>(&addr), sizeof(addr)) == 0;
+    ::close(fd);
+    return inUse;
+}
+
+/// True when the process on the other side of the Unix socket fd runs as the same user
+bool isPeerOwnedByUser(int fd)
+{
+#if defined(SO_PEERCRED)
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) != 0 || len != sizeof(cred))
+        return false;
+    return cred.uid == ::geteuid();
+#else
+    uid_t uid;
+    gid_t gid;
+    if (getpeereid(fd, &uid, &gid) != 0)
+        return false;
+    return uid == ::geteuid();
+#endif
+}
+
+} // unnamed namespace
+
+/// ShmChannel
+
+class ShmChannel : private boost::noncopyable
+{
+public:
+
+    /// Creates a new segment and passes it to the client connected to socketFd
+    static ShmChannel * create(int socketFd, uint32_t ringSize, unsigned int spinCount,
+                               uint32_t maxMessageSize, std::string *errorMsg);
+
+    /// Maps the segment received from the server connected to socketFd
+    static ShmChannel * attach(int socketFd, unsigned int spinCount,
+                               uint32_t maxMessageSize, std::string *errorMsg);
+
+    /// Unmaps the segment and closes socketFd
+    ~ShmChannel();
+
+    /// Writes a message to the outgoing ring, returns false when the channel was closed
+    bool send(const void *data, size_t size);
+
+    /// Appends a message from the incoming ring to dest, returns false when the channel was closed.
+    /// A message larger than maxMessageSize closes the channel.
+    bool receive(DBuffer &dest);
+
+    /// Wakes up all waiting threads of both sides, further operations fail
+    void close();
+
+private:
+
+    struct Ring
+    {
+        ShmRingHeader *header;
+        char *data;
+    };
+
+    ShmChannel(int socketFd, void *segment, size_t segmentSize, bool serverSide,
+               unsigned int spinCount, uint32_t maxMessageSize);
+
+    bool write(Ring &ring, const char *src, size_t size);
+
+    bool read(Ring &ring, char *dest, size_t size);
+
+    bool isReady(const Ring &ring, bool forSpace) const
+    {
+        const ShmRingHeader *h = ring.header;
+        if (forSpace)
+            return __atomic_load_n(&h->head, __ATOMIC_RELAXED) - __atomic_load_n(&h->tail, __ATOMIC_ACQUIRE) < ringSize_;
+        return __atomic_load_n(&h->head, __ATOMIC_ACQUIRE) != __atomic_load_n(&h->tail, __ATOMIC_RELAXED);
+    }
+
+    bool wait(Ring &ring, bool forSpace);
+
+    void notify(Ring &ring);
+
+    bool isPeerAlive() const;
+
+    int socketFd_;
+    void *segment_;
+    size_t segmentSize_;
+    uint32_t ringSize_;
+    unsigned int spinCount_;
+    uint32_t maxMessageSize_;
+    Ring in_;
+    Ring out_;
+};
+
+ShmChannel::ShmChannel(int socketFd, void *segment, size_t segmentSize, bool serverSide,
+                       unsigned int spinCount, uint32_t maxMessageSize)
+    : socketFd_(socketFd)
+    , segment_(segment)
+    , segmentSize_(segmentSize)
+    , ringSize_(static_cast<ShmSegmentHeader*>(segment)->ringSize)
+    // spinning only pays off when the peer runs in parallel
+    , spinCount_(boost::thread::hardware_concurrency() > 1 ? spinCount : 0)
+    , maxMessageSize_(maxMessageSize)
+{
+    ShmSegmentHeader *header = static_cast<ShmSegmentHeader*>(segment);
+    char *data = static_cast<char*>(segment) + sizeof(ShmSegmentHeader);
+
+    Ring requests = { &header->rings[REQUEST_RING], data };
+    Ring responses = { &header->rings[RESPONSE_RING], data + ringSize_ };
+
+    in_ = serverSide ? requests : responses;
+    out_ = serverSide ? responses : requests;
+}
+
+ShmChannel::~ShmChannel()
+{
+    close();
+    munmap(segment_, segmentSize_);
+    ::close(socketFd_);
+}
+
+ShmChannel * ShmChannel::create(int socketFd, uint32_t ringSize, unsigned int spinCount,
+                                uint32_t maxMessageSize, std::string *errorMsg)
+{
+    ringSize = roundUpToPowerOfTwo(ringSize);
+    const size_t segmentSize = sizeof(ShmSegmentHeader) + 2 * static_cast<size_t>(ringSize);
+
+    int shmFd = createSharedMemory(segmentSize);
+    void *segment = shmFd >= 0 ?
+        mmap(0, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, shmFd, 0) : MAP_FAILED;
+    if (segment == MAP_FAILED)
+    {
+        if (errorMsg)
+            *errorMsg = std::strerror(errno);
+        if (shmFd >= 0)
+            ::close(shmFd);
+        ::close(socketFd);
+        return 0;
+    }
+
+    // the object is zero filled by ftruncate
+    ShmSegmentHeader *header = static_cast<ShmSegmentHeader*>(segment);
+    header->magic = SHM_MAGIC;
+    header->ringSize = ringSize;
+
+    // pass the shared memory descriptor with the ring size as payload
+    struct msghdr msg;
+    struct iovec iov;
+    union
+    {
+        struct cmsghdr align;
+        char data[CMSG_SPACE(sizeof(int))];
+    } control;
+
+    memset(&msg, 0, sizeof(msg));
+    memset(&control, 0, sizeof(control));
+    iov.iov_base = &ringSize;
+    iov.iov_len = sizeof(ringSize);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data;
+    msg.msg_controllen = sizeof(control.data);
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &shmFd, sizeof(int));
+
+    ssize_t result;
+    do
+    {
+        result = sendmsg(socketFd, &msg, MSG_NOSIGNAL);
+    } while (result < 0 && errno == EINTR);
+
+    ::close(shmFd);
+
+    if (result != static_cast<ssize_t>(sizeof(ringSize)))
+    {
+        if (errorMsg)
+            *errorMsg = result < 0 ? std::strerror(errno) : "Could not send shared memory segment";
+        munmap(segment, segmentSize);
+        ::close(socketFd);
+        return 0;
+    }
+
+    return new ShmChannel(socketFd, segment, segmentSize, true, spinCount, maxMessageSize);
+}
+
+ShmChannel * ShmChannel::attach(int socketFd, unsigned int spinCount,
+                                uint32_t maxMessageSize, std::string *errorMsg)
+{
+    uint32_t ringSize = 0;
+    struct msghdr msg;
+    struct iovec iov;
+    union
+    {
+        struct cmsghdr align;
+        char data[CMSG_SPACE(sizeof(int))];
+    } control;
+
+    memset(&msg, 0, sizeof(msg));
+    iov.iov_base = &ringSize;
+    iov.iov_len = sizeof(ringSize);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data;
+    msg.msg_controllen = sizeof(control.data);
+
+    ssize_t result;
+    do
+    {
+        result = recvmsg(socketFd, &msg, MSG_CMSG_CLOEXEC);
+    } while (result < 0 && errno == EINTR);
+
+    int shmFd = -1;
+    struct cmsghdr *cmsg = result > 0 ? CMSG_FIRSTHDR(&msg) : 0;
+    if (cmsg && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+        memcpy(&shmFd, CMSG_DATA(cmsg), sizeof(int));
+
+    const size_t segmentSize = sizeof(ShmSegmentHeader) + 2 * static_cast<size_t>(ringSize);
+    struct stat st;
+    void *segment = MAP_FAILED;
+
+    if (result == static_cast<ssize_t>(sizeof(ringSize)) && shmFd >= 0 &&
+        fstat(shmFd, &st) == 0 && static_cast<size_t>(st.st_size) == segmentSize)
+    {
+        segment = mmap(0, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, shmFd, 0);
+    }
+    if (shmFd >= 0)
+        ::close(shmFd);
+
+    if (segment == MAP_FAILED || static_cast<ShmSegmentHeader*>(segment)->magic != SHM_MAGIC ||
+        static_cast<ShmSegmentHeader*>(segment)->ringSize != ringSize)
+    {
+        if (errorMsg)
+            *errorMsg = "Invalid shared memory segment received from server";
+        if (segment != MAP_FAILED)
+            munmap(segment, segmentSize);
+        ::close(socketFd);
+        return 0;
+    }
+
+    return new ShmChannel(socketFd, segment, segmentSize, false, spinCount, maxMessageSize);
+}
+
+bool ShmChannel::send(const void *data, size_t size)
+{
+    // the peer would drop the connection anyway
+    if (size > maxMessageSize_)
+        return false;
+    const uint32_t messageSize = static_cast<uint32_t>(size);
+    if (!write(out_, reinterpret_cast<const char*>(&messageSize), sizeof(messageSize)) ||
+        !write(out_, static_cast<const char*>(data), size))
+        return false;
+    notify(out_);
+    return true;
+}
+
+bool ShmChannel::receive(DBuffer &dest)
+{
+    uint32_t messageSize;
+    if (!read(in_, reinterpret_cast<char*>(&messageSize), sizeof(messageSize)))
+        return false;
+
+    const size_t offset = dest.size();
+    if (messageSize > maxMessageSize_ || !dest.resize(offset + messageSize))
+    {
+        // the stream can't be resynchronized
+        close();
+        return false;
+    }
+    if (!read(in_, dest.data() + offset, messageSize))
+        return false;
+    notify(in_);
+    return true;
+}
+
+bool ShmChannel::write(Ring &ring, const char *src, size_t size)
+{
+    ShmRingHeader *h = ring.header;
+    while (size)
+    {
+        const uint32_t head = __atomic_load_n(&h->head, __ATOMIC_RELAXED);
+        const uint32_t used = head - __atomic_load_n(&h->tail, __ATOMIC_ACQUIRE);
+        if (used == ringSize_)
+        {
+            // let the consumer drain the ring
+            notify(ring);
+            if (!wait(ring, true))
+                return false;
+            continue;
+        }
+
+        const uint32_t pos = head & (ringSize_ - 1);
+        const size_t chunk = std::min(size, static_cast<size_t>(std::min(ringSize_ - used, ringSize_ - pos)));
+        memcpy(ring.data + pos, src, chunk);
+        __atomic_store_n(&h->head, head + static_cast<uint32_t>(chunk), __ATOMIC_RELEASE);
+
+        src += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+bool ShmChannel::read(Ring &ring, char *dest, size_t size)
+{
+    ShmRingHeader *h = ring.header;
+    while (size)
+    {
+        const uint32_t tail = __atomic_load_n(&h->tail, __ATOMIC_RELAXED);
+        const uint32_t available = __atomic_load_n(&h->head, __ATOMIC_ACQUIRE) - tail;
+        if (available == 0)
+        {
+            // let the producer fill the ring
+            notify(ring);
+            if (!wait(ring, false))
+                return false;
+            continue;
+        }
+
+        const uint32_t pos = tail & (ringSize_ - 1);
+        const size_t chunk = std::min(size, static_cast<size_t>(std::min(available, ringSize_ - pos)));
+        memcpy(dest, ring.data + pos, chunk);
+        __atomic_store_n(&h->tail, tail + static_cast<uint32_t>(chunk), __ATOMIC_RELEASE);
+
+        dest += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+bool ShmChannel::wait(Ring &ring, bool forSpace)
+{
+    ShmRingHeader *h = ring.header;
+
+    for (unsigned int i = 0; i < spinCount_; ++i)
+    {
+        if (isReady(ring, forSpace))
+            return true;
+        cpuRelax();
+    }
+
+    for (;;)
+    {
+        // Register as waiter before the last check, notify() either sees
+        // the waiter or its update of the ring is seen by the check.
+        __atomic_add_fetch(&h->waiters, 1, __ATOMIC_SEQ_CST);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        const uint32_t seq = __atomic_load_n(&h->seq, __ATOMIC_SEQ_CST);
+        const bool ready = isReady(ring, forSpace);
+        if (!ready && !__atomic_load_n(&h->closed, __ATOMIC_SEQ_CST))
+            futexWait(&h->seq, seq, WAIT_TIMEOUT_MS);
+        __atomic_sub_fetch(&h->waiters, 1, __ATOMIC_SEQ_CST);
+
+        if (ready || isReady(ring, forSpace))
+            return true;
+        if (__atomic_load_n(&h->closed, __ATOMIC_ACQUIRE) || !isPeerAlive())
+            return false;
+    }
+}
+
+void ShmChannel::notify(Ring &ring)
+{
+    ShmRingHeader *h = ring.header;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&h->waiters, __ATOMIC_SEQ_CST))
+    {
+        __atomic_add_fetch(&h->seq, 1, __ATOMIC_SEQ_CST);
+        futexWake(&h->seq);
+    }
+}
+
+void ShmChannel::close()
+{
+    Ring *rings[2] = { &in_, &out_ };
+    for (int i = 0; i < 2; ++i)
+    {
+        ShmRingHeader *h = rings[i]->header;
+        __atomic_store_n(&h->closed, 1, __ATOMIC_SEQ_CST);
+        __atomic_add_fetch(&h->seq, 1, __ATOMIC_SEQ_CST);
+        futexWake(&h->seq);
+    }
+}
+
+bool ShmChannel::isPeerAlive() const
+{
+    // nothing is sent over the socket after the setup,
+    // so any event means that the peer closed it
+    struct pollfd pfd;
+    pfd.fd = socketFd_;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    return poll(&pfd, 1, 0) == 0;
+}
+
+/// ShmTransport
+
+extern "C" {
+
+static ::KIARA_Connection * kiara_getConnection(::KIARA_FuncObj *funcObj)
+{
+    return funcObj->base.connection;
+}
+
+static ::KIARA_Connection * kiara_getServiceConnection(::KIARA_ServiceFuncObj *funcObj)
+{
+    return funcObj->base.connection;
+}
+
+static KIARA_Result kiara_sendDataShm(::KIARA_Connection *conn, const void *msgData, size_t msgDataSize, kr_dbuffer_t *destBuf)
+{
+    return ((KIARA::Impl::ClientConnection*)conn)->callTransport(msgData, msgDataSize, destBuf);
+}
+
+}
+
+static NetworkHandler shmNetworkHandler = {
+    kiara_getConnection,
+    kiara_getServiceConnection,
+    kiara_sendDataShm
+};
+
+/// ShmAddress
+
+ShmAddress::ShmAddress(const std::string &hostName, unsigned short port, const Transport *transport)
+    : TransportAddress(transport)
+    , hostName_(hostName)
+    , port_(port)
+{
+}
+
+std::string ShmAddress::getHostName() const
+{
+    return hostName_;
+}
+
+unsigned short ShmAddress::getPort() const
+{
+    return port_;
+}
+
+bool ShmAddress::acceptConnection(const TransportAddress::Ptr &address) const
+{
+    // all connections are local, the socket is selected by the port only
+    return address && address->getTransport() == getTransport() && address->getPort() == getPort();
+}
+
+bool ShmAddress::equals(const TransportAddress::Ptr &other) const
+{
+    return acceptConnection(other);
+}
+
+std::string ShmAddress::toString() const
+{
+    std::ostringstream oss;
+    oss << getTransport()->getName() << "://" << hostName_ << ":" << port_;
+    return oss.str();
+}
+
+/// ShmTransport
+
+ShmTransport::ShmTransport()
+    : Transport("shm", 5)
+{
+    setHttpTransport(false);
+    setSecureTransport(false);
+    setNetworkHandler(shmNetworkHandler);
+}
+
+std::string ShmTransport::getPrivateDirectory(const std::string &socketDirectory)
+{
+    std::ostringstream oss;
+    oss << socketDirectory << "/kiara-" << ::geteuid();
+    return oss.str();
+}
+
+std::string ShmTransport::getSocketPath(const std::string &socketDirectory, unsigned short port)
+{
+    std::ostringstream oss;
+    oss << getPrivateDirectory(socketDirectory) << "/kiara-shm-" << port << ".sock";
+    return oss.str();
+}
+
+bool ShmTransport::isAvailable(const std::string &_url) const
+{
+    URL url(_url);
+    if (!url.isValid() || url.scheme != getName())
+        return false;
+
+    const SharedMemoryConfiguration config = Impl::Global::getSharedMemoryConfiguration();
+    if (!config.enabled)
+        return false;
+
+    if (!checkPrivateDirectory(getPrivateDirectory(config.socketDirectory), false, 0))
+        return false;
+
+    struct stat st;
+    const std::string path = getSocketPath(config.socketDirectory, static_cast<unsigned short>(atoi(url.port.c_str())));
+    if (lstat(path.c_str(), &st) != 0 || !S_ISSOCK(st.st_mode) || st.st_uid != ::geteuid())
+        return false;
+
+    return URL::isLocalHost(url.host);
+}
+
+Connection::Ptr ShmTransport::openConnection(
+    const std::string &_url,
+    const NetworkContext::Ptr& ctx,
+    boost::system::error_code *errorCode) const
+{
+    URL url(_url);
+    if (!url.isValid() || url.scheme != getName())
+    {
+        if (errorCode)
+            errorCode->assign(boost::system::errc::invalid_argument, boost::system::system_category());
+        return Connection::Ptr();
+    }
+
+    const unsigned short port = static_cast<unsigned short>(atoi(url.port.c_str()));
+    const SharedMemoryConfiguration config = Impl::Global::getSharedMemoryConfiguration();
+
+    struct sockaddr_un addr;
+    int fd = -1;
+    std::string errorMsg;
+    if (!checkPrivateDirectory(getPrivateDirectory(config.socketDirectory), false, &errorMsg))
+    {
+        DFC_DEBUG("Could not open shared memory connection to "<<_url<<": "<<errorMsg);
+    }
+    else if (makeSocketAddress(getSocketPath(config.socketDirectory, port), addr))
+    {
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0)
+        {
+            setCloseOnExec(fd);
+            if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0)
+            {
+                int savedErrno = errno;
+                ::close(fd);
+                fd = -1;
+                errno = savedErrno;
+            }
+            else if (!isPeerOwnedByUser(fd))
+            {
+                DFC_DEBUG("Shared memory server at "<<_url<<" runs as another user");
+                ::close(fd);
+                fd = -1;
+                errno = EACCES;
+            }
+        }
+    }
+    if (fd < 0)
+    {
+        if (errorCode)
+            errorCode->assign(errno, boost::system::system_category());
+        return Connection::Ptr();
+    }
+
+    ShmChannel *channel = ShmChannel::attach(fd, config.spinCount, config.maxMessageSize, &errorMsg);
+    if (!channel)
+    {
+        DFC_DEBUG("Could not open shared memory connection to "<<_url<<": "<<errorMsg);
+        if (errorCode)
+            errorCode->assign(boost::system::errc::connection_refused, boost::system::system_category());
+        return Connection::Ptr();
+    }
+
+    return Connection::Ptr(new ShmConnection(channel, url.host, port));
+}
+
+Connection::Ptr ShmTransport::createConnection(
+    const NetworkContext::Ptr& ctx,
+    boost::system::error_code *errorCode) const
+{
+    if (errorCode)
+        errorCode->assign(boost::system::errc::operation_not_supported, boost::system::system_category());
+    return Connection::Ptr();
+}
+
+TransportAddress::Ptr ShmTransport::createAddress(const std::string &_url) const
+{
+    URL url(_url);
+    if (!url.isValid() || url.scheme != getName())
+        return TransportAddress::Ptr();
+
+    return TransportAddress::Ptr(new ShmAddress(url.host, boost::lexical_cast<unsigned short>(url.port), this));
+}
+
+NetworkContext::Ptr ShmTransport::createContext() const
+{
+    return NetworkContext::Ptr();
+}
+
+/// ShmConnection
+
+ShmConnection::ShmConnection(ShmChannel *channel, const std::string &hostName, unsigned short port)
+    : channel_(channel)
+    , hostName_(hostName)
+    , port_(port)
+{
+}
+
+ShmConnection::~ShmConnection()
+{
+}
+
+bool ShmConnection::call(const DBuffer &request, DBuffer &response, std::string *errorMsg)
+{
+    boost::mutex::scoped_lock lock(mutex_);
+    if (!channel_->send(request.data(), request.size()) || !channel_->receive(response))
+    {
+        if (errorMsg)
+            *errorMsg = "Shared memory connection closed by server";
+        return false;
+    }
+    return true;
+}
+
+/// ShmServer
+
+ShmServer::ShmServer(const SharedMemoryConfiguration &config, unsigned short port, const RequestHandler &handler)
+    : config_(config)
+    , socketPath_(ShmTransport::getSocketPath(config.socketDirectory, port))
+    , handler_(handler)
+    , listenFd_(-1)
+    , acceptThread_(0)
+    , stopping_(false)
+{
+}
+
+ShmServer::~ShmServer()
+{
+    stop();
+}
+
+bool ShmServer::start(std::string *errorMsg)
+{
+    // only the user can reach the socket, a socket or link planted by
+    // somebody else in a shared directory can't be picked up by clients
+    if (!checkPrivateDirectory(ShmTransport::getPrivateDirectory(config_.socketDirectory), true, errorMsg))
+        return false;
+
+    struct sockaddr_un addr;
+    if (!makeSocketAddress(socketPath_, addr) ||
+        (listenFd_ = socket(AF_UNIX, SOCK_STREAM, 0)) < 0)
+    {
+        if (errorMsg)
+            *errorMsg = socketPath_ + ": " + std::strerror(errno);
+        return false;
+    }
+    setCloseOnExec(listenFd_);
+
+    if (isSocketInUse(addr))
+    {
+        if (errorMsg)
+            *errorMsg = socketPath_ + ": used by a running server";
+        ::close(listenFd_);
+        listenFd_ = -1;
+        return false;
+    }
+
+    // remove socket left by a server that was not shut down
+    if (::unlink(socketPath_.c_str()) != 0 && errno != ENOENT)
+    {
+        if (errorMsg)
+            *errorMsg = socketPath_ + ": " + std::strerror(errno);
+        ::close(listenFd_);
+        listenFd_ = -1;
+        return false;
+    }
+
+    if (bind(listenFd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(listenFd_, SOMAXCONN) != 0)
+    {
+        if (errorMsg)
+            *errorMsg = socketPath_ + ": " + std::strerror(errno);
+        ::close(listenFd_);
+        listenFd_ = -1;
+        return false;
+    }
+
+    acceptThread_ = new boost::thread(boost::bind(&ShmServer::acceptConnections, this));
+    return true;
+}
+
+void ShmServer::stop()
+{
+    {
+        boost::mutex::scoped_lock lock(mutex_);
+        if (stopping_)
+            return;
+        stopping_ = true;
+    }
+
+    if (acceptThread_)
+    {
+        // wakes up accept()
+        ::shutdown(listenFd_, SHUT_RDWR);
+        acceptThread_->join();
+        delete acceptThread_;
+        acceptThread_ = 0;
+    }
+    if (listenFd_ >= 0)
+    {
+        ::close(listenFd_);
+        listenFd_ = -1;
+        ::unlink(socketPath_.c_str());
+    }
+
+    {
+        boost::mutex::scoped_lock lock(mutex_);
+        for (ConnectionMap::iterator it = connections_.begin(), end = connections_.end(); it != end; ++it)
+            it->first->close();
+        while (!connections_.empty())
+            channelClosed_.wait(lock);
+    }
+    joinFinishedThreads();
+}
+
+void ShmServer::joinFinishedThreads()
+{
+    std::vector<boost::thread*> threads;
+    {
+        boost::mutex::scoped_lock lock(mutex_);
+        std::swap(threads, finishedThreads_);
+    }
+    for (std::vector<boost::thread*>::iterator it = threads.begin(), end = threads.end(); it != end; ++it)
+    {
+        (*it)->join();
+        delete *it;
+    }
+}
+
+void ShmServer::acceptConnections()
+{
+    for (;;)
+    {
+        int fd = ::accept(listenFd_, 0, 0);
+        if (fd < 0)
+        {
+            {
+                boost::mutex::scoped_lock lock(mutex_);
+                if (stopping_)
+                    break;
+            }
+            // out of descriptors or memory, retry later
+            if (errno != EINTR && errno != ECONNABORTED)
+                usleep(10000);
+            continue;
+        }
+        setCloseOnExec(fd);
+        joinFinishedThreads();
+
+        if (!isPeerOwnedByUser(fd))
+        {
+            DFC_DEBUG("Rejected shared memory connection on "<<socketPath_<<" from another user");
+            ::close(fd);
+            continue;
+        }
+
+        {
+            // only this thread adds connections
+            boost::mutex::scoped_lock lock(mutex_);
+            if (connections_.size() >= config_.maxConnections)
+            {
+                DFC_DEBUG("Rejected shared memory connection on "<<socketPath_<<", "<<connections_.size()<<" connections are open");
+                ::close(fd);
+                continue;
+            }
+        }
+
+        std::string errorMsg;
+        ShmChannel *channel = ShmChannel::create(fd, config_.ringSize, config_.spinCount,
+                                                 config_.maxMessageSize, &errorMsg);
+        if (!channel)
+        {
+            DFC_DEBUG("Could not create shared memory connection on "<<socketPath_<<": "<<errorMsg);
+            continue;
+        }
+
+        boost::mutex::scoped_lock lock(mutex_);
+        if (stopping_)
+        {
+            delete channel;
+            break;
+        }
+        // the thread waits for the lock before it can remove its connection
+        connections_[channel] = new boost::thread(boost::bind(&ShmServer::serveConnection, this, channel));
+    }
+}
+
+void ShmServer::serveConnection(ShmChannel *channel)
+{
+    DBuffer request;
+    DBuffer response;
+    for (;;)
+    {
+        request.clear();
+        if (!channel->receive(request))
+            break;
+
+        response.clear();
+        handler_(request, response);
+
+        if (!channel->send(response.data(), response.size()))
+            break;
+    }
+
+    boost::mutex::scoped_lock lock(mutex_);
+    ConnectionMap::iterator it = connections_.find(channel);
+    finishedThreads_.push_back(it->second);
+    connections_.erase(it);
+    delete channel;
+    channelClosed_.notify_all();
+}
+
+static ShmTransport shmTransport;
+
+DFC_STATIC_INIT_FUNC
+{
+    Transport::registerTransport(&shmTransport);
+}
+
+} // namespace Transport
+} // namespace KIARA
@@ -0,0 +1,178 @@
+/*
+ * ShmTransport.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef KIARA_TRANSPORT_SHMTRANSPORT_HPP_INCLUDED
+#define KIARA_TRANSPORT_SHMTRANSPORT_HPP_INCLUDED
+
+#include "Transport.hpp"
+#include <KIARA/DB/SharedMemoryConfiguration.hpp>
+#include <KIARA/Utils/DBuffer.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace KIARA
+{
+namespace Transport
+{
+
+/// Shared memory segment of a single connection, see ShmTransport.cpp
+class ShmChannel;
+
+class ShmAddress: public TransportAddress
+{
+public:
+
+    typedef boost::shared_ptr<ShmAddress> Ptr;
+
+    ShmAddress(const std::string &hostName, unsigned short port, const Transport *transport);
+
+    std::string getHostName() const;
+
+    unsigned short getPort() const;
+
+    bool acceptConnection(const TransportAddress::Ptr &address) const;
+
+    bool equals(const TransportAddress::Ptr &other) const;
+
+    std::string toString() const;
+
+private:
+    std::string hostName_;
+    unsigned short port_;
+};
+
+/// Transport for clients on the same host as the server.
+///
+/// Every connection owns a shared memory segment with one ring buffer per
+/// direction, messages are copied into the ring by the sender and out of it
+/// by the receiver without any system call as long as the peer is running.
+/// Waiting threads spin shortly and then sleep on a futex in the segment.
+///
+/// A server serving TCP port N accepts shared memory connections on the Unix
+/// socket <socketDirectory>/kiara-<uid>/kiara-shm-N.sock, which is used only
+/// to pass the segment to the client and to detect when the peer goes away.
+/// The directory must be private to the user and both sides check that the
+/// peer process runs as the same user.
+class ShmTransport: public Transport
+{
+public:
+
+    ShmTransport();
+
+    Connection::Ptr openConnection(
+        const std::string &url,
+        const NetworkContext::Ptr& ctx,
+        boost::system::error_code *errorCode = 0) const;
+
+    /// Server side connections are created by ShmServer
+    Connection::Ptr createConnection(
+        const NetworkContext::Ptr& ctx,
+        boost::system::error_code *errorCode = 0) const;
+
+    TransportAddress::Ptr createAddress(const std::string &url) const;
+
+    NetworkContext::Ptr createContext() const;
+
+    /// True when the host of url is the local host and a server listens on its port
+    bool isAvailable(const std::string &url) const;
+
+    /// Returns the per-user subdirectory of socketDirectory that holds the sockets
+    static std::string getPrivateDirectory(const std::string &socketDirectory);
+
+    static std::string getSocketPath(const std::string &socketDirectory, unsigned short port);
+
+};
+
+/// Client side of a shared memory connection
+class ShmConnection: public Connection
+{
+public:
+
+    typedef boost::shared_ptr<ShmConnection> Ptr;
+
+    ShmConnection(ShmChannel *channel, const std::string &hostName, unsigned short port);
+
+    ~ShmConnection();
+
+    bool call(const DBuffer &request, DBuffer &response, std::string *errorMsg = 0);
+
+    std::string getRemoteHostName() const { return hostName_; }
+
+    unsigned short getRemotePort() const { return port_; }
+
+    std::string getLocalHostName() const { return hostName_; }
+
+    unsigned short getLocalPort() const { return 0; }
+
+protected:
+
+    void handleStart() { }
+
+private:
+    boost::scoped_ptr<ShmChannel> channel_;
+    std::string hostName_;
+    unsigned short port_;
+    boost::mutex mutex_; // a channel carries one request at a time
+};
+
+class ShmServer;
+typedef boost::shared_ptr<ShmServer> ShmServerPtr;
+
+/// Accepts shared memory connections for a TCP port and serves each of them
+/// by its own thread, up to SharedMemoryConfiguration::maxConnections at once.
+class ShmServer: private boost::noncopyable
+{
+public:
+
+    typedef ShmServerPtr Ptr;
+
+    /// Called concurrently by the threads of all connections
+    typedef boost::function<void (const DBuffer &request, DBuffer &response)> RequestHandler;
+
+    ShmServer(const SharedMemoryConfiguration &config, unsigned short port, const RequestHandler &handler);
+
+    /// Closes all connections and waits for their threads
+    ~ShmServer();
+
+    bool start(std::string *errorMsg = 0);
+
+    void stop();
+
+    const std::string & getSocketPath() const { return socketPath_; }
+
+private:
+
+    void acceptConnections();
+
+    void serveConnection(ShmChannel *channel);
+
+    /// Joins threads of closed connections
+    void joinFinishedThreads();
+
+    typedef std::map<ShmChannel*, boost::thread*> ConnectionMap; // open connection to its thread
+
+    SharedMemoryConfiguration config_;
+    std::string socketPath_;
+    RequestHandler handler_;
+    int listenFd_;
+    boost::thread *acceptThread_;
+    boost::mutex mutex_;                 // guards all members below
+    bool stopping_;
+    ConnectionMap connections_;          // channels are owned by their threads
+    std::vector<boost::thread*> finishedThreads_; // threads of closed connections, not joined yet
+    boost::condition_variable channelClosed_;
+};
+
+} // namespace Transport
+} // namespace KIARA
+
+#endif /* KIARA_TRANSPORT_SHMTRANSPORT_HPP_INCLUDED */
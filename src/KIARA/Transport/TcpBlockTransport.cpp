@@ -6,6 +6,7 @@
  */
 
 #include "TcpBlockTransport.hpp"
+#include "ConnectionPool.hpp"
 #include <iostream>
 #include <uriparser/Uri.h>
 #include <boost/system/error_code.hpp>
@@ -15,6 +16,8 @@
 #include <KIARA/CDT/kr_dumpdata.h>
 #include <KIARA/Utils/URL.hpp>
 #include <sstream>
+#include <cstring>
+#include <cerrno>
 
 #define DFC_DO_DEBUG
 #include <DFC/Utils/Debug.hpp>
@@ -61,26 +64,8 @@ static ::KIARA_Connection * kiara_getServiceConnection(::KIARA_ServiceFuncObj *f
 
 static KIARA_Result kiara_sendDataTcp(::KIARA_Connection *conn, const void *msgData, size_t msgDataSize, kr_dbuffer_t *destBuf)
 {
-    KIARA_Result result = KIARA_SUCCESS;
-	
-    KIARA::Impl::ClientConnection *cconn = ((KIARA::Impl::ClientConnection*)conn);
-    TcpZmqConnection::Ptr zmqconnection = boost::static_pointer_cast<TcpZmqConnection>(cconn->getTransportConnection());
-	
-	KT_Msg message;
-	
-	message.set_payload ( msgData );
-	message.set_size( msgDataSize );
-	
-	zmqconnection->connection->send ( message, *zmqconnection->session, 0 );
-	
-	KT_Msg reply;
-	zmqconnection->connection->recv ( *zmqconnection->session, reply, 0 );
-	
-	std::cout << (char*)reply.get_payload_binary() << std::endl;
-	
-	kr_dbuffer_append_mem(destBuf, reply.get_payload_binary(), reply.get_size());
-	
-    return result;
+    // Pooled, ZeroMQ and block connections implement the same call interface
+    return ((KIARA::Impl::ClientConnection*)conn)->callTransport(msgData, msgDataSize, destBuf);
 }
 
 }
@@ -295,6 +280,29 @@ TcpBlockConnection::~TcpBlockConnection()
 }
 
 
+/// TcpZmqConnection
+
+bool TcpZmqConnection::call(const DBuffer &request, DBuffer &response, std::string *errorMsg)
+{
+    if (!connection || !session)
+    {
+        if (errorMsg)
+            *errorMsg = "Not connected";
+        return false;
+    }
+
+    boost::mutex::scoped_lock lock(mutex_);
+    if (connection->send(request, *session) != 0 || connection->recv(*session, response) != 0)
+    {
+        if (errorMsg)
+            *errorMsg = std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+/// TcpBlockConnection
+
 bool TcpBlockConnection::open(const std::string &address, const std::string &port, boost::system::error_code *errorCode)
 {
 	//printf("Using the cpp TCP open\n");
@@ -322,15 +330,37 @@ bool TcpBlockConnection::send(const Request &request, boost::system::error_code
 {
 	//printf("Using the cpp TCP send\n");
     DFC_IFDEBUG(kr_dump_data("TcpBlockClientConnection::send: ", stderr, (unsigned char *)request.getPayload().data(), request.getPayloadSize(), 0));
+    return writeBlock(request.getPayload().data(), request.getPayloadSize(), errorCode);
+}
 
+bool TcpBlockConnection::receive(Response &response, boost::system::error_code *errorCode)
+{
+    response.getPayload().clear();
+    return readBlock(response.getPayload(), errorCode);
+}
+
+bool TcpBlockConnection::call(const DBuffer &request, DBuffer &response, std::string *errorMsg)
+{
+    boost::system::error_code error;
+    if (!writeBlock(request.data(), request.size(), &error) || !readBlock(response, &error))
+    {
+        if (errorMsg)
+            *errorMsg = error.message();
+        return false;
+    }
+    return true;
+}
+
+bool TcpBlockConnection::writeBlock(const void *data, size_t size, boost::system::error_code *errorCode)
+{
     char blockSizeData[4];
-    setInt32LE(request.getPayloadSize(), blockSizeData);
+    setInt32LE(size, blockSizeData);
 
     boost::system::error_code error;
 
     boost::array<boost::asio::const_buffer, 2> bufs = {
         boost::asio::buffer(blockSizeData),
-        boost::asio::buffer(request.getPayload().data(), request.getPayloadSize())
+        boost::asio::buffer(data, size)
     };
 
     boost::asio::write(getSocket(), bufs, error);
@@ -344,7 +374,7 @@ bool TcpBlockConnection::send(const Request &request, boost::system::error_code
     return true;
 }
 
-bool TcpBlockConnection::receive(Response &response, boost::system::error_code *errorCode)
+bool TcpBlockConnection::readBlock(DBuffer &dest, boost::system::error_code *errorCode)
 {
     char blockSizeData[4];
 
@@ -357,13 +387,19 @@ bool TcpBlockConnection::receive(Response &response, boost::system::error_code *
         return false;
     }
 
-    size_t blockSize = getInt32LE(blockSizeData);
+    const size_t blockSize = getInt32LE(blockSizeData);
+    const size_t offset = dest.size();
 
-    response.getPayload().resize_nocopy(blockSize);
+    if (!dest.resize(offset + blockSize))
+    {
+        if (errorCode)
+            errorCode->assign(boost::system::errc::not_enough_memory, boost::system::system_category());
+        return false;
+    }
 
     if (blockSize)
     {
-        boost::asio::read(getSocket(), boost::asio::buffer(response.getPayload().data(), response.getPayloadSize()), error);
+        boost::asio::read(getSocket(), boost::asio::buffer(dest.data() + offset, blockSize), error);
         if (error)
         {
             if (errorCode)
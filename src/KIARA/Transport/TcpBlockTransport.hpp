@@ -13,6 +13,7 @@
 #include "Transport.hpp"
 #include "KT_Zeromq.hpp"
 #include <boost/asio/ip/address.hpp>
+#include <boost/thread/mutex.hpp>
 
 namespace KIARA
 {
@@ -90,10 +91,16 @@ public:
     std::string getLocalHostName() const { return ""; }
 
     unsigned short getLocalPort() const { return 0; }
+
+    /// Sends request over the REQ socket and appends the reply to response
+    bool call(const DBuffer &request, DBuffer &response, std::string *errorMsg = 0);
 	
 	KT_Connection* connection;
 	
 	KT_Session* session;
+
+private:
+    boost::mutex mutex_; // REQ sockets allow one outstanding request only
 };
 
 class TcpBlockConnection;
@@ -125,6 +132,9 @@ public:
 
     bool receive(Response &response, boost::system::error_code *errorCode = 0);
 
+    /// Writes request as single block and appends the response block to response
+    bool call(const DBuffer &request, DBuffer &response, std::string *errorMsg = 0);
+
     /// Start the first asynchronous operation for the connection.
     void handleStart();
 	
@@ -132,6 +142,10 @@ public:
 
 private:
 
+    bool writeBlock(const void *data, size_t size, boost::system::error_code *errorCode);
+
+    bool readBlock(DBuffer &dest, boost::system::error_code *errorCode);
+
     void readBlockSize();
 
     void handleReadBlockSize(const boost::system::error_code& e);
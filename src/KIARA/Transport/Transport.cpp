@@ -45,6 +45,13 @@ void Connection::setConnectionHandler(ConnectionHandler * connectionHandler)
     connectionHandler_ = connectionHandler;
 }
 
+bool Connection::call(const DBuffer &request, DBuffer &response, std::string *errorMsg)
+{
+    if (errorMsg)
+        *errorMsg = "Connection does not support synchronous calls";
+    return false;
+}
+
 
 /// TcpConnection
 
@@ -106,6 +106,13 @@ public:
 
     virtual unsigned short getLocalPort() const = 0;
 
+    /// Client side request/reply, blocks until the reply arrives.
+    ///
+    /// The request buffer is only borrowed for the duration of the call,
+    /// the reply is appended to the response buffer. This is the single
+    /// interface used by the client connections of all transports.
+    virtual bool call(const DBuffer &request, DBuffer &response, std::string *errorMsg = 0);
+
     /// Start the first asynchronous operation for the connection.
     /// Don't call multiple times !!!
     void start()
@@ -287,6 +294,11 @@ public:
 
     virtual NetworkContext::Ptr createContext() const = 0;
 
+    /// Returns false when the endpoint at url can't be reached with this
+    /// transport from the calling process, e.g. when the transport is
+    /// restricted to the local host and the peer is remote.
+    virtual bool isAvailable(const std::string &url) const { return true; }
+
     static const Transport * getTransportByName(const char *transportName);
 
     static const Transport * getTransportByURL(const std::string &url);
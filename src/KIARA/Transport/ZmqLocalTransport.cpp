@@ -0,0 +1,215 @@
+/*
+ * ZmqLocalTransport.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#include "ZmqLocalTransport.hpp"
+#include "TcpBlockTransport.hpp"
+#include <KIARA/Impl/Network.hpp>
+#include <KIARA/Utils/URL.hpp>
+#include <DFC/Base/Utils/StaticInit.hpp>
+#include <boost/lexical_cast.hpp>
+#include <sstream>
+#include <cstdlib>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#define DFC_DO_DEBUG
+#include <DFC/Utils/Debug.hpp>
+
+namespace KIARA
+{
+namespace Transport
+{
+
+/// ZmqLocalTransport
+
+namespace
+{
+
+/// Hosts of a server that listens on all interfaces
+const char *wildcardHostNames[] = { "0.0.0.0", "*", "::" };
+
+} // unnamed namespace
+
+extern "C" {
+
+static ::KIARA_Connection * kiara_getConnection(::KIARA_FuncObj *funcObj)
+{
+    return funcObj->base.connection;
+}
+
+static ::KIARA_Connection * kiara_getServiceConnection(::KIARA_ServiceFuncObj *funcObj)
+{
+    return funcObj->base.connection;
+}
+
+static KIARA_Result kiara_sendDataZmqLocal(::KIARA_Connection *conn, const void *msgData, size_t msgDataSize, kr_dbuffer_t *destBuf)
+{
+    return ((KIARA::Impl::ClientConnection*)conn)->callTransport(msgData, msgDataSize, destBuf);
+}
+
+}
+
+static NetworkHandler zmqLocalNetworkHandler = {
+    kiara_getConnection,
+    kiara_getServiceConnection,
+    kiara_sendDataZmqLocal
+};
+
+ZmqLocalTransport::ZmqLocalTransport(const char *name, int priority, kt_transport_layer transportLayer)
+    : Transport(name, priority)
+    , transportLayer_(transportLayer)
+{
+    setHttpTransport(false);
+    setSecureTransport(false);
+    setNetworkHandler(zmqLocalNetworkHandler);
+}
+
+bool ZmqLocalTransport::isEnabled(const LocalTransportConfiguration &config) const
+{
+    return transportLayer_ == KT_INPROC ? config.inproc : config.ipc;
+}
+
+std::string ZmqLocalTransport::getEndpointHostName(const LocalTransportConfiguration &config,
+                                                   const std::string &host, unsigned short port) const
+{
+    if (transportLayer_ == KT_INPROC)
+        return "kiara/" + host;
+
+    std::ostringstream oss;
+    oss << config.ipcDirectory << "/kiara-" << port << ".ipc";
+    return oss.str();
+}
+
+bool ZmqLocalTransport::isAvailable(const std::string &_url) const
+{
+    URL url(_url);
+    if (!url.isValid() || url.scheme != getName())
+        return false;
+
+    const LocalTransportConfiguration config = Impl::Global::getLocalTransportConfiguration();
+    if (!isEnabled(config))
+        return false;
+
+    const unsigned short port = static_cast<unsigned short>(atoi(url.port.c_str()));
+
+    if (transportLayer_ == KT_INPROC)
+        return URL::isLocalHost(url.host) && !findBoundHostName(config, url.host, port).empty();
+
+    const std::string hostName = getEndpointHostName(config, url.host, port);
+
+    struct stat st;
+    if (stat(hostName.c_str(), &st) != 0 || !S_ISSOCK(st.st_mode))
+        return false;
+
+    return URL::isLocalHost(url.host);
+}
+
+Connection::Ptr ZmqLocalTransport::openConnection(
+    const std::string &_url,
+    const NetworkContext::Ptr& ctx,
+    boost::system::error_code *errorCode) const
+{
+    URL url(_url);
+    if (!url.isValid() || url.scheme != getName())
+    {
+        if (errorCode)
+            errorCode->assign(boost::system::errc::invalid_argument, boost::system::system_category());
+        return Connection::Ptr();
+    }
+
+    const unsigned short port = static_cast<unsigned short>(atoi(url.port.c_str()));
+    const LocalTransportConfiguration localConfig = Impl::Global::getLocalTransportConfiguration();
+
+    // inproc endpoints are named after the host of the tcp port, clients
+    // only reach the server that a tcp connection to url would reach
+    std::string host = url.host;
+    if (transportLayer_ == KT_INPROC)
+    {
+        host = URL::isLocalHost(url.host) ? findBoundHostName(localConfig, url.host, port) : "";
+        if (host.empty())
+        {
+            if (errorCode)
+                errorCode->assign(boost::system::errc::connection_refused, boost::system::system_category());
+            return Connection::Ptr();
+        }
+    }
+
+    KT_Configuration config;
+    config.set_application_type( KT_REQUESTREPLY );
+    config.set_host( transportLayer_, getEndpointHostName(localConfig, host, port), port );
+
+    KT_Connection* connection = new KT_Zeromq ();
+    connection->set_configuration (config);
+
+    KT_Session* session = nullptr;
+
+    if ( 0 != connection->connect ( &session ) )
+    {
+        DFC_DEBUG("Could not connect to "<<config.get_endpoint());
+        if (errorCode)
+            errorCode->assign(errno, boost::system::system_category());
+        delete connection;
+        return Connection::Ptr();
+    }
+
+    TcpZmqConnection *zmqconnection = new TcpZmqConnection;
+    zmqconnection->connection = connection;
+    zmqconnection->session = session;
+
+    return TcpZmqConnection::Ptr(zmqconnection);
+}
+
+Connection::Ptr ZmqLocalTransport::createConnection(
+    const NetworkContext::Ptr& ctx,
+    boost::system::error_code *errorCode) const
+{
+    if (errorCode)
+        errorCode->assign(boost::system::errc::operation_not_supported, boost::system::system_category());
+    return Connection::Ptr();
+}
+
+std::string ZmqLocalTransport::findBoundHostName(const LocalTransportConfiguration &config,
+                                                 const std::string &host, unsigned short port) const
+{
+    if (KT_Zeromq::is_inproc_bound(KT_Configuration::make_endpoint(KT_INPROC, getEndpointHostName(config, host, port), port)))
+        return host;
+
+    for (size_t i = 0; i < sizeof(wildcardHostNames) / sizeof(wildcardHostNames[0]); ++i)
+    {
+        if (KT_Zeromq::is_inproc_bound(
+                KT_Configuration::make_endpoint(KT_INPROC, getEndpointHostName(config, wildcardHostNames[i], port), port)))
+            return wildcardHostNames[i];
+    }
+    return std::string();
+}
+
+TransportAddress::Ptr ZmqLocalTransport::createAddress(const std::string &_url) const
+{
+    URL url(_url);
+    if (!url.isValid() || url.scheme != getName())
+        return TransportAddress::Ptr();
+
+    return TransportAddress::Ptr(new TcpBlockAddress(url.host, boost::lexical_cast<unsigned short>(url.port), this));
+}
+
+NetworkContext::Ptr ZmqLocalTransport::createContext() const
+{
+    return NetworkContext::Ptr();
+}
+
+// inproc is preferred over shared memory, ipc only over tcp
+static ZmqLocalTransport inprocTransport("inproc", 2, KT_INPROC);
+static ZmqLocalTransport ipcTransport("ipc", 7, KT_IPC);
+
+DFC_STATIC_INIT_FUNC
+{
+    Transport::registerTransport(&inprocTransport);
+    Transport::registerTransport(&ipcTransport);
+}
+
+} // namespace Transport
+} // namespace KIARA
@@ -0,0 +1,76 @@
+/*
+ * ZmqLocalTransport.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef KIARA_TRANSPORT_ZMQLOCALTRANSPORT_HPP_INCLUDED
+#define KIARA_TRANSPORT_ZMQLOCALTRANSPORT_HPP_INCLUDED
+
+#include "Transport.hpp"
+#include "KT_Configuration_glob.h"
+#include <KIARA/DB/LocalTransportConfiguration.hpp>
+#include <string>
+
+namespace KIARA
+{
+namespace Transport
+{
+
+/// Transport over the ZeroMQ ipc or inproc endpoints of a TCP port.
+///
+/// A server serving TCP port N binds the same ZeroMQ router also to
+/// ipc://<ipcDirectory>/kiara-N.ipc for processes on the same host and to
+/// inproc://kiara/<host>:N for clients in the same process, which skips the
+/// TCP stack and for inproc any system call. <host> is the host the TCP port
+/// is bound to, a client uses the inproc endpoint only when the host of its
+/// url is local and is that host, or the port is bound to all interfaces.
+class ZmqLocalTransport: public Transport
+{
+public:
+
+    /// transportLayer is KT_IPC or KT_INPROC
+    ZmqLocalTransport(const char *name, int priority, kt_transport_layer transportLayer);
+
+    kt_transport_layer getTransportLayer() const { return transportLayer_; }
+
+    Connection::Ptr openConnection(
+        const std::string &url,
+        const NetworkContext::Ptr& ctx,
+        boost::system::error_code *errorCode = 0) const;
+
+    /// Server side connections are created by KT_Zeromq
+    Connection::Ptr createConnection(
+        const NetworkContext::Ptr& ctx,
+        boost::system::error_code *errorCode = 0) const;
+
+    TransportAddress::Ptr createAddress(const std::string &url) const;
+
+    NetworkContext::Ptr createContext() const;
+
+    /// True when the host of url is the local host and the endpoint of url
+    /// is bound in this process (inproc) or on this host (ipc)
+    bool isAvailable(const std::string &url) const;
+
+    bool isEnabled(const LocalTransportConfiguration &config) const;
+
+    /// Host name of the KT_Configuration of the endpoint of a TCP port bound
+    /// to host, see KT_Configuration::make_endpoint
+    std::string getEndpointHostName(const LocalTransportConfiguration &config,
+                                    const std::string &host, unsigned short port) const;
+
+private:
+
+    /// Returns the host of the inproc endpoint bound for port that serves
+    /// host, either host itself or a wildcard host, empty if there is none
+    std::string findBoundHostName(const LocalTransportConfiguration &config,
+                                  const std::string &host, unsigned short port) const;
+
+    kt_transport_layer transportLayer_;
+};
+
+} // namespace Transport
+} // namespace KIARA
+
+#endif /* KIARA_TRANSPORT_ZMQLOCALTRANSPORT_HPP_INCLUDED */
@@ -18,17 +18,26 @@ static const char* kt_transport_prefix[] = {
 	"tcp://",
 	"udp://",
 	"dccp://",
-	"sctp://"
+	"sctp://",
+	"ipc://",
+	"inproc://"
 };
 
 char* compile_endpoint_string(kt_connconf_t config)
 {
 	//FIXME: Dynamic allocation of memory for endpoint
 	char *endpoint = malloc(256);
-	snprintf(endpoint, 255, "%s%s:%i",
-		kt_transport_prefix[config.network_config.transport],
-		config.base_url,
-		config.network_config.port
-		);
+	const char *prefix = kt_transport_prefix[config.network_config.transport];
+
+	if (IPC == config.network_config.transport ||
+		(INPROC == config.network_config.transport && 0 == config.network_config.port)) {
+		snprintf(endpoint, 255, "%s%s", prefix, config.base_url);
+	} else {
+		snprintf(endpoint, 255, "%s%s:%i",
+			prefix,
+			config.base_url,
+			config.network_config.port
+			);
+	}
 	return endpoint;
 }
@@ -43,7 +43,9 @@ enum kt_transport_layer {
 	TCP,
 	UDP,
 	DCCP,
-	SCTP
+	SCTP,
+	IPC,
+	INPROC
 };
 
 /**
@@ -144,6 +146,9 @@ typedef struct {
 /**
  * @brief Creates an endpoint by prepending the protocol name and appending the
  * port number to the hostname.
+ *
+ * For IPC the base_url is the path of the socket and the port is ignored, for
+ * INPROC it is the name of the endpoint and the port is appended if not zero.
  * @param config A struct containing the protocol, hostname/IP and port
  * @return A char* as a human readable string that was used by ZeroMQ
  * @note Unused
@@ -10,6 +10,8 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
 #include <uthash.h>
 #include "reco_engine.h"
 #include "registry.h"
@@ -61,17 +63,85 @@ void neg_get_final_capability(neg_ctx_t* neg_ctx, char* key) {
  * @brief
  */
 void neg_negotiate_remote(neg_ctx_t* neg_ctx, char* identifier, char* payload) {
-	reg_set_remote_capability(neg_ctx, identifier, payload);
-	neg_set_final_capabilities(neg_ctx, neg_negotiate(neg_ctx, identifier));
+	char *response = neg_negotiate_offer(neg_ctx, identifier, payload, strlen(payload));
+	if (response != NULL) {
+		neg_set_final_capabilities(neg_ctx, response);
+		free(response);
+	}
 }
 
 /**
  * @param neg_ctx
- * @return
- * @brief
+ * @param identifier Remote endpoint
+ * @param offer Remote capabilities, JSON document or binary encoded
+ * @param size Size of offer
+ * @return Negotiated capabilities, must be freed by the caller, NULL when the offer is invalid
+ * @brief Negotiates with a remote offer, identical offers are answered from the cache
+ *
+ * The result depends only on the local capabilities and the offer, so it is
+ * cached by the hash of both. After a server restart all clients send the
+ * same few offers and only the first of each is negotiated.
+ */
+char *neg_negotiate_offer(neg_ctx_t *neg_ctx, const char *identifier, const char *offer, size_t size) {
+	neg_cache_entry_t *entry;
+	char key[64];
+	char *response;
+
+	snprintf(key, sizeof (key), "negotiate:%016" PRIx64,
+			reg_hash_data(offer, size, reg_get_local_capability_hash(neg_ctx)));
+	entry = reg_cache_find(neg_ctx, key);
+	if (entry != NULL && entry->response != NULL)
+		return strdup(entry->response);
+
+	if (reg_set_remote_capability_data(neg_ctx, identifier, offer, size) != 0)
+		return NULL;
+	response = neg_negotiate(neg_ctx, identifier);
+	if (response != NULL)
+		reg_cache_add(neg_ctx, key, response, NULL, 0);
+	return response;
+}
+
+/**
+ * @param neg_ctx
+ * @return Response of the remote endpoint, must be freed by the caller
+ * @brief Sends the local capabilities to neg_ctx->host, the response is cached per endpoint
  */
 char *neg_send_offer(neg_ctx_t *neg_ctx) {
-	return reco_send_offer(neg_ctx->host, neg_ctx);
+	neg_cache_entry_t *entry;
+	char key[strlen(neg_ctx->host) + 64];
+	char *response;
+
+	snprintf(key, sizeof (key), "offer:%s:%d:%016" PRIx64,
+			neg_ctx->host, neg_ctx->port, reg_get_local_capability_hash(neg_ctx));
+	entry = reg_cache_find(neg_ctx, key);
+	if (entry != NULL && entry->response != NULL)
+		return strdup(entry->response);
+
+	response = reco_send_offer(neg_ctx->host, neg_ctx);
+	/* Do not cache failures and fallback negotiation done by the client */
+	if (response != NULL && response[0] != '\0' && !neg_ctx->client_nego)
+		reg_cache_add(neg_ctx, key, response, NULL, 0);
+	return response;
+}
+
+/**
+ * @param neg_ctx
+ * @param ttl Time in seconds negotiation results are cached, 0 disables the cache
+ * @brief
+ */
+void neg_set_cache_ttl(neg_ctx_t *neg_ctx, int ttl) {
+	neg_ctx->cache_ttl = ttl;
+	if (ttl <= 0)
+		reg_cache_clear(neg_ctx);
+}
+
+/**
+ * @param neg_ctx
+ * @param enable Send offers in the compact binary encoding instead of JSON
+ * @brief Only remote endpoints which support the binary encoding accept such offers
+ */
+void neg_set_binary_offers(neg_ctx_t *neg_ctx, int enable) {
+	neg_ctx->binary_offers = enable;
 }
 
 /**
@@ -251,6 +321,8 @@ char *neg_negotiate(neg_ctx_t *neg_ctx, const char *endpoint) {
 			HASH_ADD_KEYPTR(hh, neg_dict, response_key, strlen(response_key), nego_tmp);
 		}
 	}
+	/* The response must only depend on this negotiation, it is cached by neg_negotiate_offer */
+	json_object_clear(neg_ctx->root_response);
 	char *json = _reg_get_local_capability_json(neg_dict, neg_ctx->root_response);
 	return json;
 }
@@ -291,6 +363,10 @@ int neg_capability_to_int(char *capability) {
 		return KT_UDP;
 	} else if (strcmp(capability, "stream") == 0) {
 		return KT_STREAM;
+	} else if (strcmp(capability, "ipc") == 0) {
+		return KT_IPC;
+	} else if (strcmp(capability, "inproc") == 0) {
+		return KT_INPROC;
 	} else if (strcmp(capability, "tcp") == 0) {
 		
 	} else if (strcmp(capability, "tcp") == 0) {
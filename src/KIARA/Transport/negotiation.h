@@ -9,6 +9,8 @@
 
 #include <uthash.h>
 #include <jansson.h>
+#include <stdint.h>
+#include <time.h>
 #include "KT_Configuration_glob.h"
 
 #ifndef NEGOTIATION_H
@@ -50,6 +52,23 @@ typedef struct neg_dict_remote_collection_t {
     UT_hash_handle hh;
 } neg_dict_remote_collection_t;
 
+/**
+ * @struct neg_cache_entry_t
+ * @brief Cached negotiation result
+ *
+ * The key consists of the endpoint and the hash of the capability sets the
+ * result was computed from, so an entry never has to be invalidated when
+ * capabilities change. Entries are dropped when they expire.
+ */
+typedef struct neg_cache_entry_t {
+	char *id;
+	char *response;              /* negotiated capability document or NULL */
+	unsigned char *data;         /* binary encoded capabilities or NULL */
+	size_t size;
+	time_t expires;
+	UT_hash_handle hh;
+} neg_cache_entry_t;
+
 /**
  * @struct neg_ctx_t
  * @brief negotiation context
@@ -68,8 +87,19 @@ typedef struct neg_ctx_t {
 	char* server_repsonse_body;
 	json_t *root;
 	json_t *root_response;
+	neg_cache_entry_t *cache;
+	int cache_ttl;               /* seconds, 0 disables the cache */
+	int binary_offers;           /* send offers in binary encoding */
+	uint64_t local_hash;         /* hash of the local capabilities */
+	int local_hash_valid;
 } neg_ctx_t;
 
+/** Default time negotiation results are cached in seconds */
+#define NEG_CACHE_DEFAULT_TTL 300
+
+/** Maximal number of cached negotiation results per context */
+#define NEG_CACHE_MAX_ENTRIES 1024
+
 /**
  * @enum precedence
  * @brief
@@ -88,6 +118,9 @@ void neg_get_final_capability(neg_ctx_t* neg_ctx, char* key);
 char *neg_get_best_local_capability(neg_ctx_t *neg_ctx, const char *capability);
 int neg_run_server(neg_ctx_t *neg_ctx);
 char *neg_negotiate(neg_ctx_t *neg_ctx, const char *endpoint);
+char *neg_negotiate_offer(neg_ctx_t *neg_ctx, const char *identifier, const char *offer, size_t size);
+void neg_set_cache_ttl(neg_ctx_t *neg_ctx, int ttl);
+void neg_set_binary_offers(neg_ctx_t *neg_ctx, int enable);
 int neg_set_final_capabilities(neg_ctx_t* neg_ctx, char *response);
 int neg_set_profile(int profile);
 int neg_capability_to_int(char *capability);
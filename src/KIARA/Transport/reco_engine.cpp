@@ -18,6 +18,7 @@
 #include <unistd.h>
 #include <cstring>
 #include <string>
+#include <mutex>
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -40,6 +41,10 @@ using namespace KIARA::Transport;
  */
 void callback_handler_reco(KT_Msg&, KT_Session*, KT_Connection*);
 
+/// Negotiation contexts are not thread safe, the callback is called by the
+/// dispatch threads of the connection concurrently.
+static std::mutex neg_ctx_mutex;
+
 /**
  * @param endpoint
  * @param neg_ctx
@@ -89,6 +94,7 @@ int RecoServer::RunServer() {
  */
 void callback_handler_reco(KT_Msg& msg, KT_Session* sess, KT_Connection* obj) {
 	KT_HTTP_Parser parser(msg);
+	std::unique_lock<std::mutex> lock(neg_ctx_mutex);
 	neg_ctx_t *neg_ctx = (neg_ctx_t*) sess->get_k_user_data();
 	std::cout << neg_ctx->host << std::endl;
 	std::string payload("");
@@ -112,8 +118,17 @@ void callback_handler_reco(KT_Msg& msg, KT_Session* sess, KT_Connection* obj) {
 					break;
 				}
 				std::cout << parser.get_payload() << std::endl;
-				reg_set_remote_capability(neg_ctx, parser.get_identifier().c_str(), parser.get_payload().c_str());
-				payload.append(neg_negotiate(neg_ctx, parser.get_identifier().c_str()));
+				{
+					std::string offer(parser.get_payload());
+					char *response = neg_negotiate_offer(neg_ctx, parser.get_identifier().c_str(), offer.data(), offer.size());
+					if (response == NULL) {
+						payload.append("Invalid offer!");
+						payload = KT_HTTP_Responder::generate_400_BAD_REQUEST(std::vector<char>(payload.begin(), payload.end()));
+						break;
+					}
+					payload.append(response);
+					free(response);
+				}
 				payload = KT_HTTP_Responder::generate_200_OK(std::vector<char>(payload.begin(), payload.end()));
 				break;
 				//Anything else
@@ -125,6 +140,7 @@ void callback_handler_reco(KT_Msg& msg, KT_Session* sess, KT_Connection* obj) {
 	//DEBUG Only
 	//std::cout << parser.get_payload() << std::endl;
 	//std::cout << parser.get_identifier() << std::endl;
+	lock.unlock();
 
 	KT_Msg message;
 	message.set_payload(payload);
@@ -158,7 +174,15 @@ RecoClient::RecoClient(char* serverhost, neg_ctx_t* neg_ctx) {
 		}
 
 		KT_Msg request;
-		std::string payload(reg_get_local_capability_json(neg_ctx));
+		std::string payload;
+		unsigned char *offer = NULL;
+		size_t offerSize = 0;
+		if (neg_ctx->binary_offers && (offerSize = reg_encode_capabilities(neg_ctx->hash, &offer)) != 0) {
+			payload.assign((const char *) offer, offerSize);
+			free(offer);
+		} else {
+			payload.append(reg_get_local_capability_json(neg_ctx));
+		}
 		payload = KT_HTTP_Requester::generate_request("PUT", "localhost:5555", "/negotiation", std::vector<char>(payload.begin(), payload.end()));
 
 		request.set_payload(payload);
@@ -198,6 +222,9 @@ RecoClient::RecoClient(char* serverhost, neg_ctx_t* neg_ctx) {
 	}
 }
 
+RecoClient::~RecoClient() {
+}
+
 /**
  * @return
  * @brief
@@ -233,18 +260,20 @@ extern "C" {
         /**
          * @param endpoint
          * @param neg_ctx
-         * @return
+         * @return Response of the endpoint, must be freed by the caller
          * @brief
          */
 	char* reco_send_offer(char *endpoint, neg_ctx_t* neg_ctx) {
 		if(_check_remote_endpoint(endpoint, neg_ctx->port) == 0){
 			neg_ctx->kiara_endpoint = 0;
-			return "";
+			return strdup("");
 		}
 		else {
 			//Try PUT first
 			RecoClient *out = new RecoClient(endpoint, neg_ctx);
-			return out->GetPayload();
+			char *response = strdup(out->GetPayload());
+			delete out;
+			return response;
 		}
 	}
 
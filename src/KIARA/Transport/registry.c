@@ -30,6 +30,11 @@ neg_ctx_t *reg_create_context(void) {
 	neg_ctx->root_response = json_object();
 	neg_ctx->kiara_endpoint = 1;
 	neg_ctx->client_nego = 0;
+	neg_ctx->cache = NULL;
+	neg_ctx->cache_ttl = NEG_CACHE_DEFAULT_TTL;
+	neg_ctx->binary_offers = 0;
+	neg_ctx->local_hash = 0;
+	neg_ctx->local_hash_valid = 0;
 	return neg_ctx;
 }
 
@@ -41,15 +46,63 @@ neg_ctx_t *reg_create_context(void) {
  * @brief
  */
 int reg_set_remote_capability(neg_ctx_t *neg_ctx, const char *endpoint, const char *remote_body) {
-	neg_dict_remote_collection_t *remote_dict = reg_get_remote_dict(neg_ctx, endpoint);
-	neg_dict_remote_collection_t *tmp, *current_dict, *out;
+	return reg_set_remote_capability_data(neg_ctx, endpoint, remote_body, strlen(remote_body));
+}
+
+/**
+ * @param remote_dict
+ * @brief Removes all capabilities received from a remote endpoint
+ */
+static void _reg_clear_remote_dict(neg_dict_remote_collection_t *remote_dict) {
+	neg_dict_remote_collection_t *current_dict, *tmp;
+	HASH_ITER(hh, remote_dict->sub, current_dict, tmp) {
+		HASH_DEL(remote_dict->sub, current_dict);
+		free((char *) current_dict->id);
+		free(current_dict->value);
+		free(current_dict);
+	}
+}
+
+/**
+ * @param user_data The remote dictionary
+ * @param id Owned by the dictionary afterwards
+ * @param value Owned by the dictionary afterwards
+ * @brief Adds a decoded capability to a remote dictionary
+ */
+static void _reg_add_remote_capability(void *user_data, char *id, char *value) {
+	neg_dict_remote_collection_t *remote_dict = (neg_dict_remote_collection_t *) user_data;
 	neg_dict_remote_collection_t *s = malloc(sizeof (*s));
+	s->id = id;
+	s->value = value;
+	s->sub = NULL;
+	HASH_ADD_KEYPTR(hh, remote_dict->sub, s->id, strlen(s->id), s);
+}
+
+/**
+ * @param neg_ctx
+ * @param endpoint
+ * @param remote_body JSON document or binary encoded capabilities
+ * @param size Size of remote_body
+ * @return 0 on success, -1 when remote_body is not valid
+ * @brief Replaces the capabilities of the endpoint by the ones in remote_body
+ */
+int reg_set_remote_capability_data(neg_ctx_t *neg_ctx, const char *endpoint, const char *remote_body, size_t size) {
+	neg_dict_remote_collection_t *remote_dict = reg_get_remote_dict(neg_ctx, endpoint);
+
+	_reg_clear_remote_dict(remote_dict);
+
+	if (reg_is_binary_capabilities(remote_body, size)) {
+		return reg_decode_capabilities((const unsigned char *) remote_body, size, _reg_add_remote_capability, remote_dict);
+	}
+
 	json_t *root, *value;
 	const char *key;
 	char *nego_key;
 	json_error_t error;
 
-	root = json_loads(remote_body, 0, &error);
+	root = json_loadb(remote_body, size, 0, &error);
+	if (root == NULL)
+		return -1;
 
 	json_object_foreach(root, key, value) {
 		if (strcmp(key, "general") == 0) {
@@ -59,12 +112,10 @@ int reg_set_remote_capability(neg_ctx_t *neg_ctx, const char *endpoint, const ch
 		} else if (json_is_object(value)) {
 			asprintf(&nego_key, "%s.", key);
 			_reg_parse_dict(value, remote_dict, nego_key);
+			free(nego_key);
 		}
 	}
-
-	HASH_ITER(hh, neg_ctx->dict_collection, current_dict, tmp) {
-		HASH_FIND_STR(current_dict->sub, "security.mechanism.ssl.prec", out);
-	}
+	json_decref(root);
 	return 0;
 }
 
@@ -133,11 +184,12 @@ int _parse_final_capabilities(json_t *value, neg_ctx_t* neg_ctx, char *nego_key,
  * @brief
  */
 neg_dict_remote_collection_t* reg_get_remote_dict(neg_ctx_t *neg_ctx, const char *endpoint) {
-	neg_dict_remote_collection_t *s = malloc(sizeof (*s));
+	neg_dict_remote_collection_t *s;
 	HASH_FIND_STR(neg_ctx->dict_collection, endpoint, s);
 	if (s == NULL) {
 		s = malloc(sizeof (struct neg_dict_remote_collection_t));
-		s->id = endpoint;
+		/* endpoint is usually a temporary string of the caller */
+		s->id = strdup(endpoint);
 		s->sub = NULL;
 		s->value = "";
 		HASH_ADD_KEYPTR(hh, neg_ctx->dict_collection, s->id, strlen(s->id), s);
@@ -158,6 +210,7 @@ int reg_set_capability(neg_ctx_t *neg_ctx, char *key, char *value) {
 	s->id = key;
 	s->value = value;
 	HASH_ADD_KEYPTR(hh, neg_ctx->hash, s->id, strlen(s->id), s);
+	neg_ctx->local_hash_valid = 0;
 	return 0;
 }
 
@@ -265,19 +318,398 @@ int _reg_parse_dict(json_t* value, neg_dict_remote_collection_t* remote_dict, co
 
 	json_object_foreach(value, new_key, new_value) {
 		if (json_is_object(new_value)) {
-			const char *tmp_key;
+			char *tmp_key;
 			asprintf(&tmp_key, "%s%s.", nego_key, new_key);
 			_reg_parse_dict(new_value, remote_dict, tmp_key);
+			free(tmp_key);
 		}
 		if (json_is_string(new_value)) {
 			neg_dict_remote_collection_t *s = malloc(sizeof (*s));
-			const char *tmp_key;
+			char *tmp_key;
 			asprintf(&tmp_key, "%s%s", nego_key, new_key);
 			s->id = tmp_key;
-			s->value = json_string_value(new_value);
+			/* the JSON document is released after parsing */
+			s->value = strdup(json_string_value(new_value));
 			s->sub = NULL;
 			HASH_ADD_KEYPTR(hh, remote_dict->sub, s->id, strlen(s->id), s);
 		}
 	}
 	return 0;
 }
+
+/**
+ * @brief Growable output buffer of the binary encoder
+ */
+typedef struct reg_buffer_t {
+	unsigned char *data;
+	size_t size;
+	size_t capacity;
+} reg_buffer_t;
+
+static int _reg_buffer_reserve(reg_buffer_t *buf, size_t size) {
+	if (buf->size + size > buf->capacity) {
+		size_t capacity = buf->capacity ? buf->capacity * 2 : 256;
+		unsigned char *data;
+		while (capacity < buf->size + size)
+			capacity *= 2;
+		data = realloc(buf->data, capacity);
+		if (data == NULL)
+			return 0;
+		buf->data = data;
+		buf->capacity = capacity;
+	}
+	return 1;
+}
+
+static int _reg_buffer_put(reg_buffer_t *buf, const void *data, size_t size) {
+	if (!_reg_buffer_reserve(buf, size))
+		return 0;
+	memcpy(buf->data + buf->size, data, size);
+	buf->size += size;
+	return 1;
+}
+
+static int _reg_buffer_put_varint(reg_buffer_t *buf, size_t value) {
+	unsigned char bytes[10];
+	size_t n = 0;
+	do {
+		bytes[n] = value & 0x7f;
+		value >>= 7;
+		if (value)
+			bytes[n] |= 0x80;
+		n++;
+	} while (value);
+	return _reg_buffer_put(buf, bytes, n);
+}
+
+static int _reg_get_varint(const unsigned char **data, const unsigned char *end, size_t *value) {
+	size_t result = 0;
+	unsigned shift = 0;
+	while (*data < end && shift < sizeof (size_t) * 8) {
+		unsigned char byte = *(*data)++;
+		result |= (size_t) (byte & 0x7f) << shift;
+		if ((byte & 0x80) == 0) {
+			*value = result;
+			return 1;
+		}
+		shift += 7;
+	}
+	return 0;
+}
+
+/** Precedence strings stored as one byte, index is the code */
+static const char *_reg_prec_names[] = { "NONE", "MUST NOT", "SHOULD NOT", "SHOULD", "MUST" };
+
+#define REG_STRING_VALUE 0xff
+
+/**
+ * @param value
+ * @return The precedence code of value or REG_STRING_VALUE
+ * @brief
+ */
+static int _reg_prec_to_code(const char *value) {
+	int i;
+	for (i = 0; i < (int) (sizeof (_reg_prec_names) / sizeof (_reg_prec_names[0])); i++) {
+		if (strcmp(value, _reg_prec_names[i]) == 0)
+			return i;
+	}
+	return REG_STRING_VALUE;
+}
+
+static int _reg_compare_ids(const void *a, const void *b) {
+	return strcmp((*(neg_dict_t * const *) a)->id, (*(neg_dict_t * const *) b)->id);
+}
+
+/**
+ * @param hash Capabilities to encode
+ * @param data Receives the malloc'ed encoding, must be freed by the caller
+ * @return Size of the encoding, 0 on failure
+ * @brief Encodes capabilities in the binary encoding described in registry.h
+ */
+size_t reg_encode_capabilities(neg_dict_t *hash, unsigned char **data) {
+	reg_buffer_t buf = { NULL, 0, 0 };
+	const unsigned char version = REG_BINARY_VERSION;
+	neg_dict_t **entries, *tmp;
+	size_t count = HASH_COUNT(hash), i;
+	const char *prev = "";
+	int ok;
+
+	entries = malloc(sizeof (neg_dict_t *) * (count ? count : 1));
+	if (entries == NULL)
+		return 0;
+	for (i = 0, tmp = hash; tmp != NULL; tmp = (neg_dict_t *) tmp->hh.next)
+		entries[i++] = tmp;
+	qsort(entries, count, sizeof (neg_dict_t *), _reg_compare_ids);
+
+	ok = _reg_buffer_put(&buf, REG_BINARY_MAGIC, 3) &&
+		_reg_buffer_put(&buf, &version, 1) &&
+		_reg_buffer_put_varint(&buf, count);
+
+	for (i = 0; ok && i < count; i++) {
+		const char *id = entries[i]->id;
+		const char *value = entries[i]->value ? entries[i]->value : "";
+		size_t shared = 0, length = strlen(id);
+		unsigned char code = (unsigned char) _reg_prec_to_code(value);
+
+		while (prev[shared] != '\0' && prev[shared] == id[shared])
+			shared++;
+
+		ok = _reg_buffer_put_varint(&buf, shared) &&
+			_reg_buffer_put_varint(&buf, length - shared) &&
+			_reg_buffer_put(&buf, id + shared, length - shared) &&
+			_reg_buffer_put(&buf, &code, 1);
+		if (ok && code == REG_STRING_VALUE) {
+			ok = _reg_buffer_put_varint(&buf, strlen(value)) &&
+				_reg_buffer_put(&buf, value, strlen(value));
+		}
+		prev = id;
+	}
+	free(entries);
+
+	if (!ok) {
+		free(buf.data);
+		return 0;
+	}
+	*data = buf.data;
+	return buf.size;
+}
+
+/**
+ * @brief Decoded capability, id and value are malloc'ed
+ */
+typedef struct reg_capability_t {
+	char *id;
+	char *value;
+} reg_capability_t;
+
+/**
+ * @param data Position in the encoding, advanced past the entry
+ * @param end
+ * @param prev Id of the previous entry or NULL
+ * @param entry Receives the decoded capability
+ * @return Non-zero on success, nothing is allocated on failure
+ * @brief Decodes a single entry of the binary encoding
+ */
+static int _reg_decode_capability(const unsigned char **data, const unsigned char *end, const char *prev, reg_capability_t *entry) {
+	size_t prev_length = prev ? strlen(prev) : 0, shared, length;
+	unsigned char code;
+	char *id, *value;
+
+	if (!_reg_get_varint(data, end, &shared) || shared > prev_length ||
+		!_reg_get_varint(data, end, &length) || length > (size_t) (end - *data))
+		return 0;
+
+	id = malloc(shared + length + 1);
+	if (id == NULL)
+		return 0;
+	if (shared != 0)
+		memcpy(id, prev, shared);
+	memcpy(id + shared, *data, length);
+	id[shared + length] = '\0';
+	*data += length;
+
+	if (*data == end) {
+		free(id);
+		return 0;
+	}
+	code = *(*data)++;
+	if (code == REG_STRING_VALUE) {
+		size_t value_length;
+		if (!_reg_get_varint(data, end, &value_length) || value_length > (size_t) (end - *data)) {
+			free(id);
+			return 0;
+		}
+		value = malloc(value_length + 1);
+		if (value != NULL) {
+			memcpy(value, *data, value_length);
+			value[value_length] = '\0';
+		}
+		*data += value_length;
+	} else if (code < sizeof (_reg_prec_names) / sizeof (_reg_prec_names[0])) {
+		value = strdup(_reg_prec_names[code]);
+	} else {
+		free(id);
+		return 0;
+	}
+	if (value == NULL) {
+		free(id);
+		return 0;
+	}
+
+	entry->id = id;
+	entry->value = value;
+	return 1;
+}
+
+/**
+ * @param data
+ * @param size
+ * @param fn Called with malloc'ed id and value of every capability, takes ownership of both
+ * @param user_data Passed to fn
+ * @return 0 on success, -1 when data is not a valid encoding
+ * @brief Decodes capabilities encoded by reg_encode_capabilities
+ *
+ * The whole encoding is validated first, fn is not called for invalid data.
+ */
+int reg_decode_capabilities(const unsigned char *data, size_t size, reg_capability_fn fn, void *user_data) {
+	const unsigned char *end = data + size;
+	reg_capability_t *entries;
+	size_t count, num_entries = 0, i;
+	int ok = 1;
+
+	if (!reg_is_binary_capabilities((const char *) data, size))
+		return -1;
+	data += 4;
+	/* Every entry takes at least three bytes, count is not trusted otherwise */
+	if (!_reg_get_varint(&data, end, &count) || count > (size_t) (end - data) / 3)
+		return -1;
+
+	entries = malloc(sizeof (reg_capability_t) * (count ? count : 1));
+	if (entries == NULL)
+		return -1;
+
+	for (i = 0; ok && i < count; i++) {
+		ok = _reg_decode_capability(&data, end, num_entries ? entries[num_entries - 1].id : NULL, &entries[num_entries]);
+		if (ok)
+			num_entries++;
+	}
+	ok = ok && data == end;
+
+	for (i = 0; i < num_entries; i++) {
+		if (ok) {
+			fn(user_data, entries[i].id, entries[i].value);
+		} else {
+			free(entries[i].id);
+			free(entries[i].value);
+		}
+	}
+	free(entries);
+	return ok ? 0 : -1;
+}
+
+/**
+ * @param data
+ * @param size
+ * @return Non-zero when data starts with the binary encoding header
+ * @brief JSON documents start with '{' and are never detected as binary
+ */
+int reg_is_binary_capabilities(const char *data, size_t size) {
+	return size >= 4 && memcmp(data, REG_BINARY_MAGIC, 3) == 0 && (unsigned char) data[3] == REG_BINARY_VERSION;
+}
+
+/**
+ * @param data
+ * @param size
+ * @param seed Hash of preceding data or 0
+ * @return 64-bit FNV-1a hash
+ * @brief
+ */
+uint64_t reg_hash_data(const void *data, size_t size, uint64_t seed) {
+	const unsigned char *p = (const unsigned char *) data;
+	uint64_t hash = seed ? seed : 14695981039346656037ULL;
+	size_t i;
+	for (i = 0; i < size; i++) {
+		hash ^= p[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+/**
+ * @param neg_ctx
+ * @return Hash of the binary encoding of the local capabilities
+ * @brief The hash is computed again only after capabilities were changed
+ */
+uint64_t reg_get_local_capability_hash(neg_ctx_t *neg_ctx) {
+	if (!neg_ctx->local_hash_valid) {
+		unsigned char *data = NULL;
+		size_t size = reg_encode_capabilities(neg_ctx->hash, &data);
+		neg_ctx->local_hash = reg_hash_data(data, size, 0);
+		neg_ctx->local_hash_valid = size != 0;
+		free(data);
+	}
+	return neg_ctx->local_hash;
+}
+
+static void _reg_cache_free_entry(neg_ctx_t *neg_ctx, neg_cache_entry_t *entry) {
+	HASH_DEL(neg_ctx->cache, entry);
+	free(entry->id);
+	free(entry->response);
+	free(entry->data);
+	free(entry);
+}
+
+/**
+ * @param neg_ctx
+ * @param id
+ * @return The cached entry or NULL when there is none or it has expired
+ * @brief
+ */
+neg_cache_entry_t *reg_cache_find(neg_ctx_t *neg_ctx, const char *id) {
+	neg_cache_entry_t *entry;
+
+	if (neg_ctx->cache_ttl <= 0)
+		return NULL;
+	HASH_FIND_STR(neg_ctx->cache, id, entry);
+	if (entry != NULL && entry->expires <= time(NULL)) {
+		_reg_cache_free_entry(neg_ctx, entry);
+		entry = NULL;
+	}
+	return entry;
+}
+
+/**
+ * @param neg_ctx
+ * @param id
+ * @param response Negotiated capability document or NULL, is copied
+ * @param data Binary encoded capabilities or NULL, is copied
+ * @param size Size of data
+ * @return The new entry or NULL when caching is disabled
+ * @brief Adds or replaces a cache entry which expires after neg_ctx->cache_ttl seconds
+ */
+neg_cache_entry_t *reg_cache_add(neg_ctx_t *neg_ctx, const char *id, const char *response, const unsigned char *data, size_t size) {
+	neg_cache_entry_t *entry, *tmp;
+	time_t now = time(NULL);
+
+	if (neg_ctx->cache_ttl <= 0)
+		return NULL;
+
+	HASH_FIND_STR(neg_ctx->cache, id, entry);
+	if (entry != NULL)
+		_reg_cache_free_entry(neg_ctx, entry);
+
+	if (HASH_COUNT(neg_ctx->cache) >= NEG_CACHE_MAX_ENTRIES) {
+		HASH_ITER(hh, neg_ctx->cache, entry, tmp) {
+			if (entry->expires <= now)
+				_reg_cache_free_entry(neg_ctx, entry);
+		}
+		/* Entries are iterated in insertion order, drop the oldest ones */
+		while (HASH_COUNT(neg_ctx->cache) >= NEG_CACHE_MAX_ENTRIES)
+			_reg_cache_free_entry(neg_ctx, neg_ctx->cache);
+	}
+
+	entry = malloc(sizeof (*entry));
+	entry->id = strdup(id);
+	entry->response = response ? strdup(response) : NULL;
+	entry->data = NULL;
+	entry->size = 0;
+	if (data != NULL && size != 0) {
+		entry->data = malloc(size);
+		memcpy(entry->data, data, size);
+		entry->size = size;
+	}
+	entry->expires = now + neg_ctx->cache_ttl;
+	HASH_ADD_KEYPTR(hh, neg_ctx->cache, entry->id, strlen(entry->id), entry);
+	return entry;
+}
+
+/**
+ * @param neg_ctx
+ * @brief Removes all cached negotiation results
+ */
+void reg_cache_clear(neg_ctx_t *neg_ctx) {
+	neg_cache_entry_t *entry, *tmp;
+	HASH_ITER(hh, neg_ctx->cache, entry, tmp) {
+		_reg_cache_free_entry(neg_ctx, entry);
+	}
+}
@@ -40,6 +40,35 @@ extern "C" {
 	char* reg_get_local_capability_json(neg_ctx_t* neg_ctx);
 	char* _reg_get_local_capability_json(neg_dict_t *hash, json_t *root);
 	int _reg_parse_dict(json_t* value, neg_dict_remote_collection_t* remote_dict, const char* nego_key);
+	int reg_set_remote_capability_data(neg_ctx_t *neg_ctx, const char *endpoint, const char *remote_body, size_t size);
+
+	/*
+	 * Binary encoding of capability sets
+	 *
+	 *   set   := "KNO" version:u8 count:varint entry*
+	 *   entry := shared:varint length:varint suffix value
+	 *   value := precedence:u8 | 0xff length:varint bytes
+	 *
+	 * Entries are sorted by id, every id is stored as the length of the prefix
+	 * shared with the previous id and the remaining suffix. Precedences are
+	 * stored as single byte (see _reg_prec_to_code), other values as strings.
+	 * Unsigned integers are stored as little endian base 128 varints.
+	 */
+#define REG_BINARY_MAGIC "KNO"
+#define REG_BINARY_VERSION 1
+
+	typedef void (*reg_capability_fn)(void *user_data, char *id, char *value);
+
+	size_t reg_encode_capabilities(neg_dict_t *hash, unsigned char **data);
+	int reg_decode_capabilities(const unsigned char *data, size_t size, reg_capability_fn fn, void *user_data);
+	int reg_is_binary_capabilities(const char *data, size_t size);
+	uint64_t reg_hash_data(const void *data, size_t size, uint64_t seed);
+	uint64_t reg_get_local_capability_hash(neg_ctx_t *neg_ctx);
+
+	/* Negotiation result cache */
+	neg_cache_entry_t *reg_cache_find(neg_ctx_t *neg_ctx, const char *id);
+	neg_cache_entry_t *reg_cache_add(neg_ctx_t *neg_ctx, const char *id, const char *response, const unsigned char *data, size_t size);
+	void reg_cache_clear(neg_ctx_t *neg_ctx);
 
 #ifdef	__cplusplus
 }
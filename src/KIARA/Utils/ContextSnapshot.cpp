@@ -0,0 +1,294 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * ContextSnapshot.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#define KIARA_LIB
+#include "ContextSnapshot.hpp"
+#include <KIARA/Utils/MemoryBuffer.hpp>
+#include <KIARA/Common/Version.h>
+#include <KIARA/kiara.h>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+
+namespace KIARA
+{
+
+namespace
+{
+
+const char SNAPSHOT_MAGIC[8] = { 'K', 'I', 'A', 'R', 'A', 'S', 'N', 'P' };
+const uint32_t SNAPSHOT_FORMAT_VERSION = 1;
+
+// All integers are stored in little endian byte order
+
+void writeU32(std::ostream &out, uint32_t value)
+{
+    char buf[4];
+    for (int i = 0; i < 4; ++i)
+        buf[i] = static_cast<char>((value >> (i * 8)) & 0xFF);
+    out.write(buf, sizeof(buf));
+}
+
+void writeU64(std::ostream &out, uint64_t value)
+{
+    char buf[8];
+    for (int i = 0; i < 8; ++i)
+        buf[i] = static_cast<char>((value >> (i * 8)) & 0xFF);
+    out.write(buf, sizeof(buf));
+}
+
+void writeString(std::ostream &out, const std::string &str)
+{
+    writeU64(out, str.size());
+    out.write(str.data(), str.size());
+}
+
+class Reader
+{
+public:
+
+    Reader(const char *begin, const char *end) : cur_(begin), end_(end) { }
+
+    bool readBytes(void *dest, size_t size)
+    {
+        if (static_cast<size_t>(end_ - cur_) < size)
+            return false;
+        memcpy(dest, cur_, size);
+        cur_ += size;
+        return true;
+    }
+
+    bool readU32(uint32_t &value)
+    {
+        unsigned char buf[4];
+        if (!readBytes(buf, sizeof(buf)))
+            return false;
+        value = 0;
+        for (int i = 3; i >= 0; --i)
+            value = (value << 8) | buf[i];
+        return true;
+    }
+
+    bool readU64(uint64_t &value)
+    {
+        unsigned char buf[8];
+        if (!readBytes(buf, sizeof(buf)))
+            return false;
+        value = 0;
+        for (int i = 7; i >= 0; --i)
+            value = (value << 8) | buf[i];
+        return true;
+    }
+
+    bool readString(std::string &str)
+    {
+        uint64_t size;
+        if (!readU64(size) || static_cast<uint64_t>(end_ - cur_) < size)
+            return false;
+        str.assign(cur_, static_cast<size_t>(size));
+        cur_ += size;
+        return true;
+    }
+
+    /// Reads element count, each element occupies at least minElementSize bytes
+    bool readCount(uint32_t &count, size_t minElementSize)
+    {
+        return readU32(count) && static_cast<uint64_t>(count) * minElementSize <= static_cast<uint64_t>(end_ - cur_);
+    }
+
+private:
+    const char *cur_;
+    const char *end_;
+};
+
+} // unnamed namespace
+
+void ContextSnapshot::clear()
+{
+    libraryVersion.clear();
+    idls.clear();
+    llvmModuleNames.clear();
+    serverConfigurations.clear();
+    runtimeCacheFiles.clear();
+}
+
+std::string ContextSnapshot::getLibraryVersion()
+{
+    return boost::lexical_cast<std::string>(KIARA_VERSION) + "-" + kiaraGetRepositoryRevision();
+}
+
+bool ContextSnapshot::write(const std::string &fileName, std::string *errorMsg) const
+{
+    // Write to a temporary file first, so that concurrently starting
+    // processes never see a partially written snapshot.
+    std::ostringstream tmpPath;
+    tmpPath << fileName << ".tmp" << boost::filesystem::unique_path().string();
+
+    {
+        std::ofstream out(tmpPath.str().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            if (errorMsg)
+                *errorMsg = "Could not open file '" + tmpPath.str() + "' for writing";
+            return false;
+        }
+
+        out.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        writeU32(out, SNAPSHOT_FORMAT_VERSION);
+        writeString(out, libraryVersion);
+
+        writeU32(out, static_cast<uint32_t>(idls.size()));
+        for (std::vector<IDLEntry>::const_iterator it = idls.begin(), end = idls.end(); it != end; ++it)
+        {
+            writeString(out, it->fileName);
+            writeString(out, it->contents);
+        }
+
+        writeU32(out, static_cast<uint32_t>(llvmModuleNames.size()));
+        for (std::vector<std::string>::const_iterator it = llvmModuleNames.begin(),
+            end = llvmModuleNames.end(); it != end; ++it)
+        {
+            writeString(out, *it);
+        }
+
+        writeU32(out, static_cast<uint32_t>(serverConfigurations.size()));
+        for (std::vector<ServerConfigurationEntry>::const_iterator it = serverConfigurations.begin(),
+            end = serverConfigurations.end(); it != end; ++it)
+        {
+            writeString(out, it->uri);
+            writeString(out, it->etag);
+            writeU64(out, it->contentHash);
+            writeString(out, it->json);
+        }
+
+        writeU32(out, static_cast<uint32_t>(runtimeCacheFiles.size()));
+        for (std::vector<FileEntry>::const_iterator it = runtimeCacheFiles.begin(),
+            end = runtimeCacheFiles.end(); it != end; ++it)
+        {
+            writeString(out, it->fileName);
+            writeString(out, it->contents);
+        }
+
+        out.flush();
+        if (!out)
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove(tmpPath.str(), ec);
+            if (errorMsg)
+                *errorMsg = "Could not write file '" + tmpPath.str() + "'";
+            return false;
+        }
+    }
+
+    boost::system::error_code ec;
+    boost::filesystem::rename(tmpPath.str(), fileName, ec);
+    if (ec)
+    {
+        boost::filesystem::remove(tmpPath.str(), ec);
+        if (errorMsg)
+            *errorMsg = "Could not rename snapshot file to '" + fileName + "'";
+        return false;
+    }
+    return true;
+}
+
+bool ContextSnapshot::read(const std::string &fileName, std::string *errorMsg)
+{
+    clear();
+
+    MemoryBuffer buffer;
+    if (!buffer.open(fileName, errorMsg))
+        return false;
+
+    Reader reader(buffer.begin(), buffer.end());
+
+    char magic[sizeof(SNAPSHOT_MAGIC)];
+    uint32_t formatVersion = 0;
+    if (!reader.readBytes(magic, sizeof(magic)) ||
+        memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0 ||
+        !reader.readU32(formatVersion))
+    {
+        if (errorMsg)
+            *errorMsg = "File '" + fileName + "' is not a KIARA context snapshot";
+        return false;
+    }
+
+    if (formatVersion != SNAPSHOT_FORMAT_VERSION)
+    {
+        if (errorMsg)
+            *errorMsg = "Unsupported snapshot format version " + boost::lexical_cast<std::string>(formatVersion);
+        return false;
+    }
+
+    bool ok = reader.readString(libraryVersion);
+
+    uint32_t count = 0;
+    if (ok && (ok = reader.readCount(count, 16)))
+    {
+        idls.resize(count);
+        for (uint32_t i = 0; ok && i < count; ++i)
+            ok = reader.readString(idls[i].fileName) && reader.readString(idls[i].contents);
+    }
+
+    if (ok && (ok = reader.readCount(count, 8)))
+    {
+        llvmModuleNames.resize(count);
+        for (uint32_t i = 0; ok && i < count; ++i)
+            ok = reader.readString(llvmModuleNames[i]);
+    }
+
+    if (ok && (ok = reader.readCount(count, 32)))
+    {
+        serverConfigurations.resize(count);
+        for (uint32_t i = 0; ok && i < count; ++i)
+        {
+            ServerConfigurationEntry &entry = serverConfigurations[i];
+            ok = reader.readString(entry.uri) &&
+                reader.readString(entry.etag) &&
+                reader.readU64(entry.contentHash) &&
+                reader.readString(entry.json);
+        }
+    }
+
+    if (ok && (ok = reader.readCount(count, 16)))
+    {
+        runtimeCacheFiles.resize(count);
+        for (uint32_t i = 0; ok && i < count; ++i)
+            ok = reader.readString(runtimeCacheFiles[i].fileName) && reader.readString(runtimeCacheFiles[i].contents);
+    }
+
+    if (!ok)
+    {
+        clear();
+        if (errorMsg)
+            *errorMsg = "Snapshot file '" + fileName + "' is truncated or corrupted";
+        return false;
+    }
+    return true;
+}
+
+} // namespace KIARA
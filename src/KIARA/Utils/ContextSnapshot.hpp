@@ -0,0 +1,98 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * ContextSnapshot.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef KIARA_UTILS_CONTEXTSNAPSHOT_HPP_INCLUDED
+#define KIARA_UTILS_CONTEXTSNAPSHOT_HPP_INCLUDED
+
+#include <KIARA/Common/Config.hpp>
+#include <KIARA/Common/stdint.h>
+#include <string>
+#include <vector>
+
+namespace KIARA
+{
+
+/// Post-initialization state of a context, stored in a binary file.
+///
+/// The snapshot contains the inputs of the context type database (IDL texts
+/// in load order and LLVM module names), cached server configurations and
+/// the compiled runtime modules from the runtime cache. Restoring a context
+/// re-registers the IDL types and puts the bitcode back into the runtime
+/// cache, so connections skip KL code generation and optimization.
+class KIARA_API ContextSnapshot
+{
+public:
+
+    struct IDLEntry
+    {
+        std::string fileName;
+        std::string contents;
+
+        IDLEntry() : fileName(), contents() { }
+        IDLEntry(const std::string &fileName, const std::string &contents)
+            : fileName(fileName), contents(contents)
+        { }
+    };
+
+    struct ServerConfigurationEntry
+    {
+        std::string uri;
+        std::string etag;
+        uint64_t contentHash;
+        std::string json;       // ServerConfiguration::toJSON() text
+
+        ServerConfigurationEntry() : uri(), etag(), contentHash(0), json() { }
+    };
+
+    struct FileEntry
+    {
+        std::string fileName;   // file name without directory
+        std::string contents;
+
+        FileEntry() : fileName(), contents() { }
+        FileEntry(const std::string &fileName, const std::string &contents)
+            : fileName(fileName), contents(contents)
+        { }
+    };
+
+    std::string libraryVersion; // snapshots are only valid for the same library build
+    std::vector<IDLEntry> idls;
+    std::vector<std::string> llvmModuleNames;
+    std::vector<ServerConfigurationEntry> serverConfigurations;
+    std::vector<FileEntry> runtimeCacheFiles;
+
+    void clear();
+
+    bool write(const std::string &fileName, std::string *errorMsg = 0) const;
+
+    bool read(const std::string &fileName, std::string *errorMsg = 0);
+
+    /// Returns version string of the running library
+    static std::string getLibraryVersion();
+};
+
+} // namespace KIARA
+
+#endif /* KIARA_UTILS_CONTEXTSNAPSHOT_HPP_INCLUDED */
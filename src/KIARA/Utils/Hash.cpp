@@ -0,0 +1,67 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * Hash.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#define KIARA_LIB
+#include <KIARA/Utils/Hash.hpp>
+
+namespace KIARA
+{
+
+ContentHash & ContentHash::update(const void *data, size_t size)
+{
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    const unsigned char *end = p + size;
+    uint64_t h = hash_;
+    for (; p != end; ++p)
+    {
+        h ^= *p;
+        h *= PRIME;
+    }
+    hash_ = h;
+    return *this;
+}
+
+ContentHash & ContentHash::update(uint64_t value)
+{
+    unsigned char bytes[8];
+    for (int i = 0; i < 8; ++i)
+        bytes[i] = static_cast<unsigned char>(value >> (i * 8));
+    return update(bytes, sizeof(bytes));
+}
+
+std::string ContentHash::toHexString() const
+{
+    static const char digits[] = "0123456789abcdef";
+    std::string result(16, '0');
+    uint64_t h = hash_;
+    for (int i = 15; i >= 0; --i)
+    {
+        result[i] = digits[h & 0xF];
+        h >>= 4;
+    }
+    return result;
+}
+
+} // namespace KIARA
@@ -0,0 +1,81 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * Hash.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef KIARA_UTILS_HASH_HPP_INCLUDED
+#define KIARA_UTILS_HASH_HPP_INCLUDED
+
+#include <KIARA/Common/Config.hpp>
+#include <KIARA/Common/stdint.h>
+#include <string>
+#include <cstddef>
+
+namespace KIARA
+{
+
+/// Incremental 64-bit FNV-1a hash. Unlike boost::hash the result is stable
+/// across processes and platforms, so it can be used as a persistent
+/// content key (e.g. for on-disk caches or ETags).
+class KIARA_API ContentHash
+{
+public:
+
+    ContentHash() : hash_(OFFSET_BASIS) { }
+
+    void clear() { hash_ = OFFSET_BASIS; }
+
+    ContentHash & update(const void *data, size_t size);
+
+    ContentHash & update(const std::string &str)
+    {
+        return update(str.data(), str.size());
+    }
+
+    ContentHash & update(uint64_t value);
+
+    uint64_t getValue() const { return hash_; }
+
+    /// Returns hash value as 16 lowercase hexadecimal digits
+    std::string toHexString() const;
+
+    static uint64_t hash(const void *data, size_t size)
+    {
+        return ContentHash().update(data, size).getValue();
+    }
+
+    static uint64_t hash(const std::string &str)
+    {
+        return ContentHash().update(str).getValue();
+    }
+
+private:
+    static const uint64_t OFFSET_BASIS = 14695981039346656037ULL;
+    static const uint64_t PRIME = 1099511628211ULL;
+
+    uint64_t hash_;
+};
+
+} // namespace KIARA
+
+#endif /* KIARA_UTILS_HASH_HPP_INCLUDED */
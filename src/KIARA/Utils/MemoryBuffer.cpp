@@ -0,0 +1,126 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * MemoryBuffer.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+#define KIARA_LIB
+#include "MemoryBuffer.hpp"
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cerrno>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace KIARA
+{
+
+MemoryBuffer::MemoryBuffer()
+    : data_("")
+    , size_(0)
+    , mapped_(false)
+    , contents_()
+{
+}
+
+MemoryBuffer::~MemoryBuffer()
+{
+    close();
+}
+
+bool MemoryBuffer::open(const std::string &fileName, std::string *errorMsg)
+{
+    close();
+
+#ifndef _WIN32
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        if (errorMsg)
+            *errorMsg = "Could not open file "+fileName+": "+std::strerror(errno);
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        void *addr = ::mmap(0, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED)
+        {
+            ::close(fd);
+            data_ = static_cast<const char *>(addr);
+            size_ = static_cast<size_t>(st.st_size);
+            mapped_ = true;
+            return true;
+        }
+    }
+    ::close(fd);
+#endif
+
+    // empty files, pipes and platforms without mmap are read into memory
+    std::ifstream in(fileName.c_str(), std::ios::in | std::ios::binary);
+    if (!in)
+    {
+        if (errorMsg)
+            *errorMsg = "Could not open file "+fileName;
+        return false;
+    }
+    return read(in, errorMsg);
+}
+
+bool MemoryBuffer::read(std::istream &in, std::string *errorMsg)
+{
+    close();
+
+    std::ostringstream oss;
+    oss << in.rdbuf();
+    if (in.bad())
+    {
+        if (errorMsg)
+            *errorMsg = "Could not read input stream";
+        return false;
+    }
+    contents_ = oss.str();
+    data_ = contents_.c_str();
+    size_ = contents_.size();
+    return true;
+}
+
+void MemoryBuffer::close()
+{
+#ifndef _WIN32
+    if (mapped_)
+        ::munmap(const_cast<char *>(data_), size_);
+#endif
+    data_ = "";
+    size_ = 0;
+    mapped_ = false;
+    contents_.clear();
+}
+
+} // namespace KIARA
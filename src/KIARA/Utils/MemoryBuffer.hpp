@@ -0,0 +1,71 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * MemoryBuffer.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef KIARA_UTILS_MEMORYBUFFER_HPP_INCLUDED
+#define KIARA_UTILS_MEMORYBUFFER_HPP_INCLUDED
+
+#include <KIARA/Common/Config.hpp>
+#include <string>
+#include <iostream>
+
+namespace KIARA
+{
+
+/// Read-only contiguous contents of a file, memory mapped when possible
+class KIARA_API MemoryBuffer
+{
+public:
+
+    MemoryBuffer();
+
+    ~MemoryBuffer();
+
+    bool open(const std::string &fileName, std::string *errorMsg = 0);
+
+    /// Reads the stream until end of file
+    bool read(std::istream &in, std::string *errorMsg = 0);
+
+    void close();
+
+    bool isMapped() const { return mapped_; }
+
+    const char * begin() const { return data_; }
+    const char * end() const { return data_ + size_; }
+
+    size_t size() const { return size_; }
+
+private:
+    MemoryBuffer(const MemoryBuffer &);
+    MemoryBuffer & operator=(const MemoryBuffer &);
+
+    const char *data_;
+    size_t size_;
+    bool mapped_;
+    std::string contents_; // used when the file is not mapped
+};
+
+} // namespace KIARA
+
+#endif /* KIARA_UTILS_MEMORYBUFFER_HPP_INCLUDED */
@@ -0,0 +1,344 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * PublishedMap.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef KIARA_UTILS_PUBLISHEDMAP_HPP_INCLUDED
+#define KIARA_UTILS_PUBLISHEDMAP_HPP_INCLUDED
+
+#include <boost/atomic.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/thread/thread.hpp>
+#include <vector>
+
+namespace KIARA
+{
+
+/** Hash map that can be read by multiple threads without any locking.
+ *
+ *  Entries are immutable after they were published. insert() and erase()
+ *  publish a copy of the part of the bucket chain that precedes the replaced
+ *  or erased entry, when the bucket table grows all entries are copied into
+ *  the new table. Superseded entries and tables are freed as soon as all
+ *  readers that could still see them left find(), so values of erased
+ *  or replaced keys are released by the writer.
+ *
+ *  Writers (insert, erase, clear) must be serialized by the caller and
+ *  wait for concurrent readers, which never block. clear() and iteration
+ *  must not run concurrently with readers.
+ */
+template <class K, class V, class Hash = boost::hash<K> >
+class PublishedMap : private boost::noncopyable
+{
+public:
+
+    struct Entry
+    {
+        const K key;
+        const V value;
+        Entry *next;    // next entry in the same bucket
+
+        Entry(const K &key, const V &value, Entry *next)
+            : key(key), value(value), next(next)
+        { }
+    };
+
+private:
+
+    struct Table : private boost::noncopyable
+    {
+        size_t mask;
+        boost::scoped_array<boost::atomic<Entry *> > buckets;
+
+        explicit Table(size_t numBuckets)
+            : mask(numBuckets - 1)
+            , buckets(new boost::atomic<Entry *>[numBuckets])
+        {
+            for (size_t i = 0; i < numBuckets; ++i)
+                buckets[i].store(0, boost::memory_order_relaxed);
+        }
+
+        boost::atomic<Entry *> & bucket(size_t hash) const { return buckets[hash & mask]; }
+    };
+
+public:
+
+    /// Iterates over visible entries, must not be used concurrently with writers
+    class const_iterator
+    {
+    public:
+
+        const_iterator() : table_(0), index_(0), entry_(0) { }
+
+        const Entry & operator*() const { return *entry_; }
+        const Entry * operator->() const { return entry_; }
+
+        const_iterator & operator++()
+        {
+            entry_ = entry_->next;
+            skipEmptyBuckets();
+            return *this;
+        }
+
+        bool operator==(const const_iterator &other) const { return entry_ == other.entry_; }
+        bool operator!=(const const_iterator &other) const { return entry_ != other.entry_; }
+
+    private:
+        friend class PublishedMap;
+
+        const Table *table_;
+        size_t index_;
+        const Entry *entry_;
+
+        explicit const_iterator(const Table *table)
+            : table_(table), index_(0), entry_(0)
+        {
+            skipEmptyBuckets();
+        }
+
+        void skipEmptyBuckets()
+        {
+            while (!entry_ && table_ && index_ <= table_->mask)
+                entry_ = table_->buckets[index_++].load(boost::memory_order_relaxed);
+        }
+    };
+
+    PublishedMap()
+        : table_(0)
+        , size_(0)
+        , epoch_(0)
+    {
+        readers_[0].store(0, boost::memory_order_relaxed);
+        readers_[1].store(0, boost::memory_order_relaxed);
+    }
+
+    ~PublishedMap()
+    {
+        clear();
+    }
+
+    size_t size() const { return size_; }
+
+    bool empty() const { return size_ == 0; }
+
+    const_iterator begin() const { return const_iterator(table_.load(boost::memory_order_relaxed)); }
+    const_iterator end() const { return const_iterator(); }
+
+    /// Returns copy of the value of the key or a default constructed value,
+    /// can be called concurrently with writers
+    V find(const K &key) const
+    {
+        ReadSection section(*this);
+        const Entry *entry = findEntry(table_.load(boost::memory_order_acquire), key);
+        return entry ? entry->value : V();
+    }
+
+    /// Can be called concurrently with writers
+    bool contains(const K &key) const
+    {
+        ReadSection section(*this);
+        return findEntry(table_.load(boost::memory_order_acquire), key) != 0;
+    }
+
+    /// Inserts the key or replaces its value
+    void insert(const K &key, const V &value)
+    {
+        Table *table = table_.load(boost::memory_order_relaxed);
+        if (!table || size_ > table->mask)
+            table = grow(table);
+
+        boost::atomic<Entry *> &bucket = table->bucket(Hash()(key));
+        std::vector<Entry *> retired;
+        Entry *rest = unlinkEntry(bucket.load(boost::memory_order_relaxed), key, retired);
+        if (retired.empty())
+            ++size_;
+        bucket.store(new Entry(key, value, rest), boost::memory_order_release);
+        reclaim(retired, 0);
+    }
+
+    bool erase(const K &key)
+    {
+        Table *table = table_.load(boost::memory_order_relaxed);
+        if (!table)
+            return false;
+
+        boost::atomic<Entry *> &bucket = table->bucket(Hash()(key));
+        std::vector<Entry *> retired;
+        Entry *rest = unlinkEntry(bucket.load(boost::memory_order_relaxed), key, retired);
+        if (retired.empty())
+            return false;
+        --size_;
+        bucket.store(rest, boost::memory_order_release);
+        reclaim(retired, 0);
+        return true;
+    }
+
+    void clear()
+    {
+        Table *table = table_.exchange(0, boost::memory_order_acq_rel);
+        if (table)
+        {
+            for (size_t i = 0; i <= table->mask; ++i)
+                deleteChain(table->buckets[i].load(boost::memory_order_relaxed));
+            delete table;
+        }
+        size_ = 0;
+    }
+
+private:
+
+    /// Registers a reader in the current epoch, see synchronize()
+    class ReadSection : private boost::noncopyable
+    {
+    public:
+
+        explicit ReadSection(const PublishedMap &map)
+            : readers_(0)
+        {
+            for (;;)
+            {
+                const unsigned int epoch = map.epoch_.load(boost::memory_order_seq_cst);
+                boost::atomic<size_t> &readers = map.readers_[epoch & 1];
+                readers.fetch_add(1, boost::memory_order_seq_cst);
+                // a writer that flipped the epoch in between may not wait for us
+                if (map.epoch_.load(boost::memory_order_seq_cst) == epoch)
+                {
+                    readers_ = &readers;
+                    break;
+                }
+                readers.fetch_sub(1, boost::memory_order_release);
+            }
+        }
+
+        ~ReadSection()
+        {
+            readers_->fetch_sub(1, boost::memory_order_release);
+        }
+
+    private:
+        boost::atomic<size_t> *readers_;
+    };
+
+    enum { MIN_BUCKETS = 16 };
+
+    boost::atomic<Table *> table_;
+    size_t size_;
+    mutable boost::atomic<unsigned int> epoch_;
+    mutable boost::atomic<size_t> readers_[2];
+
+    static const Entry * findEntry(const Table *table, const K &key)
+    {
+        if (!table)
+            return 0;
+        for (const Entry *entry = table->bucket(Hash()(key)).load(boost::memory_order_acquire);
+                entry != 0; entry = entry->next)
+        {
+            if (entry->key == key)
+                return entry;
+        }
+        return 0;
+    }
+
+    /// Returns the chain without the entry of the key, entries preceding it are
+    /// copied. Replaced entries are appended to retired.
+    static Entry * unlinkEntry(Entry *head, const K &key, std::vector<Entry *> &retired)
+    {
+        Entry *found = head;
+        while (found && !(found->key == key))
+            found = found->next;
+        if (!found)
+            return head;
+
+        for (Entry *entry = head; entry != found; entry = entry->next)
+            retired.push_back(entry);
+        Entry *rest = found->next;
+        for (typename std::vector<Entry *>::reverse_iterator it = retired.rbegin(),
+                end = retired.rend(); it != end; ++it)
+            rest = new Entry((*it)->key, (*it)->value, rest);
+        retired.push_back(found);
+        return rest;
+    }
+
+    Table * grow(Table *table)
+    {
+        // copy all entries into a larger table before it is published
+        Table *newTable = new Table(table ? (table->mask + 1) * 2 : MIN_BUCKETS);
+        std::vector<Entry *> retired;
+        if (table)
+        {
+            retired.reserve(size_);
+            for (size_t i = 0; i <= table->mask; ++i)
+            {
+                for (Entry *entry = table->buckets[i].load(boost::memory_order_relaxed);
+                        entry != 0; entry = entry->next)
+                {
+                    boost::atomic<Entry *> &bucket = newTable->bucket(Hash()(entry->key));
+                    bucket.store(new Entry(entry->key, entry->value,
+                                           bucket.load(boost::memory_order_relaxed)),
+                                 boost::memory_order_relaxed);
+                    retired.push_back(entry);
+                }
+            }
+        }
+        table_.store(newTable, boost::memory_order_release);
+        reclaim(retired, table);
+        return newTable;
+    }
+
+    /// Frees unpublished entries and table after all readers that could see them left
+    void reclaim(std::vector<Entry *> &retired, Table *table)
+    {
+        if (retired.empty() && !table)
+            return;
+        synchronize();
+        for (typename std::vector<Entry *>::iterator it = retired.begin(),
+                end = retired.end(); it != end; ++it)
+            delete *it;
+        delete table;
+    }
+
+    /// Waits until all readers that started before the call left find().
+    /// Readers register in the current epoch, new readers use the flipped one.
+    void synchronize()
+    {
+        const unsigned int epoch = epoch_.fetch_add(1, boost::memory_order_seq_cst);
+        while (readers_[epoch & 1].load(boost::memory_order_seq_cst) != 0)
+            boost::this_thread::yield();
+    }
+
+    static void deleteChain(Entry *entry)
+    {
+        while (entry)
+        {
+            Entry *next = entry->next;
+            delete entry;
+            entry = next;
+        }
+    }
+};
+
+} // namespace KIARA
+
+#endif /* KIARA_UTILS_PUBLISHEDMAP_HPP_INCLUDED */
@@ -36,6 +36,7 @@ void ServerConfiguration::clear()
     info.clear();
     idlURL.clear();
     idlContents.clear();
+    idlHash.clear();
     servers.clear();
 }
 
@@ -193,6 +194,7 @@ inline bool extractFromJSON(json_t *object, ServerConfiguration &dest)
     extractFromJSON(json_object_get(object, "info"), dest.info);
     extractFromJSON(json_object_get(object, "idlURL"), dest.idlURL);
     extractFromJSON(json_object_get(object, "idlContents"), dest.idlContents);
+    extractFromJSON(json_object_get(object, "idlHash"), dest.idlHash);
     extractFromJSON(json_object_get(object, "servers"), dest.servers);
 
     return true;
@@ -208,6 +210,8 @@ inline json_t * convertToJSON(const ServerConfiguration &src)
         json_object_set_new(object, "idlURL", convertToJSON(src.idlURL));
     if (!src.idlContents.empty())
         json_object_set_new(object, "idlContents", convertToJSON(src.idlContents));
+    if (!src.idlHash.empty())
+        json_object_set_new(object, "idlHash", convertToJSON(src.idlHash));
     json_object_set_new(object, "servers", convertToJSON(src.servers));
     return object;
 }
@@ -78,6 +78,7 @@ public:
     std::string info;
     std::string idlURL;
     std::string idlContents;
+    std::string idlHash; // ContentHash of the IDL text, optional
     std::vector<ServerInfo> servers;
 
     void clear();
@@ -0,0 +1,112 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * SharedLibrary.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+#define KIARA_LIB
+#include "SharedLibrary.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace KIARA
+{
+
+SharedLibrary::SharedLibrary()
+    : handle_(0)
+    , path_()
+{
+}
+
+SharedLibrary::~SharedLibrary()
+{
+    close();
+}
+
+std::string SharedLibrary::getPlatformFileName(const std::string &name)
+{
+#if defined(_WIN32)
+    return name + ".dll";
+#elif defined(__APPLE__)
+    return "lib" + name + ".dylib";
+#else
+    return "lib" + name + ".so";
+#endif
+}
+
+bool SharedLibrary::load(const std::string &path, std::string *errorMsg)
+{
+    close();
+
+#ifdef _WIN32
+    handle_ = (void*)::LoadLibraryA(path.c_str());
+    if (!handle_)
+    {
+        if (errorMsg)
+            *errorMsg = "Could not load library " + path;
+        return false;
+    }
+#else
+    handle_ = ::dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle_)
+    {
+        if (errorMsg)
+        {
+            const char *msg = ::dlerror();
+            *errorMsg = msg ? msg : ("Could not load library " + path);
+        }
+        return false;
+    }
+#endif
+
+    path_ = path;
+    return true;
+}
+
+void SharedLibrary::close()
+{
+    if (!handle_)
+        return;
+#ifdef _WIN32
+    ::FreeLibrary((HMODULE)handle_);
+#else
+    ::dlclose(handle_);
+#endif
+    handle_ = 0;
+    path_.clear();
+}
+
+void * SharedLibrary::getSymbol(const std::string &symbolName) const
+{
+    if (!handle_)
+        return 0;
+#ifdef _WIN32
+    return (void*)::GetProcAddress((HMODULE)handle_, symbolName.c_str());
+#else
+    return ::dlsym(handle_, symbolName.c_str());
+#endif
+}
+
+} // namespace KIARA
@@ -0,0 +1,68 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * SharedLibrary.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef KIARA_UTILS_SHAREDLIBRARY_HPP_INCLUDED
+#define KIARA_UTILS_SHAREDLIBRARY_HPP_INCLUDED
+
+#include <KIARA/Common/Config.hpp>
+#include <string>
+
+namespace KIARA
+{
+
+/// Dynamically loaded shared library (dlopen / LoadLibrary)
+class KIARA_API SharedLibrary
+{
+public:
+
+    SharedLibrary();
+
+    ~SharedLibrary();
+
+    /// Returns platform specific file name of the library,
+    /// e.g. libfoo.so, libfoo.dylib or foo.dll for name "foo".
+    static std::string getPlatformFileName(const std::string &name);
+
+    bool load(const std::string &path, std::string *errorMsg = 0);
+
+    void close();
+
+    bool isLoaded() const { return handle_ != 0; }
+
+    const std::string & getPath() const { return path_; }
+
+    void * getSymbol(const std::string &symbolName) const;
+
+private:
+    SharedLibrary(const SharedLibrary &);
+    SharedLibrary & operator=(const SharedLibrary &);
+
+    void *handle_;
+    std::string path_;
+};
+
+} // namespace KIARA
+
+#endif /* KIARA_UTILS_SHAREDLIBRARY_HPP_INCLUDED */
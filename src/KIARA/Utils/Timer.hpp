@@ -0,0 +1,64 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * Timer.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef KIARA_UTILS_TIMER_HPP_INCLUDED
+#define KIARA_UTILS_TIMER_HPP_INCLUDED
+
+#include <KIARA/Common/Config.hpp>
+
+namespace KIARA
+{
+
+/// Measures elapsed wall clock time with a monotonic clock
+class KIARA_API Timer
+{
+public:
+
+    Timer() : startTime_(now()) { }
+
+    void restart() { startTime_ = now(); }
+
+    /// Seconds since construction or last restart
+    double elapsed() const { return now() - startTime_; }
+
+    /// Returns elapsed seconds and restarts the timer
+    double lap()
+    {
+        const double t = now();
+        const double dt = t - startTime_;
+        startTime_ = t;
+        return dt;
+    }
+
+    /// Current time in seconds from an unspecified point in the past
+    static double now();
+
+private:
+    double startTime_;
+};
+
+} // namespace KIARA
+
+#endif /* KIARA_UTILS_TIMER_HPP_INCLUDED */
@@ -32,6 +32,14 @@
 #include <map>
 #include <cctype>
 #include <uriparser/Uri.h>
+#include <cstring>
+
+#if !defined(DFC_WINDOWS)
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <unistd.h>
+#endif
 
 // #define DFC_DO_DEBUG
 #include <DFC/Utils/Debug.hpp>
@@ -374,4 +382,33 @@ bool URL::httpsEqHostAndPort(const std::string &url1, const std::string &url2)
         return false;
 }
 
+// Binding a socket succeeds only for addresses of local interfaces
+bool URL::isLocalHost(const std::string &hostName)
+{
+#if defined(DFC_WINDOWS)
+    return hostName == "localhost" || hostName == "127.0.0.1" || hostName == "::1";
+#else
+    struct addrinfo hints;
+    struct addrinfo *result;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    if (getaddrinfo(hostName.c_str(), 0, &hints, &result) != 0)
+        return false;
+
+    bool local = false;
+    for (struct addrinfo *p = result; p && !local; p = p->ai_next)
+    {
+        int fd = socket(p->ai_family, SOCK_DGRAM, 0);
+        if (fd >= 0)
+        {
+            local = bind(fd, p->ai_addr, p->ai_addrlen) == 0;
+            ::close(fd);
+        }
+    }
+    freeaddrinfo(result);
+    return local;
+#endif
+}
+
 } // namespace KIARA
@@ -118,6 +118,10 @@ public:
         const std::string &url);
 
     static bool httpsEqHostAndPort(const std::string &url1, const std::string &url2);
+
+    // Returns true if hostName resolves to an address of a local interface,
+    // i.e. a server on the host can be reached by ipc and shared memory
+    static bool isLocalHost(const std::string &hostName);
 };
 
 } // namespace KIARA
@@ -130,6 +130,8 @@ typedef struct KIARA_Server KIARA_Server;
 
 typedef struct KIARA_Service KIARA_Service;
 
+typedef struct KIARA_Subscriber KIARA_Subscriber;
+
 typedef uint64_t KIARA_Size;
 
 /** KIARA_Bool is boolean and can have either 0 (KIARA_FALSE) or 1 (KIARA_TRUE) value.
@@ -239,6 +241,26 @@ struct KIARA_ServiceFuncObj {
     KIARA_ServiceFunc func;
 };
 
+/* Memory used by JIT-compiled code */
+typedef struct KIARA_JITStatistics {
+    size_t codeSize;   /* bytes of machine code */
+    size_t dataSize;   /* bytes of data sections */
+    size_t numStages;  /* number of separately freed code units */
+} KIARA_JITStatistics;
+
+/* Compile time breakdown of a single JIT-compiled stub, times are in seconds */
+typedef struct KIARA_JITCompileRecord {
+    const char *name;          /* name of the compiled function */
+    const char *kind;          /* KIARA_FUNC or KIARA_SERVICE */
+    double irgenTime;          /* building IR expressions */
+    double evalTime;           /* translating IR to LLVM IR */
+    double optTime;            /* optimization passes */
+    double linkTime;           /* linking of native functions */
+    double finalizeTime;       /* machine code generation and finalization */
+    size_t codeSize;           /* bytes of machine code emitted for the stub */
+    size_t numLinkedExterns;   /* native functions linked for the stub */
+} KIARA_JITCompileRecord;
+
 /*
  * KIARA Static Declaration Types
  */
@@ -419,6 +441,11 @@ KIARA_API int kiaraInit(int *argcp, char **argv);
  */
 KIARA_API int kiaraFinalize(void);
 
+/** Returns current time in seconds from an unspecified point in the past.
+ *  The clock is monotonic, use it for measuring elapsed time.
+ */
+KIARA_API double kiaraGetTime(void);
+
 /** Allocates and initializes a new KIARA context.
  *  Each thread require its own context.
  *
@@ -426,6 +453,26 @@ KIARA_API int kiaraFinalize(void);
  */
 KIARA_API KIARA_Context * kiaraNewContext(void);
 
+/** Creates a new context from a snapshot written by kiaraSaveContextSnapshot.
+ *  IDL types, LLVM modules and cached server configurations of the saved
+ *  context are restored and its compiled runtime modules are put into the
+ *  runtime cache, so that opening connections skips code generation
+ *  of the KIARA runtime.
+ *  Snapshots are only valid for the KIARA build that created them.
+ *
+ *  @return new context or NULL if the snapshot could not be restored,
+ *          kiaraNewContext can be used as fallback.
+ */
+KIARA_API KIARA_Context * kiaraNewContextFromSnapshot(const char *fileName);
+
+/** Writes the state of an initialized context to a snapshot file.
+ *  Call it after connections were opened, so that their runtime modules
+ *  are included.
+ *
+ *  @return KIARA_SUCCESS if the snapshot was written.
+ */
+KIARA_API KIARA_Result kiaraSaveContextSnapshot(KIARA_Context *context, const char *fileName);
+
 /** Shutdowns context and frees allocated memory.
  *  Fails if there are connections opened.
  *
@@ -433,6 +480,9 @@ KIARA_API KIARA_Context * kiaraNewContext(void);
  */
 KIARA_API int kiaraFreeContext(KIARA_Context *context);
 
+/** Error state of contexts, connections, services and servers is kept
+ *  per thread: error functions report the last failed operation of the
+ *  calling thread, so objects can be used concurrently without locking. */
 KIARA_API const char * kiaraGetContextError(KIARA_Context *context);
 KIARA_API KIARA_Result kiaraGetContextErrorCode(KIARA_Context *context);
 KIARA_API void kiaraClearContextError(KIARA_Context *context);
@@ -515,6 +565,14 @@ KIARA_API KIARA_Type * kiaraGetOrDeclareContextTypeByName(KIARA_Context *ctx, co
 
 KIARA_API KIARA_Result kiaraLoadLLVMModule(KIARA_Context *ctx, const char *name);
 
+/** Get statistics about JIT-compiled code of all connections and services of the context. */
+KIARA_API KIARA_Result kiaraGetContextJITStatistics(KIARA_Context *ctx, KIARA_JITStatistics *stats);
+
+/** Get JIT statistics and compile records of all connections and services of the context as JSON.
+ *  Returned string is valid until the next call or until the context is freed.
+ */
+KIARA_API const char * kiaraGetContextJITTelemetry(KIARA_Context *ctx);
+
 /* Type mapping */
 
 KIARA_API int kiaraMapType(KIARA_Type *abstractType, KIARA_Type *nativeType);
@@ -542,10 +600,10 @@ KIARA_API int kiaraCloseConnection(KIARA_Connection *connection);
 /** Returns name of the error code */
 KIARA_API const char * kiaraGetErrorName(KIARA_Result errorCode);
 
-/** Returns description of the error or NULL if no error occurred. */
+/** Returns description of the error of the calling thread or NULL if no error occurred. */
 KIARA_API const char * kiaraGetConnectionError(KIARA_Connection *connection);
 
-/** Reset error state of a connection */
+/** Reset error state of a connection for the calling thread */
 KIARA_API void kiaraClearConnectionError(KIARA_Connection *connection);
 
 /** Get named type declared in the IDL associated with the open connection.
@@ -572,6 +630,27 @@ KIARA_API KIARA_Context * kiaraGetContext(KIARA_Connection *connection);
 /** Generate synchronous client function object accordingly to the IDL and bound datatypes */
 KIARA_API KIARA_FuncObj * kiaraGenerateClientFuncObj(KIARA_Connection *connection, const char *idlMethodName, KIARA_GetDeclType declTypeGetter, const char *mapping);
 
+/** Destroys function object generated by kiaraGenerateClientFuncObj and frees its compiled code.
+ *  Function objects not freed explicitly are destroyed with their connection.
+ */
+KIARA_API KIARA_Result kiaraFreeFuncObj(KIARA_FuncObj *funcObj);
+
+/** Get statistics about JIT-compiled code of the connection. */
+KIARA_API KIARA_Result kiaraGetConnectionJITStatistics(KIARA_Connection *connection, KIARA_JITStatistics *stats);
+
+/** Get number of functions JIT-compiled for the connection. */
+KIARA_API size_t kiaraGetConnectionNumJITCompileRecords(KIARA_Connection *connection);
+
+/** Get compile time breakdown of the function with specified index.
+ *  Strings in the record are valid as long as the connection exists.
+ */
+KIARA_API KIARA_Result kiaraGetConnectionJITCompileRecord(KIARA_Connection *connection, size_t index, KIARA_JITCompileRecord *record);
+
+/** Get JIT statistics and compile records of the connection as JSON.
+ *  Returned string is valid until the next call or until the connection is freed.
+ */
+KIARA_API const char * kiaraGetConnectionJITTelemetry(KIARA_Connection *connection);
+
 /* Service */
 
 /** Creates new service.
@@ -636,6 +715,49 @@ KIARA_API KIARA_Result kiaraFreeServer(KIARA_Server * server);
 
 KIARA_API KIARA_Result kiaraRunServer(KIARA_Server * server);
 
+/* Publish/Subscribe */
+
+/** Creates publisher bound to the ZeroMQ endpoint url (e.g. "tcp://*:5556").
+ *  Function objects generated for the publisher with kiaraGenerateClientFuncObj
+ *  send their arguments as one-way messages encoded with the protocol to all
+ *  subscribers, results of the IDL methods are not received.
+ *  Publisher is closed with kiaraCloseConnection.
+ *
+ *  Queue limits and conflation are configured with the pubSub section
+ *  of the library configuration.
+ *
+ *  @return new publisher or NULL if publisher could not be created.
+ */
+KIARA_API KIARA_Connection * kiaraNewPublisher(KIARA_Context *context, const char *url, const char *protocol);
+
+/** Load IDL from string describing the published service methods */
+KIARA_API KIARA_Result kiaraLoadPublisherIDLFromString(KIARA_Connection *publisher, const char *idlLanguage, const char *idlContents);
+
+/** Set topic of all messages published after this call, initial topic is empty. */
+KIARA_API KIARA_Result kiaraSetPublisherTopic(KIARA_Connection *publisher, const char *topic);
+
+/** Creates subscriber connected to the publisher at url.
+ *  Only messages whose topic starts with topic are received,
+ *  empty topic receives all messages.
+ *  Received messages are dispatched to the functions registered in the service.
+ *
+ *  @return new subscriber or NULL if subscriber could not be created.
+ */
+KIARA_API KIARA_Subscriber * kiaraSubscribe(KIARA_Context *context, const char *url, const char *protocol, const char *topic, KIARA_Service *service);
+
+/** Returns description of the error or NULL if no error occurred. */
+KIARA_API const char * kiaraGetSubscriberError(KIARA_Subscriber *subscriber);
+
+/** Receives and dispatches messages until kiaraStopSubscriber is called. */
+KIARA_API KIARA_Result kiaraRunSubscriber(KIARA_Subscriber *subscriber);
+
+/** Requests kiaraRunSubscriber to return, can be called from any thread
+ *  and from service functions of the subscriber.
+ */
+KIARA_API void kiaraStopSubscriber(KIARA_Subscriber *subscriber);
+
+KIARA_API KIARA_Result kiaraFreeSubscriber(KIARA_Subscriber *subscriber);
+
 /** Get major version number */
 KIARA_API int kiaraGetVersionMajor(void);
 /** Get minor version number */
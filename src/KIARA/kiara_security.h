@@ -38,9 +38,19 @@ typedef struct KIARA_CipherContext KIARA_CipherContext;
 /** Handle for symmetric key */
 typedef struct KIARA_SymmetricKey KIARA_SymmetricKey;
 
-/** Get cipher by name, use NULL for default cipher */
+/** Name of the cipher used for encrypted IDL types */
+#define KIARA_DEFAULT_AEAD_CIPHER "aes-256-gcm"
+
+/**
+ * Get cipher by name, use NULL for default cipher (aes-256-cbc).
+ * Supported are "aes-256-cbc", "aes-256-gcm" and, with OpenSSL 1.1, "chacha20-poly1305".
+ * Returns NULL for unknown ciphers.
+ */
 KIARA_API const KIARA_Cipher * kiaraGetCipher(const char *name);
 
+/** Returns non-zero when cipher is an AEAD cipher usable with kiaraSealInPlace/kiaraOpenInPlace */
+KIARA_API int kiaraIsAEADCipher(const KIARA_Cipher *cipher);
+
 KIARA_API KIARA_SymmetricKey * kiaraNewSymmetricKey(const KIARA_Cipher *cipher);
 KIARA_API KIARA_Result kiaraFreeSymmetricKey(KIARA_SymmetricKey *key);
 KIARA_API KIARA_Result kiaraInitSymmetricKeyFromText(KIARA_SymmetricKey *key, const char *text);
@@ -56,9 +66,45 @@ KIARA_API KIARA_Result kiaraEncrypt(KIARA_CipherContext *cipherContext, kr_dbuff
 /** Decrypt data provided in the ciphertext buffer and store in the ciphertext buffer */
 KIARA_API KIARA_Result kiaraDecrypt(KIARA_CipherContext *cipherContext, kr_dbuffer_t *plaintext, const kr_dbuffer_t *ciphertext);
 
+/**
+ * Returns the key derived from the text, keys are cached per thread and must not be freed.
+ * The key stays valid until the thread exits or used 16 other keys more recently,
+ * least recently used keys are evicted from the cache and wiped. Returns NULL on failure.
+ */
+KIARA_API const KIARA_SymmetricKey * kiaraGetThreadSymmetricKey(const KIARA_Cipher *cipher, const char *text);
+
+/**
+ * Encrypt buffer contents in place with an AEAD cipher.
+ * Data is split into chunks that are authenticated independently, one tag per chunk,
+ * the chunk size and a random nonce are appended to the ciphertext. The chunk size
+ * and the plaintext size are authenticated with every chunk.
+ * Chunks of large buffers are encrypted in parallel, see kiaraSetCipherThreads.
+ * The cipher context of the calling thread is reused, no cipher context needs to be created.
+ */
+KIARA_API KIARA_Result kiaraSealInPlace(const KIARA_SymmetricKey *key, kr_dbuffer_t *buffer);
+
+/**
+ * Authenticate and decrypt buffer contents created by kiaraSealInPlace in place.
+ * Decryption stops at the first chunk failing authentication, the buffer is then
+ * wiped and its size set to zero.
+ */
+KIARA_API KIARA_Result kiaraOpenInPlace(const KIARA_SymmetricKey *key, kr_dbuffer_t *buffer);
+
+/** Set number of threads used by kiaraSealInPlace/kiaraOpenInPlace, 0 uses one thread per core (default) */
+KIARA_API KIARA_Result kiaraSetCipherThreads(int numThreads);
+
+/** Returns number of threads used by kiaraSealInPlace/kiaraOpenInPlace */
+KIARA_API int kiaraGetCipherThreads(void);
+
+/** Set chunk size used by kiaraSealInPlace (default 256 KiB), kiaraOpenInPlace reads it from the data */
+KIARA_API KIARA_Result kiaraSetCipherChunkSize(size_t chunkSize);
+
 /** Returns secret key by its name */
 KIARA_API const char * kiaraGetSecretKeyText(KIARA_Connection *connection, const char *keyName);
 
+/** Returns the name of the cipher used with the secret key */
+KIARA_API const char * kiaraGetSecretKeyCipherName(KIARA_Connection *connection, const char *keyName);
+
 KIARA_END_EXTERN_C
 
 #endif /* KIARA_SECURITY_H_INCLUDED */
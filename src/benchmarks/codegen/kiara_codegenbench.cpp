@@ -0,0 +1,185 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * kiara_codegenbench.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ *
+ * Measures the type mapping work done by the serializer generator for wide
+ * structures: an IDL struct with many fields is parsed, a native struct with
+ * the same members in reverse order is declared (as done for KIARA_DECL_STRUCT
+ * declarations), and every IDL member is matched to its native member together
+ * with the attribute lookups performed by IRGen::createStructSerializer.
+ *
+ * Usage: kiara_codegenbench [numFields] [numIterations]
+ */
+
+#include <KIARA/Core/LibraryInit.hpp>
+#include <KIARA/DB/World.hpp>
+#include <KIARA/DB/Module.hpp>
+#include <KIARA/DB/DerivedTypes.hpp>
+#include <KIARA/DB/Attributes.hpp>
+#include <KIARA/IDL/IDLParserContext.hpp>
+#include <KIARA/Utils/Timer.hpp>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+
+namespace
+{
+
+std::string generateIDL(int numFields)
+{
+    static const char *types[] = { "i32", "u32", "i64", "float", "double", "string", "boolean" };
+    const int numTypes = sizeof(types) / sizeof(types[0]);
+
+    std::ostringstream out;
+    out << "namespace * codegenbench\n\n";
+    out << "struct Wide {\n";
+    for (int i = 0; i < numFields; ++i)
+        out << "    " << types[i % numTypes] << " field_with_a_long_name_" << i << ";\n";
+    out << "}\n\n";
+    out << "service codegenbench {\n";
+    out << "    Wide echo(Wide arg)\n";
+    out << "}\n";
+    return out.str();
+}
+
+KIARA::StructType::Ptr declareNativeStruct(KIARA::World &world, const KIARA::StructType::Ptr &idlType)
+{
+    const size_t numElements = idlType->getNumElements();
+    KIARA::StructType::Ptr natType = KIARA::StructType::create(world, "NativeWide", numElements);
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        const size_t idlIndex = numElements - i - 1;
+        natType->setElementAt(i, idlType->getElementAt(idlIndex));
+        natType->setElementNameAt(i, idlType->getElementNameAt(idlIndex));
+        KIARA::ElementData &elementData = natType->getElementDataAt(i);
+        elementData.setAttributeValue<KIARA::NativeOffsetAttr>(i * 8);
+        elementData.getOrCreateAttributeValueRef<KIARA::MemberSemanticsAttr>();
+    }
+    return natType;
+}
+
+/// Performs the member lookups of the serializer generator, returns number of matched members
+size_t mapMembers(const KIARA::StructType::Ptr &idlType, const KIARA::StructType::Ptr &natType, bool linearScan)
+{
+    size_t numMatched = 0;
+    for (size_t i = 0, numElems = idlType->getNumElements(); i < numElems; ++i)
+    {
+        const std::string &elemName = idlType->getElementDataAt(i).getName();
+        size_t natElemIndex = KIARA::StructType::npos;
+        if (linearScan)
+        {
+            for (size_t j = 0, numNatElems = natType->getNumElements(); j < numNatElems; ++j)
+            {
+                if (natType->getElementNameAt(j) == elemName)
+                {
+                    natElemIndex = j;
+                    break;
+                }
+            }
+        }
+        else
+            natElemIndex = natType->getElementIndexByName(elemName);
+
+        if (natElemIndex == KIARA::StructType::npos)
+            continue;
+
+        const KIARA::ElementData &natElemData = natType->getElementDataAt(natElemIndex);
+        if (natElemData.hasAttributeValue<KIARA::MainMemberAttr>())
+            continue;
+        if (natElemData.getAttributeValuePtr<KIARA::DependentMembersAttr>())
+            continue;
+        if (natElemData.getAttributeValuePtr<KIARA::MemberSemanticsAttr>())
+            ++numMatched;
+    }
+    return numMatched;
+}
+
+void report(const char *name, double seconds, int numIterations)
+{
+    std::cout << name << ": " << (seconds / numIterations) * 1000000.0 << " us" << std::endl;
+}
+
+} // unnamed namespace
+
+int main(int argc, char **argv)
+{
+    int numFields = 256;
+    int numIterations = 1000;
+
+    if (argc > 1)
+        numFields = atoi(argv[1]);
+    if (argc > 2)
+        numIterations = atoi(argv[2]);
+    if (numFields < 1)
+        numFields = 1;
+    if (numIterations < 1)
+        numIterations = 1;
+
+    KIARA::LibraryInit init;
+    KIARA::World world;
+
+    const std::string idl = generateIDL(numFields);
+    KIARA::Module::Ptr module = new KIARA::Module(world, "codegenbench");
+    {
+        KIARA::IDLParserContext ctx(module, idl.data(), idl.data() + idl.size(), "<bench>");
+        if (!ctx.parse())
+        {
+            std::cerr << "Error: Could not parse generated IDL" << std::endl;
+            return 1;
+        }
+    }
+
+    KIARA::StructType::Ptr idlType = KIARA::dyn_cast<KIARA::StructType>(module->lookupType("Wide"));
+    if (!idlType)
+    {
+        std::cerr << "Error: No struct 'Wide' in generated IDL" << std::endl;
+        return 1;
+    }
+    std::cout << "Struct with " << idlType->getNumElements() << " fields" << std::endl;
+
+    KIARA::StructType::Ptr natType;
+    {
+        KIARA::Timer timer;
+        for (int i = 0; i < numIterations; ++i)
+            natType = declareNativeStruct(world, idlType);
+        report("Declare native struct     ", timer.elapsed(), numIterations);
+    }
+
+    for (int mode = 0; mode < 2; ++mode)
+    {
+        const bool linearScan = (mode == 0);
+        size_t numMatched = 0;
+        KIARA::Timer timer;
+        for (int i = 0; i < numIterations; ++i)
+            numMatched = mapMembers(idlType, natType, linearScan);
+        report(linearScan ? "Map members, linear scan  " : "Map members, name index   ", timer.elapsed(), numIterations);
+        if (numMatched != idlType->getNumElements())
+        {
+            std::cerr << "Error: Matched " << numMatched << " of " << idlType->getNumElements() << " members" << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,306 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * kiara_httpbench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ *
+ * Measures latency and throughput of JSON-RPC calls over the HTTP transport.
+ * A calc server is forked, then
+ *  - one thread performs sequential calls of calc.add (latency),
+ *  - N threads share a single keep-alive connection, their requests
+ *    are pipelined (throughput),
+ *  - N threads use a connection each (throughput).
+ *
+ * Usage: kiara_httpbench [numCalls [numThreads [port]]]
+ */
+
+#include <KIARA/kiara.h>
+#include <KIARA/kiara_macros.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "../kiara/Profiler.h"
+
+KIARA_DECL_PTR(IntPtr, KIARA_INT)
+
+/* Server side */
+
+KIARA_DECL_SERVICE(Calc_Add_Service,
+    KIARA_SERVICE_RESULT(IntPtr, result)
+    KIARA_SERVICE_ARG(KIARA_INT, a)
+    KIARA_SERVICE_ARG(KIARA_INT, b))
+
+KIARA_Result calc_add_impl(KIARA_ServiceFuncObj *kiara_funcobj, int *result, int a, int b)
+{
+    *result = a + b;
+    return KIARA_SUCCESS;
+}
+
+static int runServer(int port)
+{
+    KIARA_Context *ctx;
+    KIARA_Service *service;
+    KIARA_Server *server;
+    KIARA_Result result;
+
+    ctx = kiaraNewContext();
+    service = kiaraNewService(ctx);
+
+    result = kiaraLoadServiceIDLFromString(service,
+        "KIARA",
+        "namespace * calc "
+        "service calc { "
+        "    i32 add(i32 a, i32 b) "
+        "} ");
+    if (result != KIARA_SUCCESS)
+    {
+        fprintf(stderr, "Error: could not parse IDL: %s: %s\n",
+                kiaraGetErrorName(result), kiaraGetServiceError(service));
+        return 1;
+    }
+
+    result = KIARA_REGISTER_SERVICE_FUNC(service, "calc.add", Calc_Add_Service, "", calc_add_impl);
+    if (result != KIARA_SUCCESS)
+    {
+        fprintf(stderr, "Error: registration failed: %s: %s\n",
+                kiaraGetErrorName(result), kiaraGetServiceError(service));
+        return 1;
+    }
+
+    server = kiaraNewServer(ctx, "0.0.0.0", port, "/service");
+
+    /* Relative path: the service is served over HTTP by the server itself */
+    kiaraAddService(server, "/rpc/calc", "jsonrpc", service);
+
+    result = kiaraRunServer(server);
+    if (result != KIARA_SUCCESS)
+    {
+        fprintf(stderr, "Error: could not start server: %s: %s\n",
+                kiaraGetErrorName(result), kiaraGetServerError(server));
+        return 1;
+    }
+
+    kiaraFreeServer(server);
+    kiaraFreeService(service);
+    kiaraFreeContext(ctx);
+    return 0;
+}
+
+/* Client side */
+
+KIARA_DECL_FUNC(Calc_Add,
+  KIARA_FUNC_RESULT(IntPtr, result)
+  KIARA_FUNC_ARG(KIARA_INT, a)
+  KIARA_FUNC_ARG(KIARA_INT, b)
+)
+
+typedef struct ClientThread
+{
+    pthread_t thread;
+    const char *url;
+    KIARA_FUNC_OBJ(Calc_Add) add; /* shared function object or NULL */
+    int numCalls;
+    int failed;
+} ClientThread;
+
+static int callAdd(KIARA_FUNC_OBJ(Calc_Add) add, int numCalls)
+{
+    int i, result = 0;
+
+    for (i = 0; i < numCalls; ++i)
+    {
+        if (KIARA_CALL(add, &result, i, 1) != KIARA_SUCCESS || result != i + 1)
+            return 1;
+    }
+    return 0;
+}
+
+static void * runClient(void *arg)
+{
+    ClientThread *client = (ClientThread*)arg;
+    KIARA_Context *ctx;
+    KIARA_Connection *conn;
+    KIARA_FUNC_OBJ(Calc_Add) add;
+
+    if (client->add)
+    {
+        client->failed = callAdd(client->add, client->numCalls);
+        return NULL;
+    }
+
+    ctx = kiaraNewContext();
+    conn = kiaraOpenConnection(ctx, client->url);
+    if (!conn)
+    {
+        fprintf(stderr, "Error: Could not open connection : %s\n", kiaraGetContextError(ctx));
+        client->failed = 1;
+        kiaraFreeContext(ctx);
+        return NULL;
+    }
+
+    add = KIARA_GENERATE_CLIENT_FUNC(conn, "calc.add", Calc_Add, "");
+    if (!add)
+    {
+        fprintf(stderr, "Error: code generation failed: %s\n", kiaraGetConnectionError(conn));
+        client->failed = 1;
+    }
+    else if (callAdd(add, client->numCalls) != 0)
+    {
+        fprintf(stderr, "Error: call failed: %s\n", kiaraGetConnectionError(conn));
+        client->failed = 1;
+    }
+
+    kiaraCloseConnection(conn);
+    kiaraFreeContext(ctx);
+    return NULL;
+}
+
+/* Returns calls per second, or 0 on failure */
+static double runClients(const char *url, KIARA_FUNC_OBJ(Calc_Add) add, int numThreads, int numCalls)
+{
+    ClientThread *clients;
+    MIDDLEWARENEWSBRIEF_PROFILER_TIME_TYPE start, elapsed;
+    int i, failed = 0;
+
+    clients = (ClientThread*)calloc(numThreads, sizeof(ClientThread));
+
+    start = MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME;
+    for (i = 0; i < numThreads; ++i)
+    {
+        clients[i].url = url;
+        clients[i].add = add;
+        clients[i].numCalls = numCalls;
+        pthread_create(&clients[i].thread, NULL, runClient, &clients[i]);
+    }
+    for (i = 0; i < numThreads; ++i)
+    {
+        pthread_join(clients[i].thread, NULL);
+        failed |= clients[i].failed;
+    }
+    elapsed = MIDDLEWARENEWSBRIEF_PROFILER_DIFF(MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME, start);
+
+    free(clients);
+
+    if (failed || !elapsed)
+        return 0.0;
+    return (double)numThreads * numCalls * USEC_PER_SEC / elapsed;
+}
+
+int main(int argc, char **argv)
+{
+    int numCalls = 10000, numThreads = 8, port = 9290;
+    int failed = 0;
+    char url[64];
+    pid_t server;
+    KIARA_Context *ctx;
+    KIARA_Connection *conn;
+    KIARA_FUNC_OBJ(Calc_Add) add = NULL;
+    MIDDLEWARENEWSBRIEF_PROFILER_TIME_TYPE start, elapsed;
+    double callsPerSec;
+
+    setvbuf(stdout, NULL, _IONBF, 0);
+    setvbuf(stderr, NULL, _IONBF, 0);
+
+    kiaraInit(&argc, argv);
+
+    if (argc > 1)
+        numCalls = atoi(argv[1]);
+    if (numCalls < 1)
+        numCalls = 1;
+    if (argc > 2)
+        numThreads = atoi(argv[2]);
+    if (numThreads < 1)
+        numThreads = 1;
+    if (argc > 3)
+        port = atoi(argv[3]);
+
+    snprintf(url, sizeof(url), "http://localhost:%i/service", port);
+
+    server = fork();
+    if (server < 0)
+    {
+        perror("fork");
+        return 1;
+    }
+    if (server == 0)
+        _exit(runServer(port));
+
+    /* Give the server time to bind its port */
+    sleep(1);
+
+    ctx = kiaraNewContext();
+    conn = kiaraOpenConnection(ctx, url);
+    if (!conn)
+    {
+        fprintf(stderr, "Error: Could not open connection : %s\n", kiaraGetContextError(ctx));
+        failed = 1;
+    }
+    else
+    {
+        add = KIARA_GENERATE_CLIENT_FUNC(conn, "calc.add", Calc_Add, "");
+        if (!add)
+        {
+            fprintf(stderr, "Error: code generation failed: %s\n", kiaraGetConnectionError(conn));
+            failed = 1;
+        }
+    }
+
+    if (add)
+    {
+        /* Warm up the connection */
+        failed |= callAdd(add, 100);
+
+        start = MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME;
+        failed |= callAdd(add, numCalls);
+        elapsed = MIDDLEWARENEWSBRIEF_PROFILER_DIFF(MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME, start);
+
+        printf("%i sequential calls of calc.add\n", numCalls);
+        printf("Average latency in %s: %.3f\n\n",
+               MIDDLEWARENEWSBRIEF_PROFILER_TIME_UNITS, (double)elapsed / numCalls);
+
+        printf("%i threads, %i calls per thread\n", numThreads, numCalls);
+        printf("%-28s %14s\n", "connections", "calls/s");
+
+        callsPerSec = runClients(url, add, numThreads, numCalls);
+        failed |= callsPerSec == 0.0;
+        printf("%-28s %14.2f\n", "1 shared (pipelined)", callsPerSec);
+    }
+
+    if (conn)
+        kiaraCloseConnection(conn);
+    kiaraFreeContext(ctx);
+
+    callsPerSec = runClients(url, NULL, numThreads, numCalls);
+    failed |= callsPerSec == 0.0;
+    printf("%-28s %14.2f\n", "1 per thread", callsPerSec);
+
+    kill(server, SIGTERM);
+    waitpid(server, NULL, 0);
+
+    kiaraFinalize();
+
+    return failed;
+}
@@ -0,0 +1,205 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * kiara_jitbench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ *
+ * Compares JIT configurations: time to generate client stubs for the
+ * calc service IDL (tests/calc.kiara) against the call throughput of the
+ * generated stubs. Start kiara_calctest_server first.
+ * JIT configuration is selected with KIARA_JIT_* environment variables,
+ * which are read each time a connection is opened.
+ * Pass --telemetry as third argument to print per-stub compile times.
+ */
+
+#include <KIARA/kiara.h>
+#include <KIARA/kiara_macros.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../kiara/Profiler.h"
+
+#ifdef _WIN32
+#define setenv(name, value, overwrite) _putenv_s(name, value)
+#define JITBENCH_TICKS_PER_SEC 1000
+#else
+#define JITBENCH_TICKS_PER_SEC USEC_PER_SEC
+#endif
+
+KIARA_DECL_PTR(IntPtr, KIARA_INT)
+KIARA_DECL_PTR(FloatPtr, KIARA_FLOAT)
+KIARA_DECL_PTR(CharPtrPtr, KIARA_CHAR_PTR)
+
+KIARA_DECL_FUNC(Calc_Add,
+  KIARA_FUNC_RESULT(IntPtr, result)
+  KIARA_FUNC_ARG(KIARA_INT, a)
+  KIARA_FUNC_ARG(KIARA_INT, b)
+)
+
+KIARA_DECL_FUNC(Calc_Add_Float,
+  KIARA_FUNC_RESULT(FloatPtr, result)
+  KIARA_FUNC_ARG(KIARA_FLOAT, a)
+  KIARA_FUNC_ARG(KIARA_FLOAT, b)
+)
+
+KIARA_DECL_FUNC(Calc_String_To_Int32,
+  KIARA_FUNC_RESULT(IntPtr, result)
+  KIARA_FUNC_ARG(KIARA_const_char_ptr, s)
+)
+
+KIARA_DECL_FUNC(Calc_Int32_To_String,
+  KIARA_FUNC_RESULT(CharPtrPtr, result)
+  KIARA_FUNC_ARG(KIARA_INT, i)
+)
+
+typedef struct JITBenchConfig
+{
+    const char *name;
+    const char *optLevel;
+    const char *passes;
+    const char *loopVectorize;
+    const char *unrollThreshold;
+} JITBenchConfig;
+
+static const JITBenchConfig configs[] = {
+    { "O0",          "0", "",                              "0", "0"  },
+    { "O1",          "1", "",                              "0", "-1" },
+    { "O2",          "2", "",                              "1", "-1" },
+    { "O3",          "3", "",                              "1", "-1" },
+    { "O3-novec",    "3", "",                              "0", "-1" },
+    { "O3-nounroll", "3", "",                              "1", "0"  },
+    { "O3-standard", "3", "standard",                      "1", "-1" },
+    { "O2-minimal",  "2", "sroa,instcombine,simplifycfg",  "0", "-1" }
+};
+
+static void applyConfig(const JITBenchConfig *config)
+{
+    setenv("KIARA_JIT_OPT_LEVEL", config->optLevel, 1);
+    setenv("KIARA_JIT_PASSES", config->passes, 1);
+    setenv("KIARA_JIT_LOOP_VECTORIZE", config->loopVectorize, 1);
+    setenv("KIARA_JIT_UNROLL_THRESHOLD", config->unrollThreshold, 1);
+}
+
+/* Print per-stub compile time breakdown as JSON to stderr */
+static int printTelemetry = 0;
+
+static int runConfig(KIARA_Context *ctx, const char *url, const JITBenchConfig *config, int numCalls)
+{
+    KIARA_Connection *conn;
+    KIARA_FUNC_OBJ(Calc_Add) add;
+    KIARA_FUNC_OBJ(Calc_Add_Float) addf;
+    KIARA_FUNC_OBJ(Calc_String_To_Int32) strToInt;
+    KIARA_FUNC_OBJ(Calc_Int32_To_String) intToStr;
+    KIARA_JITStatistics stats;
+    MIDDLEWARENEWSBRIEF_PROFILER_TIME_TYPE start, openTime, compileTime, callTime;
+    int i, result = 0;
+
+    applyConfig(config);
+
+    start = MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME;
+    conn = kiaraOpenConnection(ctx, url);
+    openTime = MIDDLEWARENEWSBRIEF_PROFILER_DIFF(MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME, start);
+    if (!conn)
+    {
+        fprintf(stderr, "Error: Could not open connection : %s\n", kiaraGetContextError(ctx));
+        return 1;
+    }
+
+    start = MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME;
+    add = KIARA_GENERATE_CLIENT_FUNC(conn, "calc.add", Calc_Add, "");
+    addf = KIARA_GENERATE_CLIENT_FUNC(conn, "calc.addf", Calc_Add_Float, "");
+    strToInt = KIARA_GENERATE_CLIENT_FUNC(conn, "calc.stringToInt32", Calc_String_To_Int32, "");
+    intToStr = KIARA_GENERATE_CLIENT_FUNC(conn, "calc.int32ToString", Calc_Int32_To_String, "");
+    compileTime = MIDDLEWARENEWSBRIEF_PROFILER_DIFF(MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME, start);
+
+    if (!add || !addf || !strToInt || !intToStr)
+    {
+        fprintf(stderr, "Error: code generation failed: %s\n", kiaraGetConnectionError(conn));
+        kiaraCloseConnection(conn);
+        return 1;
+    }
+
+    start = MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME;
+    for (i = 0; i < numCalls; ++i)
+    {
+        if (KIARA_CALL(add, &result, i, 1) != KIARA_SUCCESS)
+        {
+            fprintf(stderr, "Error: call failed: %s\n", kiaraGetConnectionError(conn));
+            kiaraCloseConnection(conn);
+            return 1;
+        }
+    }
+    callTime = MIDDLEWARENEWSBRIEF_PROFILER_DIFF(MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME, start);
+
+    kiaraGetConnectionJITStatistics(conn, &stats);
+
+    printf("%-12s %12lu %12lu %14.2f %12lu %8lu\n",
+           config->name,
+           (unsigned long)openTime,
+           (unsigned long)compileTime,
+           callTime ? (double)numCalls * JITBENCH_TICKS_PER_SEC / callTime : 0.0,
+           (unsigned long)stats.codeSize,
+           (unsigned long)stats.numStages);
+
+    if (printTelemetry)
+        fprintf(stderr, "%s: %s", config->name, kiaraGetConnectionJITTelemetry(conn));
+
+    kiaraCloseConnection(conn);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    KIARA_Context *ctx;
+    const char *url = "http://localhost:9090/rpc/calc";
+    int i, numCalls = 1000, numConfigs = sizeof(configs) / sizeof(configs[0]), failed = 0;
+
+    setvbuf(stdout, NULL, _IONBF, 0);
+    setvbuf(stderr, NULL, _IONBF, 0);
+
+    kiaraInit(&argc, argv);
+
+    if (argc > 1)
+        url = argv[1];
+    if (argc > 2)
+        numCalls = atoi(argv[2]);
+    if (numCalls < 1)
+        numCalls = 1;
+    if (argc > 3 && strcmp(argv[3], "--telemetry") == 0)
+        printTelemetry = 1;
+
+    ctx = kiaraNewContext();
+
+    printf("Times in " MIDDLEWARENEWSBRIEF_PROFILER_TIME_UNITS ", %i calls of calc.add per configuration\n", numCalls);
+    printf("%-12s %12s %12s %14s %12s %8s\n",
+           "config", "open", "compile", "calls/s", "code bytes", "stages");
+
+    for (i = 0; i < numConfigs; ++i)
+    {
+        if (runConfig(ctx, url, &configs[i], numCalls) != 0)
+            failed = 1;
+    }
+
+    kiaraFreeContext(ctx);
+    kiaraFinalize();
+
+    return failed;
+}
@@ -0,0 +1,207 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013, 2014  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * KiaraPubSubPublisher.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#include <KIARA/kiara.h>
+#include <KIARA/kiara_macros.h>
+#include <KIARA/kiara_pp_annotation.h>
+
+#include "MarketData.h"
+#include "QuoteRequest.h"
+#include "kiara_client_decls.h"
+#include "PubSubIDL.h"
+#include "Profiler.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "c99fmt.h"
+
+kiara_declare_struct(MarketData,
+    kiara_struct_array_member(mdEntries, num_mdEntries))
+
+kiara_declare_struct(QuoteRequest,
+    kiara_struct_array_member(related, num_related))
+
+kiara_declare_func(Benchmark_PublishMarketData, const MarketData *marketData)
+kiara_declare_func(Benchmark_PublishQuoteRequest, const QuoteRequest *quoteRequest)
+
+KIARA_DECL_FUNC(Benchmark_PublishMarketData,
+  KIARA_FUNC_ARG(const_MarketData_ptr, marketData)
+)
+KIARA_DECL_FUNC(Benchmark_PublishQuoteRequest,
+  KIARA_FUNC_ARG(const_QuoteRequest_ptr, quoteRequest)
+)
+
+/*
+ * Functions generated for a publisher do not wait for a response,
+ * every call only serializes the arguments and queues the message.
+ */
+KIARA_Context *ctx;
+KIARA_Connection *pub;
+
+KIARA_FUNC_OBJ(Benchmark_PublishMarketData) publish_marketdata;
+KIARA_FUNC_OBJ(Benchmark_PublishQuoteRequest) publish_quoterequest;
+
+void initPublisher(const char *url, const char *protocol)
+{
+    KIARA_Result result;
+
+    ctx = kiaraNewContext();
+
+    printf("Binding publisher to %s...\n", url);
+    pub = kiaraNewPublisher(ctx, url, protocol);
+
+    if (!pub)
+    {
+        fprintf(stderr, "Error: Could not create publisher : %s\n", kiaraGetContextError(ctx));
+        exit(1);
+    }
+
+    result = kiaraLoadPublisherIDLFromString(pub, "KIARA", PUBSUB_BENCHMARK_IDL);
+    if (result != KIARA_SUCCESS)
+    {
+        fprintf(stderr, "Error: could not parse IDL: %s: %s\n",
+                kiaraGetErrorName(result), kiaraGetConnectionError(pub));
+        exit(1);
+    }
+
+    publish_marketdata = KIARA_GENERATE_CLIENT_FUNC(pub, "benchmark.marketData", Benchmark_PublishMarketData, "");
+    if (!publish_marketdata)
+        fprintf(stderr, "Error: code generation failed: %s\n", kiaraGetConnectionError(pub));
+
+    publish_quoterequest = KIARA_GENERATE_CLIENT_FUNC(pub, "benchmark.quoteRequest", Benchmark_PublishQuoteRequest, "");
+    if (!publish_quoterequest)
+        fprintf(stderr, "Error: code generation failed: %s\n", kiaraGetConnectionError(pub));
+}
+
+void finalizePublisher()
+{
+    kiaraCloseConnection(pub);
+    kiaraFreeContext(ctx);
+    kiaraFinalize();
+}
+
+int main(int argc, char **argv)
+{
+    KIARA_Result errorCode = KIARA_SUCCESS;
+    MIDDLEWARENEWSBRIEF_PROFILER_TIME_TYPE start, finish, elapsed;
+    size_t num_messages, num_sent = 0;
+    MarketData md;
+    QuoteRequest qr;
+    const char *url = NULL;
+    const char *protocol = NULL;
+
+    /* This code is required for testing tool when compiled with MS CRT library and valgrind */
+    setvbuf(stdout, NULL, _IONBF, 0);
+    setvbuf(stderr, NULL, _IONBF, 0);
+
+    /* Initialize KIARA */
+    kiaraInit(&argc, argv);
+
+    url = argc > 1 ? argv[1] : "tcp://*:5556";
+    protocol = argc > 2 ? argv[2] : "jsonrpc";
+    num_messages = argc > 3 ? (size_t)atol(argv[3]) : 100000;
+
+    printf("Protocol: %s\n", protocol);
+
+    initPublisher(url, protocol);
+
+    /* Give subscribers time to connect, messages published before are lost */
+    sleep(1);
+
+    printf("Publishing %d messages\n", (int)num_messages);
+
+    md = MarketData_createTestData();
+    qr = QuoteRequest_createTestData();
+
+    start = MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME;
+
+    {
+        size_t i;
+        for (i = 0; i < num_messages; ++i)
+        {
+            // Send 10 MarketDatas for each QuoteRequest
+            if (i % 10 == 5)
+            {
+                qr.counter = i;
+                qr.isEcho = 0;
+                kiaraSetPublisherTopic(pub, "QuoteRequest");
+                errorCode = KIARA_CALL(publish_quoterequest, &qr);
+            }
+            else
+            {
+                md.counter = i;
+                md.isEcho = 0;
+                kiaraSetPublisherTopic(pub, "MarketData");
+                errorCode = KIARA_CALL(publish_marketdata, &md);
+            }
+
+            if (errorCode != KIARA_SUCCESS)
+            {
+                fprintf(stderr, "Error: publish failed: %s\n", kiaraGetConnectionError(pub));
+                break;
+            }
+            ++num_sent;
+        }
+    }
+
+    finish = MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME;
+
+    elapsed = MIDDLEWARENEWSBRIEF_PROFILER_DIFF(finish,start);
+
+    printf("\n\nPublished %d messages in %.3f %s\n",
+           (int)num_sent, (double)elapsed, MIDDLEWARENEWSBRIEF_PROFILER_TIME_UNITS);
+    if (elapsed > 0)
+        printf("Average time per message in %s: %.3f\n\n\n",
+               MIDDLEWARENEWSBRIEF_PROFILER_TIME_UNITS,
+               (double)elapsed / (double)num_sent);
+
+    /*
+     * Let the subscribers drain their queues, then send the end marker
+     * (counter == num_messages) on both topics.
+     */
+    sleep(1);
+
+    md.counter = num_messages;
+    kiaraSetPublisherTopic(pub, "MarketData");
+    KIARA_CALL(publish_marketdata, &md);
+
+    qr.counter = num_messages;
+    kiaraSetPublisherTopic(pub, "QuoteRequest");
+    KIARA_CALL(publish_quoterequest, &qr);
+
+    /* Give ZeroMQ time to flush the end markers */
+    sleep(1);
+
+    printf("Finished\n");
+
+    MarketData_destroy(&md);
+    QuoteRequest_destroy(&qr);
+
+    finalizePublisher();
+
+    return 0;
+}
@@ -0,0 +1,184 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013, 2014  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * KiaraPubSubSubscriber.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#include <KIARA/kiara.h>
+#include <KIARA/kiara_macros.h>
+#include <KIARA/kiara_pp_annotation.h>
+
+#include "MarketData.h"
+#include "QuoteRequest.h"
+#include "kiara_server_decls.h"
+#include "PubSubIDL.h"
+#include "Profiler.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "c99fmt.h"
+
+kiara_declare_struct(MarketData,
+    kiara_struct_array_member(mdEntries, num_mdEntries))
+
+kiara_declare_struct(QuoteRequest,
+    kiara_struct_array_member(related, num_related))
+
+kiara_declare_service(Benchmark_OnMarketData, const MarketData *marketData)
+kiara_declare_service(Benchmark_OnQuoteRequest, const QuoteRequest *quoteRequest)
+
+KIARA_DECL_SERVICE(Benchmark_OnMarketData,
+  KIARA_SERVICE_ARG(const_MarketData_ptr, marketData)
+)
+KIARA_DECL_SERVICE(Benchmark_OnQuoteRequest,
+  KIARA_SERVICE_ARG(const_QuoteRequest_ptr, quoteRequest)
+)
+
+/** Subscriber state */
+
+KIARA_Subscriber *subscriber;
+size_t num_messages = 100000;
+size_t msg_counter = 0;
+size_t out_of_order = 0;
+size_t last_counter = 0;
+MIDDLEWARENEWSBRIEF_PROFILER_TIME_TYPE start, finish;
+
+/* Returns 1 when the end marker was received, the marker is not timed */
+static int onMessage(size_t counter)
+{
+    if (counter >= num_messages)
+    {
+        kiaraStopSubscriber(subscriber);
+        return 1;
+    }
+
+    if (msg_counter == 0)
+        start = MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME;
+    else if (counter <= last_counter)
+        ++out_of_order;
+
+    finish = MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME;
+    last_counter = counter;
+    ++msg_counter;
+    return 0;
+}
+
+KIARA_Result benchmark_onmarketdata_impl(KIARA_ServiceFuncObj *kiara_funcobj, const MarketData *marketData)
+{
+    onMessage(marketData->counter);
+    return KIARA_SUCCESS;
+}
+
+KIARA_Result benchmark_onquoterequest_impl(KIARA_ServiceFuncObj *kiara_funcobj, const QuoteRequest *quoteRequest)
+{
+    onMessage(quoteRequest->counter);
+    return KIARA_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    KIARA_Context *ctx;
+    KIARA_Service *service;
+    KIARA_Result result;
+    MIDDLEWARENEWSBRIEF_PROFILER_TIME_TYPE elapsed;
+    const char *url = NULL;
+    const char *protocol = NULL;
+    const char *topic = NULL;
+
+    /* This code is required for testing tool when compiled with MS CRT library and valgrind */
+    setvbuf(stdout, NULL, _IONBF, 0);
+    setvbuf(stderr, NULL, _IONBF, 0);
+
+    /* Initialize KIARA */
+    kiaraInit(&argc, argv);
+
+    url = argc > 1 ? argv[1] : "tcp://localhost:5556";
+    protocol = argc > 2 ? argv[2] : "jsonrpc";
+    if (argc > 3)
+        num_messages = (size_t)atol(argv[3]);
+    /* Empty topic subscribes to all messages, "MarketData" or "QuoteRequest" filter */
+    topic = argc > 4 ? argv[4] : "";
+
+    printf("Publisher URL: %s\n", url);
+    printf("Protocol: %s\n", protocol);
+    printf("Topic: \"%s\"\n", topic);
+
+    ctx = kiaraNewContext();
+
+    service = kiaraNewService(ctx);
+
+    result = kiaraLoadServiceIDLFromString(service, "KIARA", PUBSUB_BENCHMARK_IDL);
+    if (result != KIARA_SUCCESS)
+    {
+        fprintf(stderr, "Error: could not parse IDL: %s: %s\n",
+                kiaraGetErrorName(result), kiaraGetServiceError(service));
+        exit(1);
+    }
+
+    result = KIARA_REGISTER_SERVICE_FUNC(service, "benchmark.marketData", Benchmark_OnMarketData, "", benchmark_onmarketdata_impl);
+    if (result != KIARA_SUCCESS)
+    {
+        fprintf(stderr, "Error: registration failed: %s: %s\n",
+                kiaraGetErrorName(result), kiaraGetServiceError(service));
+        exit(1);
+    }
+
+    result = KIARA_REGISTER_SERVICE_FUNC(service, "benchmark.quoteRequest", Benchmark_OnQuoteRequest, "", benchmark_onquoterequest_impl);
+    if (result != KIARA_SUCCESS)
+    {
+        fprintf(stderr, "Error: registration failed: %s: %s\n",
+                kiaraGetErrorName(result), kiaraGetServiceError(service));
+        exit(1);
+    }
+
+    subscriber = kiaraSubscribe(ctx, url, protocol, topic, service);
+    if (!subscriber)
+    {
+        fprintf(stderr, "Error: could not subscribe: %s\n", kiaraGetContextError(ctx));
+        exit(1);
+    }
+
+    printf("Receiving messages...\n");
+
+    result = kiaraRunSubscriber(subscriber);
+    if (result != KIARA_SUCCESS)
+        fprintf(stderr, "Error: subscriber failed: %s: %s\n",
+                kiaraGetErrorName(result), kiaraGetSubscriberError(subscriber));
+
+    elapsed = MIDDLEWARENEWSBRIEF_PROFILER_DIFF(finish,start);
+
+    printf("\n\nReceived %d of %d messages (%d out of order) in %.3f %s\n",
+           (int)msg_counter, (int)num_messages, (int)out_of_order,
+           (double)elapsed, MIDDLEWARENEWSBRIEF_PROFILER_TIME_UNITS);
+    if (msg_counter > 0)
+        printf("Average time per message in %s: %.3f\n\n\n",
+               MIDDLEWARENEWSBRIEF_PROFILER_TIME_UNITS,
+               (double)elapsed / (double)msg_counter);
+
+    kiaraFreeSubscriber(subscriber);
+    kiaraFreeService(service);
+    kiaraFreeContext(ctx);
+    kiaraFinalize();
+
+    return 0;
+}
@@ -0,0 +1,102 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013, 2014  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * PubSubIDL.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+
+#ifndef PUBSUBIDL_H_INCLUDED
+#define PUBSUBIDL_H_INCLUDED
+
+/* IDL shared by KiaraPubSubPublisher and KiaraPubSubSubscriber.
+ * All methods return void, so generated client functions are one-way.
+ */
+#define PUBSUB_BENCHMARK_IDL                                    \
+    "namespace * benchmark "                                    \
+    " "                                                         \
+    "struct MarketDataEntry { "                                 \
+    "u32 mdUpdateAction; "                                      \
+    "u32 mdPriceLevel; "                                        \
+    "double        mdEntryType; "                               \
+    "u32 openCloseSettleFlag; "                                 \
+    "u32 securityIDSource; "                                    \
+    "u32 securityID; "                                          \
+    "u32 rptSeq; "                                              \
+    "double        mdEntryPx; "                                 \
+    "u32 mdEntryTime; "                                         \
+    "u32          mdEntrySize; "                                \
+    "u32 numberOfOrders; "                                      \
+    "double        tradingSessionID; "                          \
+    "double        netChgPrevDay; "                             \
+    "u32 tradeVolume; "                                         \
+    "double        tradeCondition; "                            \
+    "double        tickDirection; "                             \
+    "double        quoteCondition; "                            \
+    "u32 aggressorSide; "                                       \
+    "double        matchEventIndicator; "                       \
+    ""                                                          \
+    "double dummy1; "                                           \
+    "float dummy2; "                                            \
+    "} "                                                        \
+    ""                                                          \
+    "struct MarketData { "                                      \
+    "boolean    isEcho; "                                       \
+    "u32        counter; "                                      \
+    "u32        securityID; "                                   \
+    "double    applVersionID; "                                 \
+    "double    messageType; "                                   \
+    "double    senderCompID; "                                  \
+    "u32       msgSeqNum; "                                     \
+    "u32       sendingTime; "                                   \
+    "u32       tradeDate; "                                     \
+    "array<MarketDataEntry>  mdEntries; "                       \
+    "} "                                                        \
+    ""                                                          \
+    "struct RelatedSym { "                                      \
+    "double    symbol; "                                        \
+    "u64       orderQuantity; "                                 \
+    "u32    side; "                                             \
+    "u64    transactTime; "                                     \
+    "u32    quoteType; "                                        \
+    "u32      securityID; "                                     \
+    "u32      securityIDSource; "                               \
+    "double dummy1; "                                           \
+    "float dummy2; "                                            \
+    "} "                                                        \
+    "struct QuoteRequest { "                                    \
+    "boolean            isEcho; "                               \
+    "u32      counter; "                                        \
+    "u32      securityID; "                                     \
+    "double             applVersionID; "                        \
+    "double             messageType; "                          \
+    "double             senderCompID; "                         \
+    "u32      msgSeqNum; "                                      \
+    "u32      sendingTime; "                                    \
+    "double             quoteReqID; "                           \
+    "array<RelatedSym>        related; "                        \
+    "} "                                                        \
+    ""                                                          \
+    "service benchmark { "                                      \
+    "  void marketData(MarketData marketData); "                \
+    "  void quoteRequest(QuoteRequest quoteRequest); "          \
+    "} "
+
+#endif /* PUBSUBIDL_H_INCLUDED */
@@ -0,0 +1,268 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * kiara_localbench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ *
+ * Compares the ZeroMQ tcp loopback, ipc and inproc transports of a tcp
+ * service. The calc server runs in a thread of the benchmark, its port is
+ * also bound to ipc and inproc endpoints. For every transport the transports
+ * preferred by clients over it are disabled by environment variables, then
+ *  - one thread performs sequential calls of calc.add (latency),
+ *  - N threads use a connection each (throughput).
+ *
+ * Usage: kiara_localbench [numCalls [numThreads [port]]]
+ */
+
+#include <KIARA/kiara.h>
+#include <KIARA/kiara_macros.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "../kiara/Profiler.h"
+
+KIARA_DECL_PTR(IntPtr, KIARA_INT)
+
+/* Server side */
+
+KIARA_DECL_SERVICE(Calc_Add_Service,
+    KIARA_SERVICE_RESULT(IntPtr, result)
+    KIARA_SERVICE_ARG(KIARA_INT, a)
+    KIARA_SERVICE_ARG(KIARA_INT, b))
+
+KIARA_Result calc_add_impl(KIARA_ServiceFuncObj *kiara_funcobj, int *result, int a, int b)
+{
+    *result = a + b;
+    return KIARA_SUCCESS;
+}
+
+static void * runServer(void *arg)
+{
+    int port = *(int*)arg;
+    KIARA_Context *ctx;
+    KIARA_Service *service;
+    KIARA_Server *server;
+    KIARA_Result result;
+    char path[64];
+
+    ctx = kiaraNewContext();
+    service = kiaraNewService(ctx);
+
+    result = kiaraLoadServiceIDLFromString(service,
+        "KIARA",
+        "namespace * calc "
+        "service calc { "
+        "    i32 add(i32 a, i32 b) "
+        "} ");
+    if (result != KIARA_SUCCESS)
+    {
+        fprintf(stderr, "Error: could not parse IDL: %s: %s\n",
+                kiaraGetErrorName(result), kiaraGetServiceError(service));
+        exit(1);
+    }
+
+    result = KIARA_REGISTER_SERVICE_FUNC(service, "calc.add", Calc_Add_Service, "", calc_add_impl);
+    if (result != KIARA_SUCCESS)
+    {
+        fprintf(stderr, "Error: registration failed: %s: %s\n",
+                kiaraGetErrorName(result), kiaraGetServiceError(service));
+        exit(1);
+    }
+
+    server = kiaraNewServer(ctx, "0.0.0.0", port, "/service");
+
+    snprintf(path, sizeof(path), "tcp://0.0.0.0:%i/rpc/calc", port + 1);
+    kiaraAddService(server, path, "jsonrpc", service);
+
+    result = kiaraRunServer(server);
+    if (result != KIARA_SUCCESS)
+    {
+        fprintf(stderr, "Error: could not start server: %s: %s\n",
+                kiaraGetErrorName(result), kiaraGetServerError(server));
+        exit(1);
+    }
+    return NULL;
+}
+
+/* Client side */
+
+KIARA_DECL_FUNC(Calc_Add,
+  KIARA_FUNC_RESULT(IntPtr, result)
+  KIARA_FUNC_ARG(KIARA_INT, a)
+  KIARA_FUNC_ARG(KIARA_INT, b)
+)
+
+typedef struct ClientThread
+{
+    pthread_t thread;
+    const char *url;
+    int numCalls;
+    int failed;
+} ClientThread;
+
+static void * runClient(void *arg)
+{
+    ClientThread *client = (ClientThread*)arg;
+    KIARA_Context *ctx;
+    KIARA_Connection *conn;
+    KIARA_FUNC_OBJ(Calc_Add) add;
+    int i, result = 0;
+
+    /* Each thread requires a separate KIARA_Context instance */
+    ctx = kiaraNewContext();
+    conn = kiaraOpenConnection(ctx, client->url);
+    if (!conn)
+    {
+        fprintf(stderr, "Error: Could not open connection : %s\n", kiaraGetContextError(ctx));
+        client->failed = 1;
+        kiaraFreeContext(ctx);
+        return NULL;
+    }
+
+    add = KIARA_GENERATE_CLIENT_FUNC(conn, "calc.add", Calc_Add, "");
+    if (!add)
+    {
+        fprintf(stderr, "Error: code generation failed: %s\n", kiaraGetConnectionError(conn));
+        client->failed = 1;
+    }
+
+    for (i = 0; add && i < client->numCalls; ++i)
+    {
+        if (KIARA_CALL(add, &result, i, 1) != KIARA_SUCCESS || result != i + 1)
+        {
+            fprintf(stderr, "Error: call failed: %s\n", kiaraGetConnectionError(conn));
+            client->failed = 1;
+            break;
+        }
+    }
+
+    kiaraCloseConnection(conn);
+    kiaraFreeContext(ctx);
+    return NULL;
+}
+
+/* Returns calls per second, or 0 on failure */
+static double runClients(const char *url, int numThreads, int numCalls)
+{
+    ClientThread *clients;
+    MIDDLEWARENEWSBRIEF_PROFILER_TIME_TYPE start, elapsed;
+    int i, failed = 0;
+
+    clients = (ClientThread*)calloc(numThreads, sizeof(ClientThread));
+
+    start = MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME;
+    for (i = 0; i < numThreads; ++i)
+    {
+        clients[i].url = url;
+        clients[i].numCalls = numCalls;
+        pthread_create(&clients[i].thread, NULL, runClient, &clients[i]);
+    }
+    for (i = 0; i < numThreads; ++i)
+    {
+        pthread_join(clients[i].thread, NULL);
+        failed |= clients[i].failed;
+    }
+    elapsed = MIDDLEWARENEWSBRIEF_PROFILER_DIFF(MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME, start);
+
+    free(clients);
+
+    if (failed || !elapsed)
+        return 0.0;
+    return (double)numThreads * numCalls * USEC_PER_SEC / elapsed;
+}
+
+/* Clients select the transport with the highest priority that is available,
+ * inproc before shared memory before ipc before tcp.
+ */
+typedef struct LocalTransport
+{
+    const char *name;
+    const char *inproc;
+    const char *sharedMemory;
+    const char *ipc;
+} LocalTransport;
+
+static const LocalTransport transports[] = {
+    { "tcp",    "0", "0", "0" },
+    { "ipc",    "0", "0", "1" },
+    { "inproc", "1", "0", "1" }
+};
+
+int main(int argc, char **argv)
+{
+    int numCalls = 10000, numThreads = 4, port = 9290;
+    int failed = 0;
+    size_t i;
+    double callsPerSec;
+    char url[64];
+    pthread_t server;
+
+    setvbuf(stdout, NULL, _IONBF, 0);
+    setvbuf(stderr, NULL, _IONBF, 0);
+
+    kiaraInit(&argc, argv);
+
+    if (argc > 1)
+        numCalls = atoi(argv[1]);
+    if (numCalls < 1)
+        numCalls = 1;
+    if (argc > 2)
+        numThreads = atoi(argv[2]);
+    if (numThreads < 1)
+        numThreads = 1;
+    if (argc > 3)
+        port = atoi(argv[3]);
+
+    snprintf(url, sizeof(url), "http://localhost:%i/service", port);
+
+    pthread_create(&server, NULL, runServer, &port);
+
+    /* Give the server time to bind its ports */
+    sleep(1);
+
+    printf("%i calls of calc.add, %i client threads\n", numCalls, numThreads);
+    printf("%8s %14s %16s\n", "", "latency (us)", "throughput (1/s)");
+
+    for (i = 0; i < sizeof(transports) / sizeof(transports[0]); ++i)
+    {
+        double latency;
+
+        setenv("KIARA_INPROC", transports[i].inproc, 1);
+        setenv("KIARA_SHARED_MEMORY", transports[i].sharedMemory, 1);
+        setenv("KIARA_IPC", transports[i].ipc, 1);
+
+        callsPerSec = runClients(url, 1, numCalls);
+        latency = callsPerSec > 0.0 ? USEC_PER_SEC / callsPerSec : 0.0;
+        if (callsPerSec == 0.0)
+            failed = 1;
+
+        callsPerSec = runClients(url, numThreads, numCalls / numThreads + 1);
+        if (callsPerSec == 0.0)
+            failed = 1;
+
+        printf("%8s %14.2f %16.2f\n", transports[i].name, latency, callsPerSec);
+    }
+
+    /* The server thread does not return */
+    _exit(failed);
+}
@@ -0,0 +1,161 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * kiara_parsebench.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ *
+ * Measures IDL and KIARA language lexer throughput over a large generated
+ * IDL, reading from std::istream and from a memory (mapped) buffer.
+ *
+ * Usage: kiara_parsebench [numStructs] [numIterations]
+ */
+
+#include <KIARA/Core/LibraryInit.hpp>
+#include <KIARA/DB/World.hpp>
+#include <KIARA/DB/Module.hpp>
+#include <KIARA/IDL/IDLParserContext.hpp>
+#include <KIARA/Compiler/Lexer.hpp>
+#include <KIARA/Utils/Timer.hpp>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+
+namespace
+{
+
+std::string generateIDL(int numStructs)
+{
+    static const char *types[] = { "i32", "u32", "i64", "float", "double", "string", "boolean" };
+    const int numTypes = sizeof(types) / sizeof(types[0]);
+
+    std::ostringstream out;
+    out << "namespace * parsebench\n\n";
+    for (int i = 0; i < numStructs; ++i)
+    {
+        out << "// generated structure " << i << "\n";
+        out << "struct Struct" << i << " {\n";
+        for (int j = 0; j < 8; ++j)
+            out << "    " << types[(i + j) % numTypes] << " member" << j << ";\n";
+        if (i > 0)
+            out << "    Struct" << (i - 1) << " previous;\n";
+        out << "}\n\n";
+    }
+    out << "service parsebench {\n";
+    for (int i = 0; i < numStructs; ++i)
+        out << "    Struct" << i << " call" << i << "(Struct" << i << " arg, i32 flags)\n";
+    out << "}\n";
+    return out.str();
+}
+
+void report(const char *name, double seconds, size_t numBytes, int numIterations)
+{
+    const double avg = seconds / numIterations;
+    std::cout << name << ": " << avg * 1000.0 << " ms, "
+              << (numBytes / avg) / (1024.0 * 1024.0) << " MB/s" << std::endl;
+}
+
+bool parseIDL(KIARA::World &world, const std::string &idl, bool fromStream)
+{
+    KIARA::Module::Ptr module = new KIARA::Module(world, "parsebench");
+    if (fromStream)
+    {
+        std::istringstream in(idl);
+        KIARA::IDLParserContext ctx(module, in, "<bench>");
+        return ctx.parse();
+    }
+    KIARA::IDLParserContext ctx(module, idl.data(), idl.data() + idl.size(), "<bench>");
+    return ctx.parse();
+}
+
+size_t lex(KIARA::Compiler::Lexer &lexer)
+{
+    size_t numTokens = 0;
+    KIARA::Compiler::Token token;
+    while (lexer.next(token) != KIARA::Compiler::TOK_EOF &&
+           token.type != KIARA::Compiler::TOK_ERROR)
+        ++numTokens;
+    return numTokens;
+}
+
+} // unnamed namespace
+
+int main(int argc, char **argv)
+{
+    int numStructs = 2000;
+    int numIterations = 10;
+
+    if (argc > 1)
+        numStructs = atoi(argv[1]);
+    if (argc > 2)
+        numIterations = atoi(argv[2]);
+    if (numStructs < 1)
+        numStructs = 1;
+    if (numIterations < 1)
+        numIterations = 1;
+
+    KIARA::LibraryInit init;
+    KIARA::World world;
+
+    const std::string idl = generateIDL(numStructs);
+    std::cout << "IDL size: " << idl.size() << " bytes, " << numStructs << " structs" << std::endl;
+
+    for (int mode = 0; mode < 2; ++mode)
+    {
+        const bool fromStream = (mode == 0);
+        KIARA::Timer timer;
+        for (int i = 0; i < numIterations; ++i)
+        {
+            if (!parseIDL(world, idl, fromStream))
+            {
+                std::cerr << "Error: Could not parse generated IDL" << std::endl;
+                return 1;
+            }
+        }
+        report(fromStream ? "IDL parser, istream" : "IDL parser, buffer ", timer.elapsed(), idl.size(), numIterations);
+        world.collectCycles();
+    }
+
+    for (int mode = 0; mode < 2; ++mode)
+    {
+        const bool fromStream = (mode == 0);
+        size_t numTokens = 0;
+        KIARA::Timer timer;
+        for (int i = 0; i < numIterations; ++i)
+        {
+            if (fromStream)
+            {
+                std::istringstream in(idl);
+                KIARA::Compiler::Lexer lexer(in);
+                numTokens = lex(lexer);
+            }
+            else
+            {
+                KIARA::Compiler::Lexer lexer(idl.data(), idl.data() + idl.size());
+                numTokens = lex(lexer);
+            }
+        }
+        report(fromStream ? "Lexer, istream     " : "Lexer, buffer      ", timer.elapsed(), idl.size(), numIterations);
+        std::cout << "  " << numTokens << " tokens" << std::endl;
+    }
+
+    return 0;
+}
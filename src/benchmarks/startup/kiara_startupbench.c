@@ -0,0 +1,142 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * kiara_startupbench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ *
+ * Measures KIARA initialization and connection setup latency.
+ * Run it twice: first run fills the runtime cache (~/.kiara/cache or
+ * KIARA_RUNTIME_CACHE_DIR), second one shows the warm start.
+ * Set KIARA_RUNTIME_CACHE_DIR to an empty string to disable the cache.
+ *
+ * Usage: kiara_startupbench [url] [numIterations] [snapshotFile]
+ * With snapshotFile the context is saved after the first connection and
+ * the time to restore it with kiaraNewContextFromSnapshot is measured.
+ */
+
+#include <KIARA/kiara.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../kiara/Profiler.h"
+
+int main(int argc, char **argv)
+{
+    KIARA_Context *ctx;
+    KIARA_Connection *conn;
+    const char *url = "http://localhost:8080/rpc/calc";
+    const char *snapshotFile = NULL;
+    int i, numIterations = 10;
+    MIDDLEWARENEWSBRIEF_PROFILER_TIME_TYPE start, initTime, contextTime, firstConnTime, connTime = 0;
+    MIDDLEWARENEWSBRIEF_PROFILER_TIME_TYPE restoreTime = 0, restoredConnTime = 0;
+
+    setvbuf(stdout, NULL, _IONBF, 0);
+    setvbuf(stderr, NULL, _IONBF, 0);
+
+    start = MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME;
+    kiaraInit(&argc, argv);
+    initTime = MIDDLEWARENEWSBRIEF_PROFILER_DIFF(MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME, start);
+
+    if (argc > 1)
+        url = argv[1];
+    if (argc > 2)
+        numIterations = atoi(argv[2]);
+    if (numIterations < 1)
+        numIterations = 1;
+    if (argc > 3)
+        snapshotFile = argv[3];
+
+    start = MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME;
+    ctx = kiaraNewContext();
+    contextTime = MIDDLEWARENEWSBRIEF_PROFILER_DIFF(MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME, start);
+
+    start = MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME;
+    conn = kiaraOpenConnection(ctx, url);
+    firstConnTime = MIDDLEWARENEWSBRIEF_PROFILER_DIFF(MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME, start);
+    if (!conn)
+    {
+        fprintf(stderr, "Error: Could not open connection : %s\n", kiaraGetContextError(ctx));
+        kiaraFreeContext(ctx);
+        kiaraFinalize();
+        return 1;
+    }
+    kiaraCloseConnection(conn);
+
+    if (snapshotFile)
+    {
+        KIARA_Context *restoredCtx;
+
+        if (kiaraSaveContextSnapshot(ctx, snapshotFile) != KIARA_SUCCESS)
+        {
+            fprintf(stderr, "Error: Could not save snapshot : %s\n", kiaraGetContextError(ctx));
+            kiaraFreeContext(ctx);
+            kiaraFinalize();
+            return 1;
+        }
+
+        start = MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME;
+        restoredCtx = kiaraNewContextFromSnapshot(snapshotFile);
+        restoreTime = MIDDLEWARENEWSBRIEF_PROFILER_DIFF(MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME, start);
+        if (!restoredCtx)
+        {
+            fprintf(stderr, "Error: Could not restore context from snapshot %s\n", snapshotFile);
+            kiaraFreeContext(ctx);
+            kiaraFinalize();
+            return 1;
+        }
+
+        start = MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME;
+        conn = kiaraOpenConnection(restoredCtx, url);
+        restoredConnTime = MIDDLEWARENEWSBRIEF_PROFILER_DIFF(MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME, start);
+        if (conn)
+            kiaraCloseConnection(conn);
+        else
+            fprintf(stderr, "Error: Could not open connection : %s\n", kiaraGetContextError(restoredCtx));
+        kiaraFreeContext(restoredCtx);
+    }
+
+    for (i = 0; i < numIterations; ++i)
+    {
+        start = MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME;
+        conn = kiaraOpenConnection(ctx, url);
+        connTime += MIDDLEWARENEWSBRIEF_PROFILER_DIFF(MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME, start);
+        if (!conn)
+        {
+            fprintf(stderr, "Error: Could not open connection : %s\n", kiaraGetContextError(ctx));
+            break;
+        }
+        kiaraCloseConnection(conn);
+    }
+
+    printf("kiaraInit: %lu " MIDDLEWARENEWSBRIEF_PROFILER_TIME_UNITS "\n", (unsigned long)initTime);
+    printf("kiaraNewContext: %lu " MIDDLEWARENEWSBRIEF_PROFILER_TIME_UNITS "\n", (unsigned long)contextTime);
+    printf("First kiaraOpenConnection: %lu " MIDDLEWARENEWSBRIEF_PROFILER_TIME_UNITS "\n", (unsigned long)firstConnTime);
+    if (snapshotFile)
+    {
+        printf("kiaraNewContextFromSnapshot: %lu " MIDDLEWARENEWSBRIEF_PROFILER_TIME_UNITS "\n", (unsigned long)restoreTime);
+        printf("First kiaraOpenConnection from snapshot: %lu " MIDDLEWARENEWSBRIEF_PROFILER_TIME_UNITS "\n", (unsigned long)restoredConnTime);
+    }
+    printf("Average latency in " MIDDLEWARENEWSBRIEF_PROFILER_TIME_UNITS ": %f\n", (double)connTime / numIterations);
+
+    kiaraFreeContext(ctx);
+    kiaraFinalize();
+
+    return 0;
+}
@@ -0,0 +1,274 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * kiara_workerbench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ *
+ * Measures requests/s of the calc service over the ZeroMQ tcp transport
+ * while the number of server worker threads grows from 1 to N.
+ * For each worker count a calc server is forked with KIARA_SERVER_WORKERS
+ * set, and a fixed number of client threads, each with its own context
+ * and connection, call calc.add against it.
+ *
+ * Usage: kiara_workerbench [maxWorkers [numClients [callsPerClient [port]]]]
+ */
+
+#include <KIARA/kiara.h>
+#include <KIARA/kiara_macros.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "../kiara/Profiler.h"
+
+KIARA_DECL_PTR(IntPtr, KIARA_INT)
+
+/* Server side */
+
+KIARA_DECL_SERVICE(Calc_Add_Service,
+    KIARA_SERVICE_RESULT(IntPtr, result)
+    KIARA_SERVICE_ARG(KIARA_INT, a)
+    KIARA_SERVICE_ARG(KIARA_INT, b))
+
+KIARA_Result calc_add_impl(KIARA_ServiceFuncObj *kiara_funcobj, int *result, int a, int b)
+{
+    *result = a + b;
+    return KIARA_SUCCESS;
+}
+
+static int runServer(int port, int numWorkers)
+{
+    KIARA_Context *ctx;
+    KIARA_Service *service;
+    KIARA_Server *server;
+    KIARA_Result result;
+    char value[32], path[64];
+
+    snprintf(value, sizeof(value), "%i", numWorkers);
+    setenv("KIARA_SERVER_WORKERS", value, 1);
+
+    ctx = kiaraNewContext();
+    service = kiaraNewService(ctx);
+
+    result = kiaraLoadServiceIDLFromString(service,
+        "KIARA",
+        "namespace * calc "
+        "service calc { "
+        "    i32 add(i32 a, i32 b) "
+        "} ");
+    if (result != KIARA_SUCCESS)
+    {
+        fprintf(stderr, "Error: could not parse IDL: %s: %s\n",
+                kiaraGetErrorName(result), kiaraGetServiceError(service));
+        return 1;
+    }
+
+    result = KIARA_REGISTER_SERVICE_FUNC(service, "calc.add", Calc_Add_Service, "", calc_add_impl);
+    if (result != KIARA_SUCCESS)
+    {
+        fprintf(stderr, "Error: registration failed: %s: %s\n",
+                kiaraGetErrorName(result), kiaraGetServiceError(service));
+        return 1;
+    }
+
+    server = kiaraNewServer(ctx, "0.0.0.0", port, "/service");
+
+    snprintf(path, sizeof(path), "tcp://0.0.0.0:%i/rpc/calc", port + 1);
+    kiaraAddService(server, path, "jsonrpc", service);
+
+    result = kiaraRunServer(server);
+    if (result != KIARA_SUCCESS)
+    {
+        fprintf(stderr, "Error: could not start server: %s: %s\n",
+                kiaraGetErrorName(result), kiaraGetServerError(server));
+        return 1;
+    }
+
+    kiaraFreeServer(server);
+    kiaraFreeService(service);
+    kiaraFreeContext(ctx);
+    return 0;
+}
+
+/* Client side */
+
+KIARA_DECL_FUNC(Calc_Add,
+  KIARA_FUNC_RESULT(IntPtr, result)
+  KIARA_FUNC_ARG(KIARA_INT, a)
+  KIARA_FUNC_ARG(KIARA_INT, b)
+)
+
+typedef struct ClientThread
+{
+    pthread_t thread;
+    const char *url;
+    int numCalls;
+    int failed;
+} ClientThread;
+
+static void * runClient(void *arg)
+{
+    ClientThread *client = (ClientThread*)arg;
+    KIARA_Context *ctx;
+    KIARA_Connection *conn;
+    KIARA_FUNC_OBJ(Calc_Add) add;
+    int i, result = 0;
+
+    /* Each thread requires a separate KIARA_Context instance */
+    ctx = kiaraNewContext();
+    conn = kiaraOpenConnection(ctx, client->url);
+    if (!conn)
+    {
+        fprintf(stderr, "Error: Could not open connection : %s\n", kiaraGetContextError(ctx));
+        client->failed = 1;
+        kiaraFreeContext(ctx);
+        return NULL;
+    }
+
+    add = KIARA_GENERATE_CLIENT_FUNC(conn, "calc.add", Calc_Add, "");
+    if (!add)
+    {
+        fprintf(stderr, "Error: code generation failed: %s\n", kiaraGetConnectionError(conn));
+        client->failed = 1;
+    }
+
+    for (i = 0; add && i < client->numCalls; ++i)
+    {
+        if (KIARA_CALL(add, &result, i, 1) != KIARA_SUCCESS || result != i + 1)
+        {
+            fprintf(stderr, "Error: call failed: %s\n", kiaraGetConnectionError(conn));
+            client->failed = 1;
+            break;
+        }
+    }
+
+    kiaraCloseConnection(conn);
+    kiaraFreeContext(ctx);
+    return NULL;
+}
+
+static int runClients(const char *url, int numClients, int callsPerClient, double *requestsPerSec)
+{
+    ClientThread *clients;
+    MIDDLEWARENEWSBRIEF_PROFILER_TIME_TYPE start, elapsed;
+    int i, failed = 0;
+
+    clients = (ClientThread*)calloc(numClients, sizeof(ClientThread));
+
+    start = MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME;
+    for (i = 0; i < numClients; ++i)
+    {
+        clients[i].url = url;
+        clients[i].numCalls = callsPerClient;
+        pthread_create(&clients[i].thread, NULL, runClient, &clients[i]);
+    }
+    for (i = 0; i < numClients; ++i)
+    {
+        pthread_join(clients[i].thread, NULL);
+        failed |= clients[i].failed;
+    }
+    elapsed = MIDDLEWARENEWSBRIEF_PROFILER_DIFF(MIDDLEWARENEWSBRIEF_PROFILER_GET_TIME, start);
+
+    *requestsPerSec = elapsed ? (double)numClients * callsPerClient * USEC_PER_SEC / elapsed : 0.0;
+
+    free(clients);
+    return failed;
+}
+
+/* 1, 2, 4, ... and finally maxWorkers */
+static int nextWorkerCount(int numWorkers, int maxWorkers)
+{
+    if (numWorkers < maxWorkers && numWorkers * 2 > maxWorkers)
+        return maxWorkers;
+    return numWorkers * 2;
+}
+
+int main(int argc, char **argv)
+{
+    int maxWorkers, numClients, callsPerClient = 2000, port = 9190;
+    int numWorkers, failed = 0;
+    double requestsPerSec, baseline = 0.0;
+    char url[64];
+    pid_t server;
+
+    setvbuf(stdout, NULL, _IONBF, 0);
+    setvbuf(stderr, NULL, _IONBF, 0);
+
+    kiaraInit(&argc, argv);
+
+    maxWorkers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (argc > 1)
+        maxWorkers = atoi(argv[1]);
+    if (maxWorkers < 1)
+        maxWorkers = 1;
+    numClients = 2 * maxWorkers;
+    if (argc > 2)
+        numClients = atoi(argv[2]);
+    if (numClients < 1)
+        numClients = 1;
+    if (argc > 3)
+        callsPerClient = atoi(argv[3]);
+    if (callsPerClient < 1)
+        callsPerClient = 1;
+    if (argc > 4)
+        port = atoi(argv[4]);
+
+    snprintf(url, sizeof(url), "http://localhost:%i/service", port);
+
+    printf("%i client threads, %i calls of calc.add per client\n", numClients, callsPerClient);
+    printf("%8s %14s %8s\n", "workers", "requests/s", "speedup");
+
+    for (numWorkers = 1; numWorkers <= maxWorkers; numWorkers = nextWorkerCount(numWorkers, maxWorkers))
+    {
+        server = fork();
+        if (server < 0)
+        {
+            perror("fork");
+            failed = 1;
+            break;
+        }
+        if (server == 0)
+            _exit(runServer(port, numWorkers));
+
+        /* Give the server time to bind its ports */
+        sleep(1);
+
+        if (runClients(url, numClients, callsPerClient, &requestsPerSec) != 0)
+            failed = 1;
+
+        kill(server, SIGTERM);
+        waitpid(server, NULL, 0);
+
+        if (numWorkers == 1)
+            baseline = requestsPerSec;
+
+        printf("%8i %14.2f %8.2f\n", numWorkers, requestsPerSec,
+               baseline > 0.0 ? requestsPerSec / baseline : 0.0);
+    }
+
+    kiaraFinalize();
+
+    return failed;
+}
@@ -29,6 +29,12 @@
 #include <DFC/Base/Core/Object.hpp>
 #include <DFC/Base/Core/ObjectFactory.hpp>
 #include <DFC/Base/Utils/Chronometer.hpp>
+#include <KIARA/Utils/Timer.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <algorithm>
+#include <vector>
 #include <limits>
 
 #ifdef min
@@ -45,8 +51,8 @@ class GCValue : public KIARA::GCObject
     DFC_DECLARE_TYPE(GCValue, KIARA::GCObject)
 public:
 
-    static size_t constructedObjects;
-    static size_t destroyedObjects;
+    static boost::atomic<size_t> constructedObjects;
+    static boost::atomic<size_t> destroyedObjects;
 
     int value;
     KIARA::GCObject::Ptr children[2];
@@ -69,6 +75,20 @@ public:
 #endif
     }
 
+    /// Children of objects shared between threads are set under the collector lock
+    void setChild(int index, const KIARA::GCObject::Ptr &child)
+    {
+        MutationLock lock(*this);
+        children[index] = child;
+    }
+
+    void moveChild(int index, GCValue &to)
+    {
+        MutationLock lock(*this);
+        to.setChild(index, children[index]);
+        children[index].reset();
+    }
+
 protected:
 
     virtual void gcUnlinkRefs()
@@ -86,8 +106,8 @@ protected:
 };
 
 DFC_DEFINE_NON_CONSTRUCTIBLE_TYPE(GCValue)
-size_t GCValue::constructedObjects = 0;
-size_t GCValue::destroyedObjects = 0;
+boost::atomic<size_t> GCValue::constructedObjects(0);
+boost::atomic<size_t> GCValue::destroyedObjects(0);
 
 
 double minTime = std::numeric_limits<double>::max();
@@ -205,6 +225,172 @@ void check(size_t maxNumRoots = 1)
     }
 }
 
+// Cycles are created and released by several threads, while the threads
+// share another object and collect concurrently.
+
+void createCycles(KIARA::CycleCollector *collector, GCValue::Ptr shared, int numCycles)
+{
+    for (int i = 0; i < numCycles; ++i)
+    {
+        GCValue::Ptr obj1 = new GCValue(i, *collector);
+        GCValue::Ptr obj2 = new GCValue(i+1, *collector);
+
+        obj1->setChild(0, obj2);
+        obj1->setChild(1, shared);
+        obj2->setChild(0, obj1);
+
+        if (i % 100 == 0)
+            collector->collectCyclesIncremental(0.0001);
+    }
+}
+
+void checkThreads(size_t maxNumRoots, int numThreads)
+{
+    KIARA::CycleCollector collector(maxNumRoots);
+    GCValue::constructedObjects = 0;
+    GCValue::destroyedObjects = 0;
+
+    {
+        GCValue::Ptr shared = new GCValue(0, collector);
+        boost::thread_group threads;
+        for (int i = 0; i < numThreads; ++i)
+            threads.create_thread(boost::bind(createCycles, &collector, shared, 10000));
+        threads.join_all();
+    }
+    collector.collectCycles();
+    collector.collectCycles(); // roots released during the first collection
+
+    BOOST_CHECK(GCValue::constructedObjects == GCValue::destroyedObjects);
+    BOOST_CHECK(collector.getNumPossibleCycleRoots() == 0);
+
+    std::cout<<"TEST WITH "<<numThreads<<" THREADS: Constructed objects: "<<GCValue::constructedObjects
+             <<" Destroyed objects: "<<GCValue::destroyedObjects<<std::endl;
+}
+
+// A reference is moved back and forth between two objects of a live cycle,
+// while other threads release garbage cycles referencing the live cycle and
+// collect concurrently. The moved object is never collected.
+
+void moveChildren(GCValue::Ptr a, GCValue::Ptr b, int numMoves)
+{
+    for (int i = 0; i < numMoves; ++i)
+    {
+        if (i % 2 == 0)
+            a->moveChild(1, *b);
+        else
+            b->moveChild(1, *a);
+    }
+}
+
+void checkMoves(int numThreads)
+{
+    KIARA::CycleCollector collector(100);
+    GCValue::constructedObjects = 0;
+    GCValue::destroyedObjects = 0;
+
+    {
+        GCValue::Ptr a = new GCValue(1, collector);
+        GCValue::Ptr b = new GCValue(2, collector);
+        GCValue *movedObject = 0;
+        {
+            GCValue::Ptr moved = new GCValue(3, collector);
+            movedObject = moved.get();
+            moved->setChild(0, a);
+            a->setChild(0, b);
+            a->setChild(1, moved);
+            b->setChild(0, a);
+        }
+
+        boost::thread_group threads;
+        threads.create_thread(boost::bind(moveChildren, a, b, 100000));
+        for (int i = 1; i < numThreads; ++i)
+            threads.create_thread(boost::bind(createCycles, &collector, b, 10000));
+        threads.join_all();
+
+        collector.collectCycles();
+        collector.collectCycles();
+        BOOST_CHECK(GCValue::destroyedObjects + 3 == GCValue::constructedObjects);
+        KIARA::GCObject::Ptr moved = a->children[1] ? a->children[1] : b->children[1];
+        BOOST_REQUIRE(moved.get() == movedObject);
+        BOOST_CHECK(movedObject->value == 3);
+    }
+    collector.collectCycles();
+    collector.collectCycles();
+
+    BOOST_CHECK(GCValue::constructedObjects == GCValue::destroyedObjects);
+
+    std::cout<<"MOVE TEST WITH "<<numThreads<<" THREADS: Constructed objects: "<<GCValue::constructedObjects
+             <<" Destroyed objects: "<<GCValue::destroyedObjects<<std::endl;
+}
+
+// Pause time benchmark: garbage cycles attached to a large live graph,
+// which is not traced by the collector when it is not reachable from roots.
+
+double percentile(const std::vector<double> &sortedTimes, double p)
+{
+    if (sortedTimes.empty())
+        return 0.0;
+    size_t index = static_cast<size_t>(p * (sortedTimes.size() - 1) + 0.5);
+    return sortedTimes[index];
+}
+
+void benchmarkPauses(const char *name, double timeBudget, size_t numLiveObjects, size_t numSteps)
+{
+    KIARA::CycleCollector collector(std::numeric_limits<size_t>::max());
+    GCValue::constructedObjects = 0;
+    GCValue::destroyedObjects = 0;
+
+    std::vector<double> pauses;
+    {
+        // live graph, like types and IR objects in the World
+        std::vector<GCValue::Ptr> live;
+        live.reserve(numLiveObjects);
+        for (size_t i = 0; i < numLiveObjects; ++i)
+        {
+            GCValue::Ptr obj = new GCValue(int(i), collector);
+            if (i > 0)
+                obj->children[0] = live[(i - 1) / 2];
+            live.push_back(obj);
+        }
+        collector.collectCycles();
+
+        for (size_t step = 0; step < numSteps; ++step)
+        {
+            for (int i = 0; i < 100; ++i)
+            {
+                GCValue::Ptr obj1 = new GCValue(i, collector);
+                GCValue::Ptr obj2 = new GCValue(i+1, collector);
+
+                obj1->children[0] = obj2;
+                obj1->children[1] = live[(step * 100 + i) % live.size()];
+                obj2->children[0] = obj1;
+            }
+
+            KIARA::Timer timer;
+            if (timeBudget > 0.0)
+                collector.collectCyclesIncremental(timeBudget);
+            else
+                collector.collectCycles();
+            pauses.push_back(timer.elapsed() * 1000.0);
+        }
+
+        while (!collector.collectCyclesIncremental(1.0))
+            ;
+        live.clear();
+    }
+    collector.collectCycles();
+
+    BOOST_CHECK(GCValue::constructedObjects == GCValue::destroyedObjects);
+
+    std::sort(pauses.begin(), pauses.end());
+    std::cout<<name<<": "<<numLiveObjects<<" live objects, "<<pauses.size()<<" pauses, "
+             <<"p50 = "<<percentile(pauses, 0.5)<<" ms, "
+             <<"p90 = "<<percentile(pauses, 0.9)<<" ms, "
+             <<"p99 = "<<percentile(pauses, 0.99)<<" ms, "
+             <<"max = "<<(pauses.empty() ? 0.0 : pauses.back())<<" ms, "
+             <<"collected = "<<collector.getNumCollectedObjects()<<std::endl;
+}
+
 int test_main (int argc, char **argv)
 {
     KIARA::LibraryInit init;
@@ -220,5 +406,12 @@ int test_main (int argc, char **argv)
     std::cout << "Maximum GC time : "<<maxTime<<" ms num roots = "<<maxTimeRoots<<std::endl;
     std::cout << "Minimum GC time : "<<minTime<<" ms num roots = "<<minTimeRoots<<std::endl;
 
+    checkThreads(100, 8);
+    checkThreads(std::numeric_limits<size_t>::max(), 8);
+    checkMoves(8);
+
+    benchmarkPauses("stop-the-world", 0.0, 100000, 1000);
+    benchmarkPauses("incremental 0.1 ms", 0.0001, 100000, 1000);
+
     return 0;
 }
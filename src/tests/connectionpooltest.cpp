@@ -0,0 +1,149 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2012, 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * connectionpooltest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+#include <boost/test/minimal.hpp>
+#include <KIARA/Transport/ConnectionPool.hpp>
+#include <KIARA/Utils/DBuffer.hpp>
+#include <zmq.h>
+#include <boost/thread/thread.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/bind.hpp>
+#include <vector>
+#include <string>
+#include <sstream>
+
+using namespace KIARA;
+
+namespace
+{
+
+const unsigned short PORT = 15731;
+const unsigned short SILENT_PORT = 15732; // no server is listening
+const size_t NUM_THREADS = 16;
+const size_t NUM_CALLS = 200;
+
+/// Echo server with REQ/REP envelope handling, replies are prefixed with "re:"
+void runServer(void *context, size_t numRequests)
+{
+    void *socket = zmq_socket(context, ZMQ_REP);
+    std::ostringstream endpoint;
+    endpoint<<"tcp://127.0.0.1:"<<PORT;
+    zmq_bind(socket, endpoint.str().c_str());
+
+    char buf[256];
+    for (size_t i = 0; i < numRequests; ++i)
+    {
+        int size = zmq_recv(socket, buf, sizeof(buf), 0);
+        if (size < 0)
+            break;
+        std::string reply = "re:" + std::string(buf, size);
+        zmq_send(socket, reply.data(), reply.size(), 0);
+    }
+    zmq_close(socket);
+}
+
+void runClient(const Transport::ConnectionPool::Ptr &pool, size_t thread, size_t &numErrors)
+{
+    Transport::PooledConnection::Ptr connection =
+        boost::static_pointer_cast<Transport::PooledConnection>(pool->openConnection("127.0.0.1", PORT));
+    if (!connection)
+    {
+        numErrors = NUM_CALLS;
+        return;
+    }
+
+    DBuffer reply;
+    for (size_t i = 0; i < NUM_CALLS; ++i)
+    {
+        std::ostringstream oss;
+        oss<<"thread "<<thread<<" call "<<i;
+        std::string request = oss.str();
+
+        reply.clear();
+        if (!connection->call(DBuffer(&request[0], request.size(), request.size(), DBuffer::dont_free_tag()), reply) ||
+            std::string(reply.data(), reply.size()) != "re:" + request)
+            ++numErrors;
+    }
+}
+
+} // unnamed namespace
+
+int test_main (int argc, char **argv)
+{
+    void *serverContext = zmq_ctx_new();
+    boost::thread server(boost::bind(&runServer, serverContext, NUM_THREADS * NUM_CALLS));
+
+    ConnectionPoolConfiguration config;
+    config.maxConnections = 4;
+    config.maxConnectionsPerPeer = 2;
+    {
+        Transport::ConnectionPool::Ptr pool(new Transport::ConnectionPool(config));
+
+        std::vector<size_t> numErrors(NUM_THREADS, 0);
+        boost::thread_group threads;
+        for (size_t i = 0; i < NUM_THREADS; ++i)
+            threads.create_thread(boost::bind(&runClient, pool, i, boost::ref(numErrors[i])));
+        threads.join_all();
+
+        for (size_t i = 0; i < NUM_THREADS; ++i)
+            BOOST_CHECK(numErrors[i] == 0);
+
+        // all logical connections were multiplexed over the per peer limit
+        BOOST_CHECK(pool->getNumChannels() == config.maxConnectionsPerPeer);
+    }
+
+    server.join();
+    zmq_ctx_term(serverContext);
+
+    // calls without reply fail after the call timeout
+    config.callTimeout = 200;
+    {
+        Transport::ConnectionPool::Ptr pool(new Transport::ConnectionPool(config));
+        Transport::PooledConnection::Ptr connection =
+            boost::static_pointer_cast<Transport::PooledConnection>(pool->openConnection("127.0.0.1", SILENT_PORT));
+        BOOST_REQUIRE(connection);
+
+        std::string request = "lost";
+        DBuffer reply;
+        std::string errorMsg;
+        const boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+        BOOST_CHECK(!connection->call(DBuffer(&request[0], request.size(), request.size(), DBuffer::dont_free_tag()),
+                                      reply, &errorMsg));
+        const boost::posix_time::time_duration elapsed = boost::posix_time::microsec_clock::universal_time() - start;
+        BOOST_CHECK(errorMsg == "Call timed out");
+        BOOST_CHECK(elapsed >= boost::posix_time::milliseconds(config.callTimeout));
+        BOOST_CHECK(elapsed < boost::posix_time::seconds(5));
+    }
+
+    // an idle timeout of 0 never closes unused channels
+    config.idleTimeout = 0;
+    {
+        Transport::ConnectionPool::Ptr pool(new Transport::ConnectionPool(config));
+        BOOST_REQUIRE(pool->openConnection("127.0.0.1", SILENT_PORT));
+        boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+        BOOST_CHECK(pool->getNumChannels() == 1);
+    }
+
+    return 0;
+}
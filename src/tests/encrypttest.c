@@ -19,6 +19,7 @@
 #include <KIARA/kiara_security.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 int mu_tests_run;
 
@@ -144,16 +145,258 @@ MU_TEST(test_encrypt)
     return NULL;
 }
 
+static const char * check_seal_in_place(const char *cipherName)
+{
+    const KIARA_SymmetricKey *key, *key2;
+    kr_dbuffer_t *buffer;
+    const char *input = "\nWho are you ?\nI am the 'Doctor'.\n'Doctor' who ?\nPrecisely!";
+    const size_t inputSize = strlen(input);
+    size_t sealedSize;
+    KIARA_Result result;
+    char keyText[32];
+    int i;
+
+    printf("Cipher: %s\n", cipherName);
+
+    MU_CHECK(kiaraIsAEADCipher(kiaraGetCipher(cipherName)));
+
+    key = kiaraGetThreadSymmetricKey(kiaraGetCipher(cipherName), "password");
+    MU_CHECK(key != NULL);
+    key2 = kiaraGetThreadSymmetricKey(kiaraGetCipher(cipherName), "password");
+    MU_CHECK(key == key2);
+
+    buffer = kr_dbuffer_new();
+    MU_CHECK(buffer != NULL);
+
+    /* Empty buffer */
+    result = kiaraSealInPlace(key, buffer);
+    MU_CHECK(result == KIARA_SUCCESS);
+    MU_CHECK(kr_dbuffer_size(buffer) > 0);
+    result = kiaraOpenInPlace(key, buffer);
+    MU_CHECK(result == KIARA_SUCCESS);
+    MU_CHECK(kr_dbuffer_size(buffer) == 0);
+
+    kr_dbuffer_copy_mem(buffer, input, inputSize);
+    result = kiaraSealInPlace(key, buffer);
+    MU_CHECK(result == KIARA_SUCCESS);
+    sealedSize = kr_dbuffer_size(buffer);
+    MU_CHECK(sealedSize > inputSize);
+    MU_CHECK(memcmp(input, kr_dbuffer_data(buffer), inputSize) != 0);
+
+    dump("Sealed", stdout, kr_dbuffer_data(buffer), kr_dbuffer_size(buffer), 0);
+
+    result = kiaraOpenInPlace(key, buffer);
+    MU_CHECK(result == KIARA_SUCCESS);
+    MU_CHECK(kr_dbuffer_size(buffer) == inputSize);
+    MU_CHECK(memcmp(input, kr_dbuffer_data(buffer), inputSize) == 0);
+
+    /* Modified ciphertext must be rejected */
+    result = kiaraSealInPlace(key, buffer);
+    MU_CHECK(result == KIARA_SUCCESS);
+    kr_dbuffer_data(buffer)[0] ^= 1;
+    result = kiaraOpenInPlace(key, buffer);
+    MU_CHECK(result == KIARA_DECRYPTION_FAILED);
+    MU_CHECK(kr_dbuffer_size(buffer) == 0);
+
+    /* Context must be usable after failed authentication */
+    kr_dbuffer_copy_mem(buffer, input, inputSize);
+    MU_CHECK(kiaraSealInPlace(key, buffer) == KIARA_SUCCESS);
+    MU_CHECK(kiaraOpenInPlace(key, buffer) == KIARA_SUCCESS);
+    MU_CHECK(memcmp(input, kr_dbuffer_data(buffer), inputSize) == 0);
+
+    /* Modified chunk size in the trailer must be rejected, the message
+       is still a single chunk with the larger chunk size */
+    MU_CHECK(kiaraSealInPlace(key, buffer) == KIARA_SUCCESS);
+    kr_dbuffer_data(buffer)[kr_dbuffer_size(buffer) - 12 - 4 + 3] ^= 1;
+    MU_CHECK(kiaraOpenInPlace(key, buffer) == KIARA_DECRYPTION_FAILED);
+    MU_CHECK(kr_dbuffer_size(buffer) == 0);
+
+    /* Truncated message */
+    kr_dbuffer_resize(buffer, 4);
+    MU_CHECK(kiaraOpenInPlace(key, buffer) == KIARA_DECRYPTION_FAILED);
+
+    /* Keys evicted from the bounded cache are derived again */
+    for (i = 0; i < 40; ++i)
+    {
+        sprintf(keyText, "password%d", i);
+        MU_CHECK(kiaraGetThreadSymmetricKey(kiaraGetCipher(cipherName), keyText) != NULL);
+    }
+    key = kiaraGetThreadSymmetricKey(kiaraGetCipher(cipherName), "password");
+    MU_CHECK(key != NULL);
+    MU_CHECK(key == kiaraGetThreadSymmetricKey(kiaraGetCipher(cipherName), "password"));
+    kr_dbuffer_copy_mem(buffer, input, inputSize);
+    MU_CHECK(kiaraSealInPlace(key, buffer) == KIARA_SUCCESS);
+    MU_CHECK(kiaraOpenInPlace(key, buffer) == KIARA_SUCCESS);
+    MU_CHECK(memcmp(input, kr_dbuffer_data(buffer), inputSize) == 0);
+
+    kr_dbuffer_delete(buffer);
+
+    return NULL;
+}
+
+MU_TEST(test_seal_in_place)
+{
+    const char *message;
+
+    MU_CHECK(!kiaraIsAEADCipher(kiaraGetCipher(NULL)));
+
+    if ((message = check_seal_in_place(KIARA_DEFAULT_AEAD_CIPHER)))
+        return message;
+    if (kiaraGetCipher("chacha20-poly1305"))
+        return check_seal_in_place("chacha20-poly1305");
+    return NULL;
+}
+
+static void fill_pattern(kr_dbuffer_t *buffer, size_t size)
+{
+    size_t i;
+    kr_dbuffer_resize(buffer, size);
+    for (i = 0; i < size; ++i)
+        kr_dbuffer_data(buffer)[i] = (char)(i * 31 + (i >> 8));
+}
+
+static int check_pattern(kr_dbuffer_t *buffer, size_t size)
+{
+    size_t i;
+    if (kr_dbuffer_size(buffer) != size)
+        return 0;
+    for (i = 0; i < size; ++i)
+        if (kr_dbuffer_data(buffer)[i] != (char)(i * 31 + (i >> 8)))
+            return 0;
+    return 1;
+}
+
+MU_TEST(test_seal_chunked)
+{
+    const KIARA_SymmetricKey *key;
+    kr_dbuffer_t *buffer, *sealed;
+    const size_t chunkSize = 1000;
+    const size_t sizes[] = { 999, 1000, 1001, 10000, 123457 };
+    const size_t num_sizes = sizeof(sizes)/sizeof(sizes[0]);
+    size_t i;
+    int threads;
+
+    key = kiaraGetThreadSymmetricKey(kiaraGetCipher(KIARA_DEFAULT_AEAD_CIPHER), "password");
+    MU_CHECK(key != NULL);
+
+    buffer = kr_dbuffer_new();
+    sealed = kr_dbuffer_new();
+
+    MU_CHECK(kiaraSetCipherChunkSize(chunkSize) == KIARA_SUCCESS);
+
+    for (threads = 1; threads <= 4; threads *= 2)
+    {
+        MU_CHECK(kiaraSetCipherThreads(threads) == KIARA_SUCCESS);
+        MU_CHECK(kiaraGetCipherThreads() == threads);
+
+        for (i = 0; i < num_sizes; ++i)
+        {
+            fill_pattern(buffer, sizes[i]);
+            MU_CHECK(kiaraSealInPlace(key, buffer) == KIARA_SUCCESS);
+            kr_dbuffer_assign(sealed, buffer);
+
+            MU_CHECK(kiaraOpenInPlace(key, buffer) == KIARA_SUCCESS);
+            MU_CHECK(check_pattern(buffer, sizes[i]));
+
+            /* Modified last chunk */
+            kr_dbuffer_assign(buffer, sealed);
+            kr_dbuffer_data(buffer)[sizes[i]-1] ^= 0x40;
+            MU_CHECK(kiaraOpenInPlace(key, buffer) == KIARA_DECRYPTION_FAILED);
+            MU_CHECK(kr_dbuffer_size(buffer) == 0);
+
+            if (sizes[i] > 2 * chunkSize)
+            {
+                /* Swapped chunks */
+                kr_dbuffer_assign(buffer, sealed);
+                memcpy(kr_dbuffer_data(buffer), kr_dbuffer_data(sealed) + chunkSize, chunkSize);
+                memcpy(kr_dbuffer_data(buffer) + chunkSize, kr_dbuffer_data(sealed), chunkSize);
+                MU_CHECK(kiaraOpenInPlace(key, buffer) == KIARA_DECRYPTION_FAILED);
+            }
+        }
+    }
+
+    /* Data sealed with other chunk size is decrypted with the stored one */
+    fill_pattern(buffer, 10000);
+    MU_CHECK(kiaraSealInPlace(key, buffer) == KIARA_SUCCESS);
+    MU_CHECK(kiaraSetCipherChunkSize(4096) == KIARA_SUCCESS);
+    MU_CHECK(kiaraOpenInPlace(key, buffer) == KIARA_SUCCESS);
+    MU_CHECK(check_pattern(buffer, 10000));
+
+    MU_CHECK(kiaraSetCipherChunkSize(0) == KIARA_INVALID_ARGUMENT);
+    MU_CHECK(kiaraSetCipherChunkSize(256 * 1024) == KIARA_SUCCESS);
+    MU_CHECK(kiaraSetCipherThreads(0) == KIARA_SUCCESS);
+
+    kr_dbuffer_delete(sealed);
+    kr_dbuffer_delete(buffer);
+
+    return NULL;
+}
+
+/* Prints encryption and decryption throughput of a sizeMB buffer for 1, 2, 4, ... threads */
+static void benchmark_scaling(int sizeMB, int repeat)
+{
+    const KIARA_SymmetricKey *key;
+    kr_dbuffer_t *buffer;
+    const size_t size = (size_t)sizeMB * 1024 * 1024;
+    int maxThreads, threads, i;
+    double startTime, sealTime, openTime;
+
+    kiaraSetCipherThreads(0);
+    maxThreads = kiaraGetCipherThreads();
+
+    key = kiaraGetThreadSymmetricKey(kiaraGetCipher(KIARA_DEFAULT_AEAD_CIPHER), "password");
+    buffer = kr_dbuffer_new();
+    fill_pattern(buffer, size);
+
+    printf("Scaling of %s with %i MB, %i cores:\n", KIARA_DEFAULT_AEAD_CIPHER, sizeMB, maxThreads);
+    printf("%8s %14s %14s\n", "threads", "seal MB/s", "open MB/s");
+
+    for (threads = 1; ; threads = threads * 2 < maxThreads ? threads * 2 : maxThreads)
+    {
+        kiaraSetCipherThreads(threads);
+
+        sealTime = openTime = 0;
+        for (i = 0; i < repeat; ++i)
+        {
+            startTime = kiaraGetTime();
+            kiaraSealInPlace(key, buffer);
+            sealTime += kiaraGetTime() - startTime;
+
+            startTime = kiaraGetTime();
+            if (kiaraOpenInPlace(key, buffer) != KIARA_SUCCESS)
+            {
+                printf("Error: decryption failed\n");
+                break;
+            }
+            openTime += kiaraGetTime() - startTime;
+        }
+
+        printf("%8i %14.1f %14.1f\n", threads, sizeMB * repeat / sealTime, sizeMB * repeat / openTime);
+
+        if (threads == maxThreads)
+            break;
+    }
+
+    kiaraSetCipherThreads(0);
+    kr_dbuffer_delete(buffer);
+}
+
 MU_TEST(all_tests)
 {
     kiaraInit(NULL, NULL);
 
     MU_RUN_TEST(test_encrypt);
+    MU_RUN_TEST(test_seal_in_place);
+    MU_RUN_TEST(test_seal_chunked);
 
     kiaraFinalize();
     return NULL;
 }
 
+/* Usage: kiara_encrypttest [sizeMB [repeat]]
+ * With sizeMB the scaling of chunked encryption with the number of threads is measured
+ * after the tests.
+ */
 int main (int argc, char **argv)
 {
     const char *result = all_tests();
@@ -167,5 +410,12 @@ int main (int argc, char **argv)
     }
     printf("Tests run: %d\n", mu_tests_run);
 
+    if (!result && argc > 1)
+    {
+        kiaraInit(NULL, NULL);
+        benchmark_scaling(atoi(argv[1]), argc > 2 ? atoi(argv[2]) : 5);
+        kiaraFinalize();
+    }
+
     return result != NULL;
 }
@@ -21,11 +21,19 @@
  *
  *  Created on: Aug 14, 2013
  *      Author: Dmitri Rubinstein
+ *
+ * Usage: kiara_enctest [url [numCalls [stringSize]]]
+ *
+ * When numCalls is specified enc.sendString is additionally called numCalls
+ * times with a string of stringSize bytes (default 4096) and the achieved
+ * rate of encrypted calls is reported.
  */
 #include <KIARA/kiara.h>
 #include <KIARA/kiara_macros.h>
 #include <KIARA/CDT/kr_dstring.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 KIARA_DECL_PTR(IntPtr, KIARA_INT)
 
@@ -65,6 +73,8 @@ int main(int argc, char **argv)
     KIARA_Context *ctx;
     KIARA_Connection *conn;
     const char *url = NULL;
+    int numCalls = 0;
+    int stringSize = 4096;
 
     KIARA_FUNC_OBJ(SendInt) sendInt;
     KIARA_FUNC_OBJ(SendString) sendString;
@@ -88,6 +98,10 @@ int main(int argc, char **argv)
     {
         url = "http://localhost:8080/service";
     }
+    if (argc > 2)
+        numCalls = atoi(argv[2]);
+    if (argc > 3)
+        stringSize = atoi(argv[3]);
 
     /* Open connection to the service */
     printf("Opening connection to %s...\n", url);
@@ -151,6 +165,41 @@ int main(int argc, char **argv)
             {
                 printf("enc.sendString: result = %s\n", kr_dstring_str(&result));
             }
+
+            if (numCalls > 0 && errorCode == KIARA_SUCCESS)
+            {
+                char *data = malloc(stringSize + 1);
+                double startTime, elapsed;
+                int i;
+
+                memset(data, 'x', stringSize);
+                data[stringSize] = '\0';
+                kr_dstring_assign_str(&value, data);
+                free(data);
+
+                printf("Benchmark: %i calls of enc.sendString with %i bytes...\n", numCalls, stringSize);
+
+                startTime = kiaraGetTime();
+                for (i = 0; i < numCalls; ++i)
+                {
+                    errorCode = KIARA_CALL(sendString, &result, &value, i);
+                    if (errorCode != KIARA_SUCCESS)
+                    {
+                        fprintf(stderr, "Error: call %i failed: %s\n", i, kiaraGetConnectionError(conn));
+                        break;
+                    }
+                }
+                elapsed = kiaraGetTime() - startTime;
+
+                if (errorCode == KIARA_SUCCESS)
+                {
+                    if (kr_dstring_length(&result) != (size_t)stringSize)
+                        fprintf(stderr, "Error: enc.sendString returned %i bytes\n", (int)kr_dstring_length(&result));
+                    printf("Benchmark: %.3f sec, %.1f calls/sec, %.2f MB/sec encrypted (both directions)\n",
+                           elapsed, numCalls / elapsed, 2.0 * numCalls * stringSize / elapsed / (1024.0 * 1024.0));
+                }
+            }
+
             kr_dstring_destroy(&value);
         }
         else
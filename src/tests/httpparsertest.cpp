@@ -0,0 +1,154 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2012, 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * httpparsertest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+#include <boost/test/minimal.hpp>
+#include <KIARA/Transport/KT_HTTP_Parser.hpp>
+#include <KIARA/Transport/KT_HTTP_Responder.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace KIARA::Transport;
+
+namespace
+{
+
+std::string makeRequest(const std::string &path, const std::string &body, const char *extraHeader = "")
+{
+    return "POST " + path + " HTTP/1.1\r\n"
+        "Host: localhost:8080\r\n" + std::string(extraHeader) +
+        "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+}
+
+} // unnamed namespace
+
+int test_main (int argc, char **argv)
+{
+    // pipelined requests in one segment are parsed one at a time
+    {
+        const std::string first = makeRequest("/rpc/calc", "first body");
+        const std::string second = makeRequest("/rpc/calc", "second", "Connection: close\r\n");
+        const std::string data = first + second;
+
+        KT_HTTP_Parser parser1(data.data(), data.size());
+        BOOST_REQUIRE(parser1.is_valid());
+        BOOST_REQUIRE(parser1.is_complete());
+        BOOST_CHECK(parser1.get_parsed_size() == first.size());
+        BOOST_CHECK(parser1.get_payload() == "first body");
+        BOOST_CHECK(parser1.get_url() == "/rpc/calc");
+        BOOST_CHECK(parser1.should_keep_alive());
+
+        const size_t offset = parser1.get_parsed_size();
+        KT_HTTP_Parser parser2(data.data() + offset, data.size() - offset);
+        BOOST_REQUIRE(parser2.is_complete());
+        BOOST_CHECK(parser2.get_parsed_size() == second.size());
+        BOOST_CHECK(parser2.get_payload() == "second");
+        BOOST_CHECK(!parser2.should_keep_alive());
+    }
+
+    // a request split over several segments is complete only with all of them
+    {
+        const std::string body(1000, 'x');
+        const std::string request = makeRequest("/rpc/calc", body);
+        const size_t headerSize = request.size() - body.size();
+
+        KT_HTTP_Parser headerOnly(request.data(), headerSize - 2);
+        BOOST_CHECK(headerOnly.is_valid());
+        BOOST_CHECK(!headerOnly.is_complete());
+
+        KT_HTTP_Parser partialBody(request.data(), headerSize + 100);
+        BOOST_CHECK(partialBody.is_valid());
+        BOOST_CHECK(!partialBody.is_complete());
+        BOOST_CHECK(partialBody.get_missing_size() == body.size() - 100);
+
+        KT_HTTP_Parser complete(request.data(), request.size());
+        BOOST_CHECK(complete.is_complete());
+        BOOST_CHECK(complete.get_payload() == body);
+    }
+
+    // a request passed in parts is parsed incrementally, also within header values
+    {
+        const std::string body(1000, 'x');
+        const std::string request = makeRequest("/rpc/calc", body, "If-None-Match: \"0123456789\"\r\n") + "GET /next HTTP/1.1\r\n";
+        const size_t headerSize = request.find("\r\n\r\n") + 4;
+
+        KT_HTTP_Parser parser;
+        size_t offset = 0;
+        while (offset < request.size() && !parser.is_complete())
+        {
+            BOOST_CHECK(parser.is_header_complete() == (offset >= headerSize));
+            const size_t parsedSize = parser.execute(request.data() + offset, std::min<size_t>(7, request.size() - offset));
+            offset += parsedSize;
+            BOOST_REQUIRE(parser.is_valid());
+            BOOST_CHECK(parser.get_parsed_size() == offset);
+            if (parser.is_header_complete())
+                BOOST_CHECK(parser.get_body_size() + parser.get_missing_size() == body.size());
+        }
+        BOOST_REQUIRE(parser.is_complete());
+        BOOST_CHECK(offset == headerSize + body.size());
+        BOOST_CHECK(parser.get_payload() == body);
+        BOOST_CHECK(parser.get_url() == "/rpc/calc");
+        BOOST_CHECK(parser.get_if_none_match() == "\"0123456789\"");
+        BOOST_CHECK(parser.get_identifier() == "localhost:8080/rpc/calc");
+        BOOST_CHECK(parser.execute(request.data() + offset, request.size() - offset) == 0);
+    }
+
+    // HTTP/1.0 closes the connection unless keep-alive is requested
+    {
+        const std::string request("GET /config HTTP/1.0\r\n\r\n");
+        KT_HTTP_Parser parser(request.data(), request.size());
+        BOOST_REQUIRE(parser.is_complete());
+        BOOST_CHECK(!parser.should_keep_alive());
+    }
+
+    {
+        const std::string request("NOT HTTP\r\n\r\n");
+        KT_HTTP_Parser parser(request.data(), request.size());
+        BOOST_CHECK(!parser.is_valid());
+    }
+
+    // responses are HTTP/1.1 and end exactly after Content-Length bytes
+    {
+        const std::string body("result");
+        const std::string response = KT_HTTP_Responder::generate_200_OK(std::vector<char>(body.begin(), body.end()));
+        const std::string data = response + response;
+
+        KT_HTTP_Parser parser(data.data(), data.size());
+        BOOST_REQUIRE(parser.is_complete());
+        BOOST_CHECK(parser.get_parsed_size() == response.size());
+        BOOST_CHECK(parser.get_status_code() == 200);
+        BOOST_CHECK(parser.get_payload() == body);
+        BOOST_CHECK(parser.should_keep_alive());
+
+        const std::string reason("bad");
+        const std::string badRequest = KT_HTTP_Responder::generate_400_BAD_REQUEST(std::vector<char>(reason.begin(), reason.end()));
+        KT_HTTP_Parser badParser(badRequest.data(), badRequest.size());
+        BOOST_REQUIRE(badParser.is_complete());
+        BOOST_CHECK(badParser.get_parsed_size() == badRequest.size());
+        BOOST_CHECK(badParser.get_status_code() == 400);
+        BOOST_CHECK(badParser.get_payload() == reason);
+    }
+
+    return 0;
+}
@@ -0,0 +1,243 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2012, 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * negotiationtest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+#include <boost/test/minimal.hpp>
+#include <KIARA/Transport/negotiation.h>
+#include <KIARA/Transport/registry.h>
+#include <KIARA/Transport/KT_Connection.hpp>
+#include <KIARA/Transport/KT_HTTP_Parser.hpp>
+#include <KIARA/Transport/KT_HTTP_Requester.hpp>
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+
+using namespace KIARA::Transport;
+
+// Server side request handler of the negotiation endpoint, see reco_engine.cpp
+void callback_handler_reco(KT_Msg&, KT_Session*, KT_Connection*);
+
+namespace
+{
+
+typedef std::map<std::string, std::string> CapabilityMap;
+
+/// Records sent messages instead of sending them
+class RecordingConnection : public KT_Connection
+{
+public:
+    std::vector<std::string> sent;
+
+    int connect(KT_Session**) { return -1; }
+    int send(KT_Msg& message, KT_Session&, int)
+    {
+        const std::vector<char> payload = message.get_payload();
+        sent.push_back(std::string(payload.begin(), payload.end()));
+        return 0;
+    }
+    int recv(KT_Session&, KT_Msg&, int) { return -1; }
+    int send(const KIARA::DBuffer&, KT_Session&) { return -1; }
+    int recv(KT_Session&, KIARA::DBuffer&) { return -1; }
+    int disconnect(KT_Session&) { return 0; }
+    int register_callback(std::function<void(KT_Msg&, KT_Session*, KT_Connection*)>) { return 0; }
+    int register_request_handler(KT_RequestHandler) { return 0; }
+    int bind() { return 0; }
+    int unbind() { return 0; }
+};
+
+void setCapabilities(neg_ctx_t *ctx)
+{
+    neg_set_local_capability(ctx, (char*)"network.transport-protocols.tcp.prec", (char*)"MUST");
+    neg_set_local_capability(ctx, (char*)"network.transport-protocols.udp.prec", (char*)"SHOULD NOT");
+    neg_set_local_capability(ctx, (char*)"network.transport-port.*.prec", (char*)"9090");
+    neg_set_local_capability(ctx, (char*)"application.application-protocols.http.prec", (char*)"SHOULD");
+}
+
+void addCapability(void *userData, char *id, char *value)
+{
+    (*static_cast<CapabilityMap*>(userData))[id] = value;
+    free(id);
+    free(value);
+}
+
+std::string encode(neg_ctx_t *ctx)
+{
+    unsigned char *data = 0;
+    size_t size = reg_encode_capabilities(ctx->hash, &data);
+    std::string result(reinterpret_cast<const char*>(data), size);
+    free(data);
+    return result;
+}
+
+std::string getJSON(neg_ctx_t *ctx)
+{
+    char *json = reg_get_local_capability_json(ctx);
+    std::string result(json);
+    free(json);
+    return result;
+}
+
+/// Sends an offer to the negotiation endpoint of server and returns the parsed response body
+std::string putOffer(neg_ctx_t *server, const std::string &offer, int *statusCode)
+{
+    std::string payload = KT_HTTP_Requester::generate_request("PUT", "localhost:5555", "/negotiation",
+                                                              std::vector<char>(offer.begin(), offer.end()));
+    KT_Msg request;
+    request.set_payload(payload);
+    KT_Session session;
+    session.set_k_user_data(server);
+    RecordingConnection connection;
+    callback_handler_reco(request, &session, &connection);
+    BOOST_REQUIRE(connection.sent.size() == 1);
+
+    KT_Msg reply;
+    reply.set_payload(connection.sent[0]);
+    KT_HTTP_Parser parser(reply);
+    *statusCode = parser.get_status_code();
+    return parser.get_payload();
+}
+
+std::string negotiate(neg_ctx_t *server, const std::string &offer)
+{
+    char *response = neg_negotiate_offer(server, "client", offer.data(), offer.size());
+    BOOST_REQUIRE(response != 0);
+    std::string result(response);
+    free(response);
+    return result;
+}
+
+} // unnamed namespace
+
+int test_main (int argc, char **argv)
+{
+    neg_ctx_t *client = neg_init();
+    setCapabilities(client);
+
+    // binary encoding round trip
+    {
+        const std::string data = encode(client);
+        BOOST_REQUIRE(!data.empty());
+        BOOST_CHECK(reg_is_binary_capabilities(data.data(), data.size()));
+        BOOST_CHECK(!reg_is_binary_capabilities("{}", 2));
+
+        CapabilityMap decoded;
+        BOOST_CHECK(reg_decode_capabilities(reinterpret_cast<const unsigned char*>(data.data()), data.size(),
+                                            addCapability, &decoded) == 0);
+        BOOST_CHECK(decoded.size() == 4);
+        BOOST_CHECK(decoded["network.transport-protocols.tcp.prec"] == "MUST");
+        BOOST_CHECK(decoded["network.transport-protocols.udp.prec"] == "SHOULD NOT");
+        BOOST_CHECK(decoded["network.transport-port.*.prec"] == "9090");
+        BOOST_CHECK(decoded["application.application-protocols.http.prec"] == "SHOULD");
+
+        // truncated and extended encodings are rejected as a whole
+        for (size_t size = 0; size < data.size(); ++size)
+        {
+            CapabilityMap partial;
+            BOOST_CHECK(reg_decode_capabilities(reinterpret_cast<const unsigned char*>(data.data()), size,
+                                                addCapability, &partial) == -1);
+            BOOST_CHECK(partial.empty());
+        }
+        const std::string extended = data + '\0';
+        CapabilityMap partial;
+        BOOST_CHECK(reg_decode_capabilities(reinterpret_cast<const unsigned char*>(extended.data()), extended.size(),
+                                            addCapability, &partial) == -1);
+        BOOST_CHECK(partial.empty());
+    }
+
+    // result cache
+    {
+        neg_ctx_t *ctx = neg_init();
+        BOOST_CHECK(reg_cache_find(ctx, "key") == 0);
+        BOOST_CHECK(reg_cache_add(ctx, "key", "response", 0, 0) != 0);
+        neg_cache_entry_t *entry = reg_cache_find(ctx, "key");
+        BOOST_REQUIRE(entry != 0);
+        BOOST_CHECK(std::string(entry->response) == "response");
+
+        // entries are replaced
+        reg_cache_add(ctx, "key", "other", 0, 0);
+        BOOST_CHECK(std::string(reg_cache_find(ctx, "key")->response) == "other");
+
+        // cache is bounded
+        for (int i = 0; i < NEG_CACHE_MAX_ENTRIES + 10; ++i)
+        {
+            std::string key = "key" + std::to_string(i);
+            reg_cache_add(ctx, key.c_str(), "response", 0, 0);
+        }
+        BOOST_CHECK(HASH_COUNT(ctx->cache) == NEG_CACHE_MAX_ENTRIES);
+
+        neg_set_cache_ttl(ctx, 0);
+        BOOST_CHECK(ctx->cache == 0);
+        BOOST_CHECK(reg_cache_add(ctx, "key", "response", 0, 0) == 0);
+        BOOST_CHECK(reg_cache_find(ctx, "key") == 0);
+    }
+
+    // JSON and binary offers through the negotiation endpoint of the server
+    {
+        neg_ctx_t *server = neg_init();
+        server->host = (char*)"localhost";
+        server->port = 5555;
+        setCapabilities(server);
+
+        // reference result, negotiated without cache
+        neg_ctx_t *reference = neg_init();
+        setCapabilities(reference);
+        neg_set_cache_ttl(reference, 0);
+        const std::string expected = negotiate(reference, getJSON(client));
+        BOOST_CHECK(!expected.empty());
+        BOOST_CHECK(negotiate(reference, encode(client)) == expected);
+
+        int statusCode = 0;
+        BOOST_CHECK(putOffer(server, getJSON(client), &statusCode) == expected);
+        BOOST_CHECK(statusCode == 200);
+        BOOST_CHECK(putOffer(server, encode(client), &statusCode) == expected);
+        BOOST_CHECK(statusCode == 200);
+
+        // repeated offers are answered from the cache with the same result
+        const unsigned int numCached = HASH_COUNT(server->cache);
+        BOOST_CHECK(numCached == 2);
+        BOOST_CHECK(putOffer(server, getJSON(client), &statusCode) == expected);
+        BOOST_CHECK(putOffer(server, encode(client), &statusCode) == expected);
+        BOOST_CHECK(HASH_COUNT(server->cache) == numCached);
+
+        // results returned from the cache are owned by the caller
+        char *first = neg_negotiate_offer(server, "client", getJSON(client).c_str(), getJSON(client).size());
+        char *second = neg_negotiate_offer(server, "client", getJSON(client).c_str(), getJSON(client).size());
+        BOOST_REQUIRE(first != 0 && second != 0);
+        BOOST_CHECK(first != second);
+        BOOST_CHECK(std::string(first) == std::string(second));
+        free(first);
+        free(second);
+
+        // invalid offers are rejected and not cached
+        const std::string binary = encode(client);
+        BOOST_CHECK(!putOffer(server, binary.substr(0, binary.size() - 1), &statusCode).empty());
+        BOOST_CHECK(statusCode == 400);
+        putOffer(server, "{ invalid", &statusCode);
+        BOOST_CHECK(statusCode == 400);
+        BOOST_CHECK(HASH_COUNT(server->cache) == numCached);
+    }
+
+    return 0;
+}
@@ -0,0 +1,232 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2012, 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * reactortest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+#include <boost/test/minimal.hpp>
+#include <KIARA/Transport/KT_Zeromq.hpp>
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+using namespace KIARA::Transport;
+
+namespace
+{
+
+const unsigned int BASE_PORT = 19730;
+const int NUM_PORTS = 2;
+const int PEERS_PER_PORT = 3;
+const int CHUNKS_PER_PEER = 200;
+
+/// Records the stream of every peer as received by the callback
+struct Recorder
+{
+    std::mutex mutex;
+    std::map<std::vector<char>, std::string> streams;
+    std::map<std::vector<char>, int> active;
+    size_t received;
+    bool overlapped;
+    std::atomic<bool> unbound;
+    bool calledAfterUnbind;
+
+    Recorder() : received(0), overlapped(false), unbound(false), calledAfterUnbind(false) { }
+};
+
+Recorder recorder;
+
+void recordingCallback(KT_Msg &msg, KT_Session *sess, KT_Connection *)
+{
+    const std::vector<char> &identity = sess->get_identifier();
+    {
+        std::lock_guard<std::mutex> lock(recorder.mutex);
+        if (recorder.unbound)
+            recorder.calledAfterUnbind = true;
+        if (++recorder.active[identity] > 1)
+            recorder.overlapped = true;
+    }
+
+    // Give the other dispatch threads a chance to overtake this request
+    usleep(static_cast<useconds_t>(msg.get_size() % 3) * 200);
+
+    std::lock_guard<std::mutex> lock(recorder.mutex);
+    --recorder.active[identity];
+    // Empty messages notify about connects and disconnects of the peer
+    if (0 != msg.get_size())
+    {
+        recorder.streams[identity].append(msg.get_payload_as_string());
+        recorder.received += msg.get_size();
+    }
+}
+
+int connectTo(unsigned int port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (fd >= 0 && 0 != ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)))
+    {
+        close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+
+std::string makeChunk(int peer, int index)
+{
+    std::ostringstream oss;
+    oss << peer << ':' << index << ';';
+    return oss.str();
+}
+
+} // unnamed namespace
+
+int test_main(int argc, char *argv[])
+{
+    KT_Zeromq server;
+    KT_Configuration config;
+    config.set_application_type(KT_STREAM);
+    config.set_worker_threads(4);
+    // Sockets are not polled while they have this many queued requests
+    config.set_max_queued_requests(8);
+    server.register_callback(&recordingCallback);
+
+    // All ports are served by the reactor of the connection
+    for (int i = 0; i < NUM_PORTS; ++i)
+    {
+        config.set_host(KT_TCP, "127.0.0.1", BASE_PORT + i);
+        server.set_configuration(config);
+        BOOST_REQUIRE(server.bind() == 0);
+    }
+
+    std::vector<int> peers;
+    for (int i = 0; i < NUM_PORTS * PEERS_PER_PORT; ++i)
+    {
+        int fd = connectTo(BASE_PORT + i % NUM_PORTS);
+        BOOST_REQUIRE(fd >= 0);
+        peers.push_back(fd);
+    }
+
+    // Peers send concurrently, every chunk is written separately
+    std::vector<std::thread> senders;
+    for (size_t i = 0; i < peers.size(); ++i)
+    {
+        senders.push_back(std::thread([&peers, i]() {
+            for (int j = 0; j < CHUNKS_PER_PEER; ++j)
+            {
+                const std::string chunk = makeChunk(static_cast<int>(i), j);
+                if (::send(peers[i], chunk.data(), chunk.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(chunk.size()))
+                    return;
+                if (0 == j % 10)
+                    usleep(100);
+            }
+        }));
+    }
+    for (size_t i = 0; i < senders.size(); ++i)
+        senders[i].join();
+
+    std::vector<std::string> sentStreams(peers.size());
+    size_t sentSize = 0;
+    for (size_t i = 0; i < peers.size(); ++i)
+    {
+        for (int j = 0; j < CHUNKS_PER_PEER; ++j)
+            sentStreams[i] += makeChunk(static_cast<int>(i), j);
+        sentSize += sentStreams[i].size();
+    }
+
+    for (int wait = 0; wait < 1000; ++wait)
+    {
+        {
+            std::lock_guard<std::mutex> lock(recorder.mutex);
+            if (recorder.received >= sentSize)
+                break;
+        }
+        usleep(10000);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(recorder.mutex);
+        BOOST_CHECK(recorder.received == sentSize);
+        BOOST_CHECK(!recorder.overlapped);
+        BOOST_REQUIRE(recorder.streams.size() == peers.size());
+
+        // Every peer's stream arrived in order, identities differ per peer
+        std::vector<std::string> receivedStreams;
+        for (std::map<std::vector<char>, std::string>::const_iterator it = recorder.streams.begin();
+             it != recorder.streams.end(); ++it)
+            receivedStreams.push_back(it->second);
+        for (size_t i = 0; i < sentStreams.size(); ++i)
+        {
+            bool found = false;
+            for (size_t j = 0; j < receivedStreams.size(); ++j)
+                found = found || receivedStreams[j] == sentStreams[i];
+            BOOST_CHECK(found);
+        }
+    }
+
+    // Unbind while a peer is still sending, it returns after the requests
+    // received so far were dispatched and no callback is called afterwards
+    std::atomic<bool> stopSending(false);
+    std::thread sender([&peers, &stopSending]() {
+        const std::string chunk = makeChunk(0, 0);
+        while (!stopSending && ::send(peers[0], chunk.data(), chunk.size(), MSG_NOSIGNAL) > 0)
+            usleep(100);
+    });
+    usleep(20000);
+    BOOST_CHECK(server.unbind() == 0);
+    recorder.unbound = true;
+    usleep(20000);
+    stopSending = true;
+    sender.join();
+
+    {
+        std::lock_guard<std::mutex> lock(recorder.mutex);
+        BOOST_CHECK(!recorder.calledAfterUnbind);
+        BOOST_CHECK(!recorder.overlapped);
+    }
+
+    for (size_t i = 0; i < peers.size(); ++i)
+        close(peers[i]);
+
+    // The ports can be bound again
+    for (int i = 0; i < NUM_PORTS; ++i)
+    {
+        config.set_host(KT_TCP, "127.0.0.1", BASE_PORT + i);
+        server.set_configuration(config);
+        BOOST_CHECK(server.bind() == 0);
+    }
+    BOOST_CHECK(server.unbind() == 0);
+
+    return 0;
+}
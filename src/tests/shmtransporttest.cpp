@@ -0,0 +1,154 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2012, 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * shmtransporttest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+#include <boost/test/minimal.hpp>
+#include <KIARA/Transport/ShmTransport.hpp>
+#include <KIARA/Impl/Core.hpp>
+#include <KIARA/Utils/DBuffer.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <vector>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace KIARA;
+
+namespace
+{
+
+const unsigned short PORT = 15732;
+const char *SERVER_URL = "shm://localhost:15732";
+const size_t NUM_THREADS = 4;
+const size_t NUM_CALLS = 500;
+
+void echo(const DBuffer &request, DBuffer &response)
+{
+    response.append_mem("re:", 3);
+    response.append(request);
+}
+
+void runClient(size_t thread, size_t &numErrors)
+{
+    const Transport::Transport *transport = Transport::Transport::getTransportByName("shm");
+    Transport::Connection::Ptr connection = transport->openConnection(SERVER_URL, Transport::NetworkContext::Ptr());
+    if (!connection)
+    {
+        numErrors = NUM_CALLS;
+        return;
+    }
+
+    DBuffer reply;
+    for (size_t i = 0; i < NUM_CALLS; ++i)
+    {
+        // messages larger than the ring buffer are streamed through it
+        std::string request(i * 37, static_cast<char>('a' + thread));
+
+        reply.clear();
+        if (!connection->call(DBuffer(&request[0], request.size(), request.size(), DBuffer::dont_free_tag()), reply) ||
+            std::string(reply.data(), reply.size()) != "re:" + request)
+            ++numErrors;
+    }
+}
+
+} // unnamed namespace
+
+int test_main (int argc, char **argv)
+{
+    const Transport::Transport *transport = Transport::Transport::getTransportByName("shm");
+    BOOST_REQUIRE(transport != 0);
+    BOOST_CHECK(!transport->isAvailable(SERVER_URL));
+
+    SharedMemoryConfiguration config = Impl::Global::getSharedMemoryConfiguration();
+    config.ringSize = 4096;
+
+    Transport::ShmServer server(config, PORT, &echo);
+    BOOST_REQUIRE(server.start());
+    BOOST_CHECK(transport->isAvailable(SERVER_URL));
+
+    // the socket of a running server is not taken over
+    {
+        Transport::ShmServer secondServer(config, PORT, &echo);
+        std::string errorMsg;
+        BOOST_CHECK(!secondServer.start(&errorMsg));
+        BOOST_CHECK(!errorMsg.empty());
+    }
+    BOOST_CHECK(transport->isAvailable(SERVER_URL));
+
+    std::vector<size_t> numErrors(NUM_THREADS, 0);
+    boost::thread_group threads;
+    for (size_t i = 0; i < NUM_THREADS; ++i)
+        threads.create_thread(boost::bind(&runClient, i, boost::ref(numErrors[i])));
+    threads.join_all();
+
+    for (size_t i = 0; i < NUM_THREADS; ++i)
+        BOOST_CHECK(numErrors[i] == 0);
+
+    // calls on open connections fail once the server is stopped
+    Transport::Connection::Ptr connection = transport->openConnection(SERVER_URL, Transport::NetworkContext::Ptr());
+    BOOST_REQUIRE(connection);
+    server.stop();
+
+    std::string request("hello");
+    DBuffer reply;
+    BOOST_CHECK(!connection->call(DBuffer(&request[0], request.size(), request.size(), DBuffer::dont_free_tag()), reply));
+    BOOST_CHECK(!transport->isAvailable(SERVER_URL));
+
+    // sockets live in a directory private to the user
+    struct stat st;
+    BOOST_REQUIRE(lstat(Transport::ShmTransport::getPrivateDirectory(config.socketDirectory).c_str(), &st) == 0);
+    BOOST_CHECK(S_ISDIR(st.st_mode) && st.st_uid == geteuid() && (st.st_mode & 077) == 0);
+
+    // a message above the size limit of the server closes the connection,
+    // connections above the limit are refused
+    config.maxMessageSize = 1024;
+    config.maxConnections = 1;
+    Transport::ShmServer limitedServer(config, PORT, &echo);
+    BOOST_REQUIRE(limitedServer.start());
+    connection = transport->openConnection(SERVER_URL, Transport::NetworkContext::Ptr());
+    BOOST_REQUIRE(connection);
+    BOOST_CHECK(!transport->openConnection(SERVER_URL, Transport::NetworkContext::Ptr()));
+
+    reply.clear();
+    BOOST_CHECK(connection->call(DBuffer(&request[0], request.size(), request.size(), DBuffer::dont_free_tag()), reply));
+    std::string largeRequest(2048, 'x');
+    reply.clear();
+    BOOST_CHECK(!connection->call(DBuffer(&largeRequest[0], largeRequest.size(), largeRequest.size(), DBuffer::dont_free_tag()), reply));
+    reply.clear();
+    BOOST_CHECK(!connection->call(DBuffer(&request[0], request.size(), request.size(), DBuffer::dont_free_tag()), reply));
+
+    // the closed connection frees its slot once its thread finished
+    connection.reset();
+    for (int i = 0; i < 100 && !connection; ++i)
+    {
+        connection = transport->openConnection(SERVER_URL, Transport::NetworkContext::Ptr());
+        if (!connection)
+            boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+    }
+    BOOST_REQUIRE(connection);
+    reply.clear();
+    BOOST_CHECK(connection->call(DBuffer(&request[0], request.size(), request.size(), DBuffer::dont_free_tag()), reply));
+
+    return 0;
+}
@@ -0,0 +1,143 @@
+/*  KIARA - Middleware for efficient and QoS/Security-aware invocation of services and exchange of messages
+ *
+ *  Copyright (C) 2012, 2013  German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/*
+ * worldmttest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Dmitri Rubinstein
+ */
+#include <boost/test/minimal.hpp>
+#include <KIARA/Core/LibraryInit.hpp>
+#include <KIARA/DB/World.hpp>
+#include <KIARA/DB/Module.hpp>
+#include <KIARA/DB/DerivedTypes.hpp>
+#include <KIARA/Utils/Timer.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <vector>
+#include <sstream>
+
+using namespace KIARA;
+
+namespace
+{
+
+const size_t NUM_THREADS = 8;
+const size_t NUM_ITERATIONS = 20000;
+const size_t NUM_ARRAY_SIZES = 16;
+
+struct SharedTypes
+{
+    World &world;
+    Module::Ptr module;
+    std::vector<Type::Ptr> arrays;  // expected results of type interning
+    FunctionType::Ptr funcType;
+
+    SharedTypes(World &world)
+        : world(world)
+        , module(new Module(world, "mttest"))
+    {
+        PtrType::Ptr i32Ptr = PtrType::get(world.type_i32());
+        for (size_t i = 0; i < NUM_ARRAY_SIZES; ++i)
+            arrays.push_back(FixedArrayType::get(i32Ptr, i));
+
+        Type::Ptr params[] = { world.type_c_int(), world.type_c_double() };
+        funcType = FunctionType::get(world.type_c_float(), params);
+    }
+};
+
+std::string typeName(size_t thread, size_t index)
+{
+    std::ostringstream oss;
+    oss<<"T"<<thread<<"_"<<index;
+    return oss.str();
+}
+
+void resolveTypes(SharedTypes &shared, size_t thread, size_t &numErrors)
+{
+    World &world = shared.world;
+    for (size_t i = 0; i < NUM_ITERATIONS; ++i)
+    {
+        // equal types created concurrently must be unified
+        Type::Ptr arrayType = FixedArrayType::get(PtrType::get(world.type_i32()), i % NUM_ARRAY_SIZES);
+        if (arrayType != shared.arrays[i % NUM_ARRAY_SIZES])
+            ++numErrors;
+
+        Type::Ptr params[] = { world.type_c_int(), world.type_c_double() };
+        if (FunctionType::get(world.type_c_float(), params) != shared.funcType)
+            ++numErrors;
+
+        // lookups of built-in types run concurrently with bindings
+        if (shared.module->lookupType("i32") != world.type_i32())
+            ++numErrors;
+
+        if (i % 100 == 0)
+        {
+            const size_t index = i / 100;
+            PtrType::Ptr ptrType = PtrType::get(shared.arrays[index % NUM_ARRAY_SIZES]);
+            shared.module->bindType(typeName(thread, index), TypedefType::create(typeName(thread, index), ptrType));
+
+            // types bound by other threads are either not yet visible or complete
+            Type::Ptr other = shared.module->lookupType(typeName((thread + 1) % NUM_THREADS, index));
+            if (other && !canonicallyEqual(other, ptrType))
+                ++numErrors;
+        }
+
+        if (thread == 0 && i % 1000 == 0)
+            world.collectCyclesIncremental(0.0001);
+    }
+}
+
+} // unnamed namespace
+
+int test_main (int argc, char **argv)
+{
+    KIARA::LibraryInit init;
+
+    World world;
+    {
+        SharedTypes shared(world);
+        std::vector<size_t> numErrors(NUM_THREADS, 0);
+
+        Timer timer;
+        boost::thread_group threads;
+        for (size_t i = 0; i < NUM_THREADS; ++i)
+            threads.create_thread(boost::bind(&resolveTypes, boost::ref(shared), i, boost::ref(numErrors[i])));
+        threads.join_all();
+
+        std::cout<<NUM_THREADS<<" threads x "<<NUM_ITERATIONS<<" iterations : "
+                 <<timer.elapsed() * 1000.0<<" ms"<<std::endl;
+
+        for (size_t i = 0; i < NUM_THREADS; ++i)
+            BOOST_CHECK(numErrors[i] == 0);
+
+        for (size_t t = 0; t < NUM_THREADS; ++t)
+        {
+            for (size_t index = 0; index < NUM_ITERATIONS / 100; ++index)
+            {
+                Type::Ptr type = shared.module->lookupType(typeName(t, index));
+                BOOST_CHECK(type != 0);
+                BOOST_CHECK(shared.module->getTypeName(type) == typeName(t, index));
+            }
+        }
+    }
+    world.collectCycles();
+
+    return 0;
+}